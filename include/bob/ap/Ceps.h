@@ -165,6 +165,15 @@ class Ceps: public Spectrogram
     { if (with_delta_delta) m_with_delta = true;
       m_with_delta_delta = with_delta_delta; }
 
+  protected:
+    /**
+     * @brief Computes the cepstral coefficients (and energy) of the output
+     * rows [begin,end[. The DCT of a whole block of frames is computed as a
+     * single matrix product.
+     */
+    virtual void processFrames(const blitz::Array<double,1>& input,
+      const int begin, const int end, blitz::Array<double,2>& output) const;
+
   private:
     /**
      * @brief Computes the first order derivative from the given input. 
@@ -89,6 +89,17 @@ class Energy: public FrameExtractor
      */
     double logEnergy(blitz::Array<double,1> &data) const;
 
+    /**
+     * @brief Computes the output rows [begin,end[ for the given input,
+     * output having the shape returned by getShape(). Only local working
+     * arrays are used, so that disjoint blocks of frames may be processed
+     * concurrently.
+     */
+    virtual void processFrames(const blitz::Array<double,1>& input,
+      const int begin, const int end, blitz::Array<double,2>& output) const;
+
+    friend class FeatureStream;
+
     double m_energy_floor;
     double m_log_energy_floor;
 };
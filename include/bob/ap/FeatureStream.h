@@ -0,0 +1,141 @@
+/**
+ * @file bob/ap/FeatureStream.h
+ * @date Sat Oct 18 16:21:09 2026 +0200
+ *
+ * @brief Extracts audio features from a stream of samples
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_AP_FEATURE_STREAM_H
+#define BOB_AP_FEATURE_STREAM_H
+
+#include <deque>
+#include <vector>
+#include <blitz/array.h>
+#include <boost/shared_ptr.hpp>
+#include "Energy.h"
+
+namespace bob {
+/**
+ * \ingroup libap_api
+ * @{
+ *
+ */
+namespace ap {
+
+/**
+ * @brief This class extracts features (Energy, Spectrogram or Ceps) from an
+ * audio signal given as a sequence of chunks of arbitrary sizes. Feature
+ * rows are returned as soon as the corresponding frames are complete, so
+ * that the memory used does not depend on the length of the recording.
+ *
+ * The concatenation of all the rows returned by process() and flush() is
+ * the same as the output of the extractor on the whole signal. When first
+ * and second order derivatives are enabled (Ceps), a row is only returned
+ * once the delta_win (resp. 2*delta_win) following frames are known.
+ *
+ * The parameters of the extractor should not be changed while a stream is
+ * being processed.
+ */
+class FeatureStream
+{
+  public:
+    /**
+     * @brief Constructor. Features are computed by the given extractor.
+     */
+    FeatureStream(boost::shared_ptr<const Energy> extractor);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~FeatureStream();
+
+    /**
+     * @brief Returns the extractor used to compute the features
+     */
+    boost::shared_ptr<const Energy> getExtractor() const
+    { return m_extractor; }
+
+    /**
+     * @brief Returns the dimension of the feature rows
+     */
+    size_t getNFeatures() const
+    { return m_n_features; }
+
+    /**
+     * @brief Returns the number of samples given to process() since the
+     * beginning of the stream
+     */
+    size_t getNSamples() const
+    { return m_n_samples; }
+
+    /**
+     * @brief Returns the number of rows returned since the beginning of the
+     * stream
+     */
+    size_t getNEmitted() const
+    { return m_n_emitted; }
+
+    /**
+     * @brief Processes a chunk of samples, and returns the feature rows that
+     * became available (possibly none).
+     */
+    blitz::Array<double,2> process(const blitz::Array<double,1>& samples);
+
+    /**
+     * @brief Ends the stream: returns the remaining feature rows, and resets
+     * the stream so that a new one may be processed.
+     */
+    blitz::Array<double,2> flush();
+
+    /**
+     * @brief Discards the state of the current stream
+     */
+    void reset();
+
+  private:
+    /**
+     * @brief Computes the derivatives of the rows that can be computed,
+     * taking the stream end into account if last is set.
+     */
+    void updateDerivatives(const bool last);
+
+    /**
+     * @brief Computes the derivative of the row i from the columns
+     * [src,src+m_n_coefs[ of rows [i-delta_win,i+delta_win], replicating the
+     * first and last rows, as Ceps does.
+     */
+    void derivative(const size_t i, const int src, const size_t n_rows);
+
+    /**
+     * @brief Removes the completed rows from the history and returns them,
+     * keeping the ones still needed to compute derivatives.
+     */
+    blitz::Array<double,2> emit(const size_t n);
+
+    blitz::Array<double,1>& row(const size_t i)
+    { return m_rows[i-m_first]; }
+
+    boost::shared_ptr<const Energy> m_extractor;
+    size_t m_n_features; ///< dimension of the output rows
+    size_t m_n_coefs; ///< dimension of the static features
+    size_t m_delta_win;
+    bool m_with_delta;
+    bool m_with_delta_delta;
+
+    std::vector<double> m_samples; ///< samples of the next frames
+    size_t m_skip; ///< samples to discard before the next frame starts
+    size_t m_n_samples;
+
+    std::deque<blitz::Array<double,1> > m_rows; ///< rows not yet discarded
+    size_t m_first; ///< index of the first row in m_rows
+    size_t m_n_frames; ///< number of rows with static features
+    size_t m_n_delta; ///< number of rows with first order derivatives
+    size_t m_n_delta_delta; ///< number of rows with second order derivatives
+    size_t m_n_emitted;
+};
+
+}}
+
+#endif /* BOB_AP_FEATURE_STREAM_H */
@@ -125,6 +125,11 @@ class Spectrogram: public Energy
      */
     bool getEnergyBands() const
     { return m_energy_bands; }
+    /**
+     * @brief Returns the number of threads used to process the frames
+     */
+    size_t getNThreads() const
+    { return m_n_threads; }
 
     /**
      * @brief Sets the sampling frequency/frequency rate
@@ -187,6 +192,12 @@ class Spectrogram: public Energy
      */
     virtual void setEnergyBands(bool energy_bands)
     { m_energy_bands = energy_bands; }
+    /**
+     * @brief Sets the number of threads used to process the frames. Each
+     * thread processes a contiguous block of frames, and the output does not
+     * depend on this setting.
+     */
+    void setNThreads(size_t n_threads);
 
 
   protected:
@@ -228,6 +239,49 @@ class Spectrogram: public Energy
     void triangularFilterBank(blitz::Array<double,1>& data) const;
 
 
+    /**
+     * @brief Computes the output rows [begin,end[ for the given input. Only
+     * local working arrays are used, so that disjoint blocks of frames may
+     * be processed concurrently.
+     */
+    virtual void processFrames(const blitz::Array<double,1>& input,
+      const int begin, const int end, blitz::Array<double,2>& output) const;
+    /**
+     * @brief Calls processFrames() over all the frames of the input, split
+     * into m_n_threads contiguous blocks.
+     */
+    void processAllFrames(const blitz::Array<double,1>& input,
+      const int n_frames, blitz::Array<double,2>& output) const;
+    /**
+     * @brief Extracts and normalizes the frames starting at index begin
+     * into the rows of the given (C-style) array of m_win_size columns.
+     */
+    void extractFrames(const blitz::Array<double,1>& input, const int begin,
+      blitz::Array<double,2>& frames) const;
+    /**
+     * @brief Applies pre-emphasis and the Hamming window to each row of the
+     * given frames, and replaces the m_win_size/2+1 first elements of each
+     * row by the magnitude (or energy) of its spectrum. A real FFT is used,
+     * and wsave should have been initialized with rffti(). It rounds
+     * differently from the complex FFT of powerSpectrumFFT(): the
+     * magnitudes differ by about 1e-15 of the largest one, which is the
+     * only difference with the frame by frame computation.
+     */
+    void powerSpectra(blitz::Array<double,2>& frames,
+      blitz::Array<double,1>& wsave) const;
+    /**
+     * @brief Applies the triangular filter bank to each row of the given
+     * power spectra. As each filter only spans a few frequency bins, this is
+     * a banded matrix product.
+     */
+    void filterBanks(const blitz::Array<double,2>& spectra,
+      blitz::Array<double,2>& bands) const;
+    /**
+     * @brief Number of frames processed together by processFrames(). The
+     * working arrays of a block are small enough to remain in cache.
+     */
+    static const int s_frames_per_block = 64;
+
     virtual void initWinLength();
     virtual void initWinSize();
 
@@ -263,6 +317,7 @@ class Spectrogram: public Energy
     bool m_log_filter;
     bool m_energy_bands;
     double m_log_fb_out_floor;
+    size_t m_n_threads;
 
     blitz::Array<double,1> m_hamming_kernel;
     blitz::Array<int,1> m_p_index;
@@ -13,6 +13,7 @@
 #define BOB_CORE_ARRAY_UTILS_H
 
 #include <blitz/array.h>
+#include <vector>
 #include <stdint.h>
 #include <stdexcept>
 #include <boost/format.hpp>
@@ -133,6 +134,35 @@ namespace bob { namespace core { namespace array {
 
   }
 
+  /**
+   * @brief Returns a blitz::Array<> referring to the same data, shape,
+   * strides and bases as the given one, but with its own reference counter.
+   * The reference counting of blitz::Array<> is not thread safe (unless
+   * Blitz++ was built with BZ_THREADSAFE), so a thread that works on a part
+   * of arrays shared with other threads should create such views first, and
+   * only slice or copy these. The given array must outlive the view.
+   */
+  template <typename T, int N>
+  blitz::Array<T,N> private_view(const blitz::Array<T,N>& a) {
+    blitz::GeneralArrayStorage<N> storage;
+    storage.ordering() = a.ordering();
+    storage.base() = a.base();
+    return blitz::Array<T,N>(const_cast<T*>(a.data()), a.shape(), a.stride(),
+        blitz::neverDeleteData, storage);
+  }
+
+  /**
+   * @brief Returns private_view() of each array of the given vector
+   */
+  template <typename T, int N>
+  std::vector<blitz::Array<T,N> > private_view
+  (const std::vector<blitz::Array<T,N> >& a) {
+    std::vector<blitz::Array<T,N> > res;
+    res.reserve(a.size());
+    for (size_t k=0; k<a.size(); ++k) res.push_back(private_view(a[k]));
+    return res;
+  }
+
   /**
    * @}
    */
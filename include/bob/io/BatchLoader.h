@@ -0,0 +1,177 @@
+/**
+ * @file bob/io/BatchLoader.h
+ * @date Sun Oct 19 11:48:26 2026 +0200
+ *
+ * @brief Loads lists of files in parallel, e.g. to prepare data sets of
+ * images.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IO_BATCHLOADER_H
+#define BOB_IO_BATCHLOADER_H
+
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <bob/core/array.h>
+#include <bob/core/blitz_array.h>
+#include <bob/io/File.h>
+#include <bob/io/ImageLoadOptions.h>
+
+namespace bob { namespace io {
+  /**
+   * @ingroup IO
+   * @{
+   */
+
+  /**
+   * @brief Loads the contents of several files (each one as a single array,
+   * see bob::io::File::read_all()) with a pool of threads.
+   *
+   * Each thread takes the next file of the list, decodes it and releases it
+   * before taking another one, so that at most getNThreads() files are
+   * decoded at once, whatever the length of the list. Errors are reported
+   * file by file, and do not stop the loading of the other files.
+   *
+   * load() opens each file once, and decodes it as soon as the type of its
+   * contents is known, directly into its slice of the stacked array when
+   * possible.
+   *
+   * The files may be loaded with image loading options (see
+   * bob::io::ImageLoadOptions), e.g. to decode images downscaled or in
+   * grayscale.
+   *
+   * @warning The codecs of the files should support being used from several
+   * threads at once, which is the case of the image codecs. HDF5 files, for
+   * instance, should be loaded with a single thread.
+   */
+  class BatchLoader {
+
+    public: //api
+
+      /**
+       * @brief Constructor, loading the files with their default codec
+       */
+      BatchLoader(const size_t n_threads=1);
+
+      /**
+       * @brief Constructor, loading images with the given options
+       */
+      BatchLoader(const ImageLoadOptions& options, const size_t n_threads=1);
+
+      /**
+       * @brief Getters and setters
+       */
+      size_t getNThreads() const { return m_n_threads; }
+      void setNThreads(const size_t n_threads);
+      bool useOptions() const { return m_use_options; }
+      const ImageLoadOptions& getOptions() const { return m_options; }
+      void setOptions(const ImageLoadOptions& options);
+
+      /**
+       * @brief Finds the type of the contents of each file. If a file cannot
+       * be opened, the corresponding type is reset (invalid) and the error
+       * message is set in errors (which are empty strings otherwise).
+       */
+      void peek(const std::vector<std::string>& filenames,
+          std::vector<bob::core::array::typeinfo>& types,
+          std::vector<std::string>& errors) const;
+
+      /**
+       * @brief Reads each file into the corresponding buffer, which should
+       * have the type returned by peek(). The buffers of the files which
+       * cannot be read are left untouched, and the error messages are set
+       * in errors (which are empty strings otherwise). Null buffers are
+       * skipped.
+       */
+      void read(const std::vector<std::string>& filenames,
+          const std::vector<boost::shared_ptr<bob::core::array::interface> >& buffers,
+          std::vector<std::string>& errors) const;
+
+      /**
+       * @brief Allocates the arrays the files are loaded into, e.g. as NumPy
+       * arrays in the Python bindings. allocate() is called from the loading
+       * threads, but never by two threads at once.
+       */
+      class Allocator {
+        public:
+          virtual ~Allocator() {}
+          virtual boost::shared_ptr<bob::core::array::interface>
+            allocate(const bob::core::array::typeinfo& type) =0;
+      };
+
+      /**
+       * @brief Loads all the files. If the contents of all the readable files
+       * have the same type, they are written into a single array, stacked
+       * along a new first dimension (the slices of the files which cannot be
+       * read are filled with zeros), and true is returned. Otherwise, each
+       * file is loaded in a separate array of arrays (null for the files
+       * which cannot be read), and false is returned.
+       */
+      bool load(const std::vector<std::string>& filenames,
+          bob::core::array::blitz_array& stacked,
+          std::vector<boost::shared_ptr<bob::core::array::blitz_array> >& arrays,
+          std::vector<std::string>& errors) const;
+
+      /**
+       * @brief Same as above, but the arrays are allocated by the given
+       * allocator. In the stacked case, stacked is set and arrays is empty;
+       * otherwise, stacked is reset.
+       */
+      bool load(const std::vector<std::string>& filenames,
+          Allocator& allocator,
+          boost::shared_ptr<bob::core::array::interface>& stacked,
+          std::vector<boost::shared_ptr<bob::core::array::interface> >& arrays,
+          std::vector<std::string>& errors) const;
+
+      /**
+       * @brief Gets the type of the stacked array of the given types, and
+       * returns false if they are not all the same (ignoring invalid types).
+       */
+      static bool stackedType(
+          const std::vector<bob::core::array::typeinfo>& types,
+          bob::core::array::typeinfo& stacked);
+
+    private: //representation
+
+      /**
+       * @brief Opens the given file, with the options if they are set
+       */
+      boost::shared_ptr<File> open(const std::string& filename) const;
+
+      /**
+       * @brief The state shared by the threads of load()
+       */
+      struct LoadState;
+
+      /**
+       * @brief Peeks, reads or loads the files given by a shared counter,
+       * until there is no file left
+       */
+      void peekFiles(const std::vector<std::string>* filenames,
+          std::vector<bob::core::array::typeinfo>* types,
+          std::vector<std::string>* errors, size_t* next,
+          boost::mutex* mutex) const;
+      void readFiles(const std::vector<std::string>* filenames,
+          const std::vector<boost::shared_ptr<bob::core::array::interface> >* buffers,
+          std::vector<std::string>* errors, size_t* next,
+          boost::mutex* mutex) const;
+      void loadFiles(const std::vector<std::string>* filenames,
+          Allocator* allocator, LoadState* state,
+          std::vector<std::string>* errors, size_t* next,
+          boost::mutex* mutex) const;
+
+      size_t m_n_threads; ///< the number of threads
+      bool m_use_options; ///< are the images loaded with options?
+      ImageLoadOptions m_options; ///< the image loading options
+  };
+
+  /**
+   * @}
+   */
+}}
+
+#endif /* BOB_IO_BATCHLOADER_H */
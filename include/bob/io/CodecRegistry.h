@@ -16,6 +16,7 @@
 #include <boost/shared_ptr.hpp>
 
 #include <bob/io/File.h>
+#include <bob/io/ImageLoadOptions.h>
 
 namespace bob { namespace io {
 
@@ -59,6 +60,16 @@ namespace bob { namespace io {
 
       bool isRegistered(const std::string& ext);
 
+      /**
+       * Registers the decoder with loading options of an image format. The
+       * extension should also be registered with registerExtension().
+       */
+      void registerImageDecoder(const std::string& extension,
+          image_decoder_t decoder);
+
+      image_decoder_t findImageDecoderByExtension(const std::string& ext);
+      image_decoder_t findImageDecoderByFilenameExtension(const std::string& fn);
+
     private:
 
       CodecRegistry(): s_extension2codec(), s_ignore(false) {}
@@ -68,6 +79,7 @@ namespace bob { namespace io {
 
       std::map<std::string, file_factory_t> s_extension2codec;
       std::map<std::string, std::string> s_extension2description;
+      std::map<std::string, image_decoder_t> s_extension2decoder;
       bool s_ignore; ///< shall I ignore double-registrations?
     
   };
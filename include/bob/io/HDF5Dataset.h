@@ -247,6 +247,31 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
           return readArray<T,N>(0);
         }
 
+      /**
+       * Reads a range of consecutive entries of a list dataset in a single
+       * shot. The first extent of the given array determines how many
+       * entries are read, starting at position "index"; the remaining
+       * extents have to match the shape of each entry. For lists of scalars,
+       * pass a 1D array.
+       *
+       * This is much faster than reading the entries one by one, as all data
+       * is fetched with a single HDF5 read operation.
+       *
+       * @param index The position of the first entry to read
+       * @param value The output array data will be stored inside this
+       * variable. This variable has to be a zero-based C-style contiguous
+       * storage array. If that is not the case, we will raise an exception.
+       */
+      template <typename T, int N>
+        void readArrays(size_t index, blitz::Array<T,N>& value) {
+          bob::core::array::assertCZeroBaseContiguous(value);
+          bob::io::HDF5Type dest_type(value);
+          if (N == 1) dest_type = bob::io::HDF5Type(T());
+          else dest_type.shape() <<= 1;
+          read_buffer(index, value.extent(0), dest_type,
+              reinterpret_cast<void*>(value.data()));
+        }
+
       /**
        * DATA WRITING FUNCTIONALITY
        */
@@ -384,6 +409,13 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
        */
       void read_buffer (size_t index, const bob::io::HDF5Type& dest, void* buffer);
 
+      /**
+       * Reads "count" consecutive objects of type "dest", starting at
+       * "index", into the given (user) buffer, using a single read.
+       */
+      void read_buffer (size_t index, size_t count,
+          const bob::io::HDF5Type& dest, void* buffer);
+
       /**
        * Writes the contents of a given buffer into the file. The area that the
        * data will occupy should have been selected beforehand.
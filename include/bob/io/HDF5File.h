@@ -236,6 +236,18 @@ namespace bob { namespace io {
           return readArray<T,N>(path, 0);
       }
 
+      /**
+       * Reads a range of consecutive entries of a list dataset in a single
+       * operation. The first extent of "value" sets the number of entries to
+       * read, starting at position "pos". The remaining extents must match
+       * the shape of each entry (use a 1D array for lists of scalars).
+       * Relative paths are accepted.
+       */
+      template <typename T, int N> void readArrays(const std::string& path,
+          size_t pos, blitz::Array<T,N>& value) {
+        (*m_cwd)[path]->readArrays(pos, value);
+      }
+
       /**
        * Modifies the value of a scalar inside the file. Relative paths are
        * accepted.
@@ -357,6 +369,43 @@ namespace bob { namespace io {
         (*m_cwd)[path]->replaceArray(0, value);
       }
 
+    public: //chunking, caching and compression settings
+
+      /**
+       * Sets the target size, in bytes, for the chunks of datasets created
+       * from now on. As many entries as fit in this size are stored in each
+       * chunk, which reduces the per-chunk overhead when storing many small
+       * objects. Zero (the default) stores one entry per chunk.
+       */
+      void setChunkSize(size_t bytes) { m_file->set_chunk_bytes(bytes); }
+
+      /**
+       * Returns the current target chunk size, in bytes
+       */
+      size_t getChunkSize() const { return m_file->chunk_bytes(); }
+
+      /**
+       * If set, compressed datasets created from now on apply the HDF5
+       * shuffle filter before gzip. This usually improves both compression
+       * ratio and speed on numerical data, specially with low compression
+       * levels.
+       */
+      void setShuffle(bool v) { m_file->set_shuffle(v); }
+
+      /**
+       * Tells if the shuffle filter is used for new compressed datasets
+       */
+      bool getShuffle() const { return m_file->shuffle(); }
+
+      /**
+       * Configures the chunk cache of all datasets in this file: the number
+       * of hash table slots (preferably a prime, about 100 times the number of
+       * chunks that fit in the cache), the cache size in bytes and the
+       * preemption policy w0, between 0 and 1 (set it to 1 if chunks are
+       * read once, sequentially). The file structure is reloaded.
+       */
+      void setChunkCache(size_t nslots, size_t nbytes, double w0=0.75);
+
     public: //api shortcuts to deal with buffers -- avoid these at all costs!
 
       /**
@@ -375,6 +424,14 @@ namespace bob { namespace io {
       void read_buffer (const std::string& path, size_t pos,
           const HDF5Type& type, void* buffer) const;
 
+      /**
+       * Reads "count" consecutive objects starting at position "pos" into a
+       * buffer with sufficient space to hold all of them. Relative paths are
+       * accepted.
+       */
+      void read_buffer (const std::string& path, size_t pos, size_t count,
+          const HDF5Type& type, void* buffer) const;
+
       /**
        * writes the contents of a given buffer into the file. the area that the
        * data will occupy should have been selected beforehand.
@@ -116,12 +116,44 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
        */
       bool writeable() const;
 
+      /**
+       * Target size, in bytes, of the chunks of newly created datasets. The
+       * chunk extent along the first (list) dimension is set so that each
+       * chunk holds approximately this many bytes. Zero (the default) keeps
+       * one object per chunk.
+       */
+      size_t chunk_bytes() const { return m_chunk_bytes; }
+      void set_chunk_bytes(size_t bytes) { m_chunk_bytes = bytes; }
+
+      /**
+       * If set, the shuffle filter is applied before compression on newly
+       * created datasets. Has no effect on uncompressed datasets.
+       */
+      bool shuffle() const { return m_shuffle; }
+      void set_shuffle(bool v) { m_shuffle = v; }
+
+      /**
+       * Sets the chunk cache used for datasets opened from now on: the
+       * number of hash slots, the total size in bytes and the preemption
+       * policy (0 to 1, see H5Pset_chunk_cache()). Call reset() so already
+       * opened datasets pick up the new settings.
+       */
+      void set_chunk_cache(size_t nslots, size_t nbytes, double w0);
+
+      /**
+       * Dataset access property list to use when opening datasets
+       */
+      const boost::shared_ptr<hid_t> dapl() const { return m_dapl; }
+
     private: //representation
 
       const boost::filesystem::path m_path; ///< path to the file
       unsigned int m_flags; ///< flags used to open it
       boost::shared_ptr<hid_t> m_fcpl; ///< file creation property lists
       boost::shared_ptr<hid_t> m_id; ///< the HDF5 id attributed to this file.
+      boost::shared_ptr<hid_t> m_dapl; ///< dataset access property list
+      size_t m_chunk_bytes; ///< target chunk size for new datasets
+      bool m_shuffle; ///< apply shuffle before compression
       boost::shared_ptr<RootGroup> m_root;
   };
 
@@ -0,0 +1,103 @@
+/**
+ * @file bob/io/ImageLoadOptions.h
+ * @date Sun Oct 19 11:02:13 2026 +0200
+ *
+ * @brief Options of the image decoders, to load images downscaled and/or in
+ * grayscale directly, from files or from in-memory buffers.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IO_IMAGELOADOPTIONS_H
+#define BOB_IO_IMAGELOADOPTIONS_H
+
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include <boost/format.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <bob/io/File.h>
+
+namespace bob { namespace io {
+  /**
+   * @ingroup IO
+   * @{
+   */
+
+  /**
+   * @brief Options applied by the image decoders while loading an image.
+   *
+   * Downscaling is applied during decoding (JPEG images are downscaled in
+   * the DCT domain by libjpeg, which skips most of the decoding work). The
+   * decoded image has ceil(height/d) x ceil(width/d) pixels, where d is the
+   * scale denominator.
+   */
+  struct ImageLoadOptions {
+
+    /**
+     * @brief Constructor
+     * @param scale_denom The scale denominator: 1, 2, 4 or 8
+     * @param gray Decodes color images directly to grayscale (2D) arrays
+     * @param min_size If not 0, the scale denominator is the largest one
+     *   (up to 8) for which the smallest side of the decoded image is still
+     *   at least min_size pixels, and scale_denom is ignored
+     * @param scanlines The number of rows decoded at once
+     */
+    ImageLoadOptions(const size_t scale_denom=1, const bool gray=false,
+        const size_t min_size=0, const size_t scanlines=16):
+      scale_denom(scale_denom), gray(gray), min_size(min_size),
+      scanlines(scanlines)
+    {
+      check();
+    }
+
+    /**
+     * @brief Checks that the options are valid
+     */
+    void check() const {
+      if (scale_denom != 1 && scale_denom != 2 && scale_denom != 4 &&
+          scale_denom != 8) {
+        boost::format m("the scale denominator of the images (%d) should be 1, 2, 4 or 8");
+        m % scale_denom;
+        throw std::runtime_error(m.str());
+      }
+      if (scanlines == 0)
+        throw std::runtime_error("the number of rows decoded at once should be strictly positive");
+    }
+
+    /**
+     * @brief Returns the scale denominator to use for an image of the given
+     * size (at full scale)
+     */
+    size_t denominator(const size_t height, const size_t width) const {
+      if (min_size == 0) return scale_denom;
+      const size_t side = std::min(height, width);
+      size_t denom = 8;
+      while (denom > 1 && (side + denom - 1) / denom < min_size) denom /= 2;
+      return denom;
+    }
+
+    size_t scale_denom; ///< the scale denominator (1, 2, 4 or 8)
+    bool gray; ///< decodes color images to grayscale
+    size_t min_size; ///< minimum size of the smallest side, if not 0
+    size_t scanlines; ///< number of rows decoded at once
+  };
+
+  /**
+   * @brief This defines the factory method of the image decoders which
+   * support loading options. If data is not null, the image is decoded from
+   * the size bytes at data (which are copied) and filename is only used in
+   * messages; otherwise the image is read from the given file, which is
+   * opened once. The returned File is read-only.
+   */
+  typedef boost::shared_ptr<File> (*image_decoder_t)
+    (const std::string& filename, const void* data, size_t size,
+     const ImageLoadOptions& options);
+
+  /**
+   * @}
+   */
+}}
+
+#endif /* BOB_IO_IMAGELOADOPTIONS_H */
@@ -0,0 +1,308 @@
+/**
+ * @file bob/io/MappedTensorFile.h
+ * @date Sat Oct 18 10:12:31 2026 +0200
+ *
+ * @brief Read-only, memory-mapped access to .tensor files
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IO_MAPPEDTENSORFILE_H
+#define BOB_IO_MAPPEDTENSORFILE_H
+
+#include <boost/format.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
+#include <boost/type_traits/alignment_of.hpp>
+
+#include <blitz/array.h>
+#include <bob/core/array.h>
+#include <bob/core/cast.h>
+#include <bob/io/TensorFileHeader.h>
+
+namespace bob { namespace io {
+
+  /**
+   * This class maps a .tensor file in memory and gives random access to the
+   * arrays it contains, without going through intermediate buffers. All
+   * arrays in a tensor file have the same type and shape and are stored one
+   * after the other, so locating any of them is a constant time operation.
+   *
+   * Arrays are stored in column-major order on disk. The view() methods
+   * return blitz::Array<>'s pointing directly to the mapped memory, with
+   * strides set accordingly. These views are read-only and must not outlive
+   * this object.
+   *
+   * The header of tensor files is 28 bytes long, so the arrays of 8-byte
+   * types (int64, float64) are never aligned in the file. They cannot be
+   * viewed in place (view() raises an exception): read() and block_iterator
+   * copy them to aligned buffers instead.
+   */
+  class MappedTensorFile {
+
+    public: //api
+
+      /**
+       * Maps the given file in memory
+       */
+      MappedTensorFile(const std::string& filename);
+
+      /**
+       * Destructor
+       */
+      virtual ~MappedTensorFile();
+
+      /**
+       * The number of arrays in the file
+       */
+      size_t size() const { return m_header.m_n_samples; }
+
+      /**
+       * The type of each array in the file
+       */
+      const bob::core::array::typeinfo& type() const {
+        return m_header.m_type;
+      }
+
+      /**
+       * Pointer to the (column-major) data of the array at the given
+       * position
+       */
+      const void* data(size_t index) const;
+
+      /**
+       * Reads the array at the given position into the given buffer,
+       * converting it to row-major order. The buffer size will be reset if
+       * required.
+       */
+      void read(size_t index, bob::core::array::interface& buffer) const;
+
+      /**
+       * Returns a zero-copy, read-only view over the array at the given
+       * position. The element type and number of dimensions must match the
+       * ones of the file, and the array must be aligned for its element
+       * type in the mapped memory, otherwise an exception is raised.
+       */
+      template <typename T, int N>
+        const blitz::Array<T,N> view(size_t index) const {
+          check<T,N>();
+          const void* ptr = data(index);
+          check_alignment<T>(ptr);
+          blitz::TinyVector<int,N> shape;
+          blitz::TinyVector<int,N> stride;
+          set_layout(shape, stride, 0);
+          return blitz::Array<T,N>(const_cast<T*>(static_cast<const T*>(ptr)),
+              shape, stride, blitz::neverDeleteData);
+        }
+
+      /**
+       * Returns a zero-copy, read-only view over "count" consecutive arrays,
+       * starting at position "start". The first dimension of the returned
+       * array indexes the arrays. For files of 1D arrays, the returned 2D
+       * array is C-style contiguous and can be fed directly to code
+       * expecting a matrix with one sample per row.
+       */
+      template <typename T, int N>
+        const blitz::Array<T,N+1> view(size_t start, size_t count) const {
+          check<T,N>();
+          check_range(start, count);
+          const char* ptr = m_data + m_header.getArrayIndex(start);
+          check_alignment<T>(ptr);
+          return block_view<T,N>(ptr, count);
+        }
+
+      /**
+       * Returns a C-style copy of the array at the given position, cast to
+       * the requested type. Arrays that are not aligned in the mapped memory
+       * are copied to an aligned buffer first.
+       */
+      template <typename T, int N>
+        blitz::Array<T,N> read(size_t index) const {
+          switch (m_header.m_type.dtype) {
+            case bob::core::array::t_int8:
+              return bob::core::array::cast<T>(aligned<int8_t,N>(index));
+            case bob::core::array::t_int16:
+              return bob::core::array::cast<T>(aligned<int16_t,N>(index));
+            case bob::core::array::t_int32:
+              return bob::core::array::cast<T>(aligned<int32_t,N>(index));
+            case bob::core::array::t_int64:
+              return bob::core::array::cast<T>(aligned<int64_t,N>(index));
+            case bob::core::array::t_float32:
+              return bob::core::array::cast<T>(aligned<float,N>(index));
+            case bob::core::array::t_float64:
+              return bob::core::array::cast<T>(aligned<double,N>(index));
+            default:
+              throw std::runtime_error("unsupported tensor element type");
+          }
+        }
+
+    public: //bulk iteration
+
+      /**
+       * Iterates over a tensor file in blocks of consecutive arrays, so a
+       * whole dataset can be streamed from disk without being loaded in
+       * memory. Each block is a zero-copy view over the mapped file when the
+       * arrays are aligned for their element type. Otherwise (int64 and
+       * float64 arrays), the block is copied to a buffer of the iterator,
+       * which is overwritten by the next call to next().
+       *
+       * Usage:
+       *
+       * MappedTensorFile::block_iterator<double,1> it(file, 1000);
+       * blitz::Array<double,2> block;
+       * while (it.next(block)) { ... }
+       */
+      template <typename T, int N> class block_iterator {
+
+        public:
+
+          block_iterator(const MappedTensorFile& file, size_t block_size):
+            m_file(file), m_block_size(block_size), m_position(0) {
+              if (!m_block_size)
+                throw std::runtime_error("block size must be greater than zero");
+            }
+
+          /**
+           * Points "block" to the next block of arrays. The last block may be
+           * smaller than the block size. Returns false when all arrays have
+           * been visited.
+           */
+          bool next(blitz::Array<T,N+1>& block) {
+            if (m_position >= m_file.size()) return false;
+            size_t count = std::min(m_block_size, m_file.size() - m_position);
+            block.reference(m_file.block<T,N>(m_position, count, m_buffer));
+            m_position += count;
+            return true;
+          }
+
+          /**
+           * Position of the next array to be visited
+           */
+          size_t position() const { return m_position; }
+
+          /**
+           * Restarts the iteration from the first array
+           */
+          void reset() { m_position = 0; }
+
+        private:
+
+          const MappedTensorFile& m_file;
+          size_t m_block_size;
+          size_t m_position;
+          blitz::Array<T,1> m_buffer; ///< copies of unaligned blocks
+
+      };
+
+    private: //helpers
+
+      template <typename T, int N> void check() const {
+        const bob::core::array::typeinfo& info = m_header.m_type;
+        if (info.dtype != bob::core::array::getElementType<T>() ||
+            info.nd != N) {
+          boost::format m("cannot view arrays of type `%s' in tensor file `%s' as blitz::Array<%s,%d>");
+          m % info.str() % m_filename % bob::core::array::stringize<T>() % N;
+          throw std::runtime_error(m.str());
+        }
+      }
+
+      void check_range(size_t start, size_t count) const {
+        if (start + count > size()) {
+          boost::format m("cannot view arrays [%d, %d[ of tensor file `%s' that contains %d arrays");
+          m % start % (start + count) % m_filename % size();
+          throw std::runtime_error(m.str());
+        }
+      }
+
+      template <typename T> static bool is_aligned(const void* ptr) {
+        return reinterpret_cast<uintptr_t>(ptr) % boost::alignment_of<T>::value == 0;
+      }
+
+      template <typename T> void check_alignment(const void* ptr) const {
+        if (!is_aligned<T>(ptr)) {
+          boost::format m("cannot view arrays of type `%s' in tensor file `%s' in place, as they are not aligned in the file: use read() instead");
+          m % m_header.m_type.str() % m_filename;
+          throw std::runtime_error(m.str());
+        }
+      }
+
+      /**
+       * Returns a view over the array at the given position if it is
+       * aligned, or a (column-major) copy of it otherwise
+       */
+      template <typename T, int N>
+        blitz::Array<T,N> aligned(size_t index) const {
+          check<T,N>();
+          const void* ptr = data(index);
+          if (is_aligned<T>(ptr)) return view<T,N>(index);
+          blitz::TinyVector<int,N> shape;
+          blitz::TinyVector<int,N> stride;
+          set_layout(shape, stride, 0);
+          blitz::Array<T,N> copy(shape, blitz::ColumnMajorArray<N>());
+          std::memcpy(copy.data(), ptr, m_header.getNElements() * sizeof(T));
+          return copy;
+        }
+
+      /**
+       * Returns a view over "count" consecutive arrays stored at ptr, with
+       * the first dimension indexing the arrays
+       */
+      template <typename T, int N>
+        const blitz::Array<T,N+1> block_view(const void* ptr, size_t count) const {
+          blitz::TinyVector<int,N+1> shape;
+          blitz::TinyVector<int,N+1> stride;
+          shape(0) = count;
+          stride(0) = m_header.getNElements();
+          set_layout(shape, stride, 1);
+          return blitz::Array<T,N+1>(const_cast<T*>(static_cast<const T*>(ptr)),
+              shape, stride, blitz::neverDeleteData);
+        }
+
+      /**
+       * Same as view(start, count), but the arrays are copied into buffer
+       * (which grows if required) if they are not aligned in the mapped
+       * memory
+       */
+      template <typename T, int N>
+        const blitz::Array<T,N+1> block(size_t start, size_t count,
+            blitz::Array<T,1>& buffer) const {
+          check<T,N>();
+          check_range(start, count);
+          const char* ptr = m_data + m_header.getArrayIndex(start);
+          if (is_aligned<T>(ptr)) return block_view<T,N>(ptr, count);
+          const size_t n_elements = count * m_header.getNElements();
+          if ((size_t)buffer.extent(0) < n_elements) buffer.resize(n_elements);
+          std::memcpy(buffer.data(), ptr, n_elements * sizeof(T));
+          return block_view<T,N>(buffer.data(), count);
+        }
+
+      /**
+       * Fills shape and column-major strides from position "offset" on
+       */
+      template <int M>
+        void set_layout(blitz::TinyVector<int,M>& shape,
+            blitz::TinyVector<int,M>& stride, int offset) const {
+          const bob::core::array::typeinfo& info = m_header.m_type;
+          int s = 1;
+          for (size_t k=0; k<info.nd; ++k) {
+            shape(k+offset) = info.shape[k];
+            stride(k+offset) = s;
+            s *= info.shape[k];
+          }
+        }
+
+    private: //representation
+
+      std::string m_filename;
+      detail::TensorFileHeader m_header;
+      boost::iostreams::mapped_file_source m_file;
+      const char* m_data; ///< start of the mapped file
+
+  };
+
+}}
+
+#endif /* BOB_IO_MAPPEDTENSORFILE_H */
@@ -10,6 +10,7 @@
 
 #include <boost/shared_ptr.hpp>
 #include <bob/io/File.h>
+#include <bob/io/ImageLoadOptions.h>
 
 namespace bob { namespace io {
 
@@ -40,6 +41,23 @@ namespace bob { namespace io {
   boost::shared_ptr<File> open (const std::string& filename, char mode, 
       const std::string& pretend_extension);
 
+  /**
+   * Opens an image for reading, with the given loading options (e.g. to
+   * decode it downscaled or in grayscale). The file is opened only once to
+   * find the type of the image and to load it.
+   */
+  boost::shared_ptr<File> open (const std::string& filename,
+      const ImageLoadOptions& options);
+
+  /**
+   * Decodes an image from the given in-memory buffer, with the given loading
+   * options. The extension (e.g. ".jpg") selects the image decoder. The
+   * buffer is copied, and can be released once this function returns.
+   */
+  boost::shared_ptr<File> decode (const void* data, size_t size,
+      const std::string& extension,
+      const ImageLoadOptions& options=ImageLoadOptions());
+
   /**
    * Peeks the file and returns the typeinfo for reading individual frames (or
    * samples) from the file.
@@ -78,6 +96,16 @@ namespace bob { namespace io {
     return open(filename, 'r')->read<T,N>(index);
   }
 
+  /**
+   * Opens an image for reading and loads it with the given loading options
+   *
+   * This method is equivalent to calling open() with the options and then
+   * calling read_all() on the returned bob::io::File object.
+   */
+  template <typename T, int N> blitz::Array<T,N> load (const std::string& filename, const ImageLoadOptions& options) {
+    return open(filename, options)->read_all<T,N>();
+  }
+
   /**
    * Opens for appending and add an array to it
    *
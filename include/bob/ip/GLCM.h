@@ -12,10 +12,15 @@
 #define BOB_IP_GLCM_H
 
 #include <math.h>
+#include <stdint.h>
 #include <iostream>
+#include <vector>
+#include <stdexcept>
 #include <blitz/array.h>
 #include <algorithm>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
 #include "bob/core/assert.h"
 #include "bob/core/array_copy.h"
 #include "bob/core/cast.h"
@@ -74,6 +79,11 @@ namespace bob { namespace ip {
       /**
        * @brief Compute Gray-Level Co-occurences from a 2D blitz::Array, and save the resulting
        * GLCM matrix in the dst 3D blitz::Array.
+       *
+       * The co-occurences are counted with integers, and the rows of the image
+       * are split into stripes that are processed in parallel (see
+       * setNThreads()). Each thread has its own counts for all the offsets,
+       * so that the memory used grows with the number of threads.
        */
       void operator()(const blitz::Array<T,2>& src, blitz::Array<double,3>& glcm) const;
 
@@ -90,6 +100,7 @@ namespace bob { namespace ip {
       const bool getNormalized() const { return m_normalized; }
       const bob::sp::Quantization<T> getQuantization() const { return m_quantization; }
       const blitz::Array<T,1>&  getQuantizationTable() const{ return m_quantization.getThresholds(); }
+      size_t getNThreads() const { return m_n_threads; }
 
 
       /**
@@ -105,6 +116,28 @@ namespace bob { namespace ip {
       void setNormalized(const bool normalized)
       { m_normalized = normalized; }
 
+      /**
+       * @brief Sets the number of threads used to count the co-occurences.
+       * The result does not depend on it.
+       */
+      void setNThreads(const size_t n_threads)
+      {
+        if (n_threads == 0)
+          throw std::runtime_error("the number of threads should be strictly positive");
+        m_n_threads = n_threads;
+      }
+
+    private:
+    /**
+     * @brief Counts the co-occurences of the given stripe of rows, for all the
+     * offsets (given as consecutive (x,y) pairs). The quantized image is
+     * stored contiguously, and the counts of each offset are stored as a
+     * num_levels x num_levels row-major matrix.
+     */
+    static void accumulate(const uint32_t* quant, const int height,
+      const int width, const int num_levels, const std::vector<int>& offsets,
+      uint64_t* counts, const int block, const int n_blocks);
+
     protected:
     /**
      * @brief Attributes
@@ -114,6 +147,7 @@ namespace bob { namespace ip {
     bob::sp::Quantization<T> m_quantization;
     bool m_symmetric;
     bool m_normalized;
+    size_t m_n_threads;
 
    };
 
@@ -125,6 +159,7 @@ bob::ip::GLCM<T>::GLCM()
   m_offset = 1, 0; // this is the default offset
   m_symmetric = false;
   m_normalized = false;
+  m_n_threads = 1;
   m_quantization = bob::sp::Quantization<T>();
 }
 
@@ -135,6 +170,7 @@ bob::ip::GLCM<T>::GLCM(int num_levels)
   m_offset = 1, 0; // this is the default offset
   m_symmetric = false;
   m_normalized = false;
+  m_n_threads = 1;
   m_quantization = bob::sp::Quantization<T>(bob::sp::quantization::UNIFORM, num_levels);
 }
 
@@ -145,6 +181,7 @@ bob::ip::GLCM<T>::GLCM(int num_levels, T min_level, T max_level)
   m_offset = 1, 0; // this is the default offset
   m_symmetric = false;
   m_normalized = false;
+  m_n_threads = 1;
   m_quantization = bob::sp::Quantization<T>(bob::sp::quantization::UNIFORM, num_levels, min_level, max_level);
 }
 
@@ -155,6 +192,7 @@ bob::ip::GLCM<T>::GLCM(const blitz::Array<T,1>& quant_thres)
   m_offset = 1, 0; // this is the default offset
   m_symmetric = false;
   m_normalized = false;
+  m_n_threads = 1;
   m_quantization = bob::sp::Quantization<T>(quant_thres);
 }
 
@@ -165,6 +203,7 @@ bob::ip::GLCM<T>::GLCM(const bob::ip::GLCM<T>& other)
   m_symmetric = other.getSymmetric();
   m_normalized = other.getNormalized();
   m_quantization = other.getQuantization();
+  m_n_threads = other.getNThreads();
 }
 
 template <typename T>
@@ -178,6 +217,7 @@ bob::ip::GLCM<T>& bob::ip::GLCM<T>::operator=(const bob::ip::GLCM<T>& other) {
     m_symmetric = other.getSymmetric();
     m_normalized = other.getNormalized();
     m_quantization = other.getQuantization();
+    m_n_threads = other.getNThreads();
   }
   return *this;
 }
@@ -194,6 +234,34 @@ const blitz::TinyVector<int,3> bob::ip::GLCM<T>::getGLCMShape() const
   return res;
 }
 
+template <typename T>
+void bob::ip::GLCM<T>::accumulate(const uint32_t* quant, const int height,
+  const int width, const int num_levels, const std::vector<int>& offsets,
+  uint64_t* counts, const int block, const int n_blocks)
+{
+  const int num_offsets = offsets.size() / 2;
+  for(int off_ind = 0; off_ind < num_offsets; ++off_ind) // loop over all the possible offsets
+  {
+    const int dx = offsets[2*off_ind], dy = offsets[2*off_ind+1];
+    // the range of pixels for which the pixel at the offset is inside the image
+    const int y_begin = std::max(0, -dy), y_end = std::min(height, height - dy);
+    const int x_begin = std::max(0, -dx), x_end = std::min(width, width - dx);
+    if (y_begin >= y_end || x_begin >= x_end) continue;
+
+    // the stripe of rows of this block
+    const int y_first = y_begin + (int)(((int64_t)(y_end - y_begin) * block) / n_blocks);
+    const int y_last = y_begin + (int)(((int64_t)(y_end - y_begin) * (block+1)) / n_blocks);
+    uint64_t* off_counts = counts + (size_t)off_ind * num_levels * num_levels;
+    for(int y = y_first; y < y_last; ++y)
+    {
+      const uint32_t* row = quant + (size_t)y * width;
+      const uint32_t* row1 = quant + (size_t)(y + dy) * width + dx;
+      for(int x = x_begin; x < x_end; ++x)
+        ++off_counts[row[x] * num_levels + row1[x]];
+    }
+  }
+}
+
 template <typename T>
 void bob::ip::GLCM<T>::operator()(const blitz::Array<T,2>& src, blitz::Array<double,3>& glcm) const
 {
@@ -201,50 +269,59 @@ void bob::ip::GLCM<T>::operator()(const blitz::Array<T,2>& src, blitz::Array<dou
   blitz::TinyVector<int,3> shape(getGLCMShape());
   bob::core::array::assertSameShape(glcm, shape);
 
-  glcm=0;
+  const int num_levels = shape(0);
+  const int num_offsets = shape(2);
+  const int height = src.extent(0), width = src.extent(1);
 
-  blitz::Array<uint32_t,2> src_quant = m_quantization(src);
+  // the quantized image is contiguous, so that the threads only read raw memory
+  const blitz::Array<uint32_t,2> src_quant = m_quantization(src);
+  std::vector<int> offsets(2*num_offsets);
+  for(int off_ind = 0; off_ind < num_offsets; ++off_ind)
+  {
+    offsets[2*off_ind] = m_offset(off_ind, 0);
+    offsets[2*off_ind+1] = m_offset(off_ind, 1);
+  }
 
-  for(int off_ind = 0; off_ind < m_offset.extent(0); ++off_ind) // loop over all the possible offsets
+  // count the co-occurences in stripes of rows, each with its own counts
+  const size_t size = (size_t)num_levels * num_levels * num_offsets;
+  const int n_blocks = std::max(1, std::min((int)m_n_threads, height));
+  std::vector<std::vector<uint64_t> > counts(n_blocks, std::vector<uint64_t>(size, 0));
+  boost::thread_group threads;
+  for (int t = 1; t < n_blocks; ++t)
+    threads.create_thread(boost::bind(&bob::ip::GLCM<T>::accumulate,
+      src_quant.data(), height, width, num_levels, boost::cref(offsets),
+      &counts[t][0], t, n_blocks));
+  accumulate(src_quant.data(), height, width, num_levels, offsets,
+    &counts[0][0], 0, n_blocks);
+  threads.join_all();
+
+  std::vector<uint64_t>& total = counts[0];
+  for (int t = 1; t < n_blocks; ++t)
+    for (size_t k = 0; k < size; ++k)
+      total[k] += counts[t][k];
+
+  for(int off_ind = 0; off_ind < num_offsets; ++off_ind)
   {
-      // loop over each pixel of the image
-      for(int y = 0; y < src_quant.extent(0); ++y)
+    const uint64_t* off_counts = &total[(size_t)off_ind * num_levels * num_levels];
+
+    // the number of co-occurences of this offset, counted twice when symmetric
+    uint64_t n = 0;
+    for (int k = 0; k < num_levels * num_levels; ++k)
+      n += off_counts[k];
+    if(m_symmetric) n *= 2;
+
+    for(int i = 0; i < num_levels; ++i)
+    {
+      for(int j = 0; j < num_levels; ++j)
       {
-        for(int x = 0; x < src_quant.extent(1); ++x)
-        {
-          int i_level = (int)(src_quant(y,x)); // the grey level of the current pixel
-          const int y1 = y + m_offset(off_ind, 1);
-          const int x1 = x + m_offset(off_ind, 0);
-
-          if(y1 >= 0 && y1 < src_quant.extent(0) && x1 >= 0 && x1 < src_quant.extent(1))
-          {
-            int j_level = (int)(src_quant(y1, x1));
-            glcm(i_level, j_level, off_ind) += 1;
-
-          }
-        }
+        // make the matrix symmetric
+        uint64_t c = off_counts[i * num_levels + j];
+        if(m_symmetric) c += off_counts[j * num_levels + i];
+        // normalize the output image
+        glcm(i, j, off_ind) = (m_normalized ? (double)c / (double)n : (double)c);
       }
-
     }
-
-  if(m_symmetric) // make the matrix symmetric
-  {
-    blitz::Array<double,3> temp = glcm.copy();
-    temp.transposeSelf(1,0,2);
-    glcm += temp;
-  }
-
-  if (m_normalized) // normalize the output image
-  {
-    blitz::firstIndex i;
-    blitz::secondIndex j;
-    blitz::thirdIndex k;
-    blitz::Array<double, 2> summations_temp(blitz::sum(glcm(i, k, j), k));
-    blitz::Array<double, 1> summations(blitz::sum(summations_temp(j,i), j));
-    glcm /= summations(k);
-    //std::cout << "glcm after normalization: " << glcm(blitz::Range(0,1),blitz::Range(0,1),blitz::Range(0,1)) << std::endl;
   }
-
 }
 
 }}
@@ -12,6 +12,7 @@
 #define BOB_IP_GLCMPROP_H
 
 #include <blitz/array.h>
+#include <vector>
 #include <algorithm>
 #include <boost/shared_ptr.hpp>
 #include "bob/core/assert.h"
@@ -35,6 +36,37 @@ namespace bob { namespace ip {
 
     public: //api
 
+      /**
+       * @brief The texture properties, which can be computed together by properties()
+       */
+      typedef enum {
+        ANGULAR_SECOND_MOMENT = 0,
+        ENERGY,
+        VARIANCE,
+        CONTRAST,
+        AUTO_CORRELATION,
+        CORRELATION,
+        CORRELATION_M,
+        INV_DIFF_MOM,
+        SUM_AVG,
+        SUM_VAR,
+        SUM_ENTROPY,
+        ENTROPY,
+        DIFF_VAR,
+        DIFF_ENTROPY,
+        DISSIMILARITY,
+        HOMOGENEITY,
+        CLUSTER_PROM,
+        CLUSTER_SHADE,
+        MAX_PROB,
+        INF_MEAS_CORR1,
+        INF_MEAS_CORR2,
+        INV_DIFF,
+        INV_DIFF_NORM,
+        INV_DIFF_MOM_NORM
+      }
+      Property;
+
       /**
        * @brief Complete constructor
        */
@@ -117,6 +149,16 @@ namespace bob { namespace ip {
       void inv_diff_norm(const blitz::Array<double,3>& glcm, blitz::Array<double,1>& prop) const;
       void inv_diff_mom_norm(const blitz::Array<double,3>& glcm, blitz::Array<double,1>& prop) const;
 
+      /**
+       * @brief Computes several properties of the GLCM at once, with a single
+       * pass over the matrix of each offset: the normalized matrix, its
+       * marginals and the distributions of i+j and |i-j| are computed once,
+       * and all the requested properties are derived from them. The row p of
+       * the output contains the property props[p] (same values as the
+       * functions above, up to rounding errors) for each offset.
+       */
+      void properties(const blitz::Array<double,3>& glcm, const std::vector<Property>& props, blitz::Array<double,2>& values) const;
+
     protected:
     /**
      * @brief Methods
@@ -12,10 +12,12 @@
 #ifndef BOB_IP_GABOR_WAVELET_TRANSFORM_H
 #define BOB_IP_GABOR_WAVELET_TRANSFORM_H
 
+#include <map>
 #include <vector>
 #include <utility>
 #include <stdexcept>
 #include <blitz/array.h>
+#include <boost/shared_ptr.hpp>
 
 #include "bob/io/HDF5File.h"
 #include "bob/sp/FFT2D.h"
@@ -58,8 +60,20 @@ namespace bob {
           blitz::Array<std::complex<double>,2>& transformed_frequency_domain_image
         ) const;
 
+        //! \brief Computes the responses of the Gabor wavelet at some positions of the image only,
+        //! directly from the frequency domain image, i.e., without inverse FFT.
+        //! The phase factors of the positions (y_n,x_n) are given as
+        //! phase_y(n,u) = exp(2i*pi*u*y_n/height) and phase_x(n,v) = exp(2i*pi*v*x_n/width)
+        void transform(
+          const blitz::Array<std::complex<double>,2>& frequency_domain_image,
+          const blitz::Array<std::complex<double>,2>& phase_y,
+          const blitz::Array<std::complex<double>,2>& phase_x,
+          blitz::Array<std::complex<double>,1>& responses
+        ) const;
+
       private:
-        // the Gabor wavelet, stored as pairs of indices and values
+        // the Gabor wavelet, stored as pairs of indices and values (the wavelet is band-limited,
+        // so that only the pixels above epsilon are stored), ordered by row
         std::vector<std::pair<blitz::TinyVector<unsigned,2>, double> > m_kernel_pixel;
 
         unsigned m_x_resolution, m_y_resolution;
@@ -102,7 +116,9 @@ namespace bob {
         //! Non-equality operator
         bool operator!=(const GaborWaveletTransform& other) const;
 
-        //! generate the kernels for the new resolution
+        //! \brief generate the kernels for the new resolution
+        //! The kernels of the previous resolutions are kept in a cache, and reused when images of
+        //! these resolutions are transformed again
         void generateKernels(blitz::TinyVector<unsigned,2> resolution);
 
         //! Returns the Gabor kernel for the given index
@@ -119,6 +135,11 @@ namespace bob {
         //! Returns the vector of central frequencies used by this Gabor wavelet family
         const std::vector<blitz::TinyVector<double,2> >& kernelFrequencies() const {return m_kernel_frequencies;}
 
+        //! The number of threads used to compute the responses of the kernels.
+        //! Each thread processes a contiguous block of kernels, and the results do not depend on this setting
+        size_t getNThreads() const {return m_n_threads;}
+        void setNThreads(size_t n_threads);
+
         double sigma() const {return m_sigma;}
         double k_max() const {return m_k_max;}
         double k_fac() const {return m_k_fac;}
@@ -147,6 +168,26 @@ namespace bob {
           bool do_normalize = true
         );
 
+        //! \brief performs Gabor wavelet transform at the given positions (y,x) only, e.g., the nodes
+        //! of a graph, and creates one Gabor jet (absolute part and phase part) per position.
+        //! The responses are computed from the frequency domain image directly, which is faster than
+        //! computeJetImage() when the number of positions is small compared to the image size
+        void computeJets(
+          const blitz::Array<std::complex<double>,2>& gray_image,
+          const blitz::Array<int,2>& positions,
+          blitz::Array<double,3>& jets,
+          bool do_normalize = true
+        );
+
+        //! \brief performs Gabor wavelet transform at the given positions (y,x) only, and creates one
+        //! Gabor jet (absolute parts of the responses only) per position
+        void computeJets(
+          const blitz::Array<std::complex<double>,2>& gray_image,
+          const blitz::Array<int,2>& positions,
+          blitz::Array<double,2>& jets,
+          bool do_normalize = true
+        );
+
         //! \brief saves the parameters of this Gabor wavelet family to file
         void save(bob::io::HDF5File& file) const;
 
@@ -157,6 +198,42 @@ namespace bob {
 
         void computeKernelFrequencies();
 
+        //! resizes the working arrays of the threads to the current resolution
+        void resizeThreadBuffers();
+
+        //! \brief computes the responses of the kernels [begin,end[ in the given thread, and writes
+        //! them to the output (the one that is not NULL) in the layout expected by this output
+        void transformKernels(
+          unsigned thread, int begin, int end,
+          blitz::Array<std::complex<double>,3>* trafo_image,
+          blitz::Array<double,4>* jet_image,
+          blitz::Array<double,3>* abs_jet_image
+        );
+
+        //! \brief computes the responses of the kernels [begin,end[ at the given positions only
+        void transformKernelsAt(
+          int begin, int end,
+          const blitz::Array<std::complex<double>,2>& phase_y,
+          const blitz::Array<std::complex<double>,2>& phase_x,
+          blitz::Array<double,3>* jets,
+          blitz::Array<double,2>* abs_jets
+        );
+
+        //! \brief computes the responses at the given positions, and stores them in one of the outputs
+        void computeJetsAt(
+          const blitz::Array<std::complex<double>,2>& gray_image,
+          const blitz::Array<int,2>& positions,
+          blitz::Array<double,3>* jets,
+          blitz::Array<double,2>* abs_jets
+        );
+
+        //! splits the kernels into blocks, and runs transformKernels() on them in parallel
+        void runThreads(
+          blitz::Array<std::complex<double>,3>* trafo_image,
+          blitz::Array<double,4>* jet_image,
+          blitz::Array<double,3>* abs_jet_image
+        );
+
         double m_sigma;
         double m_pow_of_k;
         double m_k_max;
@@ -164,6 +241,9 @@ namespace bob {
         bool m_dc_free;
         std::vector<GaborKernel> m_gabor_kernels;
 
+        //! The kernels of the previous resolutions (height, width)
+        std::map<std::pair<unsigned,unsigned>, std::vector<GaborKernel> > m_kernel_cache;
+
         std::vector<blitz::TinyVector<double,2> > m_kernel_frequencies;
 
         bob::sp::FFT2D m_fft;
@@ -171,6 +251,11 @@ namespace bob {
 
         blitz::Array<std::complex<double>,2> m_temp_array, m_temp_array2, m_frequency_image;
 
+        //! The number of threads, and the working arrays of the threads other than the first one
+        size_t m_n_threads;
+        std::vector<boost::shared_ptr<bob::sp::IFFT2D> > m_thread_ifft;
+        std::vector<blitz::Array<std::complex<double>,2> > m_thread_temp_array, m_thread_temp_array2;
+
         //! The number of scales (levels, frequencies) of this family
         unsigned m_number_of_scales;
         //! The number of directions (orientations) of this family
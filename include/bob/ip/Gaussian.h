@@ -15,6 +15,7 @@
 #include "bob/core/cast.h"
 #include "bob/sp/conv.h"
 #include "bob/sp/extrapolate.h"
+#include "bob/sp/convsep.h"
 
 namespace bob {
 
@@ -151,8 +152,6 @@ namespace bob {
         blitz::Array<double, 1> m_kernel_x;
 
         blitz::Array<double, 2> m_tmp_int;
-        blitz::Array<double, 2> m_tmp_int1;
-        blitz::Array<double, 2> m_tmp_int2;
     };
 
     // Declare template method full specialization
@@ -11,9 +11,16 @@
 
 #include <blitz/array.h>
 #include <bob/ip/Gaussian.h>
+#include <bob/sp/convsep.h>
 #include <bob/core/assert.h>
+#include <bob/core/cast.h>
+#include <bob/core/array_utils.h>
 
 #include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 namespace bob {
@@ -153,6 +160,7 @@ class GaussianScaleSpace
     { return m_conv_border; }
     boost::shared_ptr<bob::ip::Gaussian> getGaussian(const size_t i) const 
     { return m_gaussians[i]; }
+    size_t getNThreads() const { return m_n_threads; }
 
     /**
      * @brief Setters
@@ -175,6 +183,12 @@ class GaussianScaleSpace
     { m_kernel_radius_factor = kernel_radius_factor; resetGaussians(); }
     void setConvBorder(const bob::sp::Extrapolation::BorderType border_type)
     { m_conv_border = border_type; resetGaussians(); }
+    /**
+     * @brief Sets the number of threads used to filter the images. Each
+     * convolution pass is split into slabs of rows (or columns) processed
+     * concurrently, and the output does not depend on this setting.
+     */
+    void setNThreads(const size_t n_threads);
 
     /**
      * Automatically sets sigma0 to a value such that there is no smoothing
@@ -186,13 +200,47 @@ class GaussianScaleSpace
 
     /**
      * @brief Process a 2D blitz Array/Image by extracting a Gaussian Pyramid.
+     *   Each scale is obtained by smoothing the previous one with the
+     *   differential sigma between both scales.
      * @param src The 2D input blitz array
      * @param dst A vector of 3D blitz Arrays. Each octave is described by
      *   one element of the vector. The bliz Arrays should have the 
      *   expected size.
      */
     template <typename T> 
-    void operator()(const blitz::Array<T,2>& src, std::vector<blitz::Array<double,3> >& dst) const;
+    void operator()(const blitz::Array<T,2>& src, std::vector<blitz::Array<double,3> >& dst) const
+    { process(src, dst, 0, 0, 0); }
+
+    /**
+     * @brief Process a 2D blitz Array/Image by extracting a Gaussian Pyramid
+     *   in single precision. This halves the memory traffic of the
+     *   convolutions, at the cost of a lower accuracy.
+     */
+    template <typename T> 
+    void operator()(const blitz::Array<T,2>& src, std::vector<blitz::Array<float,3> >& dst) const
+    { process(src, dst, 0, 0, 0); }
+
+    /**
+     * @brief Process a 2D blitz Array/Image by extracting a Gaussian Pyramid,
+     *   as well as the Difference of Gaussians (DoG) and the gradients of the
+     *   scales 1 to n_intervals of each octave. They are computed as soon as
+     *   a scale has been filtered, while it is still in cache, instead of in
+     *   separate passes over the whole pyramid.
+     * @param src The 2D input blitz array
+     * @param gss The Gaussian pyramid (n_intervals+3 scales per octave)
+     * @param dog The DoG pyramid (n_intervals+2 scales per octave), scale s
+     *   being equal to gss[s+1]-gss[s]
+     * @param grad_mag The magnitude of the gradients (n_intervals scales per
+     *   octave), scale s being the gradient of gss[s+1]
+     * @param grad_ori The orientation of the gradients (n_intervals scales
+     *   per octave), scale s being the gradient of gss[s+1]
+     */
+    template <typename T, typename U> 
+    void operator()(const blitz::Array<T,2>& src, 
+      std::vector<blitz::Array<U,3> >& gss, std::vector<blitz::Array<U,3> >& dog,
+      std::vector<blitz::Array<U,3> >& grad_mag,
+      std::vector<blitz::Array<U,3> >& grad_ori) const
+    { process(src, gss, &dog, &grad_mag, &grad_ori); }
 
     /**
      * @brief Allocate output vector of blitz Arrays.
@@ -200,6 +248,7 @@ class GaussianScaleSpace
      *   New blitz Arrays of suitable sizes will be allocated and will populate the vector.
      */
     void allocateOutputPyramid(std::vector<blitz::Array<double,3> >& dst) const;
+    void allocateOutputPyramid(std::vector<blitz::Array<float,3> >& dst) const;
 
     /**
      * @brief Returns the output shape for a given octave. 
@@ -228,14 +277,41 @@ class GaussianScaleSpace
 
     std::vector<boost::shared_ptr<bob::ip::Gaussian> > m_gaussians;
     bool m_smooth_at_init;
+    size_t m_n_threads;
 
     /**
-     * Working arrays/variables in cache
+     * Working arrays/variables in cache. They hold the output of the
+     * vertical pass of the convolutions, and are only reallocated when the
+     * image size changes.
      */
-    mutable blitz::Array<double,2> m_cache_array0;
-    void resetCache() const;
+    mutable blitz::Array<double,2> m_cache_tmp;
+    mutable blitz::Array<float,2> m_cache_tmp_f;
+    blitz::Array<double,2>& cacheTmp(double) const { return m_cache_tmp; }
+    blitz::Array<float,2>& cacheTmp(float) const { return m_cache_tmp_f; }
     void resetGaussians();
 
+    /**
+     * Computes the pyramid, and optionally the DoG and gradient pyramids
+     */
+    template <typename T, typename U> 
+    void process(const blitz::Array<T,2>& src, 
+      std::vector<blitz::Array<U,3> >& gss, std::vector<blitz::Array<U,3> >* dog,
+      std::vector<blitz::Array<U,3> >* grad_mag,
+      std::vector<blitz::Array<U,3> >* grad_ori) const;
+
+    /**
+     * Separable Gaussian filtering of src into dst, using tmp as the
+     * output of the vertical pass
+     */
+    template <typename U>
+    void blur(const blitz::Array<U,2>& src, blitz::Array<U,2>& dst,
+      const size_t i, blitz::Array<U,2>& tmp) const;
+
+    /**
+     * Number of slabs a pass over n rows (or columns) is split into
+     */
+    int nBlocks(const int n) const;
+
     /**
      * Checks that minimum octave index is in the range [-1,+infty], and
      * throws an exception otherwise.
@@ -246,8 +322,8 @@ class GaussianScaleSpace
 
 namespace detail 
 {
-  template <typename T>
-  void upsample(const blitz::Array<T,2>& src, blitz::Array<double,2>& dst)
+  template <typename T, typename U>
+  void upsample(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst)
   {
     // Check dimensions
     bob::core::array::assertSameDimensionLength(src.extent(0)*2, dst.extent(0));
@@ -267,15 +343,15 @@ namespace detail
     blitz::Range rall = blitz::Range::all();
 
     // Non interpolated values
-    blitz::Array<double,2> dst1 = dst(rdst_y0, rdst_x0);
+    blitz::Array<U,2> dst1 = dst(rdst_y0, rdst_x0);
     dst1 = src;
 
     // Interpolated values
-    blitz::Array<double,2> dst2 = dst(rdst_y0, rdst_x1m);
+    blitz::Array<U,2> dst2 = dst(rdst_y0, rdst_x1m);
     dst2 = 0.5 * (src(rall, rsrc_x0) + src(rall, rsrc_x1));
-    blitz::Array<double,2> dst3 = dst(rdst_y1m, rdst_x0);
+    blitz::Array<U,2> dst3 = dst(rdst_y1m, rdst_x0);
     dst3 = 0.5 * (src(rsrc_y0, rall) + src(rsrc_y1, rall));
-    blitz::Array<double,2> dst4 = dst(rdst_y1m, rdst_x1m);
+    blitz::Array<U,2> dst4 = dst(rdst_y1m, rdst_x1m);
     dst4 = 0.5 * (dst3(rall, rsrc_x0) + dst3(rall, rsrc_x1)); // = 0.5 * (dst2(rsrc_y0, rall) + dst2(rsrc_y1, rall))
 
     // Right and bottom borders
@@ -283,8 +359,8 @@ namespace detail
     dst(dst.extent(0)-1, rall) = dst(dst.extent(0)-2, rall);
   }
 
-  template <typename T>
-  void downsample(const blitz::Array<T,2>& src, blitz::Array<double,2>& dst, 
+  template <typename T, typename U>
+  void downsample(const blitz::Array<T,2>& src, blitz::Array<U,2>& dst, 
     const size_t d)
   {
     // Checks dimensions
@@ -301,55 +377,230 @@ namespace detail
     // Updates dst values
     dst = src(rsrc_y, rsrc_x);
   }
+
+  /**
+   * One pass of a separable convolution on the slab [begin,end[ of columns
+   * (dim=0) or rows (dim=1) of the image. This is run by several threads at
+   * once, which only work on private views of the shared arrays.
+   */
+  template <typename U>
+  void convSepSlab(const blitz::Array<U,2>& src, const blitz::Array<U,1>& kernel,
+    blitz::Array<U,2>& dst, const size_t dim,
+    const bob::sp::Extrapolation::BorderType border_type,
+    const int begin, const int end)
+  {
+    const blitz::Array<U,2> src_v(bob::core::array::private_view(src));
+    const blitz::Array<U,1> kernel_v(bob::core::array::private_view(kernel));
+    blitz::Array<U,2> dst_v(bob::core::array::private_view(dst));
+    const blitz::Range rall = blitz::Range::all();
+    const blitz::Range r(begin, end-1);
+    const blitz::Array<U,2> src_s(dim == 0 ? src_v(rall,r) : src_v(r,rall));
+    blitz::Array<U,2> dst_s(dim == 0 ? dst_v(rall,r) : dst_v(r,rall));
+    bob::sp::convSepBorder(src_s, kernel_v, dst_s, dim, border_type);
+  }
+
+  /**
+   * Computes the DoG cur-prev, and the gradient of cur (magnitude and
+   * orientation), for the rows [begin,end[. The gradient is computed as
+   * bob::math::gradient() does (central differences in the interior, and
+   * first differences on the borders). Empty outputs are skipped.
+   */
+  template <typename U>
+  void dogGradientRows(const blitz::Array<U,2>& prev_s,
+    const blitz::Array<U,2>& cur_s, blitz::Array<U,2>& dog_s,
+    blitz::Array<U,2>& mag_s, blitz::Array<U,2>& ori_s,
+    const int begin, const int end)
+  {
+    // Private views of the arrays shared with the other threads
+    const blitz::Array<U,2> prev(bob::core::array::private_view(prev_s));
+    const blitz::Array<U,2> cur(bob::core::array::private_view(cur_s));
+    blitz::Array<U,2> dog, mag, ori;
+    if (dog_s.size()) dog.reference(bob::core::array::private_view(dog_s));
+    if (mag_s.size()) mag.reference(bob::core::array::private_view(mag_s));
+    if (ori_s.size()) ori.reference(bob::core::array::private_view(ori_s));
+
+    const int H = cur.extent(0);
+    const int W = cur.extent(1);
+    for (int y=begin; y<end; ++y)
+    {
+      if (dog.size())
+        for (int x=0; x<W; ++x)
+          dog(y,x) = cur(y,x) - prev(y,x);
+      if (!mag.size()) continue;
+
+      const int yp = std::min(y+1, H-1);
+      const int ym = std::max(y-1, 0);
+      const U dy = (y == 0 || y == H-1 ? 1 : 2);
+      for (int x=0; x<W; ++x)
+      {
+        const int xp = std::min(x+1, W-1);
+        const int xm = std::max(x-1, 0);
+        const U dx = (x == 0 || x == W-1 ? 1 : 2);
+        const U gy = (cur(yp,x) - cur(ym,x)) / dy;
+        const U gx = (cur(y,xp) - cur(y,xm)) / dx;
+        mag(y,x) = std::sqrt(gy*gy + gx*gx);
+        ori(y,x) = std::atan2(gy, gx);
+      }
+    }
+  }
 }
 
 
-template <typename T>
-void bob::ip::GaussianScaleSpace::operator()(const blitz::Array<T,2>& src, 
-  std::vector<blitz::Array<double,3> >& dst) const
+template <typename U>
+void bob::ip::GaussianScaleSpace::blur(const blitz::Array<U,2>& src, 
+  blitz::Array<U,2>& dst, const size_t i, blitz::Array<U,2>& tmp) const
+{
+  // Same filtering as bob::ip::Gaussian, with kernels in the output type
+  const bob::ip::Gaussian& g = *m_gaussians[i];
+  const blitz::Array<U,1> kernel_y = bob::core::array::cast<U>(g.getKernelY());
+  const blitz::Array<U,1> kernel_x = bob::core::array::cast<U>(g.getKernelX());
+  const bob::sp::Extrapolation::BorderType border_type =
+    (g.getConvBorder() == bob::sp::Extrapolation::Constant ?
+      bob::sp::Extrapolation::Mirror : g.getConvBorder());
+
+  const int H = src.extent(0);
+  const int W = src.extent(1);
+
+  // Vertical pass, split into slabs of columns
+  int n_blocks = nBlocks(W);
+  if (n_blocks == 1)
+    bob::sp::convSepBorder(src, kernel_y, tmp, 0, border_type);
+  else
+  {
+    boost::thread_group threads;
+    for (int t=0; t<n_blocks; ++t)
+    {
+      const int begin = (int)(((int64_t)W*t)/n_blocks);
+      const int end = (int)(((int64_t)W*(t+1))/n_blocks);
+      threads.create_thread(boost::bind(&detail::convSepSlab<U>,
+        boost::cref(src), boost::cref(kernel_y), boost::ref(tmp), 0,
+        border_type, begin, end));
+    }
+    threads.join_all();
+  }
+
+  // Horizontal pass, split into slabs of rows
+  n_blocks = nBlocks(H);
+  if (n_blocks == 1)
+    bob::sp::convSepBorder(tmp, kernel_x, dst, 1, border_type);
+  else
+  {
+    boost::thread_group threads;
+    for (int t=0; t<n_blocks; ++t)
+    {
+      const int begin = (int)(((int64_t)H*t)/n_blocks);
+      const int end = (int)(((int64_t)H*(t+1))/n_blocks);
+      threads.create_thread(boost::bind(&detail::convSepSlab<U>,
+        boost::cref(tmp), boost::cref(kernel_x), boost::ref(dst), 1,
+        border_type, begin, end));
+    }
+    threads.join_all();
+  }
+}
+
+template <typename T, typename U>
+void bob::ip::GaussianScaleSpace::process(const blitz::Array<T,2>& src, 
+  std::vector<blitz::Array<U,3> >& dst, std::vector<blitz::Array<U,3> >* dog,
+  std::vector<blitz::Array<U,3> >* grad_mag,
+  std::vector<blitz::Array<U,3> >* grad_ori) const
 {
   // Checks
   bob::core::array::assertZeroBase(src);
   bob::core::array::assertSameDimensionLength(src.extent(0),m_height);
   bob::core::array::assertSameDimensionLength(src.extent(1),m_width);
-  for (size_t i=0; i<dst.size(); ++i)
-    bob::core::array::assertZeroBase(dst[i]);
-
+  bob::core::array::assertSameDimensionLength(dst.size(),m_n_octaves);
   for (size_t i=0; i<dst.size(); ++i)
   {
+    bob::core::array::assertZeroBase(dst[i]);
     const blitz::TinyVector<int,3> shape = getOutputShape(m_octave_min+i);
     bob::core::array::assertSameShape(dst[i], shape);
+    if (dog)
+    {
+      bob::core::array::assertSameDimensionLength((*dog).size(),m_n_octaves);
+      bob::core::array::assertZeroBase((*dog)[i]);
+      bob::core::array::assertSameShape((*dog)[i],
+        blitz::shape(shape(0)-1, shape(1), shape(2)));
+    }
+    if (grad_mag && grad_ori)
+    {
+      bob::core::array::assertSameDimensionLength((*grad_mag).size(),m_n_octaves);
+      bob::core::array::assertSameDimensionLength((*grad_ori).size(),m_n_octaves);
+      bob::core::array::assertZeroBase((*grad_mag)[i]);
+      bob::core::array::assertZeroBase((*grad_ori)[i]);
+      const blitz::TinyVector<int,3> gshape(shape(0)-3, shape(1), shape(2));
+      bob::core::array::assertSameShape((*grad_mag)[i], gshape);
+      bob::core::array::assertSameShape((*grad_ori)[i], gshape);
+    }
   }
 
-  if (m_octave_min < 0)
-    bob::ip::detail::upsample(src, m_cache_array0);
-  else if (m_octave_min > 0)
-    bob::ip::detail::downsample(src, m_cache_array0, m_octave_min);
-  else // 0
-    m_cache_array0 = src;
+  // The temporary array is only reallocated when the image size changes,
+  // and smaller octaves use a part of it
+  const blitz::TinyVector<int,3> shape0 = getOutputShape(m_octave_min);
+  blitz::Array<U,2>& tmp_full = cacheTmp(U());
+  if (tmp_full.extent(0) != shape0(1) || tmp_full.extent(1) != shape0(2))
+    tmp_full.resize(shape0(1), shape0(2));
 
   blitz::Range rall = blitz::Range::all();
+  const blitz::Array<U,2> empty;
   // Iterates over the scales
   for (size_t o=0; o<m_n_octaves; ++o)
   {
-    blitz::Array<double,2> dst_m1 = dst[o](0, rall, rall);
+    const int H = dst[o].extent(1);
+    const int W = dst[o].extent(2);
+    blitz::Array<U,2> tmp = tmp_full(blitz::Range(0,H-1), blitz::Range(0,W-1));
+    blitz::Array<U,2> dst_m1 = dst[o](0, rall, rall);
     if (o==0) {
+      // The resampled image is stored in the next scale when it has to be
+      // smoothed, as this scale is overwritten afterwards
+      blitz::Array<U,2> base = (m_smooth_at_init ? dst[o](1, rall, rall) : dst_m1);
+      if (m_octave_min < 0)
+        bob::ip::detail::upsample(src, base);
+      else if (m_octave_min > 0)
+        bob::ip::detail::downsample(src, base, m_octave_min);
+      else // 0
+        base = src;
       if (m_smooth_at_init)
-        m_gaussians[0]->operator()(m_cache_array0, dst_m1);
-      else
-        dst_m1 = m_cache_array0;
+        blur(base, dst_m1, 0, tmp);
     }
     else {
       // Copy from previous octave and downsample
-      blitz::Array<double,2> dst_prev = dst[o-1]((int)m_n_intervals, rall, rall);
+      blitz::Array<U,2> dst_prev = dst[o-1]((int)m_n_intervals, rall, rall);
       bob::ip::detail::downsample(dst_prev, dst_m1, 1);
     }
 
     for (size_t s=1; s<m_n_intervals+3; ++s)
     {
-      blitz::Array<double,2> dst_prev = dst[o](s-1, rall, rall);
-      blitz::Array<double,2> dst_cur = dst[o](s, rall, rall);
-      m_gaussians[s]->operator()(dst_prev, dst_cur);
+      blitz::Array<U,2> dst_prev = dst[o](s-1, rall, rall);
+      blitz::Array<U,2> dst_cur = dst[o](s, rall, rall);
+      blur(dst_prev, dst_cur, s, tmp);
+
+      // DoG and gradients of this scale, while it is still in cache
+      const bool with_grad = grad_mag && grad_ori && s <= m_n_intervals;
+      if (!dog && !with_grad) continue;
+      if (with_grad && (H < 2 || W < 2)) {
+        boost::format m("cannot compute the gradient of a %dx%d image");
+        m % H % W;
+        throw std::runtime_error(m.str());
+      }
+      blitz::Array<U,2> dog_s = dog ? (*dog)[o](s-1, rall, rall) : empty;
+      blitz::Array<U,2> mag_s = with_grad ? (*grad_mag)[o](s-1, rall, rall) : empty;
+      blitz::Array<U,2> ori_s = with_grad ? (*grad_ori)[o](s-1, rall, rall) : empty;
+      const int n_blocks = nBlocks(H);
+      if (n_blocks == 1)
+        detail::dogGradientRows(dst_prev, dst_cur, dog_s, mag_s, ori_s, 0, H);
+      else
+      {
+        boost::thread_group threads;
+        for (int t=0; t<n_blocks; ++t)
+        {
+          const int begin = (int)(((int64_t)H*t)/n_blocks);
+          const int end = (int)(((int64_t)H*(t+1))/n_blocks);
+          threads.create_thread(boost::bind(&detail::dogGradientRows<U>,
+            boost::cref(dst_prev), boost::cref(dst_cur), boost::ref(dog_s),
+            boost::ref(mag_s), boost::ref(ori_s), begin, end));
+        }
+        threads.join_all();
+      }
     }
   }
 }
@@ -0,0 +1,398 @@
+/**
+ * @file bob/ip/IntegralHOG.h
+ * @date Sun Oct 18 20:05:12 2026 +0200
+ *
+ * @brief Computes Histogram of Oriented Gradients (HOG) descriptors of many
+ *   windows of the same image, using integral histograms
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_INTEGRAL_HOG_H
+#define BOB_IP_INTEGRAL_HOG_H
+
+#include <cmath>
+#include <stdexcept>
+#include <boost/format.hpp>
+#include "bob/core/assert.h"
+#include "bob/core/array_copy.h"
+#include "bob/ip/BlockCellDescriptors.h"
+#include "bob/ip/BlockCellGradientDescriptors.h"
+
+namespace bob {
+/**
+ * \ingroup libip_api
+ * @{
+ */
+  namespace ip {
+
+    /**
+      * @brief Class to extract Histogram of Gradients (HOG) descriptors from
+      * many (possibly overlapping) windows of the same image, such as when
+      * scanning an image with a detector.
+      *
+      * The gradients of the full image are computed once, and each
+      * pixel is soft-assigned to the two closest orientation bins, exactly
+      * as hogComputeHistogram_() does. One integral image is then built per
+      * orientation bin, so that the histogram of any rectangular cell is
+      * obtained with four lookups, whatever its size. Extracting the
+      * descriptor of a window therefore only costs the block normalization,
+      * and does not depend on the window size.
+      *
+      * The cell and block layout of a window (of size height x width) is
+      * the same as for the HOG class. When the input image has the size of
+      * a window, forward() gives the same descriptors as HOG::forward().
+      * When windows are extracted from a larger image, the gradients at the
+      * boundaries of the windows are computed using the neighbouring pixels
+      * of the image, rather than uncentered gradients.
+      */
+    template <typename T>
+    class IntegralHOG: public BlockCellDescriptors<T,double>
+    {
+      public:
+        /**
+          * Constructor
+          */
+        IntegralHOG(const size_t height, const size_t width,
+          const size_t cell_dim=8, const bool full_orientation=false,
+          const size_t cell_y=4, const size_t cell_x=4,
+          const size_t cell_ov_y=0, const size_t cell_ov_x=0,
+          const size_t block_y=4, const size_t block_x=4,
+          const size_t block_ov_y=0, const size_t block_ov_x=0);
+
+        /**
+          * Copy constructor
+          */
+        IntegralHOG(const IntegralHOG& other);
+
+        /**
+          * Destructor
+          */
+        virtual ~IntegralHOG() {}
+
+        /**
+          * @brief Assignment operator
+          */
+        IntegralHOG& operator=(const IntegralHOG& other);
+
+        /**
+          * @brief Equal to
+          */
+        bool operator==(const IntegralHOG& b) const;
+        /**
+          * @brief Not equal to
+          */
+        bool operator!=(const IntegralHOG& b) const;
+
+        /**
+          * Getters
+          */
+        bool getFullOrientation() const { return m_full_orientation; }
+        GradientMagnitudeType getGradientMagnitudeType() const
+        { return m_gradient_maps.getGradientMagnitudeType(); }
+        /**
+          * Returns the size of the image given to
+          * computeIntegralHistograms()
+          */
+        size_t getImageHeight() const { return m_integral.extent(0)-1; }
+        size_t getImageWidth() const { return m_integral.extent(1)-1; }
+        /**
+          * Returns the integral histograms of the current image. The first
+          * two dimensions are the (y,x) coordinates (shifted by one, the
+          * first row and column being zero), and the last one is the bin.
+          */
+        const blitz::Array<double,3>& getIntegralHistograms() const
+        { return m_integral; }
+        /**
+          * Setters. Changing these parameters requires to call
+          * computeIntegralHistograms() again.
+          */
+        void setFullOrientation(const bool full_orientation)
+        { m_full_orientation = full_orientation; }
+        void setGradientMagnitudeType(const GradientMagnitudeType m)
+        { m_gradient_maps.setGradientMagnitudeType(m); }
+
+        /**
+          * @brief Computes the gradients of the given image, and the
+          * integral histograms of their orientations. The image may be
+          * larger than the window size.
+          */
+        void computeIntegralHistograms(const blitz::Array<T,2>& image);
+
+        /**
+          * @brief Computes the histogram of the gradients of the rectangle
+          * of size (h,w) with top left corner (y,x), from the integral
+          * histograms of the current image.
+          * @warning Does not check that the rectangle is inside the image
+          */
+        void cellHistogram_(const int y, const int x, const int h,
+          const int w, blitz::Array<double,1>& hist) const;
+
+        /**
+          * @brief Extracts the HOG descriptors of the window with top left
+          * corner (y,x) of the current image. The output is 3D, as for
+          * the HOG class.
+          */
+        void extract_(const int y, const int x, blitz::Array<double,3>& output);
+        void extract(const int y, const int x, blitz::Array<double,3>& output);
+
+        /**
+          * @brief Extracts the HOG descriptors of several windows of the
+          * current image. Each row of positions gives the (y,x) coordinates
+          * of the top left corner of a window. The first dimension of the
+          * output is the index of the window, and the three other ones are
+          * the same as for extract().
+          */
+        void extract(const blitz::Array<int,2>& positions,
+          blitz::Array<double,4>& output);
+
+        /**
+          * Processes an input array of the size of a window. This is the
+          * same as calling computeIntegralHistograms() and extracting the
+          * window at position (0,0).
+          */
+        virtual void forward_(const blitz::Array<T,2>& input,
+          blitz::Array<double,3>& output);
+        virtual void forward(const blitz::Array<T,2>& input,
+          blitz::Array<double,3>& output);
+
+      protected:
+        void checkWindow(const int y, const int x) const;
+
+        bool m_full_orientation;
+        GradientMaps m_gradient_maps;
+        blitz::Array<double,2> m_magnitude;
+        blitz::Array<double,2> m_orientation;
+        blitz::Array<double,3> m_integral;
+    };
+
+    template <typename T>
+    IntegralHOG<T>::IntegralHOG(const size_t height,
+        const size_t width, const size_t cell_dim,
+        const bool full_orientation,
+        const size_t cell_y, const size_t cell_x,
+        const size_t cell_ov_y, const size_t cell_ov_x,
+        const size_t block_y, const size_t block_x,
+        const size_t block_ov_y, const size_t block_ov_x):
+      BlockCellDescriptors<T,double>(height, width,
+        cell_dim, cell_y, cell_x, cell_ov_y, cell_ov_x,
+        block_y, block_x, block_ov_y, block_ov_x),
+      m_full_orientation(full_orientation),
+      m_gradient_maps(height, width),
+      m_integral(1, 1, cell_dim)
+    {
+      m_integral = 0.;
+    }
+
+    template <typename T>
+    IntegralHOG<T>::IntegralHOG(const IntegralHOG& other):
+      BlockCellDescriptors<T,double>(other),
+      m_full_orientation(other.m_full_orientation),
+      m_gradient_maps(other.m_gradient_maps),
+      m_integral(bob::core::array::ccopy(other.m_integral))
+    {
+    }
+
+    template <typename T>
+    IntegralHOG<T>& IntegralHOG<T>::operator=(const IntegralHOG<T>& other)
+    {
+      if(this != &other)
+      {
+        BlockCellDescriptors<T,double>::operator=(other);
+        m_full_orientation = other.m_full_orientation;
+        m_gradient_maps = other.m_gradient_maps;
+        m_integral.reference(bob::core::array::ccopy(other.m_integral));
+      }
+      return *this;
+    }
+
+    template <typename T>
+    bool IntegralHOG<T>::operator==(const IntegralHOG<T>& b) const
+    {
+      return (BlockCellDescriptors<T,double>::operator==(b) &&
+              this->m_full_orientation == b.m_full_orientation &&
+              this->getGradientMagnitudeType() ==
+                b.getGradientMagnitudeType());
+    }
+
+    template <typename T>
+    bool IntegralHOG<T>::operator!=(const IntegralHOG<T>& b) const
+    {
+      return !(this->operator==(b));
+    }
+
+    template <typename T>
+    void IntegralHOG<T>::computeIntegralHistograms(
+      const blitz::Array<T,2>& image)
+    {
+      const int height = image.extent(0);
+      const int width = image.extent(1);
+      const int nb_bins = BlockCellDescriptors<T,double>::m_cell_dim;
+
+      // Computes the gradient maps of the full image
+      if (m_gradient_maps.getHeight() != (size_t)height ||
+          m_gradient_maps.getWidth() != (size_t)width)
+        m_gradient_maps.resize(height, width);
+      m_magnitude.resize(height, width);
+      m_orientation.resize(height, width);
+      m_gradient_maps.forward_(image, m_magnitude, m_orientation);
+
+      // Integral histograms: each row is the row above, plus the running sum
+      // of the current row (computed for all bins at once)
+      m_integral.resize(height+1, width+1, nb_bins);
+      m_integral = 0.;
+      const double range_orientation = (m_full_orientation? 2*M_PI : M_PI);
+      const double scale = nb_bins / range_orientation;
+      blitz::Array<double,1> acc(nb_bins);
+      const int sy = m_integral.stride(0);
+      const int sx = m_integral.stride(1);
+      for(int i=0; i<height; ++i)
+      {
+        acc = 0.;
+        const double* above = m_integral.data() + i*sy + sx;
+        double* cur = m_integral.data() + (i+1)*sy + sx;
+        double* a = acc.data();
+        for(int j=0; j<width; ++j, above+=sx, cur+=sx)
+        {
+          // Same (bilinear) assignment to the orientation bins as
+          // hogComputeHistogram_()
+          const double energy = m_magnitude(i,j);
+          const double bin = m_orientation(i,j) * scale;
+          int bin_index1 = (int)floor(bin);
+          const double weight = 1.-(bin-bin_index1);
+          bin_index1 = bin_index1 % nb_bins;
+          if(bin_index1<0) bin_index1+=nb_bins;
+          const int bin_index2 = (bin_index1+1) % nb_bins;
+          a[bin_index1] += weight * energy;
+          a[bin_index2] += (1. - weight) * energy;
+
+          for(int k=0; k<nb_bins; ++k) cur[k] = above[k] + a[k];
+        }
+      }
+    }
+
+    template <typename T>
+    void IntegralHOG<T>::cellHistogram_(const int y, const int x,
+      const int h, const int w, blitz::Array<double,1>& hist) const
+    {
+      const int sy = m_integral.stride(0);
+      const int sx = m_integral.stride(1);
+      const double* tl = m_integral.data() + y*sy + x*sx;
+      const double* tr = tl + w*sx;
+      const double* bl = tl + h*sy;
+      const double* br = bl + w*sx;
+      for(int k=0; k<hist.extent(0); ++k)
+        hist(k) = br[k] - bl[k] - tr[k] + tl[k];
+    }
+
+    template <typename T>
+    void IntegralHOG<T>::checkWindow(const int y, const int x) const
+    {
+      if(y < 0 || x < 0 ||
+         (size_t)y + BlockCellDescriptors<T,double>::m_height >
+           getImageHeight() ||
+         (size_t)x + BlockCellDescriptors<T,double>::m_width >
+           getImageWidth())
+      {
+        boost::format m("the window of size (%d,%d) at position (%d,%d) is not inside the image of size (%d,%d)");
+        m % BlockCellDescriptors<T,double>::m_height %
+          BlockCellDescriptors<T,double>::m_width % y % x %
+          getImageHeight() % getImageWidth();
+        throw std::runtime_error(m.str());
+      }
+    }
+
+    template <typename T>
+    void IntegralHOG<T>::extract_(const int y, const int x,
+      blitz::Array<double,3>& output)
+    {
+      const int step_y = BlockCellDescriptors<T,double>::m_cell_y -
+        BlockCellDescriptors<T,double>::m_cell_ov_y;
+      const int step_x = BlockCellDescriptors<T,double>::m_cell_x -
+        BlockCellDescriptors<T,double>::m_cell_ov_x;
+      blitz::Range rall = blitz::Range::all();
+      for(size_t cy=0; cy<BlockCellDescriptors<T,double>::m_nb_cells_y; ++cy)
+        for(size_t cx=0; cx<BlockCellDescriptors<T,double>::m_nb_cells_x;
+          ++cx)
+        {
+          blitz::Array<double,1> hist =
+            BlockCellDescriptors<T,double>::m_cell_descriptor(cy,cx,rall);
+          cellHistogram_(y+cy*step_y, x+cx*step_x,
+            BlockCellDescriptors<T,double>::m_cell_y,
+            BlockCellDescriptors<T,double>::m_cell_x, hist);
+        }
+
+      BlockCellDescriptors<T,double>::normalizeBlocks(output);
+    }
+
+    template <typename T>
+    void IntegralHOG<T>::extract(const int y, const int x,
+      blitz::Array<double,3>& output)
+    {
+      // Checks the window and the output array
+      checkWindow(y, x);
+      bob::core::array::assertSameDimensionLength(m_integral.extent(2),
+        BlockCellDescriptors<T,double>::m_cell_dim);
+      const blitz::TinyVector<int,3> r =
+        BlockCellDescriptors<T,double>::getOutputShape();
+      bob::core::array::assertSameShape(output, r);
+
+      extract_(y, x, output);
+    }
+
+    template <typename T>
+    void IntegralHOG<T>::extract(const blitz::Array<int,2>& positions,
+      blitz::Array<double,4>& output)
+    {
+      // Checks the positions and the output array
+      bob::core::array::assertSameDimensionLength(positions.extent(1), 2);
+      bob::core::array::assertSameDimensionLength(m_integral.extent(2),
+        BlockCellDescriptors<T,double>::m_cell_dim);
+      const blitz::TinyVector<int,3> r =
+        BlockCellDescriptors<T,double>::getOutputShape();
+      const blitz::TinyVector<int,4> shape(positions.extent(0), r(0), r(1),
+        r(2));
+      bob::core::array::assertSameShape(output, shape);
+      for(int n=0; n<positions.extent(0); ++n)
+        checkWindow(positions(n,0), positions(n,1));
+
+      blitz::Range rall = blitz::Range::all();
+      for(int n=0; n<positions.extent(0); ++n)
+      {
+        blitz::Array<double,3> output_n = output(n,rall,rall,rall);
+        extract_(positions(n,0), positions(n,1), output_n);
+      }
+    }
+
+    template <typename T>
+    void IntegralHOG<T>::forward_(const blitz::Array<T,2>& input,
+      blitz::Array<double,3>& output)
+    {
+      computeIntegralHistograms(input);
+      extract_(0, 0, output);
+    }
+
+    template <typename T>
+    void IntegralHOG<T>::forward(const blitz::Array<T,2>& input,
+      blitz::Array<double,3>& output)
+    {
+      // Checks input/output arrays
+      const blitz::TinyVector<int,2> s(BlockCellDescriptors<T,double>::m_height,
+        BlockCellDescriptors<T,double>::m_width);
+      bob::core::array::assertSameShape(input, s);
+      const blitz::TinyVector<int,3> r =
+        BlockCellDescriptors<T,double>::getOutputShape();
+      bob::core::array::assertSameShape(output, r);
+
+      // Generates the HOG descriptors
+      forward_(input, output);
+    }
+
+  }
+
+/**
+ * @}
+ */
+}
+
+#endif /* BOB_IP_INTEGRAL_HOG_H */
@@ -73,6 +73,7 @@ class SIFT
      */
     size_t getHeight() const { return m_gss->getHeight(); }
     size_t getWidth() const { return m_gss->getWidth(); }
+    size_t getNThreads() const { return m_gss->getNThreads(); }
     size_t getNOctaves() const { return m_gss->getNOctaves(); }
     size_t getNIntervals() const { return m_gss->getNIntervals(); }
     int getOctaveMin() const { return m_gss->getOctaveMin(); }
@@ -100,6 +101,8 @@ class SIFT
     { m_gss->setHeight(height); }
     void setWidth(const size_t width) 
     { m_gss->setWidth(width); }
+    void setNThreads(const size_t n_threads)
+    { m_gss->setNThreads(n_threads); }
     void setNOctaves(const size_t n_octaves) 
     { m_gss->setNOctaves(n_octaves); }
     void setNIntervals(const size_t n_intervals) 
@@ -161,6 +164,11 @@ class SIFT
      * @brief Resets the cache
      */
     void resetCache();
+    /**
+     * @brief Tells if the cache has the shapes required by the current
+     * parameters, in which case it is reused for the next image
+     */
+    bool isCacheValid() const;
 
     /**
      * @brief Recomputes the value effectively used in the edge-like rejection
@@ -175,22 +183,6 @@ class SIFT
     const blitz::TinyVector<int,3> 
     getGaussianOutputShape(const int octave) const;
 
-    /**
-     * @brief Computes the Gaussian pyramid
-     */
-    template <typename T> 
-    void computeGaussianPyramid(const blitz::Array<T,2>& src);
-    /**
-     * @brief Computes the Difference of Gaussians pyramid
-     * @warning assumes that the Gaussian pyramid has already been computed
-     */
-    void computeDog();
-
-    /**
-     * @brief Computes gradients from the Gaussian pyramid
-     */
-    void computeGradient();
-
     /**
      * @brief Compute SIFT descriptors for the given keypoints
      * @param keypoints The keypoints
@@ -237,15 +229,11 @@ class SIFT
     std::vector<blitz::Array<double,3> > m_dog_pyr;
     std::vector<blitz::Array<double,3> > m_gss_pyr_grad_mag;
     std::vector<blitz::Array<double,3> > m_gss_pyr_grad_or;
-    std::vector<boost::shared_ptr<bob::ip::GradientMaps> > m_gradient_maps;
-   
 
     /**
      * For testing purposes only
      */
     friend class SIFTtest;
-    void setGaussianPyramid(const std::vector<blitz::Array<double,3> >& gss_pyr)
-    { m_gss_pyr = gss_pyr; }
 };
 
 template <typename T>
@@ -253,23 +241,16 @@ void bob::ip::SIFT::computeDescriptor(const blitz::Array<T,2>& src,
   const std::vector<boost::shared_ptr<bob::ip::GSSKeypoint> >& keypoints,
   blitz::Array<double,4>& dst)
 {
-  // Computes the Gaussian pyramid
-  computeGaussianPyramid(src);
-  // Computes the Difference of Gaussians pyramid
-  computeDog();
-  // Computes the Gradient of the Gaussians pyramid
-  computeGradient();
+  // Only reallocates the cache if the parameters have changed
+  if (!isCacheValid()) resetCache();
+  // Computes the Gaussian pyramid, the Difference of Gaussians pyramid and
+  // the gradient of the Gaussians pyramid in a single pass
+  m_gss->operator()(src, m_gss_pyr, m_dog_pyr, m_gss_pyr_grad_mag,
+    m_gss_pyr_grad_or);
   // Computes the descriptors for the given keypoints
   computeDescriptor(keypoints, dst);
 }
 
-template <typename T>
-void bob::ip::SIFT::computeGaussianPyramid(const blitz::Array<T,2>& src)
-{
-  // Computes the Gaussian pyramid
-  m_gss->operator()(src, m_gss_pyr);
-}
-
 }}
 
 #endif /* BOB_IP_SIFT_H */
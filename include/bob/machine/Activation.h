@@ -12,6 +12,7 @@
 
 #include <string>
 #include <boost/shared_ptr.hpp>
+#include <blitz/array.h>
 #include "bob/io/HDF5File.h"
 
 namespace bob { namespace machine {
@@ -45,6 +46,23 @@ namespace bob { namespace machine {
        */
       virtual double f_prime_from_f (double a) const =0;
 
+      /**
+       * Computes the activated values of all elements of the given array, in
+       * place. The default implementation calls f() on each element; the
+       * built-in activation functions override it with loops over contiguous
+       * memory, which avoid a virtual call per element. Only the
+       * polynomial loops (the derivatives, and the linear activation) are
+       * vectorized by the compiler; tanh() and exp() remain calls to the
+       * C library, which dominate their cost.
+       */
+      virtual void f_inplace (blitz::Array<double,2>& z) const;
+
+      /**
+       * Computes the derivatives from the activated values of all elements of
+       * the given array, in place, as f_prime_from_f() does.
+       */
+      virtual void f_prime_from_f_inplace (blitz::Array<double,2>& a) const;
+
       /**
        * Saves itself to an HDF5File
        */
@@ -98,6 +116,8 @@ namespace bob { namespace machine {
       virtual double f (double z) const;
       virtual double f_prime (double z) const;
       virtual double f_prime_from_f (double a) const;
+      virtual void f_inplace (blitz::Array<double,2>& z) const;
+      virtual void f_prime_from_f_inplace (blitz::Array<double,2>& a) const;
       virtual void save(bob::io::HDF5File&) const;
       virtual void load(bob::io::HDF5File&);
       virtual std::string unique_identifier() const;
@@ -117,6 +137,8 @@ namespace bob { namespace machine {
       virtual double f (double z) const;
       virtual double f_prime (double z) const;
       virtual double f_prime_from_f (double a) const;
+      virtual void f_inplace (blitz::Array<double,2>& z) const;
+      virtual void f_prime_from_f_inplace (blitz::Array<double,2>& a) const;
       double C() const;
       virtual void save(bob::io::HDF5File& f) const;
       virtual void load(bob::io::HDF5File&);
@@ -140,6 +162,8 @@ namespace bob { namespace machine {
       virtual double f (double z) const;
       virtual double f_prime (double z) const;
       virtual double f_prime_from_f (double a) const;
+      virtual void f_inplace (blitz::Array<double,2>& z) const;
+      virtual void f_prime_from_f_inplace (blitz::Array<double,2>& a) const;
       virtual void save(bob::io::HDF5File& f) const;
       virtual void load(bob::io::HDF5File&);
       virtual std::string unique_identifier() const;
@@ -159,6 +183,8 @@ namespace bob { namespace machine {
       virtual double f (double z) const;
       virtual double f_prime (double z) const;
       virtual double f_prime_from_f (double a) const;
+      virtual void f_inplace (blitz::Array<double,2>& z) const;
+      virtual void f_prime_from_f_inplace (blitz::Array<double,2>& a) const;
       double C() const;
       double M() const;
       virtual void save(bob::io::HDF5File& f) const;
@@ -184,6 +210,8 @@ namespace bob { namespace machine {
       virtual double f (double z) const;
       virtual double f_prime (double z) const;
       virtual double f_prime_from_f (double a) const;
+      virtual void f_inplace (blitz::Array<double,2>& z) const;
+      virtual void f_prime_from_f_inplace (blitz::Array<double,2>& a) const;
       virtual void save(bob::io::HDF5File& f) const;
       virtual void load(bob::io::HDF5File&);
       virtual std::string unique_identifier() const;
@@ -16,6 +16,7 @@
 #include <bob/io/HDF5File.h>
 
 #include <sstream>
+#include <cstddef>
 
 namespace bob{ namespace machine {
   /**
@@ -30,7 +31,7 @@ namespace bob{ namespace machine {
     public:
       //! \brief Default constructor that should be used only to call "average" or
       //! one of the similarity functions
-      GaborGraphMachine(){}
+      GaborGraphMachine() : m_n_threads(1) {}
 
       //! creates a face grid graph using two reference positions, namely, the eyes
       GaborGraphMachine(
@@ -64,6 +65,10 @@ namespace bob{ namespace machine {
       //! Returns the generated node positions (in the usual order (y,x))
       blitz::Array<int,2> nodes() const {return m_node_positions;}
 
+      //! The number of threads used by similarities(); the results do not depend on it
+      size_t getNThreads() const {return m_n_threads;}
+      void setNThreads(size_t n_threads);
+
       //! extracts the Gabor jets of the graph from the jet image
       void extract(
         const blitz::Array<double,4>& jet_image,
@@ -76,6 +81,24 @@ namespace bob{ namespace machine {
         blitz::Array<double,2>& graph_jets
       ) const;
 
+      //! \brief extracts the Gabor jets of the graph directly from the image, computing the Gabor
+      //! wavelet transform at the node positions only
+      void extract(
+        bob::ip::GaborWaveletTransform& gwt,
+        const blitz::Array<std::complex<double>,2>& image,
+        blitz::Array<double,3>& graph_jets,
+        bool do_normalize = true
+      ) const;
+
+      //! \brief extracts the Gabor jets (abs part only) of the graph directly from the image,
+      //! computing the Gabor wavelet transform at the node positions only
+      void extract(
+        bob::ip::GaborWaveletTransform& gwt,
+        const blitz::Array<std::complex<double>,2>& image,
+        blitz::Array<double,2>& graph_jets,
+        bool do_normalize = true
+      ) const;
+
       //! averages multiple Gabor graphs into one
       void average(
         const blitz::Array<double,4>& many_graph_jets,
@@ -110,6 +133,27 @@ namespace bob{ namespace machine {
         const bob::machine::GaborJetSimilarity& jet_similarity_function
       ) const;
 
+      //! \brief computes the similarity of the probe graph to each graph of the gallery.
+      //! The gallery is a C-contiguous array of graphs (number of graphs x number of nodes x 2 x number of kernels),
+      //! with the same topology as the probe graph (the node positions of this machine are not used),
+      //! which is split into chunks that are scored in parallel; scores(g) is the same as
+      //! similarity(gallery(g,...), probe_graph_jets, jet_similarity_function)
+      void similarities(
+        const blitz::Array<double,4>& gallery_graph_jets,
+        const blitz::Array<double,3>& probe_graph_jets,
+        const bob::machine::GaborJetSimilarity& jet_similarity_function,
+        blitz::Array<double,1>& scores
+      ) const;
+
+      //! \brief computes the similarity of the probe graph (abs parts only) to each graph of the gallery,
+      //! which is a C-contiguous array of graphs (number of graphs x number of nodes x number of kernels)
+      void similarities(
+        const blitz::Array<double,3>& gallery_graph_jets,
+        const blitz::Array<double,2>& probe_graph_jets,
+        const bob::machine::GaborJetSimilarity& jet_similarity_function,
+        blitz::Array<double,1>& scores
+      ) const;
+
       //! saves this machine to file
       void save(bob::io::HDF5File& file) const;
 
@@ -117,13 +161,28 @@ namespace bob{ namespace machine {
       void load(bob::io::HDF5File& file);
 
     private:
-      void checkPositions(int height, int width) const throw();
+      void checkPositions(int height, int width) const;
+
+      // scores the contiguous gallery graphs with the given jet size (number of values per node)
+      void scoreGallery(
+        const double* gallery,
+        const double* probe,
+        int number_of_graphs,
+        int number_of_nodes,
+        int number_of_kernels,
+        int jet_size,
+        const bob::machine::GaborJetSimilarity& jet_similarity_function,
+        double* scores
+      ) const;
 
       // The node positions of the graph
       blitz::Array<int,2> m_node_positions;
 
       // temporary complex vector of Gabor jet averages
       mutable blitz::Array<std::complex<double>,1> m_averages;
+
+      // the number of threads used to score galleries
+      size_t m_n_threads;
   };
 
   /**
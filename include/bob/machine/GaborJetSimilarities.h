@@ -47,6 +47,30 @@ namespace bob { namespace machine {
       //! The similarity between two Gabor jets, including absolute values only
       double operator()(const blitz::Array<double,1>& jet1, const blitz::Array<double,1>& jet2) const;
 
+      //! \brief The similarity between two Gabor jets given as contiguous memory, i.e., the
+      //! number_of_kernels absolute values, followed by the number_of_kernels phases for the
+      //! similarity types that require them.
+      //! The confidences and phase_differences buffers need number_of_kernels elements (they are
+      //! only used by disparity types), and the estimated disparity is returned in disparity.
+      //! This function does not modify this object, so it can be called by several threads concurrently.
+      double similarity(
+        int number_of_kernels,
+        const double* jet1,
+        const double* jet2,
+        double* confidences,
+        double* phase_differences,
+        blitz::TinyVector<double,2>& disparity
+      ) const;
+
+      //! The type of this similarity function
+      SimilarityType type() const {return m_type;}
+
+      //! The Gabor wavelet transform defining the kernels used by disparity types
+      const bob::ip::GaborWaveletTransform& gwt() const {return m_gwt;}
+
+      //! Does this similarity function use the Gabor phases?
+      bool usesPhases() const {return m_type >= DISPARITY;}
+
       //! returns the disparity vector estimated during the last call of similarity; only valid for disparity types
       blitz::TinyVector<double,2> disparity(const blitz::Array<double,2>& jet1, const blitz::Array<double,2>& jet2) const;
 
@@ -69,18 +93,16 @@ namespace bob { namespace machine {
       // members required by disparity functions
       bob::ip::GaborWaveletTransform m_gwt;
 
-      // initializes the internal memory to be used for disparity-like Gabor jet similarities
+      // initializes the disparity of disparity-like Gabor jet similarities
       void init();
-      // computes confidences from the given Gabor jets
-      void compute_confidences(const blitz::Array<double,2>& jet1, const blitz::Array<double,2>& jet2) const;
-      // computes the disparity using the m_confidences and m_phase_differences values
-      void compute_disparity() const;
+      // computes confidences and phase differences from the given Gabor jets
+      void compute_confidences(int number_of_kernels, const double* jet1, const double* jet2, double* confidences, double* phase_differences) const;
+      // computes the disparity from the given confidences and phase differences
+      void compute_disparity(const double* confidences, const double* phase_differences, blitz::TinyVector<double,2>& disparity) const;
 
+      // the disparity estimated during the last call of a (non thread-safe) similarity function
       mutable blitz::TinyVector<double,2> m_disparity;
 
-      mutable std::vector<double> m_confidences;
-      mutable std::vector<double> m_phase_differences;
-
   }; // class GaborJetSimilarity
 
   /**
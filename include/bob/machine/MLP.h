@@ -167,6 +167,13 @@ namespace bob { namespace machine {
       void forward_ (const blitz::Array<double,2>& input,
           blitz::Array<double,2>& output);
 
+      /**
+       * Same as above, but the rows of the input are split in n_threads
+       * contiguous blocks that are forwarded concurrently.
+       */
+      void forward_ (const blitz::Array<double,2>& input,
+          blitz::Array<double,2>& output, size_t n_threads);
+
       /**
        * Forwards data through the network, outputs the values of each output
        * neuron. This variant will take a number of inputs in one single input
@@ -179,6 +186,13 @@ namespace bob { namespace machine {
       void forward (const blitz::Array<double,2>& input,
           blitz::Array<double,2>& output);
 
+      /**
+       * Same as above, but the rows of the input are split in n_threads
+       * contiguous blocks that are forwarded concurrently.
+       */
+      void forward (const blitz::Array<double,2>& input,
+          blitz::Array<double,2>& output, size_t n_threads);
+
       /**
        * Resizes the machine. This causes this MLP to be completely
        * re-initialized and should be considered invalid for calculation after
@@ -365,6 +379,23 @@ namespace bob { namespace machine {
        */
       void randomize(double lower_bound=-0.1, double upper_bound=+0.1);
 
+    private: //helpers
+
+      /**
+       * Forwards the rows [begin,end[ of the input, in blocks of rows. Each
+       * layer is computed for a whole block with a single matrix product.
+       * Only local working arrays are used, so that disjoint ranges of rows
+       * can be forwarded concurrently.
+       */
+      void forward_rows (const blitz::Array<double,2>& input,
+          blitz::Array<double,2>& output, int begin, int end) const;
+
+      /**
+       * Checks the input and output of the batched forward methods
+       */
+      void check_forward (const blitz::Array<double,2>& input,
+          const blitz::Array<double,2>& output) const;
+
     private: //representation
 
       blitz::Array<double, 1> m_input_sub; ///< input subtraction
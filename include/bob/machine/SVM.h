@@ -338,6 +338,49 @@ namespace bob { namespace machine {
         (const blitz::Array<double,1>& input,
          blitz::Array<double,1>& probabilities) const;
 
+      /**
+       * Predicts the classes of several inputs, organized row-wise. The
+       * number of labels should be the same as the number of rows of the
+       * input.
+       *
+       * Contrary to the single-input methods, which call libsvm on a sparse
+       * copy of each input, the kernel values between a block of inputs and
+       * all the support vectors (kept in a dense matrix) are computed with
+       * a single matrix product, followed by an element-wise transform. The
+       * decision functions of linear machines are collapsed into weight
+       * vectors. The decisions are the same as libsvm's, up to the rounding
+       * of the kernel values. The rows of the input may be split among
+       * n_threads threads.
+       *
+       * @note Machines with precomputed kernels are still evaluated by
+       * libsvm, one input at a time.
+       */
+      void predictClassesDense(const blitz::Array<double,2>& input,
+          blitz::Array<int,1>& labels, size_t n_threads=1) const;
+
+      /**
+       * Same as above, but does not check the input and output arrays
+       */
+      void predictClassesDense_(const blitz::Array<double,2>& input,
+          blitz::Array<int,1>& labels, size_t n_threads=1) const;
+
+      /**
+       * Predicts the classes and the scores of several inputs, organized
+       * row-wise (see predictClassesDense()). Each row of the scores
+       * contains the values of the decision functions for the corresponding
+       * input, as returned by predictClassAndScores().
+       */
+      void predictClassesAndScoresDense(const blitz::Array<double,2>& input,
+          blitz::Array<int,1>& labels, blitz::Array<double,2>& scores,
+          size_t n_threads=1) const;
+
+      /**
+       * Same as above, but does not check the input and output arrays
+       */
+      void predictClassesAndScoresDense_(const blitz::Array<double,2>& input,
+          blitz::Array<int,1>& labels, blitz::Array<double,2>& scores,
+          size_t n_threads=1) const;
+
       /**
        * Saves the current model state to a file. With this variant, the model
        * is saved on simpler libsvm model file that does not include the
@@ -365,6 +408,36 @@ namespace bob { namespace machine {
        */
       void reset();
 
+      /**
+       * Copies the support vectors and the coefficients of the decision
+       * functions of the libsvm model into dense matrices, for the batched
+       * prediction methods
+       */
+      void densify();
+
+      /**
+       * Predicts the classes (and the scores, if not null) of the rows
+       * [begin,end[ of the input, in blocks of rows. Only local working
+       * arrays are used, so that disjoint ranges of rows can be predicted
+       * concurrently.
+       */
+      void predictRows(const blitz::Array<double,2>& input,
+          blitz::Array<int,1>& labels, blitz::Array<double,2>* scores,
+          int begin, int end) const;
+
+      /**
+       * Predicts the rows of the input with n_threads threads
+       */
+      void predictAll(const blitz::Array<double,2>& input,
+          blitz::Array<int,1>& labels, blitz::Array<double,2>* scores,
+          size_t n_threads) const;
+
+      /**
+       * Checks the input and output of the batched prediction methods
+       */
+      void checkBatch(const blitz::Array<double,2>& input,
+          const blitz::Array<int,1>& labels) const;
+
     private: //representation
 
       boost::shared_ptr<svm_model> m_model; ///< libsvm model pointer
@@ -372,6 +445,11 @@ namespace bob { namespace machine {
       size_t m_input_size; ///< vector size expected as input for the SVM's
       blitz::Array<double,1> m_input_sub; ///< scaling: subtraction
       blitz::Array<double,1> m_input_div; ///< scaling: division
+      blitz::Array<double,2> m_sv; ///< dense support vectors (one per row)
+      blitz::Array<double,1> m_sv_norm2; ///< squared norms of the SVs (RBF)
+      blitz::Array<double,2> m_coef; ///< coefficient of each SV (or input, if linear) in each decision function
+      blitz::Array<double,1> m_rho; ///< offset of each decision function
+      bool m_collapsed; ///< linear decision functions collapsed into m_coef?
 
   };
 
@@ -0,0 +1,155 @@
+/**
+ * @file bob/math/ScatterAccumulator.h
+ * @date Sat Oct 18 21:12:37 2026 +0200
+ *
+ * @brief This file defines an accumulator of the mean and the scatter
+ * matrix of a data set, which is given as a sequence of blocks of rows.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_MATH_SCATTER_ACCUMULATOR_H
+#define BOB_MATH_SCATTER_ACCUMULATOR_H
+
+#include <stdint.h>
+#include <vector>
+#include <blitz/array.h>
+
+namespace bob { namespace math {
+/**
+ * @ingroup MATH
+ * @{
+ */
+
+/**
+ * @brief Accumulates the mean and the scatter matrix of samples given as
+ *   blocks of rows (each sample is a row, each feature is a column), so that
+ *   a data set does not need to be loaded in memory at once.
+ *
+ *   Each block is split into stripes of rows, which are processed by
+ *   separate threads. The scatter of a stripe is computed around its own
+ *   mean with symmetric rank-k updates (see bob::math::syrk()), and the
+ *   partial results are combined with the pairwise update of Chan et al.:
+ *     n = n_a + n_b, d = m_b - m_a, m = m_a + d*n_b/n,
+ *     S = S_a + S_b + (n_a*n_b/n) d*d^T
+ *   which avoids the loss of precision of the sum of squares. Accumulators
+ *   filled independently (e.g. on parts of a data set) can be combined in
+ *   the same way with merge().
+ */
+class ScatterAccumulator
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param n_features The dimensionality of the samples
+     */
+    ScatterAccumulator(const size_t n_features=0);
+
+    /**
+     * @brief Copy constructor
+     */
+    ScatterAccumulator(const ScatterAccumulator& other);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~ScatterAccumulator() {}
+
+    /**
+     * @brief Assigns from a different class instance
+     */
+    ScatterAccumulator& operator=(const ScatterAccumulator& other);
+
+    /**
+     * @brief Equal to
+     */
+    bool operator==(const ScatterAccumulator& b) const;
+    /**
+     * @brief Not equal to
+     */
+    bool operator!=(const ScatterAccumulator& b) const;
+
+    /**
+     * @brief Discards the accumulated samples, and sets the dimensionality
+     * of the samples
+     */
+    void reset(const size_t n_features);
+    /**
+     * @brief Discards the accumulated samples
+     */
+    void reset();
+
+    /**
+     * @brief Getters
+     */
+    size_t getNFeatures() const { return m_mean.extent(0); }
+    uint64_t getNSamples() const { return m_n_samples; }
+    const blitz::Array<double,1>& getMean() const { return m_mean; }
+    const blitz::Array<double,2>& getScatter() const { return m_scatter; }
+    size_t getNThreads() const { return m_n_threads; }
+
+    /**
+     * @brief Sets the number of threads used to accumulate a block. The
+     * result only depends on it by rounding errors.
+     */
+    void setNThreads(const size_t n_threads);
+
+    /**
+     * @brief Computes the covariance matrix (the scatter matrix divided by
+     * the number of samples minus one)
+     */
+    void getCovariance(blitz::Array<double,2>& covariance) const;
+
+    /**
+     * @brief Adds the samples of the given block (one sample per row)
+     */
+    void accumulate(const blitz::Array<double,2>& data);
+    /**
+     * @brief Adds a single sample
+     */
+    void accumulate(const blitz::Array<double,1>& sample);
+
+    /**
+     * @brief Adds the samples accumulated by another accumulator
+     */
+    void merge(const ScatterAccumulator& other);
+
+  private:
+    /**
+     * @brief Computes the mean and the scatter of the rows [begin,end[ of
+     * the given block
+     */
+    static void accumulateStripe(const blitz::Array<double,2>& data,
+      const int begin, const int end, blitz::Array<double,1>* mean,
+      blitz::Array<double,2>* scatter);
+
+    /**
+     * @brief Adds the mean and the scatter of n_b samples to the given ones
+     * of n_a samples
+     */
+    static void combine(const uint64_t n_a, blitz::Array<double,1>& mean_a,
+      blitz::Array<double,2>& scatter_a, const uint64_t n_b,
+      const blitz::Array<double,1>& mean_b,
+      const blitz::Array<double,2>& scatter_b);
+
+    uint64_t m_n_samples;
+    blitz::Array<double,1> m_mean;
+    blitz::Array<double,2> m_scatter;
+    size_t m_n_threads;
+};
+
+/**
+ * @brief Calculates the within and between class scatter matrices Sw and Sb,
+ *   and the overall mean m, from the accumulators of each class. This gives
+ *   the same results as bob::math::scatters() on the data of the classes.
+ */
+void scatters(const std::vector<ScatterAccumulator>& classes,
+  blitz::Array<double,2>& Sw, blitz::Array<double,2>& Sb,
+  blitz::Array<double,1>& m);
+
+/**
+ * @}
+ */
+}}
+
+#endif /* BOB_MATH_SCATTER_ACCUMULATOR_H */
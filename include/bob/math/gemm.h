@@ -0,0 +1,70 @@
+/**
+ * @file bob/math/gemm.h
+ * @date Sat Oct 18 18:02:44 2026 +0200
+ *
+ * @brief This file defines a general matrix-matrix product of 2D blitz
+ * arrays, based on the BLAS dgemm function, and the symmetric rank-k update
+ * based on the BLAS dsyrk function.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_MATH_GEMM_H
+#define BOB_MATH_GEMM_H
+
+#include <blitz/array.h>
+
+namespace bob { namespace math {
+
+/**
+ * @ingroup MATH
+ * @{
+ */
+
+/**
+ * @brief Function which computes C = alpha*op(A)*op(B) + beta*C, where
+ *   op(X) is X or its transpose, using the dgemm BLAS function. This is
+ *   much faster than prod() for large matrices.
+ * @param A The A matrix (size MxK, or KxM if transA is set)
+ * @param B The B matrix (size KxN, or NxK if transB is set)
+ * @param C The C matrix (size MxN)
+ * @param transA Whether A should be transposed
+ * @param transB Whether B should be transposed
+ * @param alpha The factor of the product
+ * @param beta The factor of the initial content of C
+ */
+void gemm(const blitz::Array<double,2>& A, const blitz::Array<double,2>& B,
+  blitz::Array<double,2>& C, const bool transA=false,
+  const bool transB=false, const double alpha=1., const double beta=0.);
+/**
+ * @warning No checks are performed on the array sizes.
+ */
+void gemm_(const blitz::Array<double,2>& A, const blitz::Array<double,2>& B,
+  blitz::Array<double,2>& C, const bool transA=false,
+  const bool transB=false, const double alpha=1., const double beta=0.);
+
+/**
+ * @brief Function which computes C = alpha*A^T*A + beta*C using the dsyrk
+ *   BLAS function, i.e. the (scaled) sum of the outer products of the rows
+ *   of A. Only half of the products of gemm() are computed, and the other
+ *   triangle of C is copied afterwards. C should be symmetric if beta is
+ *   not zero.
+ * @param A The A matrix (size KxN)
+ * @param C The C matrix (size NxN)
+ * @param alpha The factor of the product
+ * @param beta The factor of the initial content of C
+ */
+void syrk(const blitz::Array<double,2>& A, blitz::Array<double,2>& C,
+  const double alpha=1., const double beta=0.);
+/**
+ * @warning No checks are performed on the array sizes.
+ */
+void syrk_(const blitz::Array<double,2>& A, blitz::Array<double,2>& C,
+  const double alpha=1., const double beta=0.);
+
+/**
+ * @}
+ */
+}}
+
+#endif /* BOB_MATH_GEMM_H */
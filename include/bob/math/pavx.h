@@ -51,6 +51,16 @@ namespace bob { namespace math {
      * the corresponding heights of bins (in increasing order).
      */
     std::pair<blitz::Array<size_t,1>, blitz::Array<double,1> > pavxWidthHeight(const blitz::Array<double,1>& y, blitz::Array<double,1>& ghat);
+    /**
+     * This variant only computes the pav bins, without allocating any
+     * memory: the heights and widths of the bins (from left to right) are
+     * written at the beginning of height and width, which should have the
+     * same size as y, and the number of bins is returned. The bins are
+     * pooled on a stack stored in these arrays, such that height may be y
+     * itself (the pooling is then done in place). Arguments are not
+     * checked!
+     */
+    size_t pavxBins_(const blitz::Array<double,1>& y, blitz::Array<double,1>& height, blitz::Array<size_t,1>& width);
 
 /**
  * @}
@@ -0,0 +1,54 @@
+/**
+ * @file bob/math/sort.h
+ * @date Sun Oct 18 21:10:42 2026 +0200
+ *
+ * @brief Sorts arrays of scores, keeping track of the permutation
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_MATH_SORT_H
+#define BOB_MATH_SORT_H
+
+#include <blitz/array.h>
+#include <cstddef>
+
+namespace bob { namespace math {
+/**
+ * @ingroup MATH
+ * @{
+ */
+
+    /**
+     * @brief Sorts the values in increasing order. The sorted values are
+     * written in sorted, and the index (in values) of each of them in
+     * permutation, such that sorted(i) == values(permutation(i)). Like
+     * std::stable_sort, equal values are kept in their original order.
+     *
+     * Large arrays are sorted with a least-significant-digit radix sort on
+     * the bits of the values, which takes a fixed number of passes over the
+     * data whatever their order. The digits of each pass are counted and
+     * scattered by n_threads threads, each of them processing a contiguous
+     * part of the array. Small arrays are sorted with std::stable_sort.
+     *
+     * @warning -0. and 0. are considered equal, and the values should not
+     * be NaN.
+     */
+    void sortWithPermutation(const blitz::Array<double,1>& values,
+      blitz::Array<double,1>& sorted, blitz::Array<size_t,1>& permutation,
+      const size_t n_threads=1);
+
+    /**
+     * @brief Same as sortWithPermutation(), but the arguments are not
+     * checked!
+     */
+    void sortWithPermutation_(const blitz::Array<double,1>& values,
+      blitz::Array<double,1>& sorted, blitz::Array<size_t,1>& permutation,
+      const size_t n_threads=1);
+
+/**
+ * @}
+ */
+}}
+
+#endif /* BOB_MATH_SORT_H */
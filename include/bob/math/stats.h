@@ -22,6 +22,35 @@ namespace bob { namespace math {
  * @{
  */
 
+    namespace detail {
+      /**
+       * @brief Adds the scatter of the rows of A around the given mean M to
+       * S, with one outer product per row.
+       */
+      template <typename T>
+      void addScatter_(const blitz::Array<T,2>& A, const blitz::Array<T,1>& M,
+        blitz::Array<T,2>& S)
+      {
+        blitz::firstIndex i;
+        blitz::secondIndex j;
+        blitz::Range a = blitz::Range::all();
+
+        blitz::Array<T,1> buffer(A.extent(1));
+        for (int z=0; z<A.extent(0); ++z) {
+          buffer = A(z,a) - M;
+          S += buffer(i) * buffer(j); //outer product
+        }
+      }
+
+      /**
+       * @brief Adds the scatter of the rows of A around the given mean M to
+       * S. The centered rows are gathered in blocks, and each block is
+       * accumulated with a single symmetric rank-k update (BLAS dsyrk).
+       */
+      void addScatter_(const blitz::Array<double,2>& A,
+        const blitz::Array<double,1>& M, blitz::Array<double,2>& S);
+    }
+
     /**
      * @brief Computes the scatter matrix of a 2D array considering data is
      * organized row-wise (each sample is a row, each feature is a column).
@@ -38,16 +67,10 @@ namespace bob { namespace math {
         blitz::Array<T,1>& M) {
       blitz::firstIndex i;
       blitz::secondIndex j;
-      blitz::Range a = blitz::Range::all();
 
       M = blitz::mean(A(j,i),j);
       S = 0;
-
-      blitz::Array<T,1> buffer(A.extent(1));
-      for (int z=0; z<A.extent(0); ++z) {
-        buffer = A(z,a) - M;
-        S += buffer(i) * buffer(j); //outer product
-      }
+      detail::addScatter_(A, M, S);
     }
 
     /**
@@ -190,10 +213,8 @@ namespace bob { namespace math {
       // within class scatter Sw
       Sw = 0;
       for (size_t k=0; k<data.size(); ++k) { //class loop
-        for (int example=0; example<data[k].extent(0); ++example) {
-          buffer = data[k](example,a) - m_k(a,k);
-          Sw += buffer(i) * buffer(j); //outer product
-        }
+        const blitz::Array<T,1> m_c(m_k(a,k).copy());
+        detail::addScatter_(data[k], m_c, Sw);
       }
     }
 
@@ -216,9 +216,10 @@ namespace bob { namespace measure {
    * Calculates the equal-error-rate (EER) given the input data, on the ROC 
    * Convex Hull, as performed in the Bosaris toolkit.
    * (https://sites.google.com/site/bosaristoolkit/)
+   * The scores are sorted with n_threads threads (see bob::measure::rocch()).
    */
   double eerRocch(const blitz::Array<double,1>& negatives,
-      const blitz::Array<double,1>& positives);
+      const blitz::Array<double,1>& positives, const size_t n_threads=1);
 
   /**
    * Calculates the threshold that minimizes the error rate, given the input
@@ -302,10 +303,14 @@ namespace bob { namespace measure {
    * and the second row is for "pfa").
    * Reference: Bosaris toolkit
    * (https://sites.google.com/site/bosaristoolkit/)
+   *
+   * The scores are sorted with a radix sort, using n_threads threads (see
+   * bob::math::sortWithPermutation()), and the vertices are computed from
+   * the bins of the Pool Adjacent Violators algorithm in linear time.
    */
   blitz::Array<double,2> rocch
     (const blitz::Array<double,1>& negatives,
-     const blitz::Array<double,1>& positives);
+     const blitz::Array<double,1>& positives, const size_t n_threads=1);
 
   /**
    * Calculates the Equal Error Rate (EER) on the ROC Convex Hull (ROCCH)
@@ -318,6 +323,24 @@ namespace bob { namespace measure {
    */
   double rocch2eer(const blitz::Array<double,2>& pmiss_pfa);
 
+  /**
+   * Calibrates the scores optimally on the ROC Convex Hull (ROCCH): each
+   * score is replaced by the log-likelihood-ratio given by the Pool
+   * Adjacent Violators bin it falls into (as opt_loglr() in the Bosaris
+   * toolkit), which is -/+infinity for the bins that only contain negatives
+   * or positives. The calibrated scores are written in llr_negatives and
+   * llr_positives, which should have the same sizes as negatives and
+   * positives, and the EER on the ROCCH (as bob::measure::eerRocch()) is
+   * returned. The scores are sorted only once, with n_threads threads, for
+   * both results.
+   * Reference: Bosaris toolkit
+   * (https://sites.google.com/site/bosaristoolkit/)
+   */
+  double calibrateRocch(const blitz::Array<double,1>& negatives,
+      const blitz::Array<double,1>& positives,
+      blitz::Array<double,1>& llr_negatives,
+      blitz::Array<double,1>& llr_positives, const size_t n_threads=1);
+
   /**
    * Calculates the ROC curve given a set of positive and negative scores at
    * the given FAR coordinates. Returns a two-dimensional blitz::Array of
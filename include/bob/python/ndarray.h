@@ -42,6 +42,7 @@
 
 #include <blitz/array.h>
 #include <stdint.h>
+#include <cstddef>
 
 /**
  * The method object::is_none() was only introduced in boost v1.43.
@@ -216,6 +217,30 @@ namespace bob { namespace python {
   convert_t convertible_to (boost::python::object array_like,
       bool writeable=true, bool behaved=true);
 
+  /**
+   * @brief Counters for the array data copies performed while moving arrays
+   * across the C++/Python boundary. Updates happen with the GIL held.
+   */
+  struct copy_statistics_t {
+    uint64_t count; ///< number of copies performed
+    uint64_t bytes; ///< total number of bytes copied
+  };
+
+  /**
+   * @brief Returns the current copy counters
+   */
+  const copy_statistics_t& copy_statistics();
+
+  /**
+   * @brief Resets the copy counters to zero
+   */
+  void reset_copy_statistics();
+
+  /**
+   * @brief Accounts for a copy of "bytes" bytes of array data
+   */
+  void account_copy(size_t bytes);
+
   class dtype {
 
     public: //api
@@ -397,9 +422,32 @@ namespace bob { namespace python {
        * this object continues to be responsible for deleting the memory and
        * you should make sure that it outlives the usage of the returned
        * pointer.
+       *
+       * The returned memory is always C-style contiguous. If this object
+       * refers to a strided NumPy array, a contiguous copy is created the
+       * first time this method is called. Use view_ptr() and view_stride() to
+       * access the data without copying.
        */
-      virtual void* ptr() { return m_ptr; }
-      virtual const void* ptr() const { return m_ptr; }
+      virtual void* ptr() { if (!m_ptr) materialize(); return m_ptr; }
+      virtual const void* ptr() const { if (!m_ptr) materialize(); return m_ptr; }
+
+      /**
+       * @brief Pointer to the first element of the referred data, in its
+       * original (possibly strided) layout.
+       */
+      void* view_ptr() const { return m_view_ptr; }
+
+      /**
+       * @brief Strides of the referred data, in number of elements. These
+       * may be negative and differ from type().stride if the NumPy array
+       * this object refers to is not C-style contiguous.
+       */
+      const ptrdiff_t* view_stride() const { return m_view_stride; }
+
+      /**
+       * @brief Tells if the referred data is C-style contiguous
+       */
+      bool is_contiguous() const { return m_contiguous; }
 
       /**
        * @brief Gets a handle to the owner of this buffer.
@@ -436,12 +484,28 @@ namespace bob { namespace python {
        */
       virtual bool is_writeable() const; ///< PyArray_ISWRITEABLE
 
+    private: //helpers
+
+      /**
+       * @brief Sets the view parameters for C-style contiguous data
+       */
+      void set_contiguous_view();
+
+      /**
+       * @brief Creates the C-style contiguous copy of strided data
+       */
+      void materialize() const;
+
     private: //representation
 
-      bob::core::array::typeinfo m_type; ///< type information
-      void* m_ptr; ///< pointer to the data
+      bob::core::array::typeinfo m_type; ///< type information (C-style)
+      mutable void* m_ptr; ///< pointer to the (contiguous) data
       bool m_is_numpy; ///< true if initiated with a NumPy array
       boost::shared_ptr<void> m_data; ///< Pointer to the data owner
+      void* m_view_ptr; ///< pointer to the referred data
+      ptrdiff_t m_view_stride[BOB_MAX_DIM+1]; ///< referred strides
+      bool m_contiguous; ///< true if m_view_ptr is C-style contiguous
+      mutable boost::shared_ptr<void> m_copy; ///< lazy contiguous copy
 
   };
 
@@ -524,6 +588,11 @@ namespace bob { namespace python {
        * ndarray outlives the blitz::Array<> and that such blitz::Array<> will
        * not be re-allocated or have any other changes made to it, except for
        * the data contents.
+       *
+       * The returned array is always C-style contiguous. If the underlying
+       * NumPy array is strided, this triggers a copy and changes to the
+       * returned array are not reflected on the NumPy side. Prefer view()
+       * when the code consuming the array does not rely on contiguity.
        */
       template <typename T, int N> blitz::Array<T,N> bz () {
 
@@ -531,6 +600,49 @@ namespace bob { namespace python {
         typedef blitz::TinyVector<int,N> shape_type;
 
         const bob::core::array::typeinfo& info = px->type();
+        check<T,N>(info);
+
+        shape_type shape;
+        shape_type stride;
+        for (size_t k=0; k<info.nd; ++k) {
+          shape[k] = info.shape[k];
+          stride[k] = info.stride[k];
+        }
+
+        //finally, we return the wrapper.
+        return array_type((T*)px->ptr(), shape, stride, blitz::neverDeleteData);
+      }
+
+      /**
+       * @brief Returns a temporary blitz::Array<> skin over this ndarray
+       * that keeps the strides of the underlying NumPy array, so slices,
+       * transposes and reversed arrays are wrapped without copying.
+       *
+       * The same lifetime restrictions of bz() apply. The returned array may
+       * not be contiguous: do not use its data() pointer as a flat buffer.
+       */
+      template <typename T, int N> blitz::Array<T,N> view () {
+
+        typedef blitz::Array<T,N> array_type;
+        typedef blitz::TinyVector<int,N> shape_type;
+
+        const bob::core::array::typeinfo& info = px->type();
+        check<T,N>(info);
+
+        shape_type shape;
+        shape_type stride;
+        for (size_t k=0; k<info.nd; ++k) {
+          shape[k] = info.shape[k];
+          stride[k] = px->view_stride()[k];
+        }
+
+        return array_type((T*)px->view_ptr(), shape, stride, blitz::neverDeleteData);
+      }
+
+    private: //helpers
+
+      template <typename T, int N>
+      void check(const bob::core::array::typeinfo& info) const {
 
         if (info.nd != N) {
           boost::format mesg("cannot wrap numpy.ndarray(%s,%d) as blitz::Array<%s,%s> - dimensions do not match");
@@ -546,15 +658,6 @@ namespace bob { namespace python {
           throw std::runtime_error(mesg.str().c_str());
         }
 
-        shape_type shape;
-        shape_type stride;
-        for (size_t k=0; k<info.nd; ++k) {
-          shape[k] = info.shape[k];
-          stride[k] = info.stride[k];
-        }
-
-        //finally, we return the wrapper.
-        return array_type((T*)px->ptr(), shape, stride, blitz::neverDeleteData);
       }
 
     protected: //representation
@@ -614,33 +717,34 @@ namespace bob { namespace python {
           return bz<T,N>();
         }
 
-        // if we got here, we have to copy-cast
-        // call the correct version of the cast function
+        // if we got here, we have to copy-cast; the cast reads straight from
+        // the (possibly strided) original data, so only one copy is made.
+        bob::python::account_copy(info.buffer_size());
         switch(info.dtype){
           // boolean types
-          case bob::core::array::t_bool: return bob::core::array::cast<T>(bz<bool,N>());
+          case bob::core::array::t_bool: return bob::core::array::cast<T>(view<bool,N>());
 
           // integral types
-          case bob::core::array::t_int8: return bob::core::array::cast<T>(bz<int8_t,N>());
-          case bob::core::array::t_int16: return bob::core::array::cast<T>(bz<int16_t,N>());
-          case bob::core::array::t_int32: return bob::core::array::cast<T>(bz<int32_t,N>());
-          case bob::core::array::t_int64: return bob::core::array::cast<T>(bz<int64_t,N>());
+          case bob::core::array::t_int8: return bob::core::array::cast<T>(view<int8_t,N>());
+          case bob::core::array::t_int16: return bob::core::array::cast<T>(view<int16_t,N>());
+          case bob::core::array::t_int32: return bob::core::array::cast<T>(view<int32_t,N>());
+          case bob::core::array::t_int64: return bob::core::array::cast<T>(view<int64_t,N>());
 
           // unsigned integral types
-          case bob::core::array::t_uint8: return bob::core::array::cast<T>(bz<uint8_t,N>());
-          case bob::core::array::t_uint16: return bob::core::array::cast<T>(bz<uint16_t,N>());
-          case bob::core::array::t_uint32: return bob::core::array::cast<T>(bz<uint32_t,N>());
-          case bob::core::array::t_uint64: return bob::core::array::cast<T>(bz<uint64_t,N>());
+          case bob::core::array::t_uint8: return bob::core::array::cast<T>(view<uint8_t,N>());
+          case bob::core::array::t_uint16: return bob::core::array::cast<T>(view<uint16_t,N>());
+          case bob::core::array::t_uint32: return bob::core::array::cast<T>(view<uint32_t,N>());
+          case bob::core::array::t_uint64: return bob::core::array::cast<T>(view<uint64_t,N>());
 
           // floating point types
-          case bob::core::array::t_float32: return bob::core::array::cast<T>(bz<float,N>());
-          case bob::core::array::t_float64: return bob::core::array::cast<T>(bz<double,N>());
-          case bob::core::array::t_float128: return bob::core::array::cast<T>(bz<long double,N>());
+          case bob::core::array::t_float32: return bob::core::array::cast<T>(view<float,N>());
+          case bob::core::array::t_float64: return bob::core::array::cast<T>(view<double,N>());
+          case bob::core::array::t_float128: return bob::core::array::cast<T>(view<long double,N>());
 
           // complex types
-          case bob::core::array::t_complex64: return bob::core::array::cast<T>(bz<std::complex<float>,N>());
-          case bob::core::array::t_complex128: return bob::core::array::cast<T>(bz<std::complex<double>,N>());
-          case bob::core::array::t_complex256: return bob::core::array::cast<T>(bz<std::complex<long double>,N>());
+          case bob::core::array::t_complex64: return bob::core::array::cast<T>(view<std::complex<float>,N>());
+          case bob::core::array::t_complex128: return bob::core::array::cast<T>(view<std::complex<double>,N>());
+          case bob::core::array::t_complex256: return bob::core::array::cast<T>(view<std::complex<long double>,N>());
 
           default: throw std::runtime_error("cast to the given (unknown) data type is not possible yet");
         }
@@ -17,6 +17,7 @@
 
 #include <vector>
 #include <bob/machine/LinearMachine.h>
+#include <bob/math/ScatterAccumulator.h>
 
 namespace bob { namespace trainer {
 
@@ -146,7 +147,43 @@ namespace bob { namespace trainer {
        */
       size_t output_size(const std::vector<blitz::Array<double,2> >& X) const;
 
+      /**
+       * @brief Trains the LinearMachine to perform Fisher/LDA discrimination
+       * from the scatter matrices accumulated on the data of each class,
+       * which does not need to be loaded in memory.
+       *
+       * Each accumulator represents data from a given input class.
+       */
+      void train(bob::machine::LinearMachine& machine,
+          const std::vector<bob::math::ScatterAccumulator>& classes) const;
+
+      /**
+       * @brief Trains the LinearMachine to perform Fisher/LDA discrimination
+       * from the scatter matrices accumulated on the data of each class, and
+       * returns the eigen values of the covariance matrix product.
+       *
+       * Each accumulator represents data from a given input class.
+       */
+      void train(bob::machine::LinearMachine& machine,
+          blitz::Array<double,1>& eigen_values,
+          const std::vector<bob::math::ScatterAccumulator>& classes) const;
+
+      /**
+       * @brief Returns the expected size of the output given the
+       * accumulators of each class.
+       */
+      size_t output_size(const std::vector<bob::math::ScatterAccumulator>& classes) const;
+
     private:
+      /**
+       * @brief Sets up the machine from the within and between class scatter
+       * matrices and the overall mean. Sw and Sb are overwritten.
+       */
+      void setupMachine(bob::machine::LinearMachine& machine,
+          blitz::Array<double,1>& eigen_values, blitz::Array<double,2>& Sw,
+          blitz::Array<double,2>& Sb, const blitz::Array<double,1>& preMean,
+          const int osize) const;
+
       bool m_use_pinv; ///< use the 'pinv' method for LDA
       bool m_strip_to_rank; ///< return rank or full matrix
   };
@@ -165,6 +165,21 @@ namespace bob { namespace trainer {
        */
       inline void setTrainBiases(bool v) { m_train_bias = v; }
 
+      /**
+       * @brief Gets the number of threads used by forward_step() and
+       * backward_step() (defaults to 1)
+       */
+      inline size_t getNThreads() const { return m_n_threads; }
+
+      /**
+       * @brief Sets the number of threads used by forward_step() and
+       * backward_step(). The examples of a batch are split into contiguous
+       * blocks, one per thread, and the derivatives computed on each block
+       * are summed up at the end. The results do not depend on this setting,
+       * up to rounding errors.
+       */
+      void setNThreads(size_t n_threads);
+
       /**
        * @brief Checks if a given machine is compatible with my inner settings.
        */
@@ -291,11 +306,36 @@ namespace bob { namespace trainer {
        */
       void reset();
 
+      /**
+       * @brief Forwards the examples [begin,end[ of the batch, filling the
+       * corresponding rows of the m_output buffers.
+       */
+      void forward_rows(const bob::machine::MLP& machine,
+        const blitz::Array<double,2>& input, int begin, int end);
+
+      /**
+       * @brief Back-propagates the examples [begin,end[ of the batch, filling
+       * the corresponding rows of the m_error buffers. The contributions of
+       * these examples to the derivatives are stored in deriv and deriv_bias.
+       */
+      void backward_rows(const bob::machine::MLP& machine,
+        const blitz::Array<double,2>& input,
+        const blitz::Array<double,2>& target, int begin, int end,
+        std::vector<blitz::Array<double,2> >& deriv,
+        std::vector<blitz::Array<double,1> >& deriv_bias);
+
+      /**
+       * @brief Resizes the derivative buffers of the threads other than the
+       * first one (which uses m_deriv and m_deriv_bias directly)
+       */
+      void resize_thread_buffers();
+
       /// training parameters:
       size_t m_batch_size; ///< the batch size
       boost::shared_ptr<bob::trainer::Cost> m_cost; ///< cost function to be minimized
       bool m_train_bias; ///< shall we be training biases? (default: true)
       size_t m_H; ///< number of hidden layers on the target machine
+      size_t m_n_threads; ///< number of threads used for a batch
 
       std::vector<blitz::Array<double,2> > m_deriv; ///< derivatives of the cost wrt. the weights
       std::vector<blitz::Array<double,1> > m_deriv_bias; ///< derivatives of the cost wrt. the biases
@@ -303,6 +343,10 @@ namespace bob { namespace trainer {
       /// buffers that are dependent on the batch_size
       std::vector<blitz::Array<double,2> > m_error; ///< error (+deltas)
       std::vector<blitz::Array<double,2> > m_output; ///< layer output
+
+      /// partial derivatives computed by the threads 1..m_n_threads-1
+      std::vector<std::vector<blitz::Array<double,2> > > m_thread_deriv;
+      std::vector<std::vector<blitz::Array<double,1> > > m_thread_deriv_bias;
   };
 
   /**
@@ -16,6 +16,7 @@
 
 #include <blitz/array.h>
 #include <bob/machine/LinearMachine.h>
+#include <bob/math/ScatterAccumulator.h>
 
 namespace bob { namespace trainer {
 
@@ -129,6 +130,24 @@ namespace bob { namespace trainer {
           blitz::Array<double,1>& eigen_values,
           const blitz::Array<double,2>& X) const;
 
+      /**
+       * @brief Trains the LinearMachine to perform the KLT from the mean and
+       * the scatter matrix accumulated on the data set, which does not need
+       * to be loaded in memory. The Covariance Method is always used.
+       */
+      virtual void train(bob::machine::LinearMachine& machine,
+          const bob::math::ScatterAccumulator& stats) const;
+
+      /**
+       * @brief Trains the LinearMachine to perform the KLT from the mean and
+       * the scatter matrix accumulated on the data set, and returns the eigen
+       * values of the covariance matrix. The Covariance Method is always
+       * used.
+       */
+      virtual void train(bob::machine::LinearMachine& machine,
+          blitz::Array<double,1>& eigen_values,
+          const bob::math::ScatterAccumulator& stats) const;
+
       /**
        * @brief Calculates the maximum possible rank for the covariance matrix
        * of X, given X.
@@ -139,6 +158,12 @@ namespace bob { namespace trainer {
        */
       size_t output_size(const blitz::Array<double,2>& X) const;
 
+      /**
+       * @brief Calculates the maximum possible rank for the covariance matrix
+       * of the accumulated data.
+       */
+      size_t output_size(const bob::math::ScatterAccumulator& stats) const;
+
     private: //representation
 
       bool m_use_svd; ///< if this trainer should be using SVD or Covariance
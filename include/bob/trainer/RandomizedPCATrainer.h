@@ -0,0 +1,181 @@
+/**
+ * @file bob/trainer/RandomizedPCATrainer.h
+ * @date Sun Oct 19 10:24:51 2026 +0200
+ *
+ * @brief Truncated Principal Component Analysis based on randomized range
+ * finding, for large and high-dimensional data sets.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_TRAINER_RANDOMIZED_PCA_TRAINER_H
+#define BOB_TRAINER_RANDOMIZED_PCA_TRAINER_H
+
+#include <stdint.h>
+#include <blitz/array.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/random.hpp>
+#include <bob/machine/LinearMachine.h>
+
+namespace bob { namespace trainer {
+
+  /**
+   * @ingroup TRAINER
+   * @{
+   */
+
+  /**
+   * @brief A data set which is read block of rows by block of rows (each
+   * sample is a row, each feature is a column), e.g. from a file that does
+   * not fit in memory. The blocks are read several times, and should be the
+   * same at each pass.
+   */
+  class BlockSource
+  {
+    public:
+      virtual ~BlockSource() {}
+
+      /**
+       * @brief The dimensionality of the samples
+       */
+      virtual size_t getNFeatures() const =0;
+
+      /**
+       * @brief Restarts from the first block
+       */
+      virtual void rewind() =0;
+
+      /**
+       * @brief Reads the next block into the given array (which is resized
+       * if required), and returns false when there is no block left.
+       */
+      virtual bool next(blitz::Array<double,2>& block) =0;
+  };
+
+  /**
+   * @brief Sets a linear machine to perform a truncated Principal Component
+   * Analysis, which only extracts the given number of leading components.
+   *
+   * The range of the covariance matrix is found by randomized power
+   * iterations, and the components are extracted from a small eigen value
+   * problem on this range (Rayleigh-Ritz), see:
+   *   "Finding structure with randomness: Probabilistic algorithms for
+   *   constructing approximate matrix decompositions", N. Halko, P. G.
+   *   Martinsson and J. A. Tropp, SIAM Review 53(2), 2011.
+   *
+   * Neither the covariance matrix nor its full eigen decomposition is
+   * computed: each pass over the data only requires products of blocks of
+   * samples with (n_features x (rank+oversampling)) matrices. The data is
+   * read 3 + n_iterations times, and may be given block by block with a
+   * BlockSource.
+   */
+  class RandomizedPCATrainer
+  {
+    public: //api
+
+      /**
+       * @brief Initializes a new trainer
+       * @param rank The number of components to extract
+       * @param oversampling The number of additional random directions used
+       *   to find the range of the covariance matrix
+       * @param n_iterations The number of power iterations, which improve
+       *   the accuracy when the eigen values decrease slowly
+       */
+      RandomizedPCATrainer(const size_t rank, const size_t oversampling=10,
+          const size_t n_iterations=2);
+
+      /**
+       * @brief Copy constructor
+       */
+      RandomizedPCATrainer(const RandomizedPCATrainer& other);
+
+      /**
+       * @brief Destructor
+       */
+      virtual ~RandomizedPCATrainer();
+
+      /**
+       * @brief Assignment
+       */
+      RandomizedPCATrainer& operator=(const RandomizedPCATrainer& other);
+
+      /**
+       * @brief Equal to
+       */
+      bool operator==(const RandomizedPCATrainer& other) const;
+
+      /**
+       * @brief Not equal to
+       */
+      bool operator!=(const RandomizedPCATrainer& other) const;
+
+      /**
+       * @brief Getters and setters
+       */
+      size_t getRank() const { return m_rank; }
+      void setRank(const size_t rank);
+      size_t getOversampling() const { return m_oversampling; }
+      void setOversampling(const size_t oversampling)
+      { m_oversampling = oversampling; }
+      size_t getNIterations() const { return m_n_iterations; }
+      void setNIterations(const size_t n_iterations)
+      { m_n_iterations = n_iterations; }
+
+      /**
+       * @brief Sets the Random Number Generator
+       */
+      void setRng(const boost::shared_ptr<boost::mt19937> rng)
+      { m_rng = rng; }
+
+      /**
+       * @brief Gets the Random Number Generator
+       */
+      const boost::shared_ptr<boost::mt19937> getRng() const
+      { return m_rng; }
+
+      /**
+       * @brief Trains the LinearMachine to extract the rank leading
+       * components of X, arranged by decreasing eigen value. The machine
+       * should have X.extent(1) inputs and rank outputs.
+       */
+      void train(bob::machine::LinearMachine& machine,
+          const blitz::Array<double,2>& X) const;
+
+      /**
+       * @brief Trains the LinearMachine to extract the rank leading
+       * components of X, and returns the corresponding eigen values of the
+       * covariance matrix.
+       */
+      void train(bob::machine::LinearMachine& machine,
+          blitz::Array<double,1>& eigen_values,
+          const blitz::Array<double,2>& X) const;
+
+      /**
+       * @brief Trains the LinearMachine to extract the rank leading
+       * components of the data read from the given source, and returns the
+       * corresponding eigen values of the covariance matrix.
+       */
+      void train(bob::machine::LinearMachine& machine,
+          blitz::Array<double,1>& eigen_values, BlockSource& data) const;
+
+    private: //representation
+
+      /**
+       * @brief Computes Y = (X-mean)^T (X-mean) Q over all the blocks of
+       * the data
+       */
+      void multiply(BlockSource& data, const blitz::Array<double,1>& mean,
+          const blitz::Array<double,2>& Q, blitz::Array<double,2>& Y) const;
+
+      size_t m_rank; ///< the number of components to extract
+      size_t m_oversampling; ///< the number of additional random directions
+      size_t m_n_iterations; ///< the number of power iterations
+      boost::shared_ptr<boost::mt19937> m_rng; ///< for the random directions
+  };
+
+  /**
+   * @}
+   */
+}}
+
+#endif /* BOB_TRAINER_RANDOMIZED_PCA_TRAINER_H */
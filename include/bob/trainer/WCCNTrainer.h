@@ -12,6 +12,7 @@
 
 #include "Trainer.h"
 #include <bob/machine/LinearMachine.h>
+#include <bob/math/ScatterAccumulator.h>
 #include <blitz/array.h>
 
 namespace bob { namespace trainer {
@@ -79,6 +80,21 @@ class WCCNTrainer: public Trainer<bob::machine::LinearMachine, std::vector<blitz
     virtual void train(bob::machine::LinearMachine& machine, 
         const std::vector<blitz::Array<double, 2> >& data);
 
+    /**
+     * @brief Trains the LinearMachine to perform the WCCN, from the scatter
+     * matrices accumulated on the data of each class
+     */
+    virtual void train(bob::machine::LinearMachine& machine, 
+        const std::vector<bob::math::ScatterAccumulator>& classes);
+
+  private:
+    /**
+     * @brief Sets up the machine from the within class scatter matrix Sw,
+     * which is overwritten
+     */
+    void setupMachine(bob::machine::LinearMachine& machine,
+        blitz::Array<double,2>& Sw, const size_t n_classes);
+
   private: //representation
 };
 
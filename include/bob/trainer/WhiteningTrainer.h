@@ -11,6 +11,7 @@
 
 #include "Trainer.h"
 #include <bob/machine/LinearMachine.h>
+#include <bob/math/ScatterAccumulator.h>
 #include <blitz/array.h>
 
 namespace bob { namespace trainer {
@@ -74,6 +75,21 @@ class WhiteningTrainer: public Trainer<bob::machine::LinearMachine, blitz::Array
     virtual void train(bob::machine::LinearMachine& machine, 
         const blitz::Array<double,2>& data);
 
+    /**
+     * @brief Trains the LinearMachine to perform the Whitening, from the
+     * mean and the scatter matrix accumulated on the training set
+     */
+    virtual void train(bob::machine::LinearMachine& machine, 
+        const bob::math::ScatterAccumulator& stats);
+
+  private:
+    /**
+     * @brief Sets up the machine from the mean and the covariance matrix of
+     * the training set
+     */
+    void setupMachine(bob::machine::LinearMachine& machine,
+        const blitz::Array<double,1>& mean, const blitz::Array<double,2>& cov);
+
   private: //representation
 };
 
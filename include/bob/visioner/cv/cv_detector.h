@@ -15,17 +15,10 @@
 
 #include "bob/visioner/model/model.h"
 #include "bob/visioner/util/geom.h"
+#include "bob/visioner/cv/cv_nms.h"
 
 namespace bob { namespace visioner {
 
-  // Detection: score + region (at the original scale) + label index
-  typedef std::pair<double, std::pair<QRectF, int> >	detection_t;
-
-  inline detection_t make_detection(double score, const QRectF& reg, int ilabel)
-  {
-    return std::make_pair(score, std::make_pair(reg, ilabel));
-  }
-
   /////////////////////////////////////////////////////////////////////////////////////////
   // Object detector that processes a pyramid of images:
   //	::scan()	-> return the object detections (thresholded & clustered)
@@ -33,6 +26,11 @@ namespace bob { namespace visioner {
   //	::evaluate()	-> computes TPs/FAs ROC curve
   //
   // NB: It can be used to detect multiple object types.
+  //
+  // NB: In tracking mode (video processing), the pyramid is fully scanned only
+  //	every <m_rescan> frames (or when there is nothing to track): otherwise
+  //	only the neighbourhood (location + nearby scales) of the detections of
+  //	the previous frame is scanned.
   /////////////////////////////////////////////////////////////////////////////////////////
 
   class CVDetector
@@ -44,7 +42,8 @@ namespace bob { namespace visioner {
       {
         // Constructor
         stats_t()
-          :       m_gts(0), m_sws(0), m_evals(0), m_timing(0.0)
+          :       m_gts(0), m_sws(0), m_evals(0), m_timing(0.0),
+                  m_frames(0), m_tracked(0)
         {                                
         }
 
@@ -56,6 +55,10 @@ namespace bob { namespace visioner {
         uint64_t         m_sws;          // #SWs processed (in total)
         uint64_t         m_evals;        // #LUT evaluations (in total)
         double        m_timing;       // total 
+        std::vector<uint64_t> m_level_sws;   // #SWs evaluated at each level
+        std::vector<uint64_t> m_level_evals; // #LUT evaluations at each level
+        uint64_t         m_frames;       // #images scanned
+        uint64_t         m_tracked;      //	only around the previous detections
       };
 
       enum Type
@@ -79,6 +82,8 @@ namespace bob { namespace visioner {
           Type detection_method=GroundTruth);
 
       // Load an image (build the image pyramid)
+      // NB: In incremental mode, the integral images of all scales are also
+      //	computed here (in parallel), @see ipyramid_t
       bool load(const std::string& ifile, const std::string& gfile);
       bool load(const ipscale_t& ipscale);
       bool load(const uint8_t* image, uint64_t rows, uint64_t cols);
@@ -102,6 +107,12 @@ namespace bob { namespace visioner {
       void evaluate(const std::vector<std::string>& ifiles, const std::vector<std::string>& gfiles,
           std::vector<double>& fas, std::vector<double>& tars);
 
+      // Calibrate the rejection thresholds after each level such that the
+      //	given fraction of the detections on the validation images is kept
+      //	(NB: the thresholds are stored in the model)
+      bool calibrate(const std::vector<std::string>& ifiles, const std::vector<std::string>& gfiles,
+          double recall);
+
       // Check the validity of different components
       bool valid() const;
       bool valid_model() const;
@@ -117,11 +128,22 @@ namespace bob { namespace visioner {
       uint64_t n_outputs() const { return m_model->n_outputs(); }
       int find(const Object& obj) const { return param().find(obj.type()); }
       const stats_t& stats() const { return m_stats; }
+      void reset_stats() { m_stats = stats_t(); }
       static double MinOverlap() { return 0.50; }	
 
       // Getters and setters
       void set_scan_levels(uint64_t levels);
       uint64_t get_scan_levels() const { return m_levels; }
+      void set_incremental(bool incremental) { m_ipyramid.set_incremental(incremental); }
+      bool get_incremental() const { return m_ipyramid.incremental(); }
+      void set_calibrated(bool calibrated);
+      bool get_calibrated() const { return m_calibrated; }
+      void set_tracking(bool tracking);
+      bool get_tracking() const { return m_tracking; }
+
+      // Forget the detections of the previous frame (tracking mode), such
+      //	that the next image is fully scanned
+      void reset_tracking();
 
       // Process detections
       static void sort_asc(std::vector<detection_t>& detections);
@@ -150,8 +172,23 @@ namespace bob { namespace visioner {
 
     private:
 
+      // Finalize the image pyramid after loading a new image
+      bool loaded(bool ok);
+
+      // Score the <x, y> sub-window (at the current scale) with the level
+      //	classifiers of the given output: returns false if it is rejected
+      //	by a calibrated threshold (its partial score is then meaningless)
+      bool classify(uint64_t output, int x, int y, double& score) const;
+
+      // Scan the whole pyramid or only the given sub-windows (sorted by scale)
+      void scan_pyramid(std::vector<detection_t>& detections) const;
+      void scan_subwindows(const std::vector<subwindow_t>& sws,
+          std::vector<detection_t>& detections) const;
+
+      // Sub-windows in the neighbourhood of the detections of the previous frame
+      void track(std::vector<subwindow_t>& sws) const;
+
       static void threshold(std::vector<detection_t>& detections, double thres);
-      static void cluster(std::vector<detection_t>& detections, double thres, uint64_t n_outputs);                 
 
       // Compute the ROC - the number of true positives and false alarms
       //	for the <min_score + t * delta_score, t < n_thress> threshold values.
@@ -163,17 +200,27 @@ namespace bob { namespace visioner {
 
       uint64_t  m_ds;        ///< Scanning resolution
       double m_cluster;	  ///< NMS threshold
+      NMSMethod m_nms;      ///< NMS method
       double m_threshold;	///< Detection threshold
       Type     m_type;      ///< Mode: scanning vs. GT
+      uint64_t  m_rescan;    ///< Tracking: full scan every <m_rescan> frames
+      uint64_t  m_track_range; ///< Tracking: neighbourhood size (in scanning steps)
 
     private: //attributes
 
       boost::shared_ptr<Model>    m_model;	       ///< Object classifier(s)
       Matrix<uint64_t> m_lmodel_begins; ///< Level classifiers for each output:
       Matrix<uint64_t> m_lmodel_ends;   ///< [begin, end) LUT range
+      Matrix<double> m_lrejections;   ///< Minimum score before each level
+      std::vector<bool> m_ocalibrated; ///< Calibrated rejections for each output?
       uint64_t			m_levels;	       ///< number of levels (speed-up scanning)
+      bool     m_calibrated;          ///< Use the calibrated rejection thresholds
       ipyramid_t  m_ipyramid;	     ///< Pyramid of images
       mutable stats_t m_stats;     ///< Scanning statistics
+      bool     m_tracking;            ///< Scan around the previous detections
+      mutable std::vector<detection_t> m_tracks; ///< Detections of the previous frame
+      mutable uint64_t m_track_frames;  ///< Frames since the last full scan
+      mutable uint64_t m_track_rows, m_track_cols; ///< Size of the previous frame
 
   };
 
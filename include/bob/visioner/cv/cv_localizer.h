@@ -51,6 +51,13 @@ namespace bob { namespace visioner {
       bool locate(const CVDetector& detector,
           const QRectF& reg, std::vector<QPointF>& points) const;
 
+      // Predict the location of the keypoints in the <reg> region, initialized
+      //	with the keypoints <init> predicted at the previous frame (video):
+      //	the multiple shots are taken from a smaller neighbourhood and
+      //	combined with the previous keypoints.
+      bool locate(const CVDetector& detector, const QRectF& reg,
+          const std::vector<QPointF>& init, std::vector<QPointF>& points) const;
+
       // Compute the normalized distances [0.0 - 1.0] between
       //	each ground truth keypoints and its predicted points.
       void evaluate(const std::vector<std::string>& ifiles, const std::vector<std::string>& gfiles,
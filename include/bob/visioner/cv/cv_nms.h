@@ -0,0 +1,73 @@
+/**
+ * @file bob/visioner/cv/cv_nms.h
+ * @date Sun 19 Oct 2026 14:05:31 CEST
+ *
+ * @brief Non-maximum suppression of object detections, comparing only the
+ * detections that are close in location and scale.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_VISIONER_CV_NMS_H
+#define BOB_VISIONER_CV_NMS_H
+
+#include <string>
+#include <vector>
+
+#include "bob/visioner/util/geom.h"
+
+namespace bob { namespace visioner {
+
+  // Detection: score + region (at the original scale) + label index
+  typedef std::pair<double, std::pair<QRectF, int> >	detection_t;
+
+  inline detection_t make_detection(double score, const QRectF& reg, int ilabel)
+  {
+    return std::make_pair(score, std::make_pair(reg, ilabel));
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+  // Non-maximum suppression (NMS) of the detections of each output:
+  //	NMSGreedy	-> the detections are processed by decreasing score and each
+  //			one removes the remaining ones that overlap it by at least
+  //			the given threshold
+  //	NMSAverage	-> as NMSGreedy, but the region of each kept detection is
+  //			the average of its region and of the ones it removes
+  //	NMSSoft		-> the overlapping detections are not removed, but their
+  //			scores decay (by <overlap * |score|>) and they are
+  //			removed only if their score falls below <min_score>
+  //			(soft-NMS, Bodla et al., ICCV 2017)
+  //
+  // NB: The detections are indexed in a grid for each band of scales (of
+  //	half an octave in area), such that only the detections that may
+  //	overlap by at least the threshold are compared. The result of NMSGreedy
+  //	is the same as comparing all the pairs of detections.
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  enum NMSMethod
+  {
+    NMSGreedy,
+    NMSAverage,
+    NMSSoft
+  };
+
+  // Decode a NMS method from its name (greedy, average, soft)
+  bool decode_nms(const std::string& name, NMSMethod& method);
+
+  // Suppress the overlapping detections: the result is sorted by output and
+  //	then by decreasing score (NB: a threshold of at least 1.0 deactivates
+  //	the suppression)
+  void nms(std::vector<detection_t>& detections, double thres, uint64_t n_outputs,
+      NMSMethod method = NMSGreedy, double min_score = 0.0);
+
+  // Reference greedy NMS, comparing all the pairs of detections
+  void nms_pairwise(std::vector<detection_t>& detections, double thres, uint64_t n_outputs);
+
+  // Save/load detections to/from a text file (one detection per line:
+  //	score, x, y, width, height and label index)
+  bool save_detections(const std::string& path, const std::vector<detection_t>& detections);
+  bool load_detections(const std::string& path, std::vector<detection_t>& detections);
+
+}}
+
+#endif // BOB_VISIONER_CV_NMS_H
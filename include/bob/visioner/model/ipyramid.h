@@ -13,6 +13,8 @@
 #ifndef BOB_VISIONER_IPYRAMID_H
 #define BOB_VISIONER_IPYRAMID_H
 
+#include <boost/shared_ptr.hpp>
+
 #include "bob/visioner/vision/object.h"
 #include "bob/visioner/vision/image.h"
 #include "bob/visioner/model/param.h"
@@ -50,9 +52,21 @@ namespace bob { namespace visioner {
       // Scale an image and its ground truth
       void scale(double sfactor, ipscale_t& dst) const;
 
+      // Scale an image and its ground truth, and set the scanning
+      //	parameters of the scaled image (as in ipyramid_t)
+      void scale(double sfactor, const param_t& param, ipscale_t& dst) const;
+
+      // Check if the integral image matches the current grayscale image
+      bool integrated() const {
+        return m_iimage && m_iimage->rows() == m_image.rows() &&
+          m_iimage->cols() == m_image.cols() && !m_iimage->empty();
+      }
+
     public: //attributes
 
       Matrix<uint8_t>	m_image;	// Grayscale image
+      boost::shared_ptr<Matrix<uint32_t> >	m_iimage;	// Integral image (optional, @see ipyramid_t::integrate),
+      							//	shared with the models using it
       std::vector<Object>	m_objects;	// Ground truth data
 
       double	m_scale;	// Scale factor relative to the original image size		
@@ -68,6 +82,12 @@ namespace bob { namespace visioner {
 
   /**
    * A pyramid of scaled images.
+   *
+   * NB: In incremental mode, the scaled images are derived from the nearest
+   * level that is at least one octave larger (the first octave is built from
+   * the original image) using area averaging directly into the buffers of the
+   * previous frame. This is meant for processing video streams, where the
+   * same pyramid object is loaded with frames of the same size.
    */
   struct ipyramid_t : public Parametrizable {
 
@@ -101,13 +121,28 @@ namespace bob { namespace visioner {
       bool check(const subwindow_t& sw) const;
       bool check(const subwindow_t& sw, const param_t& param) const;
 
+      // Compute the integral images of all scales (using multiple threads)
+      void integrate(size_t threads = 0);
+
       // Access functions
       bool empty() const { return m_ipscales.empty(); }
       uint64_t size() const { return m_ipscales.size(); }
       const ipscale_t& operator[](uint64_t i) const { return m_ipscales[i]; }
+      bool incremental() const { return m_incremental; }
+      void set_incremental(bool incremental) { m_incremental = incremental; }
+
+      // Time (in seconds) spent building each scale with the last load()
+      // (and integrate()) call
+      const std::vector<double>& timings() const { return m_timings; }
 
     private:
 
+      // Build the scaled versions of the first (original) image
+      void build(const std::vector<double>& scales);
+
+      // Compute the integral images of every <n_threads>th scale
+      void integrate_mt(uint64_t ith, uint64_t n_threads);
+
       // Project a sub-window to another scale
       subwindow_t map(const subwindow_t& sw, int s, const param_t& param) const;
 
@@ -117,6 +152,8 @@ namespace bob { namespace visioner {
     private: // representation
 
       std::vector<ipscale_t>  m_ipscales; // Images at different scales        
+      std::vector<double>     m_timings;  // Build time for each scale
+      bool                    m_incremental; // Derive scales from each other
   };
 
 }}
@@ -74,6 +74,11 @@ namespace bob { namespace visioner {
       const std::vector<std::vector<LUT> >& luts() const { return m_mluts; }
       virtual std::vector<uint64_t> features() const;
 
+      // Calibrated rejection thresholds for scanning the model in levels
+      //	(for each output, one threshold after each level but the last one)
+      const std::vector<std::vector<double> >& rejections() const { return m_param.m_rejections; }
+      void set_rejections(const std::vector<std::vector<double> >& rejections) { m_param.m_rejections = rejections; }
+
       // Describe a feature
       virtual std::string describe(uint64_t f) const = 0;   
 
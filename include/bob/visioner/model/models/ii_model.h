@@ -35,15 +35,36 @@ namespace bob { namespace visioner {
       virtual ~IIModel() {}
 
       // Preprocess the current image
+      // NB: The integral image of the scaled image is shared if it was
+      //	already computed (@see ipyramid_t::integrate), such that it stays
+      //	valid if the pyramid is rebuilt or destroyed. Otherwise it is
+      //	computed in a private buffer (which is reused, unless it is shared
+      //	with a copy of this model).
       void preprocess(const ipscale_t& ipscale)
       {
-        integral(ipscale.m_image, m_iimage);
+        if (ipscale.integrated() == true)
+        {
+          m_iimage = ipscale.m_iimage;
+        }
+        else
+        {
+          if (m_iimage.unique() == false)
+          {
+            m_iimage.reset(new Matrix<uint32_t>);
+          }
+          integral(ipscale.m_image, *m_iimage);
+        }
       }
 
     protected:    
 
+      // Access the integral image of the current image
+      const Matrix<uint32_t>& iimage() const { return *m_iimage; }
+
+    private:
+
       // Attributes
-      Matrix<uint32_t>            m_iimage;       // Integral image
+      boost::shared_ptr<Matrix<uint32_t> >	m_iimage;	// Integral image in use
   };
 
 }}
@@ -65,7 +65,7 @@ namespace bob { namespace visioner {
       virtual uint64_t get(uint64_t f, int x, int y) const
       {
         const mb_t& mb = m_mbs[f];
-        return TLBPOp(m_iimage, x + mb.m_dx, y + mb.m_dy, mb.m_cx, mb.m_cy);
+        return TLBPOp(iimage(), x + mb.m_dx, y + mb.m_dy, mb.m_cx, mb.m_cy);
       }
 
       // Access functions
@@ -16,6 +16,8 @@
 #include <boost/program_options.hpp>
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
 
 #include "bob/visioner/model/ml.h"
 
@@ -70,7 +72,7 @@ namespace bob { namespace visioner {
       // Serialize the object
       friend class boost::serialization::access;
       template <typename Archive>
-        void serialize(Archive& ar, const unsigned int)
+        void serialize(Archive& ar, const unsigned int version)
         {
           std::string dummy_to_be_removed("dense");
 
@@ -95,6 +97,12 @@ namespace bob { namespace visioner {
           ar & m_min_gt_overlap;
           ar & m_ds;
           ar & m_tagger;
+
+          // NB: models saved before the cascade calibration do not have these
+          if (version > 0)
+          {
+            ar & m_rejections;
+          }
         }
 
     public: //representation
@@ -127,6 +135,8 @@ namespace bob { namespace visioner {
 
       uint64_t		m_ds;			// Sliding windows
       std::string	m_tagger;		// Labelling sub-windows		
+
+      std::vector<std::vector<double> >	m_rejections;	// Calibrated cascade rejection thresholds (for each output and level)
   };
 
   //////////////////////////////////////////////////////////////////////////////////////
@@ -160,4 +170,6 @@ namespace bob { namespace visioner {
 
 }}
 
+BOOST_CLASS_VERSION(bob::visioner::param_t, 1)
+
 #endif // BOB_VISIONER_PARAM_H
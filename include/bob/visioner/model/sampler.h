@@ -14,6 +14,7 @@
 #define BOB_VISIONER_SAMPLER_H
 
 #include <map>
+#include <string>
 #include <boost/random.hpp>
 #include <boost/random/uniform_real.hpp>
 
@@ -42,9 +43,19 @@ namespace bob { namespace visioner {
        * the maximum number of threads this sampler should be able to work with.
        * This parameter will be used to initialize N random generators (one for
        * each thread). A value of zero will initialize a single random number
-       * generator.
+       * generator. The images are loaded with the same number of threads.
+       *
+       * In lazy mode, only the original images (and their ground truth) are
+       * kept in memory, and the scaled images are generated again from them
+       * each time they are sampled or mapped. This trades some computation
+       * for much less memory on large datasets.
+       *
+       * If a cache file is given, the images and samples are restored from
+       * it if it was saved with the same list of files and loading
+       * parameters, otherwise they are loaded and saved to it, @see load().
        */
-      Sampler(const param_t& param, SamplerType type, size_t max_threads=0);
+      Sampler(const param_t& param, SamplerType type, size_t max_threads=0,
+          bool lazy=false, const std::string& cache=std::string());
 
       /**
        * Samples, approximately, the given number of samples (uniformly). The
@@ -97,9 +108,9 @@ namespace bob { namespace visioner {
           DataSet& data, size_t threads) const;
 
       /**
-       * The total number of images loaded
+       * The total number of (scaled) images loaded
        */
-      uint64_t n_images() const { return m_ipscales.size(); }
+      uint64_t n_images() const { return m_ipsbegins.size(); }
 
       /**
        * The total number of samples loaded, taking into consideration all
@@ -116,17 +127,37 @@ namespace bob { namespace visioner {
       uint64_t n_types() const { return m_n_types; }
 
       /**
-       * Grabs all images.
+       * Grabs all stored images: the scaled images, or the original images
+       * in lazy mode.
        */
       const std::vector<ipscale_t>& images() const { return m_ipscales; }
 
       /**
-       * Resets to a list of images and (matching) ground truth files. Note:
-       * This method is buggy and will only work after object initialization.
+       * Are the scaled images generated again each time they are used?
+       */
+      bool lazy() const { return m_lazy; }
+
+      /**
+       * Resets to a list of images and (matching) ground truth files. The
+       * files are loaded and tagged with as many threads as random number
+       * generators, and the samples are numbered in the order of the files
+       * whatever the number of threads.
        */
       void load(const std::vector<std::string>& ifiles, 
           const std::vector<std::string>& gfiles);
 
+      /**
+       * Resets to a list of images and (matching) ground truth files, using
+       * the given cache file: if it was saved with the same lists of files,
+       * model size, sliding windows, tagger, labels, overlap and lazy mode,
+       * it is restored instead of loading the files. Otherwise, the files
+       * are loaded and the cache file is (over)written. The cache is also
+       * invalidated when the size or the modification time of one of the
+       * files changes.
+       */
+      void load(const std::vector<std::string>& ifiles, 
+          const std::vector<std::string>& gfiles, const std::string& cache);
+
       /**
        * Returns the current sampler type.
        */
@@ -161,6 +192,15 @@ namespace bob { namespace visioner {
       // Map the given sample to image
       uint64_t sample2image(uint64_t s) const;
 
+      // Return the given scaled image (generated in <buffer> in lazy mode)
+      const ipscale_t& ipscale(uint64_t i, ipscale_t& buffer) const;
+
+      // Save/restore the loaded images and samples to/from a cache file
+      bool save(const std::string& path, const std::vector<std::string>& ifiles,
+          const std::vector<std::string>& gfiles) const;
+      bool restore(const std::string& path, const std::vector<std::string>& ifiles,
+          const std::vector<std::string>& gfiles);
+
       // Compute the error of the given sample
       double error(uint64_t x, uint64_t y, const std::vector<double>& targets, 
           const Model& model, std::vector<double>& scores) const;
@@ -174,6 +214,17 @@ namespace bob { namespace visioner {
       // Reset to a set of listfiles
       void load(const std::vector<std::string>& listfiles);
 
+      // Images and samples found in a single file
+      struct loaded_t;
+
+      /**
+       * Loading thread (every <n_threads>th file)
+       */
+      void th_load(uint64_t ith, uint64_t n_threads,
+          const std::vector<std::string>& ifiles,
+          const std::vector<std::string>& gfiles,
+          std::vector<loaded_t>& loaded) const;
+
       /**
        * Uniform sampling worker thread
        */
@@ -203,6 +254,7 @@ namespace bob { namespace visioner {
 
       param_t	m_param; ///< Model parameters
       SamplerType	m_type; ///< Training or Validation mode
+      bool m_lazy; ///< Scaled images generated again when used
 
       boost::shared_ptr<Tagger> m_tagger; ///< Sample labelling
       boost::shared_ptr<Loss> m_loss; ///< Loss
@@ -211,9 +263,11 @@ namespace bob { namespace visioner {
       uint64_t m_n_samples; //
       uint64_t m_n_types; ///< # of distinct target types
 
-      std::vector<ipscale_t> m_ipscales; ///< Input: image + annotations @ all scales
+      std::vector<ipscale_t> m_ipscales; ///< Input: image + annotations @ all scales (@ the original scale in lazy mode)
       std::vector<uint64_t> m_ipsbegins; ///< Sample interval [begin, end)
       std::vector<uint64_t> m_ipsends;   ///< for each scaled image
+      std::vector<uint64_t> m_ipsources; ///< Original image (lazy mode)
+      std::vector<double> m_ipsfactors;  ///< and scale factor, for each scaled image
 
       std::vector<uint64_t> m_tcounts; ///< # of times / distinct target type
       mutable std::vector<double> m_sprobs; ///< base sampling probability / distinct target type
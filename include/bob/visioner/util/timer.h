@@ -43,7 +43,7 @@ namespace bob { namespace visioner {
       double elapsed() const {
         const boost::posix_time::time_duration dt = 
           boost::posix_time::microsec_clock::local_time() - m_start;
-        return 0.001 * dt.total_milliseconds();
+        return 0.000001 * dt.total_microseconds();
       }
 
     private:
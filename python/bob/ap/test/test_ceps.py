@@ -450,3 +450,22 @@ class CepsTest(unittest.TestCase):
     self.assertFalse(c0 != c1)
     self.assertFalse(c0 == c2)
     self.assertTrue( c0 != c2)
+
+  def test_cepstral_threads(self):
+    import pkg_resources
+    rate_wavsample = _read(pkg_resources.resource_filename(__name__, os.path.join('data', 'sample.wav')))
+
+    c = bob.ap.Ceps(rate_wavsample[0])
+    c.with_energy = True
+    c.with_delta = True
+    c.with_delta_delta = True
+    ceps1 = c(rate_wavsample[1])
+    c.n_threads = 4
+    ceps4 = c(rate_wavsample[1])
+    self.assertTrue(numpy.array_equal(ceps1, ceps4))
+
+    s = bob.ap.Spectrogram(rate_wavsample[0])
+    spec1 = s(rate_wavsample[1])
+    s.n_threads = 3
+    spec3 = s(rate_wavsample[1])
+    self.assertTrue(numpy.array_equal(spec1, spec3))
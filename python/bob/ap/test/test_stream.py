@@ -0,0 +1,67 @@
+#!/usr/bin/env python
+# vim: set fileencoding=utf-8 :
+#
+# Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+
+"""Tests the streaming audio feature extraction
+"""
+
+import os
+import unittest
+import bob
+import numpy
+
+def _read(filename):
+  import scipy.io.wavfile
+  rate, data = scipy.io.wavfile.read(str(filename)) # the data is read in its native format
+  if data.dtype =='int16':
+    data = numpy.cast['float'](data)
+  return [rate,data]
+
+def _stream(extractor, data, chunk_sizes):
+  """Feeds the data to a stream, in chunks of the given (cycled) sizes"""
+
+  stream = bob.ap.FeatureStream(extractor)
+  rows = []
+  start = 0
+  k = 0
+  while start < len(data):
+    size = chunk_sizes[k % len(chunk_sizes)]
+    rows.append(stream.process(data[start:start+size]))
+    start += size
+    k += 1
+  rows.append(stream.flush())
+  return numpy.vstack(rows)
+
+class FeatureStreamTest(unittest.TestCase):
+  """Performs various tests for the bob.ap.FeatureStream object"""
+
+  def setUp(self):
+    import pkg_resources
+    self.rate, self.data = _read(pkg_resources.resource_filename(__name__, os.path.join('data', 'sample.wav')))
+    self.chunk_sizes = [1, 17, 160, 1000, 3, 4096]
+
+  def test01_energy(self):
+    e = bob.ap.Energy(self.rate)
+    features = _stream(e, self.data, self.chunk_sizes)
+    self.assertTrue(numpy.allclose(features[:,0], e(self.data)))
+
+  def test02_spectrogram(self):
+    s = bob.ap.Spectrogram(self.rate, 20., 25.) # shift larger than the window
+    features = _stream(s, self.data, self.chunk_sizes)
+    self.assertTrue(numpy.allclose(features, s(self.data)))
+
+  def test03_ceps(self):
+    c = bob.ap.Ceps(self.rate)
+    c.with_energy = True
+    c.with_delta = True
+    c.with_delta_delta = True
+    stream = bob.ap.FeatureStream(c)
+    self.assertEqual(stream.n_features, c.get_shape(self.data)[1])
+    features = _stream(c, self.data, self.chunk_sizes)
+    self.assertTrue(numpy.allclose(features, c(self.data)))
+
+    # A row is returned as soon as its derivatives can be computed
+    first = stream.process(self.data[:c.win_length + 2*c.delta_win*c.win_shift])
+    self.assertEqual(first.shape, (1, stream.n_features))
+    self.assertTrue(numpy.allclose(first, features[:1]))
@@ -408,3 +408,28 @@ def test_append_compression():
   finally:
 
     os.unlink(tmpname)
+
+def test_chunked_range_read():
+
+  try:
+
+    tmpname = testutils.temporary_filename()
+    outfile = HDF5File(tmpname, 'w')
+    outfile.chunk_size = 64*1024
+    outfile.shuffle = True
+    data = numpy.random.random((500,8))
+    for k in range(len(data)): outfile.append('data', data[k], compression=1)
+    for k in range(len(data)): outfile.append('scalars', float(k))
+    outfile.set_chunk_cache(521, 1024*1024, 1.)
+    assert numpy.array_equal(data, outfile.lread_range('data', 0))
+    assert numpy.array_equal(data[100:110], outfile.lread_range('data', 100, 10))
+    assert numpy.array_equal(numpy.arange(5, 10, dtype=float),
+        outfile.lread_range('scalars', 5, 5))
+    recovered = outfile.lread('data')
+    assert len(recovered) == len(data)
+    for k in range(len(data)): assert numpy.array_equal(data[k], recovered[k])
+    del outfile
+
+  finally:
+
+    os.unlink(tmpname)
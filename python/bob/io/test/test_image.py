@@ -16,6 +16,7 @@ from ...test import utils as testutils
 
 # These are some global parameters for the test.
 PNG_INDEXED_COLOR = testutils.datafile('img_indexed_color.png', __name__)
+JPEG = testutils.datafile('test.jpg', __name__)
 
 def test_png_indexed_color():
 
@@ -25,3 +26,123 @@ def test_png_indexed_color():
   assert img.shape == (3,22,32)
   assert img[0,0,0] == 255
   assert img[0,17,17] == 117
+
+def test_image_load_options():
+
+  from .. import load, File, ImageLoadOptions, decode
+
+  # PNG: downscaled by averaging blocks of pixels, and grayscale
+  img = load(PNG_INDEXED_COLOR)
+  half = File(PNG_INDEXED_COLOR, ImageLoadOptions(scale_denom=2)).read()
+  assert half.shape == (3,11,16)
+  sums = img.astype('uint32').reshape(3,11,2,16,2).sum(axis=4).sum(axis=2)
+  assert numpy.array_equal(half, (sums + 2) // 4)
+  assert File(PNG_INDEXED_COLOR, ImageLoadOptions(min_size=10)).read().shape == (3,11,16)
+  gray = File(PNG_INDEXED_COLOR, ImageLoadOptions(gray=True)).read()
+  assert gray.shape == (22,32)
+
+  # JPEG: downscaled in the DCT domain, and grayscale
+  img = load(JPEG)
+  half = File(JPEG, ImageLoadOptions(scale_denom=2)).read()
+  assert half.shape[-2:] == tuple((k+1)//2 for k in img.shape[-2:])
+  gray = File(JPEG, ImageLoadOptions(gray=True)).read()
+  assert gray.shape == img.shape[-2:]
+  assert numpy.array_equal(File(JPEG, ImageLoadOptions(scanlines=1)).read(), img)
+
+  # Decoding from memory
+  data = open(JPEG, 'rb').read()
+  assert numpy.array_equal(decode(data, '.jpg').read(), img)
+  assert numpy.array_equal(decode(data, '.jpg', ImageLoadOptions(scale_denom=2)).read(), half)
+
+  # Invalid options
+  try:
+    ImageLoadOptions(scale_denom=3)
+    assert False, "a scale denominator of 3 should not be accepted"
+  except RuntimeError:
+    pass
+
+def write_png16(filename, img):
+  """Writes a 16-bit RGB PNG file by hand, with its samples in network
+  (big-endian) byte order as the PNG specification requires"""
+
+  import zlib
+  import struct
+  def chunk(tag, data):
+    crc = zlib.crc32(tag + data) & 0xffffffff
+    return struct.pack('>I', len(data)) + tag + data + struct.pack('>I', crc)
+  height, width = img.shape[1:]
+  rows = [b'\x00' + img[:,y,:].T.astype('>u2').tostring() for y in range(height)]
+  f = open(filename, 'wb')
+  f.write(b'\x89PNG\r\n\x1a\n')
+  f.write(chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, 16, 2, 0, 0, 0)))
+  f.write(chunk(b'IDAT', zlib.compress(b''.join(rows))))
+  f.write(chunk(b'IEND', b''))
+  f.close()
+
+def test_png_16bit():
+
+  # 16-bit samples are decoded in the byte order of the host, also when the
+  # image is downscaled, and written back in network byte order
+  from .. import load, save, File, ImageLoadOptions
+  numpy.random.seed(4)
+  img = numpy.random.randint(0, 65536, (3,22,32)).astype('uint16')
+  tmpname = testutils.temporary_filename(suffix='.png')
+  try:
+    write_png16(tmpname, img)
+    assert numpy.array_equal(load(tmpname), img)
+    half = File(tmpname, ImageLoadOptions(scale_denom=2)).read()
+    assert half.dtype == numpy.uint16
+    sums = img.astype('uint32').reshape(3,11,2,16,2).sum(axis=4).sum(axis=2)
+    assert numpy.array_equal(half, (sums + 2) // 4)
+
+    os.unlink(tmpname)
+    save(img, tmpname)
+    assert numpy.array_equal(load(tmpname), img)
+  finally:
+    if os.path.exists(tmpname): os.unlink(tmpname)
+
+def test_image_write_then_read():
+
+  # The same file object reads back the image it has just written, also in
+  # append mode on a new file
+  from .. import load, File
+  img = load(PNG_INDEXED_COLOR)
+  for extension, mode in (('.png', 'w'), ('.jpg', 'w'), ('.png', 'a')):
+    tmpname = testutils.temporary_filename(suffix=extension)
+    try:
+      f = File(tmpname, mode)
+      f.append(img)
+      back = f.read()
+      assert back.shape == img.shape
+      assert numpy.array_equal(back, load(tmpname))
+      if extension == '.png': assert numpy.array_equal(back, img)
+      del f
+    finally:
+      if os.path.exists(tmpname): os.unlink(tmpname)
+
+def test_load_batch():
+
+  from .. import load, load_batch, ImageLoadOptions
+  img = load(PNG_INDEXED_COLOR)
+
+  # Same shapes: a stacked array, and per-file errors
+  files = [PNG_INDEXED_COLOR, 'does_not_exist.png', PNG_INDEXED_COLOR]
+  arrays, errors = load_batch(files, n_threads=2)
+  assert arrays.shape == (3,3,22,32)
+  assert numpy.array_equal(arrays[0], img)
+  assert numpy.array_equal(arrays[2], img)
+  assert numpy.all(arrays[1] == 0)
+  assert errors[0] is None and errors[2] is None
+  assert errors[1] is not None
+
+  # Different shapes: a list of arrays
+  arrays, errors = load_batch([PNG_INDEXED_COLOR, JPEG], n_threads=4)
+  assert isinstance(arrays, list)
+  assert numpy.array_equal(arrays[0], img)
+  assert numpy.array_equal(arrays[1], load(JPEG))
+  assert errors == [None, None]
+
+  # With image loading options
+  arrays, errors = load_batch([PNG_INDEXED_COLOR]*5, n_threads=3,
+      options=ImageLoadOptions(scale_denom=2, gray=True))
+  assert arrays.shape == (5,11,16)
@@ -61,6 +61,15 @@ class GLCM(object):
     self._offset = value
     self.G.offset = value
 
+  @property
+  def n_threads(self):
+    'The number of threads used to count the co-occurences. The stripes of rows of the image are processed in parallel, and the result does not depend on this number.'
+    return self.G.n_threads
+
+  @n_threads.setter
+  def n_threads(self, value):
+    self.G.n_threads = value
+
 
   def __init__(self, dtype, num_levels=None, min_level=None, max_level=None, quantization_table=None):
     """
@@ -1,44 +1,43 @@
 from ..core import __from_extension_import__
-__from_extension_import__('._ip', __package__, locals(), ['GLCMProp'])
+__from_extension_import__('._ip', __package__, locals(), ['GLCMProp', 'GLCMProperty'])
 
 def properties_by_name(self, glcm_matrix, prop_names=None):
   """Possibility to query the properties of GLCM by specifying a name. Returns a list of numpy.array of the queried properties.
+  All the properties are computed at once, with a single pass over the GLCM.
 
     glcm The input GLCM as 3D numpy.ndarray of dtype='float64'
     prop_names A list GLCM texture properties' names
   """
-  prop_dict = {"angular second moment":self.angular_second_moment,
-               "energy":self.energy,
-               "variance":self.variance,
-               "contrast":self.contrast,
-               "autocorrelation":self.auto_correlation,
-               "correlation":self.correlation,
-               "correlation matlab":self.correlation_m,
-               "inverse difference moment":self.inv_diff_mom,
-               "sum average":self.sum_avg,
-               "sum variance":self.sum_var,
-               "sum entropy":self.sum_entropy,
-               "entropy":self.entropy,
-               "difference variance":self.diff_var,
-               "difference entropy":self.diff_entropy,
-               "dissimilarity":self.dissimilarity,
-               "homogeneity":self.homogeneity,
-               "cluster prominance":self.cluster_prom,
-               "cluster shade":self.cluster_shade,
-               "maximum probability":self.max_prob,
-               "information measure of correlation 1":self.inf_meas_corr1,
-               "information measure of correlation 2":self.inf_meas_corr2,
-               "inverse difference":self.inv_diff,
-               "inverse difference normalized":self.inv_diff_norm,
-               "inverse difference moment normalized":self.inv_diff_mom_norm
+  prop_dict = {"angular second moment":GLCMProperty.ANGULAR_SECOND_MOMENT,
+               "energy":GLCMProperty.ENERGY,
+               "variance":GLCMProperty.VARIANCE,
+               "contrast":GLCMProperty.CONTRAST,
+               "autocorrelation":GLCMProperty.AUTO_CORRELATION,
+               "correlation":GLCMProperty.CORRELATION,
+               "correlation matlab":GLCMProperty.CORRELATION_M,
+               "inverse difference moment":GLCMProperty.INV_DIFF_MOM,
+               "sum average":GLCMProperty.SUM_AVG,
+               "sum variance":GLCMProperty.SUM_VAR,
+               "sum entropy":GLCMProperty.SUM_ENTROPY,
+               "entropy":GLCMProperty.ENTROPY,
+               "difference variance":GLCMProperty.DIFF_VAR,
+               "difference entropy":GLCMProperty.DIFF_ENTROPY,
+               "dissimilarity":GLCMProperty.DISSIMILARITY,
+               "homogeneity":GLCMProperty.HOMOGENEITY,
+               "cluster prominance":GLCMProperty.CLUSTER_PROM,
+               "cluster shade":GLCMProperty.CLUSTER_SHADE,
+               "maximum probability":GLCMProperty.MAX_PROB,
+               "information measure of correlation 1":GLCMProperty.INF_MEAS_CORR1,
+               "information measure of correlation 2":GLCMProperty.INF_MEAS_CORR2,
+               "inverse difference":GLCMProperty.INV_DIFF,
+               "inverse difference normalized":GLCMProperty.INV_DIFF_NORM,
+               "inverse difference moment normalized":GLCMProperty.INV_DIFF_MOM_NORM
                }
   if prop_names == None:
-    prop_names = prop_dict.keys()
-  retval = []
-  for props in prop_names:
-    retval.append(prop_dict[props](glcm_matrix))
+    prop_names = list(prop_dict.keys())
+  values = self.properties(glcm_matrix, [prop_dict[props] for props in prop_names])
 
-  return retval
+  return [values[k] for k in range(len(prop_names))]
 
 GLCMProp.properties_by_name = properties_by_name
 del properties_by_name
@@ -49,3 +49,17 @@ class FlipFlopTest(unittest.TestCase):
     self.assertTrue( (B == A3_ans_flop).all())
     C = bob.ip.flop(A3_org)
     self.assertTrue( (C == A3_ans_flop).all())
+
+  def test05_flip_strided(self):
+    # slices and transposes are referred to, not copied, and results written
+    # to a strided output are visible from Python
+    big = numpy.array(range(1,17), numpy.float64).reshape((4,4))
+    src = big[::2,::2]
+    out = numpy.zeros((4,4), numpy.float64)
+    bob.core.reset_copy_statistics()
+    bob.ip.flip(src, out[1::2,1::2])
+    self.assertEqual(bob.core.copy_statistics()[0], 0)
+    self.assertTrue( (out[1::2,1::2] == src[::-1,:]).all())
+    bob.ip.flop(src.T, out[::2,::2])
+    self.assertEqual(bob.core.copy_statistics()[0], 0)
+    self.assertTrue( (out[::2,::2] == src.T[:,::-1]).all())
@@ -138,3 +138,24 @@ class GaussianScaleSpaceTest(unittest.TestCase):
     self.assertEqual(op1 != op7, True)
     self.assertEqual(op1 != op8, True)
     self.assertEqual(op1 != op9, True)
+
+  def test04_threads_float32(self):
+    # Threaded and single precision processing
+    A = bob.io.load(F(os.path.join("sift", "vlimg_ref.pgm")))
+    op = bob.ip.GaussianScaleSpace(A.shape[0],A.shape[1],3,3,-1,0.5,1.6,4.)
+    self.assertEqual(op.n_threads, 1)
+    pyr = op(A)
+
+    op.n_threads = 4
+    self.assertEqual(op.n_threads, 4)
+    self.assertEqual(op == bob.ip.GaussianScaleSpace(A.shape[0],A.shape[1],3,3,-1,0.5,1.6,4.), True)
+    self.assertRaises(RuntimeError, setattr, op, 'n_threads', 0)
+    pyr_t = op(A)
+    for o in range(len(pyr)):
+      self.assertTrue( numpy.array_equal(pyr[o], pyr_t[o]) )
+
+    pyr_f = op.allocate_output(True)
+    op(A, pyr_f)
+    for o in range(len(pyr)):
+      self.assertEqual(pyr_f[o].dtype, numpy.float32)
+      self.assertTrue( numpy.allclose(pyr[o], pyr_f[o], 1e-3, 1e-2) )
@@ -131,3 +131,42 @@ class GLCMTest(unittest.TestCase):
     self.assertTrue(numpy.allclose(glcm_prop.properties_by_name(res_matrix, ["angular second moment"]), numpy.array([0.09333333]))) # energy in [5],[6]
     
     
+
+  def test05_GLCM(self):
+    # The co-occurences counted by several threads are the ones counted by a single thread
+    numpy.random.seed(0)
+    image = numpy.random.randint(0, 256, (37, 41)).astype('uint8')
+    glcm = bob.ip.GLCM('uint8', num_levels=16)
+    glcm.offset = numpy.array([[1,0],[1,-1],[0,-1],[-1,-1],[3,2]], dtype='int32')
+    glcm.symmetric = True
+    glcm.normalized = True
+    reference = glcm(image)
+    glcm.n_threads = 4
+    self.assertEqual(glcm.n_threads, 4)
+    self.assertTrue( (glcm(image) == reference).all())
+
+    # All the properties computed at once are the ones computed one by one
+    glcm_prop = bob.ip.GLCMProp()
+    names = ["angular second moment", "energy", "variance", "contrast", "autocorrelation",
+             "correlation", "correlation matlab", "inverse difference moment", "sum average",
+             "sum variance", "sum entropy", "entropy", "difference variance", "difference entropy",
+             "dissimilarity", "homogeneity", "cluster prominance", "cluster shade",
+             "maximum probability", "information measure of correlation 1",
+             "information measure of correlation 2", "inverse difference",
+             "inverse difference normalized", "inverse difference moment normalized"]
+    functions = [glcm_prop.angular_second_moment, glcm_prop.energy, glcm_prop.variance,
+                 glcm_prop.contrast, glcm_prop.auto_correlation, glcm_prop.correlation,
+                 glcm_prop.correlation_m, glcm_prop.inv_diff_mom, glcm_prop.sum_avg,
+                 glcm_prop.sum_var, glcm_prop.sum_entropy, glcm_prop.entropy, glcm_prop.diff_var,
+                 glcm_prop.diff_entropy, glcm_prop.dissimilarity, glcm_prop.homogeneity,
+                 glcm_prop.cluster_prom, glcm_prop.cluster_shade, glcm_prop.max_prob,
+                 glcm_prop.inf_meas_corr1, glcm_prop.inf_meas_corr2, glcm_prop.inv_diff,
+                 glcm_prop.inv_diff_norm, glcm_prop.inv_diff_mom_norm]
+    values = glcm_prop.properties_by_name(reference, names)
+    self.assertEqual(len(values), len(names))
+    for k in range(len(names)):
+      self.assertTrue(numpy.allclose(values[k], functions[k](reference)))
+    values = glcm_prop.properties(reference, [bob.ip.GLCMProperty.CONTRAST, bob.ip.GLCMProperty.ENTROPY])
+    self.assertEqual(values.shape, (2, 5))
+    self.assertTrue(numpy.allclose(values[0], glcm_prop.contrast(reference)))
+    self.assertTrue(numpy.allclose(values[1], glcm_prop.entropy(reference)))
@@ -388,3 +388,56 @@ class HOGTest(unittest.TestCase):
     hog3 = bob.ip.HOG(hog2)
     self.assertTrue(  hog3 == hog2 )
     self.assertFalse( hog3 != hog2 )
+
+  def test05_IntegralHOG(self):
+    #"""Test the IntegralHOG class, which extracts HOG descriptors of many
+    #  windows of the same image"""
+
+    # Same descriptors as HOG for an image of the size of a window
+    img = numpy.random.rand(24, 32) * 255.
+    for full in (False, True):
+      hog = bob.ip.HOG(24, 32, 9, full, 6, 8, 2, 4, 2, 2, 1, 1)
+      ihog = bob.ip.IntegralHOG(24, 32, 9, full, 6, 8, 2, 4, 2, 2, 1, 1)
+      self.assertTrue( numpy.array_equal( hog.get_output_shape(), ihog.get_output_shape() ))
+      self.assertTrue( numpy.allclose( ihog(img), hog(img), 1e-8, 1e-10 ))
+      self.assertTrue( numpy.allclose( ihog(img.astype(numpy.uint8)), hog(img.astype(numpy.uint8)), 1e-8, 1e-10 ))
+      self.assertTrue( numpy.allclose( ihog.forward(img), hog(img), 1e-8, 1e-10 ))
+
+    # Images of another size than the windows are rejected
+    self.assertRaises( RuntimeError, ihog, numpy.random.rand(25, 32) )
+    self.assertRaises( RuntimeError, ihog.forward, numpy.random.rand(24, 31) )
+    self.assertRaises( RuntimeError, ihog, numpy.random.rand(40, 50).astype(numpy.uint8) )
+
+    # Windows of a larger image: the gradients are computed on the full image
+    img = numpy.random.rand(40, 50) * 255.
+    ihog = bob.ip.IntegralHOG(16, 16, 8, False, 4, 4, 0, 0, 2, 2, 1, 1)
+    ihog.compute_integral_histograms(img)
+    self.assertEqual( ihog.image_height, 40 )
+    self.assertEqual( ihog.image_width, 50 )
+    mag, ori = bob.ip.GradientMaps(40, 50)(img)
+    positions = numpy.array([[0, 0], [3, 7], [24, 34], [10, 0]], dtype=numpy.int64)
+    batch = ihog.extract(positions)
+    self.assertEqual( batch.shape, (4, 3, 3, 32) )
+    for n, (y, x) in enumerate(positions):
+      cells = numpy.ndarray((4, 4, 8), 'float64')
+      for cy in range(4):
+        for cx in range(4):
+          sy = slice(y+4*cy, y+4*cy+4)
+          sx = slice(x+4*cx, x+4*cx+4)
+          cells[cy,cx,:] = bob.ip.hog_compute_histogram(mag[sy,sx].copy(), ori[sy,sx].copy(), 8)
+      ref = numpy.ndarray((3, 3, 32), 'float64')
+      for by in range(3):
+        for bx in range(3):
+          ref[by,bx,:] = bob.ip.normalize_block(cells[by:by+2,bx:bx+2,:].copy())
+      self.assertTrue( numpy.allclose( ihog.extract(int(y), int(x)), ref, 1e-8, 1e-10 ))
+      self.assertTrue( numpy.allclose( batch[n], ref, 1e-8, 1e-10 ))
+
+    # Windows must be inside the image
+    self.assertRaises( RuntimeError, ihog.extract, 25, 0 )
+    self.assertRaises( RuntimeError, ihog.extract, 0, -1 )
+
+    # Copy constructor
+    ihog2 = bob.ip.IntegralHOG(ihog)
+    self.assertTrue(  ihog2 == ihog )
+    ihog2.full_orientation = True
+    self.assertTrue(  ihog2 != ihog )
@@ -275,3 +275,23 @@ def test_randomness():
 
     for b1, b2 in zip(m1.biases, m2.biases):
       assert (b1 == b2).all() == False
+
+def test_batched_forward():
+
+  # several blocks of rows, split among threads
+  m = MLP((20,15,10,3))
+  m.hidden_activation = LogisticActivation()
+  m.randomize()
+  m.input_subtract = numpy.random.rand(20)
+  m.input_divide = numpy.random.rand(20) + 0.5
+
+  X = numpy.random.rand(1000,20)
+  Y = numpy.vstack([m(x) for x in X])
+  assert numpy.allclose(m(X), Y, rtol=1e-10, atol=1e-15)
+  for n_threads in (2, 3, 7):
+    assert numpy.allclose(m(X, n_threads), Y, rtol=1e-10, atol=1e-15)
+
+  # non-contiguous input
+  X2 = numpy.random.rand(20,300).T
+  Y2 = numpy.vstack([m(x) for x in X2])
+  assert numpy.allclose(m(X2, 4), Y2, rtol=1e-10, atol=1e-15)
@@ -282,3 +282,26 @@ class SvmTest(unittest.TestCase):
     pred_label = machine.predict_classes(data)
 
     self.assertEqual(pred_label, expected_iris_predictions)
+
+  @utils.libsvm_available
+  def test08_dense_prediction(self):
+
+    #the batched prediction matches libsvm, with one or several threads
+    for model, datafile in ((HEART_MACHINE, HEART_DATA), (IRIS_MACHINE, IRIS_DATA)):
+      machine = bob.machine.SupportVector(model)
+      labels, data = bob.machine.SVMFile(datafile).read_all()
+      data = numpy.vstack(data)
+
+      prev_labels, prev_scores = machine.predict_classes_and_scores(data)
+      prev_scores = numpy.vstack(prev_scores)
+
+      for n_threads in (1, 3):
+        self.assertEqual(tuple(machine.predict_classes_dense(data, n_threads)), prev_labels)
+        curr_labels, curr_scores = machine.predict_classes_and_scores_dense(data, n_threads)
+        self.assertEqual(tuple(curr_labels), prev_labels)
+        self.assertTrue( numpy.all(abs(curr_scores - prev_scores) < 1e-10) )
+
+      # excess input and non-contiguous arrays
+      extra = numpy.hstack([data, numpy.ones((data.shape[0], 2), dtype=float)])
+      self.assertEqual(tuple(machine.predict_classes_dense(extra)), prev_labels)
+      self.assertEqual(tuple(machine.predict_classes_dense(data.T.copy().T)), prev_labels)
@@ -91,3 +91,37 @@ class StatsTest(unittest.TestCase):
     # 3.c comparison
     self.assertTrue(numpy.allclose(Sw, Sw_) )
     self.assertTrue(numpy.allclose(Sb, Sb_) )
+
+  def test03_scatter_accumulator(self):
+
+    # Accumulates the data in blocks, with several threads
+    data = numpy.vstack(self.data)
+    S_, M_ = bob.math.scatter(data)
+    acc = bob.math.ScatterAccumulator(data.shape[1])
+    acc.n_threads = 3
+    for start in range(0, data.shape[0], 40):
+      acc.accumulate(data[start:start+40])
+    self.assertEqual(acc.n_samples, data.shape[0])
+    self.assertTrue(numpy.allclose(acc.mean, M_))
+    self.assertTrue(numpy.allclose(acc.scatter, S_))
+    self.assertTrue(numpy.allclose(acc.covariance(), numpy.cov(data.T)))
+
+    # Merges accumulators filled sample by sample
+    acc1 = bob.math.ScatterAccumulator(data.shape[1])
+    acc2 = bob.math.ScatterAccumulator(data.shape[1])
+    for k in range(data.shape[0]):
+      (acc1 if k % 2 else acc2).accumulate(data[k])
+    acc1.merge(acc2)
+    self.assertTrue(numpy.allclose(acc1.mean, M_))
+    self.assertTrue(numpy.allclose(acc1.scatter, S_))
+
+    # Scatter matrices of the classes
+    Sw_, Sb_, m_ = scatters(self.data)
+    classes = []
+    for d in self.data:
+      classes.append(bob.math.ScatterAccumulator(d.shape[1]))
+      classes[-1].accumulate(d)
+    Sw, Sb, m = bob.math.scatters(classes)
+    self.assertTrue(numpy.allclose(Sw, Sw_) )
+    self.assertTrue(numpy.allclose(Sb, Sb_) )
+    self.assertTrue(numpy.allclose(m, m_) )
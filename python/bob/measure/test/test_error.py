@@ -296,3 +296,44 @@ class ErrorTest(unittest.TestCase):
     self.assertAlmostEqual(min_cllr, 0.337364136)
 
 
+
+  def test08_calibrate_rocch(self):
+
+    # This test set is not separable.
+    positives = bob.io.load(F('nonsep-positives.hdf5'))
+    negatives = bob.io.load(F('nonsep-negatives.hdf5'))
+    eer_ref = 0.116363636363636
+
+    llr_neg, llr_pos, eer = bob.measure.calibrate_rocch(negatives, positives)
+    self.assertEqual(llr_neg.shape, negatives.shape)
+    self.assertEqual(llr_pos.shape, positives.shape)
+    self.assertTrue( abs(eer-eer_ref) < 1e-4)
+
+    # The calibrated scores follow the order of the scores
+    scores = numpy.hstack((positives, negatives))
+    llrs = numpy.hstack((llr_pos, llr_neg))
+    order = numpy.argsort(scores, kind='mergesort')
+    self.assertTrue( numpy.all(numpy.diff(llrs[order]) >= 0) )
+
+    # Large sets of scores (sorted with the radix sort), with ties between
+    # positives and negatives
+    numpy.random.seed(42)
+    positives = numpy.round(numpy.random.normal(1., 1., 30000), 2)
+    negatives = numpy.round(numpy.random.normal(-1., 1., 50000), 2)
+    llr_neg, llr_pos, eer = bob.measure.calibrate_rocch(negatives, positives, n_threads=2)
+    self.assertTrue( abs(eer - bob.measure.eer_rocch(negatives, positives)) < 1e-12)
+    self.assertTrue( numpy.allclose(bob.measure.rocch(negatives, positives, n_threads=2),
+      bob.measure.rocch(negatives, positives), atol=1e-15) )
+
+    # Reference: stable sort (positives first) and PAV of the ideal posteriors
+    scores = numpy.hstack((positives, negatives))
+    order = numpy.argsort(scores, kind='mergesort')
+    ideal = (order < len(positives)).astype(numpy.float64)
+    popt = bob.math.pavx(ideal)
+    old_warn_setup = numpy.seterr(divide='ignore')
+    llrs = numpy.log(popt) - numpy.log(1. - popt) - numpy.log(float(len(positives)) / len(negatives))
+    numpy.seterr(**old_warn_setup)
+    llrs_ref = numpy.ndarray(scores.shape)
+    llrs_ref[order] = llrs
+    self.assertTrue( numpy.allclose(llr_pos, llrs_ref[:len(positives)]) )
+    self.assertTrue( numpy.allclose(llr_neg, llrs_ref[len(positives):]) )
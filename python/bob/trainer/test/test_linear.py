@@ -9,9 +9,10 @@
 """
 
 import numpy
+import nose.tools
 
 from ...machine import LinearMachine
-from .. import PCATrainer, FisherLDATrainer, WhiteningTrainer, EMPCATrainer, WCCNTrainer
+from .. import PCATrainer, RandomizedPCATrainer, FisherLDATrainer, WhiteningTrainer, EMPCATrainer, WCCNTrainer
 
 def test_pca_settings():
 
@@ -175,6 +176,59 @@ def test_pca_svd_vs_cov_random_2():
   assert numpy.allclose(abs(machine_svd.weights/machine_safe_svd.weights), 1.0)
 
 
+def test_pca_accumulated_vs_cov():
+
+  # Tests the training from accumulated statistics
+  from ...math import ScatterAccumulator
+  data = numpy.random.rand(1000,4)
+
+  T = PCATrainer()
+  T.use_svd = False #make it use the covariance method
+  machine_cov, eig_vals_cov = T.train(data)
+
+  stats = ScatterAccumulator(4)
+  stats.n_threads = 2
+  for start in range(0, 1000, 300):
+    stats.accumulate(data[start:start+300])
+  machine_acc, eig_vals_acc = T.train(stats)
+
+  assert numpy.allclose(eig_vals_acc, eig_vals_cov)
+  assert numpy.allclose(machine_acc.input_subtract, machine_cov.input_subtract)
+  assert numpy.allclose(abs(machine_acc.weights/machine_cov.weights), 1.0)
+
+  # Same for the whitening
+  W = WhiteningTrainer()
+  assert numpy.allclose(W.train(stats).weights, W.train(data).weights)
+
+
+def test_randomized_pca_vs_cov():
+
+  # Data with a few dominant directions
+  numpy.random.seed(0)
+  data = numpy.dot(numpy.random.randn(500,5) * [10., 8., 6., 4., 2.], numpy.random.randn(5,40))
+  data += 0.01 * numpy.random.randn(500,40)
+
+  T = PCATrainer()
+  T.use_svd = False #make it use the covariance method
+  machine_cov, eig_vals_cov = T.train(data)
+
+  R = RandomizedPCATrainer(3)
+  assert R.rank == 3
+  assert R.oversampling == 10
+  assert R.n_iterations == 2
+  machine_rnd, eig_vals_rnd = R.train(data)
+  assert machine_rnd.weights.shape == (40,3)
+  assert numpy.allclose(eig_vals_rnd, eig_vals_cov[:3])
+  assert numpy.allclose(machine_rnd.input_subtract, machine_cov.input_subtract)
+  assert numpy.allclose(abs(machine_rnd.weights/machine_cov.weights[:,:3]), 1.0)
+
+  # Same from blocks of rows
+  blocks = [data[k:k+64] for k in range(0, 500, 64)]
+  machine_blk, eig_vals_blk = R.train_blocks(blocks)
+  assert numpy.allclose(eig_vals_blk, eig_vals_cov[:3])
+  assert numpy.allclose(abs(machine_blk.weights/machine_cov.weights[:,:3]), 1.0)
+
+
 def test_fisher_lda_settings():
 
   t = FisherLDATrainer()
@@ -294,6 +348,36 @@ def test_fisher_lda_bis():
   normalized_weights = (machine_pinv.weights.T/weight_ratio).T
   assert numpy.allclose(machine.weights, normalized_weights)
 
+def test_fisher_lda_accumulated():
+
+  # Tests the training from the statistics accumulated on each class
+  from ...math import ScatterAccumulator
+  data = [numpy.random.rand(n,5) + k for k, n in enumerate((400, 250, 320))]
+  classes = []
+  for d in data:
+    stats = ScatterAccumulator(5)
+    stats.n_threads = 2
+    for start in range(0, d.shape[0], 100):
+      stats.accumulate(d[start:start+100])
+    classes.append(stats)
+
+  for use_pinv in (False, True):
+    T = FisherLDATrainer(use_pinv=use_pinv)
+    assert T.output_size(classes) == T.output_size(data)
+    machine, eig_vals = T.train(data)
+    machine_acc, eig_vals_acc = T.train(classes)
+    assert numpy.allclose(eig_vals_acc, eig_vals)
+    assert numpy.allclose(machine_acc.input_subtract, machine.input_subtract)
+    assert numpy.allclose(abs(machine_acc.weights), abs(machine.weights))
+
+    machine_acc = LinearMachine(5, T.output_size(classes))
+    assert numpy.allclose(T.train(machine_acc, classes), eig_vals)
+    assert numpy.allclose(abs(machine_acc.weights), abs(machine.weights))
+
+  # Nothing accumulated
+  nose.tools.assert_raises(RuntimeError, FisherLDATrainer().train,
+      [ScatterAccumulator(5), ScatterAccumulator(5)])
+
 def test_fisher_lda_comparisons():
 
   # Constructors and comparison operators
@@ -459,3 +543,25 @@ def test_wccn_train():
   assert numpy.allclose(m2.input_subtract, mean_ref, eps, eps)
   assert numpy.allclose(m2.weights, weight_ref, eps, eps)
   assert numpy.allclose(s2, sample_wccn_ref, eps, eps)
+
+def test_wccn_accumulated():
+
+  # Tests the training from the statistics accumulated on each class
+  from ...math import ScatterAccumulator
+  data = [numpy.random.rand(n,4) + k for k, n in enumerate((300, 200, 250))]
+  classes = []
+  for d in data:
+    stats = ScatterAccumulator(4)
+    for start in range(0, d.shape[0], 80):
+      stats.accumulate(d[start:start+80])
+    classes.append(stats)
+
+  t = WCCNTrainer()
+  m = t.train(data)
+  m_acc = t.train(classes)
+  assert numpy.allclose(m_acc.weights, m.weights)
+  assert numpy.allclose(m_acc.input_subtract, m.input_subtract)
+
+  m_acc = LinearMachine(4,4)
+  t.train(m_acc, classes)
+  assert numpy.allclose(m_acc.weights, m.weights)
@@ -242,3 +242,36 @@ def test_bias_training():
 
   assert not trainer_copy.train_biases
   
+
+def test_threads():
+
+  machine = MLP((20, 10, 5, 3))
+  machine.hidden_activation = HyperbolicTangentActivation()
+  machine.output_activation = LogisticActivation()
+  machine.randomize()
+
+  batch_size = 50
+  cost = CrossEntropyLoss(machine.output_activation)
+  X = numpy.random.rand(batch_size, 20)
+  T = numpy.random.rand(batch_size, 3)
+
+  trainer = MLPBaseTrainer(batch_size, cost, machine)
+  assert trainer.n_threads == 1
+  c1 = trainer.cost(machine, X, T)
+  trainer.backward_step(machine, X, T)
+  out1 = [k.copy() for k in trainer.output]
+  deriv1 = [k.copy() for k in trainer.derivatives]
+  bias1 = [k.copy() for k in trainer.bias_derivatives]
+
+  for n_threads in (2, 3, 7):
+    trainer.n_threads = n_threads
+    assert trainer.n_threads == n_threads
+    c2 = trainer.cost(machine, X, T)
+    trainer.backward_step(machine, X, T)
+    assert abs(c1 - c2) < 1e-10
+    for a, b in zip(out1, trainer.output): assert numpy.allclose(a, b)
+    for a, b in zip(deriv1, trainer.derivatives): assert numpy.allclose(a, b)
+    for a, b in zip(bias1, trainer.bias_derivatives): assert numpy.allclose(a, b)
+
+  trainer_copy = MLPBaseTrainer(trainer)
+  assert trainer_copy.n_threads == 7
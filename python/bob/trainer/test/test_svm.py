@@ -136,3 +136,24 @@ class SvmTrainingTest(unittest.TestCase):
     curr_scores = numpy.array(curr_scores)
     prev_scores = numpy.array(prev_scores)
     #self.assertTrue( numpy.all(abs(curr_scores-prev_scores) < 1e-8) )
+
+  @utils.libsvm_available
+  def test04_dense_prediction(self):
+
+    # the batched prediction of the trained machines matches libsvm, for
+    # every kernel (linear machines are collapsed into weight vectors)
+    f = bob.machine.SVMFile(HEART_DATA)
+    labels, data = f.read_all()
+    data = numpy.vstack(data)
+    neg = numpy.vstack([k for i,k in enumerate(data) if labels[i] < 0])
+    pos = numpy.vstack([k for i,k in enumerate(data) if labels[i] > 0])
+
+    kernels = bob.machine.svm_kernel_type
+    for kernel in (kernels.LINEAR, kernels.POLY, kernels.RBF, kernels.SIGMOID):
+      trainer = bob.trainer.SVMTrainer(kernel_type=kernel)
+      machine = trainer.train((pos, neg))
+
+      prev_labels, prev_scores = machine.predict_classes_and_scores(data)
+      curr_labels, curr_scores = machine.predict_classes_and_scores_dense(data, 2)
+      self.assertEqual(tuple(curr_labels), prev_labels)
+      self.assertTrue( numpy.all(abs(curr_scores - numpy.vstack(prev_scores)) < 1e-8) )
@@ -156,7 +156,7 @@ class Localizer(CVLocalizer):
     else:
       raise RuntimeError('input detector has to be either None, a file path or Detector object')
 
-  def __call__(self, image):
+  def __call__(self, image, previous=None):
     """Runs the localization machinery, returns the bounding box and points
 
     Keyword parameters:
@@ -164,10 +164,16 @@ class Localizer(CVLocalizer):
     image
       A gray-scaled image (2D array) with dtype=uint8.
 
+    previous
+      The result of the previous video frame (or None, the default). If its
+      bounding box overlaps the new face location, its keypoints initialize
+      the localization. Set the tracking attribute of the detector as well to
+      scan only around the previous detections.
+
     Returns a bounding box and a set of keypoints.
     """
 
-    return self.locate(self.detector, image)
+    return self.locate(self.detector, image, previous)
 
 def param_setattr(self, key, value):
   if not hasattr(self, key):
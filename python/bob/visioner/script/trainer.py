@@ -87,6 +87,10 @@ def main():
       dest = 'subwindow_labelling', help=bob.visioner.param.subwindow_labelling.__doc__ + " (options: %s; default: %%(default)s)" % '|'.join(bob.visioner.TAGGERS))
   parser.add_argument("-y", "--threads", dest="threads", type=int,
       default=0, help="Set to zero to execute the training in the current thread, set to 1 or greater to spawn that many threads (defaults to %(default)s)")
+  parser.add_argument("-z", "--lazy", dest="lazy", default=False,
+      action='store_true', help="only keep the original images in memory and generate the scaled images again each time they are used (slower, but requires much less memory on large datasets)")
+  parser.add_argument("-C", "--cache", metavar='PREFIX', type=str,
+      dest="cache", default='', help="if set, the training and validation samples are saved to (or restored from, if they were saved with the same data and parameters) the files '<PREFIX>.train' and '<PREFIX>.valid', which skips loading the images in later runs")
   parser.add_argument("-v", "--verbose", dest="verbose",
       default=False, action='store_true',
       help="enable verbose output")
@@ -106,9 +110,9 @@ def main():
   if args.verbose: print("Loading training and validation data...")
   start = time.clock()
   training = bob.visioner.Sampler(param, bob.visioner.SamplerType.Train,
-      args.threads)
+      args.threads, args.lazy, args.cache + '.train' if args.cache else '')
   validation = bob.visioner.Sampler(param, bob.visioner.SamplerType.Validation,
-      args.threads)
+      args.threads, args.lazy, args.cache + '.valid' if args.cache else '')
   total = time.clock() - start
   if args.verbose: print("Ok. Loading time was %.2f seconds" % total)
 
@@ -26,6 +26,233 @@ def test_single():
   locdata = processor(ip.rgb_to_gray(io.load(IMAGE)))
   assert locdata is not None
 
+@utils.visioner_available
+def test_level_stats():
+
+  from .. import MaxDetector
+  processor = MaxDetector(scanning_levels=10)
+  processor.reset_stats()
+  locdata = processor(ip.rgb_to_gray(io.load(IMAGE)))
+  assert locdata is not None
+
+  # every sub-window is evaluated at the first level
+  stats = processor.stats
+  nose.tools.eq_(len(stats['level_subwindows']), 11)
+  nose.tools.eq_(stats['level_subwindows'][0], stats['subwindows'])
+  nose.tools.eq_(sum(stats['level_evaluations']), stats['evaluations'])
+
+@utils.visioner_available
+def test_calibrated_rejection():
+
+  from .. import MaxDetector, Detector
+  image = ip.rgb_to_gray(io.load(IMAGE))
+  x, y, width, height, score = MaxDetector(scanning_levels=10)(image)
+
+  # the detected face is the ground truth of the calibration
+  gtfile = utils.temporary_filename(suffix='.gt')
+  f = open(gtfile, 'w')
+  f.write('1\nface unknown 0 %f %f %f %f\n' % (x, y, width, height))
+  f.close()
+
+  # without clustering, all the sub-windows above the threshold are reported,
+  # with the score of all their levels when they are not rejected early
+  full = Detector(scanning_levels=0, clustering=1.0)(image)
+  full = dict((k[:4], k[4]) for k in full)
+
+  processor = Detector(scanning_levels=10, clustering=1.0)
+  processor.reset_stats()
+  processor(image)
+  uncalibrated = processor.stats
+
+  try:
+    assert processor.calibrate([IMAGE], [gtfile], recall=0.5)
+  finally:
+    os.unlink(gtfile)
+  processor.calibrated = True
+  processor.reset_stats()
+  calibrated = processor(image)
+  stats = processor.stats
+
+  # the calibrated thresholds reject sub-windows early, and the ones they
+  # reject are not reported with their partial score
+  assert stats['level_subwindows'][-1] < uncalibrated['level_subwindows'][-1]
+  assert calibrated
+  for k in calibrated:
+    assert k[:4] in full
+    assert abs(k[4] - full[k[:4]]) < 1e-6
+
+def overlap(a, b):
+  """Jaccard overlap of two (x, y, width, height) boxes"""
+
+  w = min(a[0] + a[2], b[0] + b[2]) - max(a[0], b[0])
+  h = min(a[1] + a[3], b[1] + b[3]) - max(a[1], b[1])
+  if w <= 0 or h <= 0: return 0.
+  return w * h / float(a[2] * a[3] + b[2] * b[3] - w * h)
+
+@utils.visioner_available
+def test_incremental_pyramid():
+
+  from .. import Detector, MaxDetector
+  image = ip.rgb_to_gray(io.load(IMAGE))
+  flipped = image[:,::-1].copy()
+
+  # the original scale is not resampled, so its sub-windows have the same
+  # features (from the shared integral images) as in the full rebuild
+  incremental = Detector(threshold=-100., clustering=1.0)
+  incremental.incremental = True
+  full = Detector(threshold=-100., clustering=1.0)(image)
+  width = min(k[2] for k in full)
+  reference = sorted(k for k in full if k[2] == width)
+  assert reference
+  current = sorted(k for k in incremental(image) if k[2] == width)
+  nose.tools.eq_(len(current), len(reference))
+  for k, r in zip(current, reference):
+    nose.tools.eq_(k[:4], r[:4])
+    assert abs(k[4] - r[4]) < 1e-6
+
+  # the smaller scales are area-averaged from the nearest octave instead of
+  # being rescaled from the original image: the same face is found
+  processor = MaxDetector(scanning_levels=10)
+  reference = processor(image)
+  processor.incremental = True
+  assert overlap(processor(image)[:4], reference[:4]) > 0.7
+
+  # the buffers reused from frame to frame do not leak into the next frame
+  processor = Detector(scanning_levels=10)
+  processor.incremental = True
+  first = processor(image)
+  second = processor(flipped)
+  nose.tools.eq_(processor(image), first)
+  fresh = Detector(scanning_levels=10)
+  fresh.incremental = True
+  nose.tools.eq_(fresh(flipped), second)
+
+def sampler_files(box):
+  """Writes a ground truth file with the given face box, and returns the
+  image and ground truth lists of a small data set"""
+
+  gtfile = utils.temporary_filename(suffix='.gt')
+  f = open(gtfile, 'w')
+  f.write('1\nface unknown 0 %f %f %f %f\n' % tuple(box))
+  f.close()
+  return [IMAGE]*3, [gtfile]*3
+
+def sampler_param():
+
+  from .. import param
+  p = param(rows=24, cols=20, feature_type='elbp')
+  p.labels = ['face']
+  return p
+
+def mapped(sampler, model):
+  """Targets and feature values of a subset of the samples"""
+
+  step = max(1, sampler.num_of_samples // 20)
+  return sampler.map(range(0, sampler.num_of_samples, step), model)
+
+@utils.visioner_available
+def test_sampler_load():
+
+  from .. import MaxDetector, Sampler, SamplerType, Model
+  box = MaxDetector(scanning_levels=10)(ip.rgb_to_gray(io.load(IMAGE)))[:4]
+  images, gts = sampler_files(box)
+  try:
+    param = sampler_param()
+    model = Model(param)
+    serial = Sampler(param, SamplerType.Train, 0)
+    serial.load(images, gts)
+    assert serial.num_of_samples > 0
+    targets, values = mapped(serial, model)
+
+    # the samples are numbered in the order of the files, whatever the number
+    # of threads, and lazy samplers regenerate the same scaled images
+    for threads, lazy in ((3, False), (0, True), (2, True)):
+      sampler = Sampler(param, SamplerType.Train, threads, lazy)
+      sampler.load(images, gts)
+      nose.tools.eq_(sampler.lazy, lazy)
+      nose.tools.eq_(sampler.num_of_samples, serial.num_of_samples)
+      nose.tools.eq_(sampler.num_of_images, serial.num_of_images)
+      t, v = mapped(sampler, model)
+      assert (t == targets).all()
+      assert (v == values).all()
+
+    # loading again resets the sampler instead of appending to it
+    single = Sampler(param, SamplerType.Train, 0)
+    single.load(images[:1], gts[:1])
+    nose.tools.eq_(serial.num_of_samples, 3 * single.num_of_samples)
+    serial.load(images[:1], gts[:1])
+    nose.tools.eq_(serial.num_of_samples, single.num_of_samples)
+    nose.tools.eq_(serial.num_of_images, single.num_of_images)
+  finally:
+    os.unlink(gts[0])
+
+@utils.visioner_available
+def test_sampler_cache():
+
+  from .. import MaxDetector, Sampler, SamplerType, Model
+  box = MaxDetector(scanning_levels=10)(ip.rgb_to_gray(io.load(IMAGE)))[:4]
+  images, gts = sampler_files(box)
+  cache = utils.temporary_filename(suffix='.cache')
+  try:
+    param = sampler_param()
+    model = Model(param)
+    for lazy in (False, True):
+      if os.path.exists(cache): os.unlink(cache)
+      first = Sampler(param, SamplerType.Train, 0, lazy)
+      first.load(images, gts, cache)
+      assert os.path.exists(cache)
+      targets, values = mapped(first, model)
+
+      # restored from the cache, which is left as it is
+      saved = open(cache, 'rb').read()
+      restored = Sampler(param, SamplerType.Train, 2, lazy)
+      restored.load(images, gts, cache)
+      assert open(cache, 'rb').read() == saved
+      nose.tools.eq_(restored.num_of_samples, first.num_of_samples)
+      nose.tools.eq_(restored.num_of_images, first.num_of_images)
+      t, v = mapped(restored, model)
+      assert (t == targets).all()
+      assert (v == values).all()
+
+    # a ground truth file that changed invalidates the cache
+    x, y, width, height = box
+    f = open(gts[0], 'w')
+    f.write('1\nface unknown 0 %.3f %.3f %.3f %.3f\n' % (x + width/2., y, width, height))
+    f.close()
+    fresh = Sampler(param, SamplerType.Train, 0, True)
+    fresh.load(images, gts)
+    cached = Sampler(param, SamplerType.Train, 0, True)
+    cached.load(images, gts, cache)
+    nose.tools.eq_(cached.num_of_samples, fresh.num_of_samples)
+    t, v = mapped(cached, model)
+    ft, fv = mapped(fresh, model)
+    assert (t == ft).all()
+    assert (v == fv).all()
+    assert t.shape != targets.shape or (t != targets).any()
+  finally:
+    os.unlink(gts[0])
+    if os.path.exists(cache): os.unlink(cache)
+
+@utils.visioner_available
+def test_nms():
+
+  from .. import Detector, NMSMethod
+  image = ip.rgb_to_gray(io.load(IMAGE))
+  processor = Detector(scanning_levels=10)
+  greedy = processor(image)
+  assert greedy is not None
+
+  # averaging keeps the same detections, with averaged bounding boxes
+  processor.nms = NMSMethod.Average
+  average = processor(image)
+  nose.tools.eq_([k[4] for k in average], [k[4] for k in greedy])
+
+  # soft NMS decays the scores of the overlapping detections instead
+  processor.nms = NMSMethod.Soft
+  soft = processor(image)
+  assert len(soft) >= len(greedy)
+  nose.tools.eq_(soft[0], greedy[0])
+
 @utils.visioner_available
 @utils.ffmpeg_found()
 def test_faster():
@@ -40,6 +267,44 @@ def test_faster():
     locdata = processor(image)
     assert locdata is not None
 
+@utils.visioner_available
+def test_tracking():
+
+  from .. import MaxDetector
+  image = ip.rgb_to_gray(io.load(IMAGE))
+  processor = MaxDetector(scanning_levels=10)
+  processor.reset_stats()
+  reference = processor(image)
+  assert reference is not None
+  full_scan = processor.stats['subwindows']
+
+  # a still "video": between the full scans, only the neighbourhood of the
+  # previous detections is scanned, finding the same best detection
+  processor.tracking = True
+  processor.rescan = 5
+  processor.reset_stats()
+  for k in range(6):
+    nose.tools.eq_(processor(image), reference)
+
+  stats = processor.stats
+  nose.tools.eq_(stats['frames'], 6)
+  nose.tools.eq_(stats['tracked_frames'], 4)
+  assert stats['subwindows'] < 6 * full_scan
+
+@utils.visioner_available
+def test_tracking_localization():
+
+  from .. import Localizer
+  image = ip.rgb_to_gray(io.load(IMAGE))
+  processor = Localizer()
+  first = processor(image)
+  assert first is not None
+
+  # the keypoints of the previous frame initialize the localization
+  second = processor(image, first)
+  assert second is not None
+  nose.tools.eq_(len(second[1]), len(first[1]))
+
 @utils.visioner_available
 @utils.ffmpeg_found()
 @nose.tools.nottest
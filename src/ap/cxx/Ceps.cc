@@ -13,6 +13,10 @@
 #include <bob/ap/Ceps.h>
 #include <bob/core/assert.h>
 #include <bob/core/cast.h>
+#include <bob/core/array_utils.h>
+#include <bob/math/linear.h>
+#include <bob/sp/fftpack.h>
+#include <algorithm>
 
 bob::ap::Ceps::Ceps(const double sampling_frequency,
     const double win_length_ms, const double win_shift_ms,
@@ -142,28 +146,8 @@ void bob::ap::Ceps::operator()(const blitz::Array<double,1>& input,
   bob::core::array::assertSameShape(ceps_matrix, feature_shape);
   int n_frames=feature_shape(0);
 
-  blitz::Range r1(0,m_n_ceps-1);
-  for (int i=0; i<n_frames; ++i) 
-  {
-    // Set padded frame to zero
-    extractNormalizeFrame(input, i, m_cache_frame_d);
-
-    // Update output with energy if required
-    if (m_with_energy)
-      ceps_matrix(i,(int)m_n_ceps) = logEnergy(m_cache_frame_d);
-
-    // Apply pre-emphasis
-    pre_emphasis(m_cache_frame_d);
-    // Apply the Hamming window
-    hammingWindow(m_cache_frame_d);
-    // Take the power spectrum of the first part of the FFT
-    powerSpectrumFFT(m_cache_frame_d);
-    // Filter with the triangular filter bank (either in linear or Mel domain)
-    filterBank(m_cache_frame_d);
-    // Apply DCT kernel and update the output 
-    blitz::Array<double,1> ceps_matrix_row(ceps_matrix(i,r1));
-    applyDct(ceps_matrix_row);
-  }
+  // Computes the cepstral coefficients (and energy) of all frames
+  processAllFrames(input, n_frames, ceps_matrix);
 
   //compute the center of the cut-off frequencies
   const int n_coefs = (m_with_energy ?  m_n_ceps + 1 :  m_n_ceps);
@@ -185,6 +169,46 @@ void bob::ap::Ceps::operator()(const blitz::Array<double,1>& input,
   }
 }
 
+void bob::ap::Ceps::processFrames(const blitz::Array<double,1>& input,
+  const int begin, const int end, blitz::Array<double,2>& output) const
+{
+  // The output and the DCT kernel are shared with the other threads
+  blitz::Array<double,2> out(bob::core::array::private_view(output));
+  blitz::Array<double,2> frames(s_frames_per_block, m_win_size);
+  blitz::Array<double,2> bands(s_frames_per_block, m_n_filters);
+  blitz::Array<double,1> wsave(2*m_win_size+15);
+  rffti((int)m_win_size, wsave.data());
+  // The transposed DCT kernel, so that C = bands * kernel
+  const blitz::Array<double,2> dct_kernel_t =
+    bob::core::array::private_view(m_dct_kernel).transpose(1,0);
+
+  const blitz::Range rall = blitz::Range::all();
+  blitz::Range rc(0,m_n_ceps-1);
+  for (int b=begin; b<end; b+=s_frames_per_block)
+  {
+    const int n = std::min((int)s_frames_per_block, end-b);
+    blitz::Range rf(0,n-1);
+    blitz::Array<double,2> frames_b(frames(rf,rall));
+    blitz::Array<double,2> bands_b(bands(rf,rall));
+    extractFrames(input, b, frames_b);
+
+    // Update output with energy if required
+    if (m_with_energy)
+      for (int f=0; f<n; ++f)
+      {
+        blitz::Array<double,1> frame(frames_b(f,rall));
+        out(b+f,(int)m_n_ceps) = logEnergy(frame);
+      }
+
+    powerSpectra(frames_b, wsave);
+    // Filter with the triangular filter bank (either in linear or Mel domain)
+    filterBanks(frames_b, bands_b);
+    // Apply DCT kernel and update the output
+    blitz::Array<double,2> ceps_b(out(blitz::Range(b,b+n-1),rc));
+    bob::math::prod_(bands_b, dct_kernel_t, ceps_b);
+  }
+}
+
 void bob::ap::Ceps::applyDct(blitz::Array<double,1>& ceps_row) const
 {
   blitz::firstIndex i;
@@ -86,6 +86,18 @@ void bob::ap::Energy::operator()(const blitz::Array<double,1>& input,
   }
 }
 
+void bob::ap::Energy::processFrames(const blitz::Array<double,1>& input,
+  const int begin, const int end, blitz::Array<double,2>& output) const
+{
+  blitz::Array<double,1> frame(m_win_size);
+  for (int i=begin; i<end; ++i)
+  {
+    // Extract and normalize frame
+    extractNormalizeFrame(input, i, frame);
+    output(i,0) = logEnergy(frame);
+  }
+}
+
 double bob::ap::Energy::logEnergy(blitz::Array<double,1> &data) const
 {
   blitz::Array<double,1> data_p(data(blitz::Range(0,(int)m_win_length-1)));
@@ -0,0 +1,162 @@
+/**
+ * @file ap/cxx/FeatureStream.cc
+ * @date Sat Oct 18 16:21:09 2026 +0200
+ *
+ * @brief Extracts audio features from a stream of samples
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob/ap/FeatureStream.h>
+#include <bob/ap/Ceps.h>
+#include <algorithm>
+#include <stdexcept>
+
+bob::ap::FeatureStream::FeatureStream(boost::shared_ptr<const Energy> extractor):
+  m_extractor(extractor), m_delta_win(0), m_with_delta(false),
+  m_with_delta_delta(false)
+{
+  if (!m_extractor)
+    throw std::runtime_error("a feature stream requires a valid feature extractor");
+
+  m_n_features = m_extractor->getShape(m_extractor->getWinLength())(1);
+  m_n_coefs = m_n_features;
+  const bob::ap::Ceps* ceps = dynamic_cast<const bob::ap::Ceps*>(m_extractor.get());
+  if (ceps)
+  {
+    m_n_coefs = ceps->getNCeps() + (ceps->getWithEnergy() ? 1 : 0);
+    m_delta_win = ceps->getDeltaWin();
+    m_with_delta = ceps->getWithDelta();
+    m_with_delta_delta = ceps->getWithDeltaDelta();
+  }
+  reset();
+}
+
+bob::ap::FeatureStream::~FeatureStream()
+{
+}
+
+void bob::ap::FeatureStream::reset()
+{
+  m_samples.clear();
+  m_skip = 0;
+  m_n_samples = 0;
+  m_rows.clear();
+  m_first = 0;
+  m_n_frames = 0;
+  m_n_delta = 0;
+  m_n_delta_delta = 0;
+  m_n_emitted = 0;
+}
+
+blitz::Array<double,2>
+bob::ap::FeatureStream::process(const blitz::Array<double,1>& samples)
+{
+  const size_t n_samples = samples.extent(0);
+  m_n_samples += n_samples;
+
+  // Discards the samples between two frames (window shift larger than the
+  // window length), and appends the other ones to the buffer
+  const size_t start = std::min(m_skip, n_samples);
+  m_skip -= start;
+  for (size_t i=start; i<n_samples; ++i)
+    m_samples.push_back(samples(samples.lbound(0)+i));
+
+  // Computes the static features of the complete frames
+  const size_t win_length = m_extractor->getWinLength();
+  const size_t win_shift = m_extractor->getWinShift();
+  const size_t size = m_samples.size();
+  const size_t n_frames = (size >= win_length ? 1+(size-win_length)/win_shift : 0);
+  if (n_frames > 0)
+  {
+    blitz::Array<double,1> buffer(&m_samples[0], blitz::shape(size),
+      blitz::neverDeleteData);
+    blitz::Array<double,2> features(n_frames, m_n_features);
+    features = 0.;
+    m_extractor->processFrames(buffer, 0, n_frames, features);
+    for (size_t f=0; f<n_frames; ++f)
+      m_rows.push_back(features(f, blitz::Range::all()).copy());
+    m_n_frames += n_frames;
+
+    // Only keeps the samples of the next frames
+    const size_t consumed = n_frames * win_shift;
+    if (consumed >= size)
+    {
+      m_skip = consumed - size;
+      m_samples.clear();
+    }
+    else
+      m_samples.erase(m_samples.begin(), m_samples.begin()+consumed);
+  }
+
+  updateDerivatives(false);
+
+  size_t n_ready = m_n_frames;
+  if (m_with_delta_delta) n_ready = m_n_delta_delta;
+  else if (m_with_delta) n_ready = m_n_delta;
+  return emit(n_ready - m_n_emitted);
+}
+
+blitz::Array<double,2> bob::ap::FeatureStream::flush()
+{
+  updateDerivatives(true);
+  blitz::Array<double,2> res = emit(m_n_frames - m_n_emitted);
+  reset();
+  return res;
+}
+
+void bob::ap::FeatureStream::updateDerivatives(const bool last)
+{
+  if (!m_with_delta) return;
+
+  // The derivatives of a row need the delta_win following rows, unless the
+  // end of the stream has been reached
+  while (m_n_delta < m_n_frames && (last || m_n_delta+m_delta_win < m_n_frames))
+    derivative(m_n_delta++, 0, m_n_frames);
+
+  if (!m_with_delta_delta) return;
+  while (m_n_delta_delta < m_n_delta &&
+      (last || m_n_delta_delta+m_delta_win < m_n_delta))
+    derivative(m_n_delta_delta++, m_n_coefs, m_n_delta);
+}
+
+void bob::ap::FeatureStream::derivative(const size_t i, const int src,
+  const size_t n_rows)
+{
+  const blitz::Range rs(src, src+m_n_coefs-1);
+  blitz::Array<double,1> output(row(i)(blitz::Range(src+m_n_coefs,
+    src+2*m_n_coefs-1)));
+  output = 0.;
+
+  // \f$output[i] = \sum_{l=1}^{DW} l * (input[i+l] - input[i-l])\f$
+  for (size_t l=1; l<=m_delta_win; ++l)
+  {
+    const size_t ip = std::min(i+l, n_rows-1);
+    const size_t in = (i >= l ? i-l : 0);
+    output += (double)l * (row(ip)(rs) - row(in)(rs));
+  }
+
+  // Sum of the integer squared from 1 to delta_win
+  const double sum = m_delta_win*(m_delta_win+1)*(2*m_delta_win+1)/3;
+  output /= sum;
+}
+
+blitz::Array<double,2> bob::ap::FeatureStream::emit(const size_t n)
+{
+  blitz::Array<double,2> res(n, m_n_features);
+  for (size_t k=0; k<n; ++k)
+    res(k, blitz::Range::all()) = row(m_n_emitted+k);
+  m_n_emitted += n;
+
+  // Keeps the rows that are used by the derivatives still to compute
+  size_t keep = m_n_emitted;
+  if (m_with_delta_delta) keep = std::min(keep, m_n_delta_delta);
+  else if (m_with_delta) keep = std::min(keep, m_n_delta);
+  if (m_with_delta) keep = (keep > m_delta_win ? keep-m_delta_win : 0);
+  while (m_first < keep)
+  {
+    m_rows.pop_front();
+    ++m_first;
+  }
+  return res;
+}
@@ -12,6 +12,12 @@
 #include <bob/core/check.h>
 #include <bob/core/assert.h>
 #include <bob/core/cast.h>
+#include <bob/core/array_utils.h>
+#include <bob/sp/fftpack.h>
+#include <complex>
+#include <algorithm>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
 
 bob::ap::Spectrogram::Spectrogram(const double sampling_frequency,
     const double win_length_ms, const double win_shift_ms,
@@ -21,7 +27,7 @@ bob::ap::Spectrogram::Spectrogram(const double sampling_frequency,
   m_n_filters(n_filters), m_f_min(f_min), m_f_max(f_max),
   m_pre_emphasis_coeff(pre_emphasis_coeff), m_mel_scale(mel_scale),
   m_fb_out_floor(1.), m_energy_filter(false), m_log_filter(true),
-  m_energy_bands(false), m_fft()
+  m_energy_bands(false), m_n_threads(1), m_fft()
 {
   // Check pre-emphasis coefficient
   if (pre_emphasis_coeff < 0. || pre_emphasis_coeff > 1.) {
@@ -46,7 +52,8 @@ bob::ap::Spectrogram::Spectrogram(const Spectrogram& other):
   m_pre_emphasis_coeff(other.m_pre_emphasis_coeff),
   m_mel_scale(other.m_mel_scale), m_fb_out_floor(other.m_fb_out_floor),
   m_energy_filter(other.m_energy_filter), m_log_filter(other.m_log_filter),
-  m_energy_bands(other.m_energy_bands), m_fft(other.m_fft)
+  m_energy_bands(other.m_energy_bands), m_n_threads(other.m_n_threads),
+  m_fft(other.m_fft)
 {
   // Initialization
   initWinLength();
@@ -72,6 +79,7 @@ bob::ap::Spectrogram& bob::ap::Spectrogram::operator=(const bob::ap::Spectrogram
     m_energy_filter = other.m_energy_filter;
     m_log_filter = other.m_log_filter;
     m_energy_bands = other.m_energy_bands;
+    m_n_threads = other.m_n_threads;
     m_fft = other.m_fft;
 
     // Initialization
@@ -173,6 +181,13 @@ void bob::ap::Spectrogram::setMelScale(bool mel_scale)
   initCacheFilterBank();
 }
 
+void bob::ap::Spectrogram::setNThreads(size_t n_threads)
+{
+  if (n_threads == 0)
+    throw std::runtime_error("the number of threads should be strictly positive");
+  m_n_threads = n_threads;
+}
+
 double bob::ap::Spectrogram::herzToMel(double f)
 {
   return (2595.*log10(1+f/700.));
@@ -330,41 +345,138 @@ void bob::ap::Spectrogram::triangularFilterBank(blitz::Array<double,1>& data) co
   }
 }
 
-void bob::ap::Spectrogram::operator()(const blitz::Array<double,1>& input,
-  blitz::Array<double,2>& spectrogram_matrix)
+void bob::ap::Spectrogram::extractFrames(const blitz::Array<double,1>& input,
+  const int begin, blitz::Array<double,2>& frames) const
 {
-  // Get expected dimensionality of output array
-  blitz::TinyVector<int,2> spectrogram_shape = bob::ap::Spectrogram::getShape(input);
-  // Check dimensionality of output array
-  bob::core::array::assertSameShape(spectrogram_matrix, spectrogram_shape);
-  int n_frames=spectrogram_shape(0);
-
-  // Computes the center of the cut-off frequencies
-  blitz::Range r1 = blitz::Range(0,m_win_size/2);
-  if (m_energy_bands)
-    r1 = blitz::Range(0,m_n_filters-1);
-  for (int i=0; i<n_frames; ++i)
+  const int win_length = (int)m_win_length;
+  const int win_size = (int)m_win_size;
+  for (int f=0; f<frames.extent(0); ++f)
   {
-    // Extract and normalize frame
-    extractNormalizeFrame(input, i, m_cache_frame_d);
+    double* row = frames.data() + f*frames.stride(0);
+    // Extract frame input vector and pad it with zeros
+    const int start = (begin+f)*(int)m_win_shift;
+    double sum = 0.;
+    for (int j=0; j<win_length; ++j)
+    {
+      row[j] = input(start+j);
+      sum += row[j];
+    }
+    for (int j=win_length; j<win_size; ++j) row[j] = 0.;
+    // Subtract mean value (of the padded frame)
+    const double mean = sum / win_size;
+    for (int j=0; j<win_size; ++j) row[j] -= mean;
+  }
+}
 
+void bob::ap::Spectrogram::powerSpectra(blitz::Array<double,2>& frames,
+  blitz::Array<double,1>& wsave) const
+{
+  const int win_size = (int)m_win_size;
+  const int half = win_size/2;
+  for (int f=0; f<frames.extent(0); ++f)
+  {
+    blitz::Array<double,1> frame(frames(f, blitz::Range::all()));
     // Apply pre-emphasis
-    pre_emphasis(m_cache_frame_d);
+    pre_emphasis(frame);
     // Apply the Hamming window
-    hammingWindow(m_cache_frame_d);
-    // Take the power spectrum of the first part of the FFT
-    powerSpectrumFFT(m_cache_frame_d);
+    hammingWindow(frame);
+
+    // Apply the real FFT in place. The output is ordered as
+    // [Re(X0), Re(X1), Im(X1), ..., Re(X(n/2))]
+    double* x = frame.data();
+    rfftf(win_size, x, wsave.data());
+
+    // Take the magnitude of the first part of the output of the FFT, in place
+    const double nyquist = x[win_size-1];
+    x[0] = std::abs(x[0]);
+    for (int k=1; k<half; ++k)
+      x[k] = std::abs(std::complex<double>(x[2*k-1], x[2*k]));
+    if (half > 0) x[half] = std::abs(nyquist);
+    if (m_energy_filter) // Apply the filter bank to the energy
+      for (int k=0; k<=half; ++k) x[k] *= x[k];
+  }
+}
 
-    // Filter with the triangular filter bank (either in linear or Mel domain)
-    if (m_energy_bands)
-      filterBank(m_cache_frame_d);
+void bob::ap::Spectrogram::filterBanks(const blitz::Array<double,2>& spectra,
+  blitz::Array<double,2>& bands) const
+{
+  for (int f=0; f<spectra.extent(0); ++f)
+  {
+    const double* x = spectra.data() + f*spectra.stride(0);
+    for (int i=0; i<(int)m_n_filters; ++i)
+    {
+      const blitz::Array<double,1>& filter = m_filter_bank[i];
+      const double* xi = x + m_p_index(i);
+      double res = 0.;
+      for (int j=0; j<filter.extent(0); ++j) res += xi[j] * filter(j);
+      if (m_log_filter)
+        res = (res < m_fb_out_floor ? m_log_fb_out_floor : log(res));
+      bands(f,i) = res;
+    }
+  }
+}
 
-    blitz::Array<double,1> spec_matrix_row(spectrogram_matrix(i,r1));
+void bob::ap::Spectrogram::processFrames(const blitz::Array<double,1>& input,
+  const int begin, const int end, blitz::Array<double,2>& output) const
+{
+  // The output is shared with the other threads
+  blitz::Array<double,2> out(bob::core::array::private_view(output));
+  blitz::Array<double,2> frames(s_frames_per_block, m_win_size);
+  blitz::Array<double,2> bands(s_frames_per_block, m_n_filters);
+  blitz::Array<double,1> wsave(2*m_win_size+15);
+  rffti((int)m_win_size, wsave.data());
+
+  const blitz::Range rall = blitz::Range::all();
+  const int n_out = out.extent(1);
+  for (int b=begin; b<end; b+=s_frames_per_block)
+  {
+    const int n = std::min((int)s_frames_per_block, end-b);
+    blitz::Range rf(0,n-1);
+    blitz::Range ro(b,b+n-1);
+    blitz::Array<double,2> frames_b(frames(rf,rall));
+    extractFrames(input, b, frames_b);
+    powerSpectra(frames_b, wsave);
     if (m_energy_bands)
-      spec_matrix_row = m_cache_filters(r1);
+    {
+      blitz::Array<double,2> bands_b(bands(rf,rall));
+      filterBanks(frames_b, bands_b);
+      out(ro,rall) = bands_b;
+    }
     else
-      spec_matrix_row = m_cache_frame_d(r1);
+      out(ro,rall) = frames_b(rall,blitz::Range(0,n_out-1));
+  }
+}
+
+void bob::ap::Spectrogram::processAllFrames(const blitz::Array<double,1>& input,
+  const int n_frames, blitz::Array<double,2>& output) const
+{
+  const int n_threads = std::min((int)m_n_threads, n_frames);
+  if (n_threads <= 1)
+  {
+    processFrames(input, 0, n_frames, output);
+    return;
+  }
+
+  // Splits the frames into contiguous blocks of (almost) equal size
+  boost::thread_group threads;
+  for (int t=0; t<n_threads; ++t)
+  {
+    const int begin = (int)(((int64_t)n_frames * t) / n_threads);
+    const int end = (int)(((int64_t)n_frames * (t+1)) / n_threads);
+    threads.create_thread(boost::bind(&bob::ap::Spectrogram::processFrames,
+      this, boost::cref(input), begin, end, boost::ref(output)));
   }
+  threads.join_all();
 }
 
+void bob::ap::Spectrogram::operator()(const blitz::Array<double,1>& input,
+  blitz::Array<double,2>& spectrogram_matrix)
+{
+  // Get expected dimensionality of output array
+  blitz::TinyVector<int,2> spectrogram_shape = bob::ap::Spectrogram::getShape(input);
+  // Check dimensionality of output array
+  bob::core::array::assertSameShape(spectrogram_matrix, spectrogram_shape);
+  int n_frames=spectrogram_shape(0);
 
+  processAllFrames(input, n_frames, spectrogram_matrix);
+}
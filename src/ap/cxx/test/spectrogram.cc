@@ -0,0 +1,111 @@
+/**
+ * @file ap/cxx/test/spectrogram.cc
+ * @date Sun Oct 18 21:10:42 2026 +0200
+ *
+ * @brief Compares the spectrogram computed in blocks of frames with the
+ * frame by frame computation
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ap-Spectrogram Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <algorithm>
+#include <bob/ap/Spectrogram.h>
+
+/**
+ * Computes the spectrogram one frame at a time, with the complex FFT, as
+ * before frames were processed in blocks
+ */
+class PerFrameSpectrogram: public bob::ap::Spectrogram
+{
+  public:
+    PerFrameSpectrogram(const double sampling_frequency):
+      bob::ap::Spectrogram(sampling_frequency) {}
+
+    void perFrame(const blitz::Array<double,1>& input,
+      blitz::Array<double,2>& output)
+    {
+      const int n_frames = getShape(input)(0);
+      blitz::Range r1(0,m_win_size/2);
+      if (m_energy_bands)
+        r1 = blitz::Range(0,m_n_filters-1);
+      for (int i=0; i<n_frames; ++i)
+      {
+        extractNormalizeFrame(input, i, m_cache_frame_d);
+        pre_emphasis(m_cache_frame_d);
+        hammingWindow(m_cache_frame_d);
+        powerSpectrumFFT(m_cache_frame_d);
+        if (m_energy_bands)
+          filterBank(m_cache_frame_d);
+
+        blitz::Array<double,1> row(output(i,blitz::Range::all()));
+        if (m_energy_bands) row = m_cache_filters(r1);
+        else row = m_cache_frame_d(r1);
+      }
+    }
+};
+
+struct T {
+  blitz::Array<double,1> signal;
+
+  T(): signal(16000)
+  {
+    // Two seconds of tones and deterministic noise at 8kHz, long enough for
+    // several blocks of frames
+    double noise = 0.;
+    for (int i=0; i<signal.extent(0); ++i)
+    {
+      noise = 0.9 * noise + (double)((i * 7919) % 2001 - 1000);
+      signal(i) = 3000. * sin(2. * M_PI * 440. * i / 8000.) +
+        1000. * sin(2. * M_PI * 1250. * i / 8000.) + noise;
+    }
+  }
+
+  ~T() {}
+};
+
+/**
+ * The real FFT of the blocks and the complex FFT of the frames round
+ * differently: the magnitudes differ by about 1e-15 of the largest one, and
+ * the logarithms of the bands by about 1e-14.
+ */
+void check_blocks(PerFrameSpectrogram& s, const blitz::Array<double,1>& x)
+{
+  blitz::Array<double,2> ref(s.getShape(x));
+  s.perFrame(x, ref);
+  blitz::Array<double,2> res(s.getShape(x));
+  s(x, res);
+
+  const double scale = std::max(1., blitz::max(blitz::abs(ref)));
+  for (int i=0; i<ref.extent(0); ++i)
+    for (int j=0; j<ref.extent(1); ++j)
+      BOOST_CHECK_SMALL(res(i,j) - ref(i,j), 1e-12 * scale);
+}
+
+BOOST_FIXTURE_TEST_SUITE( test_setup, T )
+
+BOOST_AUTO_TEST_CASE( test_spectrogram_blocks )
+{
+  PerFrameSpectrogram s(8000.);
+  BOOST_REQUIRE(s.getShape(signal)(0) > 64);
+
+  // Magnitude and energy spectra
+  check_blocks(s, signal);
+  s.setEnergyFilter(true);
+  check_blocks(s, signal);
+
+  // Filter bank outputs, with and without the logarithm
+  s.setEnergyBands(true);
+  check_blocks(s, signal);
+  s.setLogFilter(false);
+  check_blocks(s, signal);
+  s.setMelScale(false);
+  check_blocks(s, signal);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
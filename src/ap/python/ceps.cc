@@ -120,6 +120,7 @@ void bind_ap_ceps()
     .add_property("energy_filter", &bob::ap::Spectrogram::getEnergyFilter, &bob::ap::Spectrogram::setEnergyFilter, "Tells whether we use the energy or the square root of the energy")
     .add_property("log_filter", &bob::ap::Spectrogram::getLogFilter, &bob::ap::Spectrogram::setLogFilter, "Tells whether we use the log triangular filter or the triangular filter")
     .add_property("energy_bands", &bob::ap::Spectrogram::getEnergyBands, &bob::ap::Spectrogram::setEnergyBands, "Tells whether we compute a spectrogram or energy bands")
+    .add_property("n_threads", &bob::ap::Spectrogram::getNThreads, &bob::ap::Spectrogram::setNThreads, "The number of threads used to process the frames (the output does not depend on it)")
     .def("__call__", &py_spectrogram_call, (arg("self"), arg("input")), "Computes the spectrogram")
   ;
 
@@ -12,6 +12,7 @@
 #include <bob/python/ndarray.h>
 
 void bind_ap_ceps();
+void bind_ap_stream();
 
 BOOST_PYTHON_MODULE(_ap)
 {
@@ -19,4 +20,5 @@ BOOST_PYTHON_MODULE(_ap)
   bob::python::setup_python("bob audio processing classes and sub-classes");
 
   bind_ap_ceps();
+  bind_ap_stream();
 }
@@ -0,0 +1,52 @@
+/**
+ * @file ap/python/stream.cc
+ * @date Sat Oct 18 16:21:09 2026 +0200
+ *
+ * @brief Binds the audio feature stream to python.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <boost/python.hpp>
+#include <bob/ap/FeatureStream.h>
+#include <bob/python/ndarray.h>
+
+using namespace boost::python;
+
+static const char* FEATURE_STREAM_DOC = "Objects of this class extract features from an audio signal given as a sequence of chunks of arbitrary sizes, using an Energy, Spectrogram or Ceps extractor. Feature rows are returned as soon as they are complete, and the concatenation of all returned rows is the same as the output of the extractor on the whole signal. The extractor should not be modified while a stream is processed.";
+
+static boost::shared_ptr<bob::ap::FeatureStream> py_stream_init(boost::shared_ptr<bob::ap::Energy> extractor)
+{
+  return boost::shared_ptr<bob::ap::FeatureStream>(new bob::ap::FeatureStream(extractor));
+}
+
+static object py_to_ndarray(const blitz::Array<double,2>& features)
+{
+  bob::python::ndarray res(bob::core::array::t_float64, features.extent(0), features.extent(1));
+  blitz::Array<double,2> res_ = res.bz<double,2>();
+  res_ = features;
+  return res.self();
+}
+
+static object py_stream_process(bob::ap::FeatureStream& stream, bob::python::const_ndarray samples)
+{
+  return py_to_ndarray(stream.process(samples.bz<double,1>()));
+}
+
+static object py_stream_flush(bob::ap::FeatureStream& stream)
+{
+  return py_to_ndarray(stream.flush());
+}
+
+void bind_ap_stream()
+{
+  class_<bob::ap::FeatureStream, boost::shared_ptr<bob::ap::FeatureStream>, boost::noncopyable>("FeatureStream", FEATURE_STREAM_DOC, no_init)
+    .def("__init__", make_constructor(&py_stream_init, default_call_policies(), (arg("extractor"))), "Creates a new feature stream, which uses the given extractor (Energy, Spectrogram or Ceps).")
+    .add_property("n_features", &bob::ap::FeatureStream::getNFeatures, "The dimension of the feature rows")
+    .add_property("n_samples", &bob::ap::FeatureStream::getNSamples, "The number of samples processed since the beginning of the stream")
+    .add_property("n_emitted", &bob::ap::FeatureStream::getNEmitted, "The number of feature rows returned since the beginning of the stream")
+    .def("process", &py_stream_process, (arg("self"), arg("samples")), "Processes a chunk of samples, and returns the feature rows that became available (possibly none), as a 2D array.")
+    .def("flush", &py_stream_flush, (arg("self")), "Ends the stream: returns the remaining feature rows, and resets the stream so that a new one can be processed.")
+    .def("reset", &bob::ap::FeatureStream::reset, (arg("self")), "Discards the state of the current stream.")
+    ;
+}
@@ -155,6 +155,7 @@ template <typename T, int N> struct bz_to_npy {
     for (int k=0; k<PyArray_NDIM(retval); ++k) stride[k] = (PyArray_STRIDES(retval)[k]/sizeof(T));
     array_type bzdest((T*)PyArray_DATA(retval), shape, stride, blitz::neverDeleteData);
     bzdest = tv;
+    bob::python::account_copy(PyArray_NBYTES(retval));
 
     return reinterpret_cast<PyObject*>(retval);
   }
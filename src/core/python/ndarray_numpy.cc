@@ -155,9 +155,17 @@ void register_const_ndarray_to_npy() {
               >();
 }
 
+static boost::python::tuple copy_statistics() {
+  const bob::python::copy_statistics_t& s = bob::python::copy_statistics();
+  return boost::python::make_tuple(s.count, s.bytes);
+}
+
 void bind_core_ndarray_numpy () {
    ndarray_from_npy();
    register_ndarray_to_npy();
    const_ndarray_from_npy();
    register_const_ndarray_to_npy();
+
+   boost::python::def("copy_statistics", &copy_statistics, "Returns a tuple (count, bytes) with the number of array copies performed while moving arrays between C++ and Python and the total number of bytes copied, since the last call to reset_copy_statistics().");
+   boost::python::def("reset_copy_statistics", &bob::python::reset_copy_statistics, "Resets the counters returned by copy_statistics() to zero.");
 }
@@ -0,0 +1,348 @@
+/**
+ * @file io/cxx/BatchLoader.cc
+ * @date Sun Oct 19 11:48:26 2026 +0200
+ *
+ * @brief Implements the parallel loading of lists of files
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <boost/format.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+
+#include <bob/io/BatchLoader.h>
+#include <bob/io/utils.h>
+
+bob::io::BatchLoader::BatchLoader(const size_t n_threads):
+  m_n_threads(1),
+  m_use_options(false)
+{
+  setNThreads(n_threads);
+}
+
+bob::io::BatchLoader::BatchLoader(const bob::io::ImageLoadOptions& options,
+    const size_t n_threads):
+  m_n_threads(1),
+  m_use_options(false)
+{
+  setNThreads(n_threads);
+  setOptions(options);
+}
+
+void bob::io::BatchLoader::setNThreads(const size_t n_threads)
+{
+  if (n_threads == 0)
+    throw std::runtime_error("the number of threads should be strictly positive");
+  m_n_threads = n_threads;
+}
+
+void bob::io::BatchLoader::setOptions(const bob::io::ImageLoadOptions& options)
+{
+  options.check();
+  m_options = options;
+  m_use_options = true;
+}
+
+boost::shared_ptr<bob::io::File> bob::io::BatchLoader::open
+(const std::string& filename) const
+{
+  if (m_use_options) return bob::io::open(filename, m_options);
+  return bob::io::open(filename, 'r');
+}
+
+/**
+ * Takes the index of the next file to process, and returns false if there
+ * is no file left
+ */
+static bool next_file(size_t* next, const size_t size, boost::mutex* mutex,
+    size_t& index)
+{
+  boost::mutex::scoped_lock lock(*mutex);
+  if (*next >= size) return false;
+  index = (*next)++;
+  return true;
+}
+
+void bob::io::BatchLoader::peekFiles(
+    const std::vector<std::string>* filenames,
+    std::vector<bob::core::array::typeinfo>* types,
+    std::vector<std::string>* errors, size_t* next,
+    boost::mutex* mutex) const
+{
+  size_t i;
+  while (next_file(next, filenames->size(), mutex, i)) {
+    try {
+      (*types)[i] = open((*filenames)[i])->type_all();
+    }
+    catch (std::exception& e) {
+      (*types)[i].reset();
+      (*errors)[i] = e.what();
+    }
+    catch (...) {
+      (*types)[i].reset();
+      (*errors)[i] = "unknown error while opening the file";
+    }
+  }
+}
+
+/**
+ * Reads the file into a view of the buffer, so that a file with a different
+ * type is detected instead of reallocating the buffer
+ */
+static void read_into(bob::io::File& file,
+    bob::core::array::interface& buffer)
+{
+  bob::core::array::blitz_array view(buffer.ptr(), buffer.type());
+  file.read_all(view);
+  if (view.ptr() != buffer.ptr()) {
+    boost::format m("the contents of the file `%s' (%s) do not match the given buffer (%s)");
+    m % file.filename() % view.type().str() % buffer.type().str();
+    throw std::runtime_error(m.str());
+  }
+}
+
+void bob::io::BatchLoader::readFiles(
+    const std::vector<std::string>* filenames,
+    const std::vector<boost::shared_ptr<bob::core::array::interface> >* buffers,
+    std::vector<std::string>* errors, size_t* next,
+    boost::mutex* mutex) const
+{
+  size_t i;
+  while (next_file(next, filenames->size(), mutex, i)) {
+    const boost::shared_ptr<bob::core::array::interface>& buffer = (*buffers)[i];
+    if (!buffer) continue;
+    try {
+      read_into(*open((*filenames)[i]), *buffer);
+    }
+    catch (std::exception& e) {
+      (*errors)[i] = e.what();
+    }
+    catch (...) {
+      (*errors)[i] = "unknown error while reading the file";
+    }
+  }
+}
+
+void bob::io::BatchLoader::peek(const std::vector<std::string>& filenames,
+    std::vector<bob::core::array::typeinfo>& types,
+    std::vector<std::string>& errors) const
+{
+  types.resize(filenames.size());
+  errors.assign(filenames.size(), std::string());
+
+  size_t next = 0;
+  boost::mutex mutex;
+  const size_t n_threads = std::max((size_t)1, std::min(m_n_threads, filenames.size()));
+  boost::thread_group threads;
+  for (size_t t=1; t<n_threads; ++t)
+    threads.create_thread(boost::bind(&bob::io::BatchLoader::peekFiles, this,
+      &filenames, &types, &errors, &next, &mutex));
+  peekFiles(&filenames, &types, &errors, &next, &mutex);
+  threads.join_all();
+}
+
+void bob::io::BatchLoader::read(const std::vector<std::string>& filenames,
+    const std::vector<boost::shared_ptr<bob::core::array::interface> >& buffers,
+    std::vector<std::string>& errors) const
+{
+  if (buffers.size() != filenames.size()) {
+    boost::format m("the number of buffers (%d) does not match the number of files (%d)");
+    m % buffers.size() % filenames.size();
+    throw std::runtime_error(m.str());
+  }
+  errors.assign(filenames.size(), std::string());
+
+  size_t next = 0;
+  boost::mutex mutex;
+  const size_t n_threads = std::max((size_t)1, std::min(m_n_threads, filenames.size()));
+  boost::thread_group threads;
+  for (size_t t=1; t<n_threads; ++t)
+    threads.create_thread(boost::bind(&bob::io::BatchLoader::readFiles, this,
+      &filenames, &buffers, &errors, &next, &mutex));
+  readFiles(&filenames, &buffers, &errors, &next, &mutex);
+  threads.join_all();
+}
+
+bool bob::io::BatchLoader::stackedType(
+    const std::vector<bob::core::array::typeinfo>& types,
+    bob::core::array::typeinfo& stacked)
+{
+  const bob::core::array::typeinfo* first = 0;
+  for (size_t i=0; i<types.size(); ++i) {
+    if (!types[i].is_valid()) continue;
+    if (!first) first = &types[i];
+    else if (!types[i].is_compatible(*first)) return false;
+  }
+  if (!first || first->nd >= BOB_MAX_DIM) return false;
+
+  size_t shape[BOB_MAX_DIM];
+  shape[0] = types.size();
+  for (size_t k=0; k<first->nd; ++k) shape[k+1] = first->shape[k];
+  stacked.set(first->dtype, first->nd + 1, shape);
+  return true;
+}
+
+struct bob::io::BatchLoader::LoadState {
+
+  LoadState(const size_t n_files):
+    is_stacked(true),
+    slice_size(0),
+    types(n_files),
+    in_stack(n_files, false),
+    arrays(n_files)
+  {
+  }
+
+  bool is_stacked; ///< can the files loaded so far be stacked?
+  bob::core::array::typeinfo slice_type; ///< the type of the first file
+  size_t slice_size; ///< the size of each slice of the stacked array
+  boost::shared_ptr<bob::core::array::interface> stacked;
+  std::vector<bob::core::array::typeinfo> types; ///< the types of the files
+  std::vector<bool> in_stack; ///< is the file decoded into its slice?
+  std::vector<boost::shared_ptr<bob::core::array::interface> > arrays;
+
+  /**
+   * Gets the buffer the file i (with the given type) is decoded into: its
+   * slice of the stacked array while all the types match, a separate array
+   * otherwise. The stacked array is allocated when the first type is known.
+   */
+  boost::shared_ptr<bob::core::array::interface> buffer(const size_t i,
+      const bob::core::array::typeinfo& type,
+      bob::io::BatchLoader::Allocator& allocator, boost::mutex& mutex)
+  {
+    boost::mutex::scoped_lock lock(mutex);
+    types[i] = type;
+    if (is_stacked && !stacked) {
+      if (type.nd < BOB_MAX_DIM) {
+        size_t shape[BOB_MAX_DIM];
+        shape[0] = types.size();
+        for (size_t k=0; k<type.nd; ++k) shape[k+1] = type.shape[k];
+        bob::core::array::typeinfo stacked_type;
+        stacked_type.set(type.dtype, type.nd + 1, shape);
+        stacked = allocator.allocate(stacked_type);
+        slice_type = type;
+        slice_size = type.buffer_size();
+      }
+      else is_stacked = false;
+    }
+    if (is_stacked && type.is_compatible(slice_type)) {
+      in_stack[i] = true;
+      return boost::shared_ptr<bob::core::array::interface>(
+        new bob::core::array::blitz_array(
+          static_cast<char*>(stacked->ptr()) + i*slice_size, type));
+    }
+    is_stacked = false;
+    arrays[i] = allocator.allocate(type);
+    return arrays[i];
+  }
+
+};
+
+void bob::io::BatchLoader::loadFiles(
+    const std::vector<std::string>* filenames,
+    bob::io::BatchLoader::Allocator* allocator,
+    bob::io::BatchLoader::LoadState* state,
+    std::vector<std::string>* errors, size_t* next,
+    boost::mutex* mutex) const
+{
+  size_t i;
+  while (next_file(next, filenames->size(), mutex, i)) {
+    // The file is released before taking the next one
+    try {
+      boost::shared_ptr<bob::io::File> file = open((*filenames)[i]);
+      read_into(*file, *state->buffer(i, file->type_all(), *allocator, *mutex));
+    }
+    catch (std::exception& e) {
+      (*errors)[i] = e.what();
+    }
+    catch (...) {
+      (*errors)[i] = "unknown error while loading the file";
+    }
+  }
+}
+
+bool bob::io::BatchLoader::load(const std::vector<std::string>& filenames,
+    bob::io::BatchLoader::Allocator& allocator,
+    boost::shared_ptr<bob::core::array::interface>& stacked,
+    std::vector<boost::shared_ptr<bob::core::array::interface> >& arrays,
+    std::vector<std::string>& errors) const
+{
+  errors.assign(filenames.size(), std::string());
+  LoadState state(filenames.size());
+
+  size_t next = 0;
+  boost::mutex mutex;
+  const size_t n_threads = std::max((size_t)1, std::min(m_n_threads, filenames.size()));
+  boost::thread_group threads;
+  for (size_t t=1; t<n_threads; ++t)
+    threads.create_thread(boost::bind(&bob::io::BatchLoader::loadFiles, this,
+      &filenames, &allocator, &state, &errors, &next, &mutex));
+  loadFiles(&filenames, &allocator, &state, &errors, &next, &mutex);
+  threads.join_all();
+
+  stacked.reset();
+  arrays.clear();
+  if (state.is_stacked && state.stacked) {
+    // Zeroes the slices of the files which could not be loaded
+    char* ptr = static_cast<char*>(state.stacked->ptr());
+    for (size_t i=0; i<filenames.size(); ++i)
+      if (!state.in_stack[i] || !errors[i].empty())
+        std::memset(ptr + i*state.slice_size, 0, state.slice_size);
+    stacked = state.stacked;
+    return true;
+  }
+
+  // The files decoded before a different type was found are copied out of
+  // their slice
+  arrays.resize(filenames.size());
+  for (size_t i=0; i<filenames.size(); ++i) {
+    if (!errors[i].empty()) continue;
+    if (!state.in_stack[i]) {
+      arrays[i] = state.arrays[i];
+      continue;
+    }
+    arrays[i] = allocator.allocate(state.types[i]);
+    std::memcpy(arrays[i]->ptr(),
+      static_cast<char*>(state.stacked->ptr()) + i*state.slice_size,
+      state.slice_size);
+  }
+  return false;
+}
+
+namespace {
+
+  /**
+   * Allocates the arrays with blitz
+   */
+  class BlitzAllocator: public bob::io::BatchLoader::Allocator {
+    public:
+      virtual boost::shared_ptr<bob::core::array::interface>
+        allocate(const bob::core::array::typeinfo& type)
+      {
+        return boost::make_shared<bob::core::array::blitz_array>(type);
+      }
+  };
+
+}
+
+bool bob::io::BatchLoader::load(const std::vector<std::string>& filenames,
+    bob::core::array::blitz_array& stacked,
+    std::vector<boost::shared_ptr<bob::core::array::blitz_array> >& arrays,
+    std::vector<std::string>& errors) const
+{
+  BlitzAllocator allocator;
+  boost::shared_ptr<bob::core::array::interface> stacked_;
+  std::vector<boost::shared_ptr<bob::core::array::interface> > arrays_;
+  const bool is_stacked = load(filenames, allocator, stacked_, arrays_, errors);
+  if (is_stacked)
+    stacked.set(boost::static_pointer_cast<bob::core::array::blitz_array>(stacked_));
+  arrays.resize(arrays_.size());
+  for (size_t i=0; i<arrays_.size(); ++i)
+    arrays[i] = boost::static_pointer_cast<bob::core::array::blitz_array>(arrays_[i]);
+  return is_stacked;
+}
@@ -24,6 +24,7 @@ boost::shared_ptr<bob::io::CodecRegistry> bob::io::CodecRegistry::instance() {
 void bob::io::CodecRegistry::deregisterExtension(const std::string& ext) {
   s_extension2codec.erase(ext);
   s_extension2description.erase(ext);
+  s_extension2decoder.erase(ext);
 }
 
 void bob::io::CodecRegistry::deregisterFactory(bob::io::file_factory_t factory) {
@@ -38,6 +39,7 @@ void bob::io::CodecRegistry::deregisterFactory(bob::io::file_factory_t factory)
       it != to_remove.end(); ++it) {
     s_extension2codec.erase(*it);
     s_extension2description.erase(*it);
+    s_extension2decoder.erase(*it);
   }
 
 }
@@ -92,3 +94,47 @@ bob::io::file_factory_t bob::io::CodecRegistry::findByFilenameExtension
   return findByExtension(boost::filesystem::path(filename).extension().c_str());
 
 }
+
+void bob::io::CodecRegistry::registerImageDecoder(const std::string& extension,
+    bob::io::image_decoder_t decoder) {
+
+  std::map<std::string, bob::io::image_decoder_t>::iterator it = 
+    s_extension2decoder.find(extension);
+
+  if (it == s_extension2decoder.end()) {
+    s_extension2decoder[extension] = decoder;
+  }
+  else if (!s_ignore) {
+    boost::format m("image decoder already registered for extension: %s - ignoring second registration");
+    m % extension;
+    bob::core::error << m.str() << std::endl;
+    throw std::runtime_error(m.str());
+  }
+
+}
+
+bob::io::image_decoder_t bob::io::CodecRegistry::findImageDecoderByExtension
+(const std::string& extension) {
+
+  std::string lower_extension = extension;
+  std::transform(extension.begin(), extension.end(), lower_extension.begin(), ::tolower);
+
+  std::map<std::string, bob::io::image_decoder_t>::iterator it = 
+    s_extension2decoder.find(lower_extension);
+
+  if (it == s_extension2decoder.end()) {
+    boost::format m("no image decoder supporting loading options for extension: %s");
+    m % lower_extension;
+    throw std::runtime_error(m.str());
+  }
+
+  return it->second;
+
+}
+
+bob::io::image_decoder_t bob::io::CodecRegistry::findImageDecoderByFilenameExtension
+(const std::string& filename) {
+
+  return findImageDecoderByExtension(boost::filesystem::path(filename).extension().c_str());
+
+}
@@ -46,7 +46,7 @@ static boost::shared_ptr<hid_t> open_dataset
 
   boost::shared_ptr<hid_t> retval(new hid_t(-1),
       std::ptr_fun(delete_h5dataset));
-  *retval = H5Dopen2(*par->location(), name.c_str(), H5P_DEFAULT);
+  *retval = H5Dopen2(*par->location(), name.c_str(), *par->file()->dapl());
   if (*retval < 0) {
     throw status_error("H5Dopen2", *retval);
   }
@@ -264,17 +264,36 @@ static void create_dataset (boost::shared_ptr<bob::io::detail::hdf5::Group> par,
   //supposed to be a list -- HDF5 only supports expandability like this.
   boost::shared_ptr<hid_t> dcpl = open_plist(H5P_DATASET_CREATE);
 
+  boost::shared_ptr<hid_t> cls = type.htype();
+
   //according to the HDF5 manual, chunks have to have the same rank as the
-  //array shape.
+  //array shape. By default, each chunk holds a single entry along the first
+  //dimension; if the file sets a target chunk size, we group as many entries
+  //as fit in it, so small objects do not pay the per-chunk overhead.
   bob::io::HDF5Shape chunking(xshape);
   chunking[0] = 1;
+  size_t chunk_bytes = par->file()->chunk_bytes();
+  if (chunk_bytes) {
+    hsize_t row_bytes = H5Tget_size(*cls);
+    for (size_t k=1; k<chunking.n(); ++k) row_bytes *= chunking[k];
+    hsize_t rows = row_bytes? (chunk_bytes / row_bytes) : 1;
+    if (rows < 1) rows = 1;
+    if (!list && rows > xshape[0]) rows = xshape[0];
+    chunking[0] = rows;
+  }
   if (list || compression) { ///< note: compression requires chunking
     herr_t status = H5Pset_chunk(*dcpl, chunking.n(), chunking.get());
     if (status < 0) throw status_error("H5Pset_chunk", status);
   }
 
-  //if the user has decided to compress the dataset, do it with gzip.
+  //if the user has decided to compress the dataset, do it with gzip,
+  //optionally preceeded by byte shuffling, which groups the bytes of the
+  //same significance and makes numerical data compress better and faster.
   if (compression) {
+    if (par->file()->shuffle()) {
+      herr_t status = H5Pset_shuffle(*dcpl);
+      if (status < 0) throw status_error("H5Pset_shuffle", status);
+    }
     if (compression > 9) compression = 9;
     herr_t status = H5Pset_deflate(*dcpl, compression);
     if (status < 0) throw status_error("H5Pset_deflate", status);
@@ -289,8 +308,6 @@ static void create_dataset (boost::shared_ptr<bob::io::detail::hdf5::Group> par,
   //please note that we don't define the fill value as in the example, but
   //according to the HDF5 documentation, this value is set to zero by default.
 
-  boost::shared_ptr<hid_t> cls = type.htype();
-
   //finally create the dataset on the file.
   boost::shared_ptr<hid_t> dataset(new hid_t(-1),
       std::ptr_fun(delete_h5dataset));
@@ -491,6 +508,46 @@ void bob::io::detail::hdf5::Dataset::read_buffer (size_t index, const bob::io::H
   if (status < 0) throw status_error("H5Dread", status);
 }
 
+void bob::io::detail::hdf5::Dataset::read_buffer (size_t index, size_t count,
+    const bob::io::HDF5Type& dest, void* buffer) {
+
+  //finds compatibility type
+  std::vector<bob::io::HDF5Descriptor>::iterator it = find_type_index(m_descr, dest);
+
+  //if we cannot find a compatible type, we throw
+  if (it == m_descr.end()) {
+    boost::format m("trying to read or write `%s' at `%s' that only accepts `%s'");
+    m % dest.str() % url() % m_descr[0].type.str();
+    throw std::runtime_error(m.str());
+  }
+
+  //checks indexing
+  if (index + count > it->size) {
+    boost::format m("trying to access elements [%d, %d[ in Dataset '%s' that only contains %d elements");
+    m % index % (index + count) % url() % it->size;
+    throw std::runtime_error(m.str());
+  }
+
+  if (!count) return;
+
+  //a single hyperslab covers the whole range, read in one call
+  bob::io::HDF5Shape start(it->hyperslab_start);
+  bob::io::HDF5Shape extent(it->hyperslab_count);
+  start[0] = index;
+  extent[0] *= count;
+
+  boost::shared_ptr<hid_t> memspace = open_memspace(extent);
+
+  herr_t status = H5Sselect_hyperslab(*m_filespace, H5S_SELECT_SET,
+      start.get(), 0, extent.get(), 0);
+  if (status < 0) throw status_error("H5Sselect_hyperslab", status);
+
+  status = H5Dread(*m_id, *it->type.htype(), *memspace, *m_filespace,
+      H5P_DEFAULT, buffer);
+
+  if (status < 0) throw status_error("H5Dread", status);
+}
+
 void bob::io::detail::hdf5::Dataset::write_buffer (size_t index, const bob::io::HDF5Type& dest,
     const void* buffer) {
 
@@ -105,6 +105,15 @@ void bob::io::HDF5File::unlink (const std::string& path) {
   m_cwd->remove_dataset(path);
 }
 
+void bob::io::HDF5File::setChunkCache(size_t nslots, size_t nbytes,
+    double w0) {
+  m_file->set_chunk_cache(nslots, nbytes, w0);
+  std::string current_path = m_cwd->path();
+  m_file->reset(); //re-open all datasets with the new access settings
+  m_cwd = m_file->root();
+  m_cwd = m_cwd->cd(current_path); //go back to the path we were before
+}
+
 void bob::io::HDF5File::rename (const std::string& from, const std::string& to) {
   if (!m_file->writeable()) {
     boost::format m("cannot rename dataset '%s' -> '%s' at path '%s' of file '%s' because it is not writeable");
@@ -158,6 +167,11 @@ void bob::io::HDF5File::read_buffer (const std::string& path, size_t pos,
   (*m_cwd)[path]->read_buffer(pos, type, buffer);
 }
 
+void bob::io::HDF5File::read_buffer (const std::string& path, size_t pos,
+    size_t count, const bob::io::HDF5Type& type, void* buffer) const {
+  (*m_cwd)[path]->read_buffer(pos, count, type, buffer);
+}
+
 void bob::io::HDF5File::write_buffer (const std::string& path,
     size_t pos, const bob::io::HDF5Type& type, const void* buffer) {
   if (!m_file->writeable()) {
@@ -106,7 +106,10 @@ bob::io::detail::hdf5::File::File(const boost::filesystem::path& path, unsigned
   m_path(path),
   m_flags(flags),
   m_fcpl(create_fcpl(userblock_size)),
-  m_id(open_file(m_path, m_flags, m_fcpl))
+  m_id(open_file(m_path, m_flags, m_fcpl)),
+  m_dapl(boost::make_shared<hid_t>(H5P_DEFAULT)),
+  m_chunk_bytes(0),
+  m_shuffle(false)
 {
 }
 
@@ -140,6 +143,24 @@ size_t bob::io::detail::hdf5::File::userblock_size() const {
   return retval;
 }
 
+void bob::io::detail::hdf5::File::set_chunk_cache(size_t nslots,
+    size_t nbytes, double w0) {
+  boost::shared_ptr<hid_t> dapl(new hid_t(-1), std::ptr_fun(delete_h5p));
+  *dapl = H5Pcreate(H5P_DATASET_ACCESS);
+  if (*dapl < 0) {
+    boost::format m("call to HDF5 C-function H5Pcreate() returned error %d. HDF5 error statck follows:\n%s");
+    m % *dapl % bob::io::format_hdf5_error();
+    throw std::runtime_error(m.str());
+  }
+  herr_t err = H5Pset_chunk_cache(*dapl, nslots, nbytes, w0);
+  if (err < 0) {
+    boost::format m("call to HDF5 C-function H5Pset_chunk_cache() returned error %d. HDF5 error statck follows:\n%s");
+    m % err % bob::io::format_hdf5_error();
+    throw std::runtime_error(m.str());
+  }
+  m_dapl = dapl;
+}
+
 void bob::io::detail::hdf5::File::get_userblock(std::string& data) const {
   //TODO
 }
@@ -17,11 +17,15 @@
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
 
 #include <bob/io/CodecRegistry.h>
 #include <bob/core/logging.h>
 
 #include <jpeglib.h>
+#include <jerror.h>
 
 // Default JPEG quality
 static int s_jpeg_quality = 92;
@@ -55,28 +59,121 @@ static void my_error_exit (j_common_ptr cinfo){
 }
 
 
+/**
+ * Reads the whole (compressed) file in memory, so that it is opened only once
+ * to get the image type and to load it
+ */
+static void read_file(const std::string& path, std::vector<JOCTET>& data) {
+  boost::shared_ptr<std::FILE> in_file = make_cfile(path.c_str(), "rb");
+  std::fseek(in_file.get(), 0, SEEK_END);
+  const long size = std::ftell(in_file.get());
+  std::fseek(in_file.get(), 0, SEEK_SET);
+  if (size <= 0) {
+    boost::format m("the file `%s' is empty or cannot be read");
+    m % path;
+    throw std::runtime_error(m.str());
+  }
+  data.resize(size);
+  if (std::fread(&data[0], 1, size, in_file.get()) != (size_t)size) {
+    boost::format m("the file `%s' could not be read entirely");
+    m % path;
+    throw std::runtime_error(m.str());
+  }
+}
+
+/**
+ * MEMORY SOURCE (jpeg_mem_src() is not available with libjpeg < 8)
+ */
+static void mem_init_source(j_decompress_ptr) {}
+
+static boolean mem_fill_input_buffer(j_decompress_ptr cinfo) {
+  // The whole data is already in the buffer: inserts a fake EOI marker, as
+  // recommended by libjpeg for truncated files
+  static const JOCTET eoi[2] = { (JOCTET)0xFF, (JOCTET)JPEG_EOI };
+  WARNMS(cinfo, JWRN_JPEG_EOF);
+  cinfo->src->next_input_byte = eoi;
+  cinfo->src->bytes_in_buffer = 2;
+  return TRUE;
+}
+
+static void mem_skip_input_data(j_decompress_ptr cinfo, long num_bytes) {
+  if (num_bytes <= 0) return;
+  if ((size_t)num_bytes > cinfo->src->bytes_in_buffer) {
+    mem_fill_input_buffer(cinfo);
+    return;
+  }
+  cinfo->src->next_input_byte += num_bytes;
+  cinfo->src->bytes_in_buffer -= num_bytes;
+}
+
+static void mem_term_source(j_decompress_ptr) {}
+
+static void set_mem_src(struct jpeg_decompress_struct *cinfo,
+    struct jpeg_source_mgr *src, const std::vector<JOCTET>& data) {
+  src->init_source = mem_init_source;
+  src->fill_input_buffer = mem_fill_input_buffer;
+  src->skip_input_data = mem_skip_input_data;
+  src->resync_to_restart = jpeg_resync_to_restart;
+  src->term_source = mem_term_source;
+  src->next_input_byte = &data[0];
+  src->bytes_in_buffer = data.size();
+  cinfo->src = src;
+}
+
+/**
+ * Releases the decompression structures, also when an error is raised
+ */
+struct decompress_guard {
+  struct jpeg_decompress_struct *cinfo;
+  decompress_guard(struct jpeg_decompress_struct *c): cinfo(c) {}
+  ~decompress_guard() { jpeg_destroy_decompress(cinfo); }
+};
+
+/**
+ * Reads the header from memory, and sets the decompression parameters
+ * matching the loading options. Returns true if the grayscale conversion
+ * should be done after the decompression (libjpeg only converts YCbCr
+ * images to grayscale).
+ */
+static bool setup_decompress(struct jpeg_decompress_struct *cinfo,
+    struct jpeg_source_mgr *src, const std::vector<JOCTET>& data,
+    const bob::io::ImageLoadOptions& options) {
+  set_mem_src(cinfo, src, data);
+  jpeg_read_header(cinfo, TRUE);
+
+  // Downscales in the DCT domain
+  cinfo->scale_num = 1;
+  cinfo->scale_denom = options.denominator(cinfo->image_height, cinfo->image_width);
+
+  // Only decodes the luminance for grayscale outputs
+  bool convert_gray = false;
+  if (options.gray && cinfo->num_components == 3) {
+    if (cinfo->jpeg_color_space == JCS_YCbCr) cinfo->out_color_space = JCS_GRAYSCALE;
+    else convert_gray = true;
+  }
+
+  jpeg_calc_output_dimensions(cinfo);
+  return convert_gray;
+}
+
 /**
  * LOADING
  */
-static void im_peek(const std::string& path, bob::core::array::typeinfo& info) {
+static void im_peek(const std::vector<JOCTET>& data,
+    const bob::io::ImageLoadOptions& options,
+    bob::core::array::typeinfo& info) {
   // 1. JPEG structures
   struct jpeg_decompress_struct cinfo;
   struct jpeg_error_mgr jerr;
+  struct jpeg_source_mgr src;
   cinfo.err = jpeg_std_error(&jerr);
   jerr.error_exit = my_error_exit;
   jpeg_create_decompress(&cinfo);
+  decompress_guard guard(&cinfo);
 
-  // 2. JPEG file opening
-  boost::shared_ptr<std::FILE> in_file = make_cfile(path.c_str(), "rb");
-  jpeg_stdio_src(&cinfo, in_file.get());
-
-  // 3. Read header
-  jpeg_read_header(&cinfo, TRUE);
-
-  // 4. Set parameters for decompression if any
-
-  // 5. Start decompression and get information
-  jpeg_start_decompress(&cinfo);
+  // 2. Read header and compute the output dimensions, without starting the
+  // decompression
+  const bool convert_gray = setup_decompress(&cinfo, &src, data, options);
 
   if( cinfo.output_components != 1 && cinfo.output_components != 3)
   {
@@ -87,7 +184,7 @@ static void im_peek(const std::string& path, bob::core::array::typeinfo& info) {
 
   // Set depth and number of dimensions
   info.dtype = bob::core::array::t_uint8;
-  info.nd = (cinfo.output_components == 1? 2 : 3);
+  info.nd = (cinfo.output_components == 1 || convert_gray ? 2 : 3);
   if(info.nd == 2)
   {
     info.shape[0] = cinfo.output_height;
@@ -104,16 +201,20 @@ static void im_peek(const std::string& path, bob::core::array::typeinfo& info) {
 }
 
 template <typename T> static
-void im_load_gray(struct jpeg_decompress_struct *cinfo, bob::core::array::interface& b) {
+void im_load_gray(struct jpeg_decompress_struct *cinfo,
+    const size_t scanlines, bob::core::array::interface& b) {
   const bob::core::array::typeinfo& info = b.type();
 
+  // Decodes several rows at once, directly into the output array
   T *element = static_cast<T*>(b.ptr());
   const int row_stride = info.shape[1];
-  JSAMPROW buffer_pptr[1];
-  while (cinfo->output_scanline < cinfo->image_height) {
-    buffer_pptr[0] = element;
-    jpeg_read_scanlines(cinfo, buffer_pptr, 1);
-    element += row_stride;
+  std::vector<JSAMPROW> buffer_pptr(scanlines);
+  while (cinfo->output_scanline < cinfo->output_height) {
+    const JDIMENSION n_rows = std::min((JDIMENSION)scanlines,
+        cinfo->output_height - cinfo->output_scanline);
+    for (JDIMENSION k=0; k<n_rows; ++k)
+      buffer_pptr[k] = element + k*row_stride;
+    element += row_stride * jpeg_read_scanlines(cinfo, &buffer_pptr[0], n_rows);
   }
 }
 
@@ -127,52 +228,71 @@ void imbuffer_to_rgb(size_t size, const T* im, T* r, T* g, T* b) {
 }
 
 template <typename T> static
-void im_load_color(struct jpeg_decompress_struct *cinfo, bob::core::array::interface& b) {
-  const bob::core::array::typeinfo& info = b.type();
+void imbuffer_to_gray(size_t size, const T* im, T* gray) {
+  for (size_t k=0; k<size; ++k)
+    gray[k] = (T)((299*im[3*k] + 587*im[3*k +1] + 114*im[3*k +2] + 500) / 1000);
+}
 
-  long unsigned int frame_size = info.shape[1] * info.shape[2];
+template <typename T> static
+void im_load_color(struct jpeg_decompress_struct *cinfo,
+    const size_t scanlines, const bool convert_gray,
+    bob::core::array::interface& b) {
+  const size_t width = cinfo->output_width;
+  const size_t frame_size = cinfo->output_height * width;
   T *element_r = static_cast<T*>(b.ptr());
   T *element_g = element_r+frame_size;
   T *element_b = element_g+frame_size;
 
-  const int row_stride = cinfo->output_width * cinfo->output_components;
-  JSAMPROW buffer_pptr[1];
-  boost::shared_array<JSAMPLE> buffer(new JSAMPLE[row_stride]);
-  buffer_pptr[0] = buffer.get();
+  // Decodes several rows at once, and converts them while they are in cache
+  const int row_stride = width * cinfo->output_components;
+  boost::shared_array<JSAMPLE> buffer(new JSAMPLE[scanlines*row_stride]);
+  std::vector<JSAMPROW> buffer_pptr(scanlines);
+  for (size_t k=0; k<scanlines; ++k)
+    buffer_pptr[k] = buffer.get() + k*row_stride;
   while (cinfo->output_scanline < cinfo->output_height) {
-    jpeg_read_scanlines(cinfo, buffer_pptr, 1);
-    imbuffer_to_rgb<T>(info.shape[2], reinterpret_cast<T*>(buffer_pptr[0]), element_r, element_g, element_b);
-    element_r += cinfo->output_width;
-    element_g += cinfo->output_width;
-    element_b += cinfo->output_width;
+    const JDIMENSION n_rows = std::min((JDIMENSION)scanlines,
+        cinfo->output_height - cinfo->output_scanline);
+    const JDIMENSION n_read = jpeg_read_scanlines(cinfo, &buffer_pptr[0], n_rows);
+    for (JDIMENSION k=0; k<n_read; ++k) {
+      const T* row = reinterpret_cast<const T*>(buffer_pptr[k]);
+      if (convert_gray) {
+        imbuffer_to_gray<T>(width, row, element_r);
+      }
+      else {
+        imbuffer_to_rgb<T>(width, row, element_r, element_g, element_b);
+        element_g += width;
+        element_b += width;
+      }
+      element_r += width;
+    }
   }
 }
 
-static void im_load(const std::string& filename, bob::core::array::interface& b) {
+static void im_load(const std::string& filename,
+    const std::vector<JOCTET>& data, const bob::io::ImageLoadOptions& options,
+    bob::core::array::interface& b) {
   // 1. JPEG structures
   struct jpeg_decompress_struct cinfo;
   struct jpeg_error_mgr jerr;
+  struct jpeg_source_mgr src;
   cinfo.err = jpeg_std_error(&jerr);
   jerr.error_exit = my_error_exit;
   jpeg_create_decompress(&cinfo);
+  decompress_guard guard(&cinfo);
 
-  // 2. JPEG file opening
-  boost::shared_ptr<std::FILE> in_file = make_cfile(filename.c_str(), "rb");
-  jpeg_stdio_src(&cinfo, in_file.get());
+  // 2. Read header and set parameters for decompression
+  const bool convert_gray = setup_decompress(&cinfo, &src, data, options);
 
-  // 3. Read header
-  jpeg_read_header(&cinfo, TRUE);
-
-  // 4. Set parameters for decompression
-
-  // 5. Start decompression and get information
+  // 3. Start decompression
   jpeg_start_decompress(&cinfo);
 
-  // 6. Read content
+  // 4. Read content
   const bob::core::array::typeinfo& info = b.type();
   if(info.dtype == bob::core::array::t_uint8) {
-    if(info.nd == 2) im_load_gray<uint8_t>(&cinfo, b);
-    else if( info.nd == 3) im_load_color<uint8_t>(&cinfo, b);
+    if(info.nd == 2 && cinfo.output_components == 1)
+      im_load_gray<uint8_t>(&cinfo, options.scanlines, b);
+    else if((info.nd == 3 || convert_gray) && cinfo.output_components == 3)
+      im_load_color<uint8_t>(&cinfo, options.scanlines, convert_gray, b);
     else {
       boost::format m("the image in file `%s' has a number of dimensions this jpeg codec has no support for: %s");
       m % filename % info.str();
@@ -185,11 +305,9 @@ static void im_load(const std::string& filename, bob::core::array::interface& b)
     throw std::runtime_error(m.str());
   }
 
-  // 7. Finish decompression
+  // 5. Finish decompression (the decompression object is released by the
+  // guard)
   jpeg_finish_decompress(&cinfo);
-
-  // 8. Release JPEG decompression object
-  jpeg_destroy_decompress(&cinfo);
 }
 
 /**
@@ -314,7 +432,8 @@ class ImageJpegFile: public bob::io::File {
 
         if (mode == 'r' || (mode == 'a' && boost::filesystem::exists(path))) {
           {
-            im_peek(path, m_type);
+            read_file(path, m_data);
+            im_peek(m_data, m_options, m_type);
             m_length = 1;
             m_newfile = false;
           }
@@ -326,6 +445,26 @@ class ImageJpegFile: public bob::io::File {
 
       }
 
+    /**
+     * Read-only image, decoded with the given options from the file or from
+     * the given buffer (if not null)
+     */
+    ImageJpegFile(const std::string& path, const void* data, size_t size,
+        const bob::io::ImageLoadOptions& options):
+      m_filename(path),
+      m_newfile(false),
+      m_options(options),
+      m_length(1) {
+
+        if (data) {
+          const JOCTET* begin = static_cast<const JOCTET*>(data);
+          m_data.assign(begin, begin + size);
+        }
+        else read_file(path, m_data);
+        im_peek(m_data, m_options, m_type);
+
+      }
+
     virtual ~ImageJpegFile() { }
 
     virtual const std::string& filename() const {
@@ -362,12 +501,13 @@ class ImageJpegFile: public bob::io::File {
         throw std::runtime_error("cannot read image with index > 0 -- there is only one image in an image file");
 
       if(!buffer.type().is_compatible(m_type)) buffer.set(m_type);
-      im_load(m_filename, buffer);
+      im_load(m_filename, m_data, m_options, buffer);
     }
 
     virtual size_t append (const bob::core::array::interface& buffer) {
       if (m_newfile) {
         im_save(m_filename, buffer);
+        read_file(m_filename, m_data); // so that the image can be read back
         m_type = buffer.type();
         m_newfile = false;
         m_length = 1;
@@ -390,6 +530,8 @@ class ImageJpegFile: public bob::io::File {
   private: //representation
     std::string m_filename;
     bool m_newfile;
+    std::vector<JOCTET> m_data; ///< the compressed image, for reading
+    bob::io::ImageLoadOptions m_options;
     bob::core::array::typeinfo m_type;
     size_t m_length;
 
@@ -431,6 +573,15 @@ make_file (const std::string& path, char mode) {
   return boost::make_shared<ImageJpegFile>(path, mode);
 }
 
+/**
+ * This defines the factory method of the decoder with loading options.
+ */
+static boost::shared_ptr<bob::io::File>
+make_decoder (const std::string& path, const void* data, size_t size,
+    const bob::io::ImageLoadOptions& options) {
+  return boost::make_shared<ImageJpegFile>(path, data, size, options);
+}
+
 /**
  * Takes care of codec registration per se.
  */
@@ -442,6 +593,8 @@ static bool register_codec() {
   {
     instance->registerExtension(".jpg", "JPG, compressed (libjpeg)", &make_file);
     instance->registerExtension(".jpeg", "JPEG, compressed (libjpeg)", &make_file);
+    instance->registerImageDecoder(".jpg", &make_decoder);
+    instance->registerImageDecoder(".jpeg", &make_decoder);
   }
   else
     bob::core::warn << "LibJPEG compiled with " << BITS_IN_JSAMPLE <<
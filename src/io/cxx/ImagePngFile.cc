@@ -16,6 +16,10 @@
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 
 #include <bob/io/CodecRegistry.h>
 
@@ -44,195 +48,270 @@ static boost::shared_ptr<std::FILE> make_cfile(const char *filename, const char
 }
 
 /**
- * LOADING
+ * Reads the whole (compressed) file in memory, so that it is opened only once
+ * to get the image type and to load it
  */
-static void im_peek(const std::string& path, bob::core::array::typeinfo& info)
+static void read_file(const std::string& path, std::vector<png_byte>& data)
 {
-  // 1. PNG structure declarations
+  boost::shared_ptr<std::FILE> in_file = make_cfile(path.c_str(), "rb");
+  std::fseek(in_file.get(), 0, SEEK_END);
+  const long size = std::ftell(in_file.get());
+  std::fseek(in_file.get(), 0, SEEK_SET);
+  if(size <= 0) {
+    boost::format m("the file `%s' is empty or cannot be read");
+    m % path;
+    throw std::runtime_error(m.str());
+  }
+  data.resize(size);
+  if(std::fread(&data[0], 1, size, in_file.get()) != (size_t)size) {
+    boost::format m("the file `%s' could not be read entirely");
+    m % path;
+    throw std::runtime_error(m.str());
+  }
+}
+
+/**
+ * Reads the PNG data from memory
+ */
+struct mem_source {
+  const std::vector<png_byte>* data;
+  size_t offset;
+};
+
+static void mem_read(png_structp png_ptr, png_bytep out, png_size_t length)
+{
+  mem_source* src = static_cast<mem_source*>(png_get_io_ptr(png_ptr));
+  if(src->offset + length > src->data->size())
+    png_error(png_ptr, "read beyond the end of the PNG data");
+  std::memcpy(out, &(*src->data)[src->offset], length);
+  src->offset += length;
+}
+
+/**
+ * Creates the PNG read structures, and releases them when going out of scope
+ * (also when an error is raised)
+ */
+struct png_reader {
   png_structp png_ptr;
   png_infop info_ptr;
+  mem_source src;
 
-  // 2. PNG file opening
-  boost::shared_ptr<std::FILE> in_file = make_cfile(path.c_str(), "rb");
-
-  // 3. Create and initialize the png_struct. The compiler header file version
-  //    is supplied, so that we know if the application was compiled with a
-  //    compatible version of the library.
-  png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
-  if(png_ptr == NULL) throw std::runtime_error("PNG: error while creating read png structure (function png_create_read_struct())");
+  png_reader(const std::vector<png_byte>& data): png_ptr(0), info_ptr(0)
+  {
+    // Create and initialize the png_struct. The compiler header file version
+    // is supplied, so that we know if the application was compiled with a
+    // compatible version of the library.
+    png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    if(png_ptr == NULL) throw std::runtime_error("PNG: error while creating read png structure (function png_create_read_struct())");
+
+    // Allocate/initialize the memory for image information.
+    info_ptr = png_create_info_struct(png_ptr);
+    if(info_ptr == NULL) {
+      png_destroy_read_struct(&png_ptr, NULL, NULL);
+      throw std::runtime_error("PNG: error while creating info png structure (function png_create_info_struct())");
+    }
 
-  // Allocate/initialize the memory for image information.
-  info_ptr = png_create_info_struct(png_ptr);
-  if(info_ptr == NULL) {
-    png_destroy_read_struct(&png_ptr, NULL, NULL);
-    throw std::runtime_error("PNG: error while creating info png structure (function png_create_info_struct())");
+    src.data = &data;
+    src.offset = 0;
+    png_set_read_fn(png_ptr, &src, mem_read);
   }
 
-  // 4. Set error handling if you are using the setjmp/longjmp method (this is
-  // the normal method of doing things with libpng). This is required as we
-  // did not set up our own error handlers in the png_create_read_struct() earlier.
-  if(setjmp(png_jmpbuf(png_ptr)))
+  ~png_reader()
   {
-    // Free all of the memory associated with the png_ptr and info_ptr
     png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-    throw std::runtime_error("PNG: error while setting error handling (function setjmp(png_jmpbuf(()))");
   }
+};
 
-  // 5. Initialize
-  png_init_io(png_ptr, in_file.get());
-
-  // 7. The call to png_read_info() gives us all of the information from the
-  // PNG file.
-  png_read_info(png_ptr, info_ptr);
-  // Get header information
-  png_uint_32 width, height;
-  int bit_depth, color_type, interlace_type;
-  png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth, &color_type,
-    &interlace_type, NULL, NULL);
+/**
+ * Computes the type of the decoded image, given the header information and
+ * the loading options
+ */
+static void output_type(const png_uint_32 height, const png_uint_32 width,
+  const int bit_depth, const int color_type,
+  const bob::io::ImageLoadOptions& options, bob::core::array::typeinfo& info)
+{
+  if(color_type != PNG_COLOR_TYPE_GRAY && color_type != PNG_COLOR_TYPE_RGB && color_type != PNG_COLOR_TYPE_PALETTE) {
+    throw std::runtime_error("PNG: codec does not support images with color spaces different than GRAY, RGB or Indexed colors (Palette)");
+  }
 
-  // 8. Clean up after the read, and free any memory allocated
-  png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+  const size_t denom = options.denominator(height, width);
+  const size_t out_height = (height + denom - 1) / denom;
+  const size_t out_width = (width + denom - 1) / denom;
 
   // Set depth and number of dimensions
   info.dtype = (bit_depth <= 8 ? bob::core::array::t_uint8 : bob::core::array::t_uint16);
-  if(color_type == PNG_COLOR_TYPE_GRAY)
-    info.nd = 2;
-  else if (color_type == PNG_COLOR_TYPE_RGB || PNG_COLOR_TYPE_PALETTE)
-    info.nd = 3;
-  else {// Unsupported color type
-    throw std::runtime_error("PNG: codec does not support images with color spaces different than GRAY, RGB or Indexed colors (Palette)");
-  }
+  info.nd = (color_type == PNG_COLOR_TYPE_GRAY || options.gray ? 2 : 3);
   if(info.nd == 2)
   {
-    info.shape[0] = height;
-    info.shape[1] = width;
+    info.shape[0] = out_height;
+    info.shape[1] = out_width;
   }
   else
   {
     info.shape[0] = 3;
-    info.shape[1] = height;
-    info.shape[2] = width;
+    info.shape[1] = out_height;
+    info.shape[2] = out_width;
   }
   info.update_strides();
 }
 
-template <typename T> static
-void im_load_gray(png_structp png_ptr, bob::core::array::interface& b)
+/**
+ * LOADING
+ */
+static void im_peek(const std::vector<png_byte>& data,
+  const bob::io::ImageLoadOptions& options, bob::core::array::typeinfo& info)
 {
-  const bob::core::array::typeinfo& info = b.type();
-  const size_t height = info.shape[0];
-  const size_t width = info.shape[1];
+  // 1. PNG structures, reading from memory
+  png_reader reader(data);
 
-#ifdef PNG_READ_INTERLACING_SUPPORTED
-  // Turn on interlace handling.
-  int number_passes = png_set_interlace_handling(png_ptr);
-#else
-  int number_passes = 1;
-#endif // PNG_READ_INTERLACING_SUPPORTED
-
-  // Read the image (one row at a time)
-  // This can deal with interlacing
-  png_bytep ptr;
-  for(int pass=0; pass<number_passes; ++pass)
+  // 2. Set error handling if you are using the setjmp/longjmp method (this is
+  // the normal method of doing things with libpng). This is required as we
+  // did not set up our own error handlers in the png_create_read_struct() earlier.
+  if(setjmp(png_jmpbuf(reader.png_ptr)))
   {
-    // Loop over the rows
-    for(size_t y=0; y<height; ++y)
-    {
-      ptr = reinterpret_cast<png_bytep>(reinterpret_cast<T*>(b.ptr())+y*width);
-      png_read_row(png_ptr, ptr, NULL);
-    }
+    throw std::runtime_error("PNG: error while setting error handling (function setjmp(png_jmpbuf(()))");
   }
+
+  // 3. The call to png_read_info() gives us all of the information from the
+  // PNG file.
+  png_read_info(reader.png_ptr, reader.info_ptr);
+  // Get header information
+  png_uint_32 width, height;
+  int bit_depth, color_type, interlace_type;
+  png_get_IHDR(reader.png_ptr, reader.info_ptr, &width, &height, &bit_depth,
+    &color_type, &interlace_type, NULL, NULL);
+
+  output_type(height, width, bit_depth, color_type, options, info);
 }
 
-template <typename T> static
-void imbuffer_to_rgb(const size_t size, const T* im, T* r, T* g, T* b)
+/**
+ * PNG stores 16-bit samples in network (big-endian) byte order, which libpng
+ * swaps (png_set_swap()) on little-endian hosts
+ */
+static bool is_little_endian()
 {
-  for(size_t k=0; k<size; ++k)
-  {
-    r[k] = im[3*k];
-    g[k] = im[3*k +1];
-    b[k] = im[3*k +2];
-  }
+  const uint16_t one = 1;
+  return *reinterpret_cast<const uint8_t*>(&one) == 1;
 }
 
-template <typename T> static
-void im_load_color(png_structp png_ptr, bob::core::array::interface& b)
+/**
+ * Writes the decoded rows (with interleaved channels) into the planar output
+ * array, averaging the blocks of denom x denom pixels when downscaling
+ */
+template <typename T> class row_writer
 {
-  const bob::core::array::typeinfo& info = b.type();
-  const size_t height = info.shape[1];
-  const size_t width = info.shape[2];
-  const size_t frame_size = height * width;
-  const size_t row_color_stride = width;
+  public:
+    row_writer(bob::core::array::interface& b, const size_t height,
+        const size_t width, const size_t channels, const size_t denom):
+      m_output(static_cast<T*>(b.ptr())), m_height(height), m_width(width),
+      m_channels(channels), m_denom(denom),
+      m_out_width((width + denom - 1) / denom),
+      m_frame_size(((height + denom - 1) / denom) * m_out_width),
+      m_sum(denom > 1 ? channels * m_out_width : 0), m_y(0)
+    {
+    }
 
-  // Allocate array to contains a row of RGB-like pixels
-  boost::shared_array<T> row(new T[3*width]);
-  png_bytep row_pointer = reinterpret_cast<png_bytep>(row.get());
+    void push(const T* row)
+    {
+      const size_t out_y = m_y / m_denom;
+      if(m_denom == 1) {
+        for(size_t c=0; c<m_channels; ++c) {
+          T* out = m_output + c*m_frame_size + out_y*m_out_width;
+          for(size_t x=0; x<m_width; ++x) out[x] = row[x*m_channels + c];
+        }
+      }
+      else {
+        for(size_t x=0; x<m_width; ++x)
+          for(size_t c=0; c<m_channels; ++c)
+            m_sum[c*m_out_width + x/m_denom] += row[x*m_channels + c];
+
+        // Last row of a block of rows: writes the averages
+        if((m_y + 1) % m_denom == 0 || m_y + 1 == m_height) {
+          const size_t n_rows = m_y % m_denom + 1;
+          for(size_t c=0; c<m_channels; ++c) {
+            T* out = m_output + c*m_frame_size + out_y*m_out_width;
+            uint32_t* sum = &m_sum[c*m_out_width];
+            for(size_t x=0; x<m_out_width; ++x) {
+              const size_t n = n_rows * (std::min(m_width, (x+1)*m_denom) - x*m_denom);
+              out[x] = (T)((sum[x] + n/2) / n);
+              sum[x] = 0;
+            }
+          }
+        }
+      }
+      ++m_y;
+    }
 
-#ifdef PNG_READ_INTERLACING_SUPPORTED
-  // Turn on interlace handling.
-  int number_passes = png_set_interlace_handling(png_ptr);
-#else
-  int number_passes = 1;
-#endif // PNG_READ_INTERLACING_SUPPORTED
+  private:
+    T* m_output;
+    const size_t m_height, m_width, m_channels, m_denom;
+    const size_t m_out_width, m_frame_size;
+    std::vector<uint32_t> m_sum; ///< sums over the current block of rows
+    size_t m_y; ///< index of the next input row
+};
 
-  // Read the image (one row at a time)
-  // This can deal with interlacing
-  T *element_r;
-  T *element_g;
-  T *element_b;
-  for(int pass=0; pass<number_passes; ++pass)
-  {
-    element_r = reinterpret_cast<T*>(b.ptr());
-    element_g = element_r + frame_size;
-    element_b = element_g + frame_size;
-    // Loop over the rows
-    for(size_t y=0; y<height; ++y)
+template <typename T> static
+void im_load_rows(png_structp png_ptr, const size_t height,
+  const size_t width, const size_t channels, const int number_passes,
+  const size_t scanlines, const size_t denom, bob::core::array::interface& b)
+{
+  // Grayscale images at full scale are decoded directly into the output
+  if(channels == 1 && denom == 1) {
+    T* output = static_cast<T*>(b.ptr());
+    const size_t n_rows = (number_passes > 1 ? height : scanlines);
+    std::vector<png_bytep> rows(n_rows);
+    for(int pass=0; pass<number_passes; ++pass)
     {
-      png_read_row(png_ptr, row_pointer, NULL);
-      imbuffer_to_rgb(row_color_stride, reinterpret_cast<T*>(row_pointer), element_r, element_g, element_b);
-      element_r += row_color_stride;
-      element_g += row_color_stride;
-      element_b += row_color_stride;
+      for(size_t y=0; y<height; y+=n_rows)
+      {
+        const size_t n = std::min(n_rows, height - y);
+        for(size_t k=0; k<n; ++k)
+          rows[k] = reinterpret_cast<png_bytep>(output + (y+k)*width);
+        png_read_rows(png_ptr, &rows[0], NULL, n);
+      }
     }
+    return;
+  }
+
+  // Otherwise, several rows are decoded at once, and written to the output
+  // while they are in cache. Interlaced images need all the rows for each
+  // pass.
+  const size_t n_rows = (number_passes > 1 ? height : std::min(scanlines, height));
+  const size_t row_size = width * channels;
+  boost::shared_array<T> buffer(new T[n_rows * row_size]);
+  std::vector<png_bytep> rows(n_rows);
+  for(size_t k=0; k<n_rows; ++k)
+    rows[k] = reinterpret_cast<png_bytep>(buffer.get() + k*row_size);
+
+  row_writer<T> writer(b, height, width, channels, denom);
+  for(size_t y=0; y<height; y+=n_rows)
+  {
+    const size_t n = std::min(n_rows, height - y);
+    for(int pass=0; pass<number_passes; ++pass)
+      png_read_rows(png_ptr, &rows[0], NULL, n);
+    for(size_t k=0; k<n; ++k)
+      writer.push(buffer.get() + k*row_size);
   }
 }
 
-static void im_load(const std::string& filename, bob::core::array::interface& b)
+static void im_load(const std::string& filename,
+  const std::vector<png_byte>& data, const bob::io::ImageLoadOptions& options,
+  bob::core::array::interface& b)
 {
-  // 1. PNG structure declarations
-  png_structp png_ptr;
-  png_infop info_ptr;
-
-  // 2. PNG file opening
-  boost::shared_ptr<std::FILE> in_file = make_cfile(filename.c_str(), "rb");
-
-  // 3. Create and initialize the png_struct with the desired error handler
-  // functions. The compiler header file version is supplied, so that we
-  // know if the application was compiled with a compatible version of the library.
-  png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
-  if(png_ptr == NULL) throw std::runtime_error("PNG: error while creating read png structure (function png_create_read_struct())");
-
-  // Allocate/initialize the memory for image informatio
-  info_ptr = png_create_info_struct(png_ptr);
-  if(info_ptr == NULL) {
-    png_destroy_read_struct(&png_ptr, NULL, NULL);
-    throw std::runtime_error("PNG: error while creating info png structure (function png_create_info_struct())");
-  }
+  // 1. PNG structures, reading from memory
+  png_reader reader(data);
+  png_structp png_ptr = reader.png_ptr;
+  png_infop info_ptr = reader.info_ptr;
 
-  // 4. Set error handling if you are using the setjmp/longjmp method (this is
+  // 2. Set error handling if you are using the setjmp/longjmp method (this is
   // the normal method of doing things with libpng). This is required as we did
   // not set up your own error handlers in the png_create_read_struct() earlier.
   if(setjmp(png_jmpbuf(png_ptr)))
   {
-    // Free all of the memory associated with the png_ptr and info_ptr
-    png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
     throw std::runtime_error("PNG: error while setting error handling (function setjmp(png_jmpbuf(()))");
   }
 
-  // 5. Initialize
-  png_init_io(png_ptr, in_file.get());
-
-  // 6. The call to png_read_info() gives us all of the information from the
+  // 3. The call to png_read_info() gives us all of the information from the
   // PNG file.
   png_read_info(png_ptr, info_ptr);
   // Get header information
@@ -241,6 +320,16 @@ static void im_load(const std::string& filename, bob::core::array::interface& b)
   png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth, &color_type,
        &interlace_type, NULL, NULL);
 
+  // We currently only support grayscale and rgb images
+  bob::core::array::typeinfo expected;
+  output_type(height, width, bit_depth, color_type, options, expected);
+  const bob::core::array::typeinfo& info = b.type();
+  if(!info.is_compatible(expected)) {
+    boost::format m("the image in file `%s' is decoded as %s, which does not match the given array: %s");
+    m % filename % expected.str() % info.str();
+    throw std::runtime_error(m.str());
+  }
+
   // Extract multiple pixels with bit depths of 1, 2, and 4 from a single
   // byte into separate bytes (useful for paletted and grayscale images).
   png_set_packing(png_ptr);
@@ -250,44 +339,37 @@ static void im_load(const std::string& filename, bob::core::array::interface& b)
     png_set_expand_gray_1_2_4_to_8(png_ptr);
   else if(color_type == PNG_COLOR_TYPE_PALETTE)
     png_set_palette_to_rgb(png_ptr);
-  // We currently only support grayscale and rgb images
-  if(color_type != PNG_COLOR_TYPE_GRAY && color_type != PNG_COLOR_TYPE_RGB && color_type != PNG_COLOR_TYPE_PALETTE) {
-    throw std::runtime_error("PNG: codec does not support images with color spaces different than GRAY, RGB or Indexed colors (Palette)");
-  }
 
-  // 7. Read content
-  const bob::core::array::typeinfo& info = b.type();
-  if(info.dtype == bob::core::array::t_uint8) {
-    if(info.nd == 2) im_load_gray<uint8_t>(png_ptr, b);
-    else if( info.nd == 3) im_load_color<uint8_t>(png_ptr, b);
-    else {
-      png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-      boost::format m("the image in file `%s' has a number of dimensions for which this png codec has no support for: %s");
-      m % info.str();
-      throw std::runtime_error(m.str());
-    }
-  }
-  else if(info.dtype == bob::core::array::t_uint16) {
-    if(info.nd == 2) im_load_gray<uint16_t>(png_ptr, b);
-    else if( info.nd == 3) im_load_color<uint16_t>(png_ptr, b);
-    else {
-      png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-      boost::format m("the image in file `%s' has a number of dimensions for which this png codec has no support for: %s");
-      m % info.str();
-      throw std::runtime_error(m.str());
-    }
-  }
-  else {
-    png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-    boost::format m("the image in file `%s' has a data type this png codec has no support for: %s");
-    m % info.str();
-    throw std::runtime_error(m.str());
-  }
+  // 16-bit samples in the byte order of the host
+  if(bit_depth == 16 && is_little_endian())
+    png_set_swap(png_ptr);
+
+  // Let libpng compute the luminance of color images
+  if(color_type != PNG_COLOR_TYPE_GRAY && options.gray)
+    png_set_rgb_to_gray_fixed(png_ptr, 1, -1, -1);
+
+#ifdef PNG_READ_INTERLACING_SUPPORTED
+  // Turn on interlace handling.
+  int number_passes = png_set_interlace_handling(png_ptr);
+#else
+  int number_passes = 1;
+#endif // PNG_READ_INTERLACING_SUPPORTED
 
-  // 8. Clean up after the read, and free any memory allocated
-  // Read rest of file, and get additional chunks in info_ptr
+  png_read_update_info(png_ptr, info_ptr);
+  const size_t channels = png_get_channels(png_ptr, info_ptr);
+  const size_t denom = options.denominator(height, width);
+
+  // 4. Read content
+  if(info.dtype == bob::core::array::t_uint8)
+    im_load_rows<uint8_t>(png_ptr, height, width, channels, number_passes,
+      options.scanlines, denom, b);
+  else
+    im_load_rows<uint16_t>(png_ptr, height, width, channels, number_passes,
+      options.scanlines, denom, b);
+
+  // 5. Read rest of file, and get additional chunks in info_ptr (the
+  // structures are released by the reader)
   png_read_end(png_ptr, NULL);
-  png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
 }
 
 
@@ -405,6 +487,10 @@ static void im_save(const std::string& filename, const bob::core::array::interfa
   // Pack pixels into bytes
   png_set_packing(png_ptr);
 
+  // 16-bit samples from the byte order of the host
+  if(bit_depth == 16 && is_little_endian())
+    png_set_swap(png_ptr);
+
   // 7. Writes content
   if(info.dtype == bob::core::array::t_uint8) {
     if(info.nd == 2) im_save_gray<uint8_t>(array, png_ptr);
@@ -473,7 +559,8 @@ class ImagePngFile: public bob::io::File {
 
         if (mode == 'r' || (mode == 'a' && boost::filesystem::exists(path))) {
           {
-            im_peek(path, m_type);
+            read_file(path, m_data);
+            im_peek(m_data, m_options, m_type);
             m_length = 1;
             m_newfile = false;
           }
@@ -485,6 +572,26 @@ class ImagePngFile: public bob::io::File {
 
       }
 
+    /**
+     * Read-only image, decoded with the given options from the file or from
+     * the given buffer (if not null)
+     */
+    ImagePngFile(const std::string& path, const void* data, size_t size,
+        const bob::io::ImageLoadOptions& options):
+      m_filename(path),
+      m_newfile(false),
+      m_options(options),
+      m_length(1) {
+
+        if (data) {
+          const png_byte* begin = static_cast<const png_byte*>(data);
+          m_data.assign(begin, begin + size);
+        }
+        else read_file(path, m_data);
+        im_peek(m_data, m_options, m_type);
+
+      }
+
     virtual ~ImagePngFile() { }
 
     virtual const std::string& filename() const {
@@ -521,12 +628,13 @@ class ImagePngFile: public bob::io::File {
         throw std::runtime_error("cannot read image with index > 0 -- there is only one image in an image file");
 
       if(!buffer.type().is_compatible(m_type)) buffer.set(m_type);
-      im_load(m_filename, buffer);
+      im_load(m_filename, m_data, m_options, buffer);
     }
 
     virtual size_t append (const bob::core::array::interface& buffer) {
       if (m_newfile) {
         im_save(m_filename, buffer);
+        read_file(m_filename, m_data); // so that the image can be read back
         m_type = buffer.type();
         m_newfile = false;
         m_length = 1;
@@ -549,6 +657,8 @@ class ImagePngFile: public bob::io::File {
   private: //representation
     std::string m_filename;
     bool m_newfile;
+    std::vector<png_byte> m_data; ///< the compressed image, for reading
+    bob::io::ImageLoadOptions m_options;
     bob::core::array::typeinfo m_type;
     size_t m_length;
 
@@ -590,6 +700,15 @@ make_file (const std::string& path, char mode) {
   return boost::make_shared<ImagePngFile>(path, mode);
 }
 
+/**
+ * This defines the factory method of the decoder with loading options.
+ */
+static boost::shared_ptr<bob::io::File>
+make_decoder (const std::string& path, const void* data, size_t size,
+    const bob::io::ImageLoadOptions& options) {
+  return boost::make_shared<ImagePngFile>(path, data, size, options);
+}
+
 /**
  * Takes care of codec registration per se.
  */
@@ -598,6 +717,7 @@ static bool register_codec() {
     bob::io::CodecRegistry::instance();
 
   instance->registerExtension(".png", "PNG, compressed (libpng)", &make_file);
+  instance->registerImageDecoder(".png", &make_decoder);
 
   return true;
 }
@@ -0,0 +1,62 @@
+/**
+ * @file io/cxx/MappedTensorFile.cc
+ * @date Sat Oct 18 10:12:31 2026 +0200
+ *
+ * @brief Implementation of memory-mapped access to .tensor files
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <fstream>
+#include <bob/io/MappedTensorFile.h>
+#include <bob/io/reorder.h>
+
+/**
+ * Reads the header with the stock stream-based reader, so both readers agree
+ * on the file layout.
+ */
+static bob::io::detail::TensorFileHeader read_header
+(const std::string& filename) {
+  std::ifstream stream(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!stream) {
+    boost::format m("cannot open tensor file `%s' for reading");
+    m % filename;
+    throw std::runtime_error(m.str());
+  }
+  bob::io::detail::TensorFileHeader header;
+  header.read(stream);
+  return header;
+}
+
+bob::io::MappedTensorFile::MappedTensorFile(const std::string& filename):
+  m_filename(filename),
+  m_header(read_header(filename)),
+  m_file(filename),
+  m_data(m_file.data())
+{
+  size_t expected = m_header.getArrayIndex(m_header.m_n_samples);
+  if (m_file.size() < expected) {
+    boost::format m("tensor file `%s' is truncated: header declares %d arrays (%d bytes), but the file only has %d bytes");
+    m % filename % m_header.m_n_samples % expected % m_file.size();
+    throw std::runtime_error(m.str());
+  }
+}
+
+bob::io::MappedTensorFile::~MappedTensorFile() {
+}
+
+const void* bob::io::MappedTensorFile::data(size_t index) const {
+  if (index >= size()) {
+    boost::format m("request to read list item at position %d which is outside the bounds of declared object with size %d");
+    m % index % size();
+    throw std::runtime_error(m.str());
+  }
+  return m_data + m_header.getArrayIndex(index);
+}
+
+void bob::io::MappedTensorFile::read(size_t index,
+    bob::core::array::interface& buffer) const {
+  const void* src = data(index);
+  if (!buffer.type().is_compatible(m_header.m_type)) buffer.set(m_header.m_type);
+  bob::io::col_to_row_order(src, buffer.ptr(), m_header.m_type);
+}
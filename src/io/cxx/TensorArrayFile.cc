@@ -9,6 +9,7 @@
  */
 
 #include <bob/io/TensorFile.h>
+#include <bob/io/MappedTensorFile.h>
 #include <bob/io/CodecRegistry.h>
 
 class TensorArrayFile: public bob::io::File {
@@ -19,6 +20,9 @@ class TensorArrayFile: public bob::io::File {
       m_file(path, mode),
       m_filename(path) {
         if (m_file.size()) m_file.peek(m_type);
+        //read-only files are served straight from a memory map
+        if (mode == bob::io::TensorFile::in && m_file.size())
+          m_mapped.reset(new bob::io::MappedTensorFile(path));
       }
 
     virtual ~TensorArrayFile() { }
@@ -48,7 +52,8 @@ class TensorArrayFile: public bob::io::File {
       if(!m_file) 
         throw std::runtime_error("uninitialized binary file cannot be read");
 
-      m_file.read(0, buffer);
+      if (m_mapped) m_mapped->read(0, buffer);
+      else m_file.read(0, buffer);
 
     }
 
@@ -57,7 +62,8 @@ class TensorArrayFile: public bob::io::File {
       if(!m_file) 
         throw std::runtime_error("uninitialized binary file cannot be read");
 
-      m_file.read(index, buffer);
+      if (m_mapped) m_mapped->read(index, buffer);
+      else m_file.read(index, buffer);
 
     }
 
@@ -81,6 +87,7 @@ class TensorArrayFile: public bob::io::File {
   private: //representation
 
     bob::io::TensorFile m_file;
+    boost::shared_ptr<bob::io::MappedTensorFile> m_mapped;
     bob::core::array::typeinfo m_type;
     std::string m_filename;
 
@@ -19,6 +19,7 @@
 #include <blitz/array.h>
 #include <complex>
 #include <string>
+#include <ctime>
 #include "bob/core/logging.h" // for bob::core::tmpdir()
 #include "bob/core/cast.h"
 #include "bob/io/HDF5File.h"
@@ -134,4 +135,51 @@ BOOST_AUTO_TEST_CASE( hdf5_write_on_readonly )
   boost::filesystem::remove(filename);
 }
 
+BOOST_AUTO_TEST_CASE( hdf5_chunked_range_read )
+{
+  // Appends many small arrays to a list dataset with grouped chunks
+  const std::string filename = bob::core::tmpfile();
+  const int N = 2000;
+  bob::io::HDF5File config(filename, bob::io::HDF5File::trunc);
+  config.setChunkSize(64*1024);
+  config.setShuffle(true);
+  blitz::Array<double,1> v(16);
+  for (int i=0; i<N; ++i) {
+    v = i + blitz::firstIndex();
+    config.appendArray("features", v, 1);
+  }
+  config.setChunkCache(521, 4*1024*1024, 1.);
+
+  // Reads them one by one
+  std::clock_t begin = std::clock();
+  blitz::Array<double,2> one(N, 16);
+  for (int i=0; i<N; ++i) {
+    blitz::Array<double,1> row = one(i, blitz::Range::all());
+    row = config.readArray<double,1>("features", i);
+  }
+  double t_one = double(std::clock() - begin) / CLOCKS_PER_SEC;
+
+  // Reads them in a single shot
+  begin = std::clock();
+  blitz::Array<double,2> all(N, 16);
+  config.readArrays("features", 0, all);
+  double t_all = double(std::clock() - begin) / CLOCKS_PER_SEC;
+  check_equal(one, all);
+
+  // A sub-range
+  blitz::Array<double,2> some(10, 16);
+  config.readArrays("features", N-10, some);
+  blitz::Array<double,2> expected = all(blitz::Range(N-10, N-1), blitz::Range::all());
+  check_equal(expected, some);
+
+  // Out of bounds
+  BOOST_CHECK_THROW(config.readArrays("features", N-5, some), std::runtime_error);
+
+  bob::core::info << "HDF5 read of " << N << " arrays: one by one " << t_one
+    << "s, single range " << t_all << "s" << std::endl;
+
+  // Clean-up
+  boost::filesystem::remove(filename);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -19,6 +19,10 @@
 #include <bob/core/cast.h>
 #include "bob/core/logging.h"
 #include "bob/io/utils.h"
+#include "bob/io/BatchLoader.h"
+
+#include <cstdio>
+#include <vector>
 
 struct T {
   blitz::Array<uint8_t,2> a;
@@ -154,6 +158,83 @@ BOOST_AUTO_TEST_CASE( image_tiff )
   }
 }
 
+BOOST_AUTO_TEST_CASE( image_png_options )
+{
+  std::string filename = bob::core::tmpfile(".png");
+  bob::io::save(filename, b);
+
+  // Downscaled: averages of blocks of 2x2 pixels
+  blitz::Array<uint8_t,3> half = bob::io::load<uint8_t,3>(filename,
+      bob::io::ImageLoadOptions(2));
+  BOOST_REQUIRE_EQUAL(half.extent(0), 3);
+  BOOST_REQUIRE_EQUAL(half.extent(1), 1);
+  BOOST_REQUIRE_EQUAL(half.extent(2), 2);
+  for (int p=0; p<3; ++p)
+    for (int x=0; x<2; ++x) {
+      int sum = b(p,0,2*x) + b(p,0,2*x+1) + b(p,1,2*x) + b(p,1,2*x+1);
+      BOOST_CHECK_EQUAL(half(p,0,x), (sum + 2) / 4);
+    }
+
+  // Grayscale
+  blitz::Array<uint8_t,2> gray = bob::io::load<uint8_t,2>(filename,
+      bob::io::ImageLoadOptions(1, true));
+  BOOST_CHECK_EQUAL(gray.extent(0), 2);
+  BOOST_CHECK_EQUAL(gray.extent(1), 4);
+
+  // Decoding from memory, a single row at a time
+  std::FILE* fp = std::fopen(filename.c_str(), "rb");
+  std::vector<char> data(4096);
+  data.resize(std::fread(&data[0], 1, data.size(), fp));
+  std::fclose(fp);
+  boost::shared_ptr<bob::io::File> f = bob::io::decode(&data[0], data.size(),
+      ".png", bob::io::ImageLoadOptions(1, false, 0, 1));
+  check_equal( f->read_all<uint8_t,3>(), b );
+  boost::filesystem::remove(filename);
+
+  BOOST_CHECK_THROW(bob::io::ImageLoadOptions(3), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE( batch_loader )
+{
+  std::string filename_a = bob::core::tmpfile(".png");
+  std::string filename_b = bob::core::tmpfile(".png");
+  bob::io::save(filename_a, a);
+  bob::io::save(filename_b, b);
+
+  std::vector<std::string> filenames;
+  filenames.push_back(filename_a);
+  filenames.push_back(filename_a + ".missing.png");
+  filenames.push_back(filename_a);
+
+  // Same types: stacked array, with a zero slice for the missing file
+  bob::io::BatchLoader loader(3);
+  bob::core::array::typeinfo unknown;
+  bob::core::array::blitz_array stacked(unknown);
+  std::vector<boost::shared_ptr<bob::core::array::blitz_array> > arrays;
+  std::vector<std::string> errors;
+  BOOST_CHECK(loader.load(filenames, stacked, arrays, errors));
+  blitz::Array<uint8_t,3> s = stacked.get<uint8_t,3>();
+  BOOST_REQUIRE_EQUAL(s.extent(0), 3);
+  check_equal(blitz::Array<uint8_t,2>(s(0, blitz::Range::all(), blitz::Range::all())), a);
+  check_equal(blitz::Array<uint8_t,2>(s(2, blitz::Range::all(), blitz::Range::all())), a);
+  BOOST_CHECK_EQUAL(blitz::max(s(1, blitz::Range::all(), blitz::Range::all())), 0);
+  BOOST_CHECK(errors[0].empty());
+  BOOST_CHECK(!errors[1].empty());
+  BOOST_CHECK(errors[2].empty());
+
+  // Different types: separate arrays
+  filenames[2] = filename_b;
+  BOOST_CHECK(!loader.load(filenames, stacked, arrays, errors));
+  BOOST_REQUIRE_EQUAL(arrays.size(), 3);
+  check_equal(arrays[0]->get<uint8_t,2>(), a);
+  BOOST_CHECK(!arrays[1]);
+  check_equal(arrays[2]->get<uint8_t,3>(), b);
+
+  boost::filesystem::remove(filename_a);
+  boost::filesystem::remove(filename_b);
+  BOOST_CHECK_THROW(loader.setNThreads(0), std::runtime_error);
+}
+
 /*
 BOOST_AUTO_TEST_CASE( image_jpg )
 {
@@ -17,7 +17,10 @@
 
 #include <blitz/array.h>
 #include "bob/core/logging.h"
+#include "bob/core/blitz_array.h"
 #include "bob/io/utils.h"
+#include "bob/io/TensorFile.h"
+#include "bob/io/MappedTensorFile.h"
 
 struct T {
   blitz::Array<int8_t,2> a, b;
@@ -72,4 +75,95 @@ BOOST_AUTO_TEST_CASE( tensor_2d_read_T5alpha )
   check_equal( bob::io::load<int8_t,2>(testdata_path.string()), b );
 }
 
+BOOST_AUTO_TEST_CASE( tensor_mapped )
+{
+  std::string filename = bob::core::tmpfile(".tensor");
+  {
+    bob::io::TensorFile out(filename, bob::io::TensorFile::out);
+    for (int k=0; k<5; ++k) {
+      blitz::Array<int8_t,2> c(a.shape());
+      c = a + k;
+      out.write(c);
+    }
+  }
+
+  bob::io::MappedTensorFile file(filename);
+  BOOST_CHECK_EQUAL(file.size(), (size_t)5);
+
+  // zero-copy random access
+  for (int k=4; k>=0; --k) {
+    blitz::Array<int8_t,2> expected(a.shape());
+    expected = a + k;
+    check_equal(file.view<int8_t,2>(k), expected);
+    check_equal(file.read<double,2>(k), expected);
+  }
+  BOOST_CHECK_THROW(file.view<int8_t,2>(5), std::runtime_error);
+  BOOST_CHECK_THROW(file.view<double,2>(0), std::runtime_error);
+
+  // bulk iteration
+  bob::io::MappedTensorFile::block_iterator<int8_t,2> it(file, 2);
+  blitz::Array<int8_t,3> block;
+  size_t visited = 0;
+  while (it.next(block)) {
+    for (int k=0; k<block.extent(0); ++k) {
+      blitz::Array<int8_t,2> expected(a.shape());
+      expected = a + (int)(visited + k);
+      blitz::Array<int8_t,2> current = block(k, blitz::Range::all(), blitz::Range::all());
+      check_equal(current, expected);
+    }
+    visited += block.extent(0);
+  }
+  BOOST_CHECK_EQUAL(visited, (size_t)5);
+
+  boost::filesystem::remove(filename);
+}
+
+BOOST_AUTO_TEST_CASE( tensor_mapped_float64 )
+{
+  // The arrays of 8-byte types are not aligned after the 28-byte header
+  std::string filename = bob::core::tmpfile(".tensor");
+  {
+    bob::io::TensorFile out(filename, bob::io::TensorFile::out);
+    for (int k=0; k<3; ++k) {
+      blitz::Array<double,2> c(a.shape());
+      c = a + k + 0.25;
+      out.write(c);
+    }
+  }
+
+  bob::io::MappedTensorFile file(filename);
+  BOOST_CHECK_EQUAL(file.size(), (size_t)3);
+  BOOST_CHECK_THROW(file.view<double,2>(1), std::runtime_error);
+  BOOST_CHECK_THROW(file.view<double,2>(0, 2), std::runtime_error);
+
+  for (int k=2; k>=0; --k) {
+    blitz::Array<double,2> expected(a.shape());
+    expected = a + k + 0.25;
+    check_equal(file.read<double,2>(k), expected);
+
+    bob::core::array::blitz_array buffer(file.type());
+    file.read(k, buffer);
+    blitz::Array<double,2> current(static_cast<double*>(buffer.ptr()),
+        a.shape(), blitz::neverDeleteData);
+    check_equal(current, expected);
+  }
+
+  // bulk iteration, through the buffer of the iterator
+  bob::io::MappedTensorFile::block_iterator<double,2> it(file, 2);
+  blitz::Array<double,3> block;
+  size_t visited = 0;
+  while (it.next(block)) {
+    for (int k=0; k<block.extent(0); ++k) {
+      blitz::Array<double,2> expected(a.shape());
+      expected = a + (int)(visited + k) + 0.25;
+      blitz::Array<double,2> current = block(k, blitz::Range::all(), blitz::Range::all());
+      check_equal(current, expected);
+    }
+    visited += block.extent(0);
+  }
+  BOOST_CHECK_EQUAL(visited, (size_t)3);
+
+  boost::filesystem::remove(filename);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
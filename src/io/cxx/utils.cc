@@ -21,6 +21,23 @@ boost::shared_ptr<bob::io::File> bob::io::open (const std::string& filename, cha
   boost::shared_ptr<bob::io::CodecRegistry> instance = bob::io::CodecRegistry::instance();
   return instance->findByFilenameExtension(filename)(filename, mode);
 }
+
+boost::shared_ptr<bob::io::File> bob::io::open (const std::string& filename,
+    const bob::io::ImageLoadOptions& options) {
+  options.check();
+  boost::shared_ptr<bob::io::CodecRegistry> instance = bob::io::CodecRegistry::instance();
+  return instance->findImageDecoderByFilenameExtension(filename)(filename, 0, 0, options);
+}
+
+boost::shared_ptr<bob::io::File> bob::io::decode (const void* data,
+    size_t size, const std::string& extension,
+    const bob::io::ImageLoadOptions& options) {
+  if (data == 0 || size == 0)
+    throw std::runtime_error("cannot decode an image from an empty buffer");
+  options.check();
+  boost::shared_ptr<bob::io::CodecRegistry> instance = bob::io::CodecRegistry::instance();
+  return instance->findImageDecoderByExtension(extension)("<memory>", data, size, options);
+}
   
 bob::core::array::typeinfo bob::io::peek (const std::string& filename) {
   return open(filename, 'r')->type();
@@ -12,8 +12,10 @@
 #include <bob/io/CodecRegistry.h>
 #include <bob/io/File.h>
 #include <bob/io/utils.h>
+#include <bob/io/BatchLoader.h>
 
 #include <bob/python/ndarray.h>
+#include <bob/python/gil.h>
 
 using namespace boost::python;
 
@@ -39,6 +41,86 @@ static boost::shared_ptr<bob::io::File> string_open2 (const std::string& filenam
   return bob::io::open(filename, mode[0], pretend_extension);
 }
 
+static boost::shared_ptr<bob::io::File> string_open_image (const std::string& filename,
+    const bob::io::ImageLoadOptions& options) {
+  return bob::io::open(filename, options);
+}
+
+static boost::shared_ptr<bob::io::File> decode (object data,
+    const std::string& extension, const bob::io::ImageLoadOptions& options) {
+  Py_buffer view;
+  if (PyObject_GetBuffer(data.ptr(), &view, PyBUF_SIMPLE) != 0)
+    throw_error_already_set();
+  boost::shared_ptr<bob::io::File> retval;
+  try {
+    retval = bob::io::decode(view.buf, view.len, extension, options);
+  }
+  catch (...) {
+    PyBuffer_Release(&view);
+    throw;
+  }
+  PyBuffer_Release(&view);
+  return retval;
+}
+
+/**
+ * Allocates the arrays of load_batch() as NumPy arrays, from the loading
+ * threads. The arrays are kept until the allocator is destroyed, so that
+ * they are only released with the GIL.
+ */
+class NumPyAllocator: public bob::io::BatchLoader::Allocator {
+  public:
+    virtual boost::shared_ptr<bob::core::array::interface>
+      allocate(const bob::core::array::typeinfo& type) {
+      bob::python::gil lock;
+      boost::shared_ptr<bob::python::py_array> array(new bob::python::py_array(type));
+      m_arrays.push_back(array);
+      return array;
+    }
+  private:
+    std::vector<boost::shared_ptr<bob::python::py_array> > m_arrays;
+};
+
+static object pyobject(boost::shared_ptr<bob::core::array::interface> array) {
+  if (!array) return object();
+  return boost::static_pointer_cast<bob::python::py_array>(array)->pyobject();
+}
+
+static tuple load_batch (object filenames, size_t n_threads, object options) {
+  std::vector<std::string> files;
+  stl_input_iterator<std::string> it(filenames), end;
+  for (; it != end; ++it) files.push_back(*it);
+
+  bob::io::BatchLoader loader(n_threads);
+  if (options.ptr() != Py_None)
+    loader.setOptions(extract<const bob::io::ImageLoadOptions&>(options));
+
+  // Loads the files into NumPy arrays, without the GIL
+  NumPyAllocator allocator;
+  boost::shared_ptr<bob::core::array::interface> stacked;
+  std::vector<boost::shared_ptr<bob::core::array::interface> > arrays;
+  std::vector<std::string> errors;
+  bool is_stacked;
+  {
+    bob::python::no_gil unlock;
+    is_stacked = loader.load(files, allocator, stacked, arrays, errors);
+  }
+
+  object retval;
+  if (is_stacked) retval = pyobject(stacked);
+  else {
+    list arrays_list;
+    for (size_t i=0; i<arrays.size(); ++i) arrays_list.append(pyobject(arrays[i]));
+    retval = arrays_list;
+  }
+  list errors_list;
+  for (size_t i=0; i<files.size(); ++i) {
+    if (errors[i].empty()) errors_list.append(object());
+    else errors_list.append(errors[i]);
+  }
+  return make_tuple(retval, errors_list);
+}
+
 static void file_write(bob::io::File& f, object array) {
   bob::python::py_array a(array, object());
   f.write(a);
@@ -61,9 +143,17 @@ static dict extensions() {
 
 void bind_io_file() {
 
+  class_<bob::io::ImageLoadOptions>("ImageLoadOptions", "Options applied by the image decoders (JPEG and PNG) while loading an image. Downscaling is applied during decoding (JPEG images are downscaled in the DCT domain by libjpeg), and gives images of ceil(height/scale_denom) x ceil(width/scale_denom) pixels.", init<optional<size_t, bool, size_t, size_t> >((arg("self"), arg("scale_denom")=1, arg("gray")=false, arg("min_size")=0, arg("scanlines")=16), "Creates new loading options. The scale denominator should be 1, 2, 4 or 8. If gray is set, color images are decoded directly to 2D grayscale arrays. If min_size is not 0, the scale denominator is the largest one for which the smallest side of the decoded image is still at least min_size pixels (and scale_denom is ignored). scanlines is the number of rows decoded at once."))
+    .def_readwrite("scale_denom", &bob::io::ImageLoadOptions::scale_denom, "The scale denominator (1, 2, 4 or 8)")
+    .def_readwrite("gray", &bob::io::ImageLoadOptions::gray, "Decodes color images directly to grayscale")
+    .def_readwrite("min_size", &bob::io::ImageLoadOptions::min_size, "If not 0, the minimum size of the smallest side of the decoded image, which sets the scale denominator")
+    .def_readwrite("scanlines", &bob::io::ImageLoadOptions::scanlines, "The number of rows decoded at once")
+    ;
+
   class_<bob::io::File, boost::shared_ptr<bob::io::File>, boost::noncopyable>("File", "Abstract base class for all Array/Arrayset i/o operations", no_init)
     .def("__init__", make_constructor(string_open1, default_call_policies(), (arg("filename"), arg("mode"))), "Opens a (supported) file for reading arrays. The mode is a **single** character which takes one of the following values: 'r' - opens the file for read-only operations; 'w' - truncates the file and open it for reading and writing; 'a' - opens the file for reading and writing w/o truncating it.")
     .def("__init__", make_constructor(string_open2, default_call_policies(), (arg("filename"), arg("mode"), arg("pretend_extension"))), "Opens a (supported) file for reading arrays but pretends its extension is as given by the last parameter - this way you can, potentially, override the default encoder/decoder used to read and write on the file. The mode is a **single** character which takes one of the following values: 'r' - opens the file for read-only operations; 'w' - truncates the file and open it for reading and writing; 'a' - opens the file for reading and writing w/o truncating it.")
+    .def("__init__", make_constructor(string_open_image, default_call_policies(), (arg("filename"), arg("options"))), "Opens an image (JPEG or PNG) for reading, with the given bob.io.ImageLoadOptions (e.g. to decode it downscaled or in grayscale). The file is opened only once to find the type of the image and to load it.")
     .add_property("filename", make_function(&bob::io::File::filename, return_value_policy<copy_const_reference>()), "The path to the file being read/written")
     .add_property("type_all", make_function(&bob::io::File::type_all, return_value_policy<copy_const_reference>()), "Typing information to load all of the file at once")
     .add_property("type", make_function(&bob::io::File::type, return_value_policy<copy_const_reference>()), "Typing information to load the file as an Arrayset")
@@ -76,6 +166,10 @@ void bind_io_file() {
     .def("append", &file_append, (arg("self"), arg("array")), "Appends an array to a file. Compatibility requirements may be enforced.")
     ;
 
+  def("decode", &decode, (arg("data"), arg("extension"), arg("options")=bob::io::ImageLoadOptions()), "Decodes an image (JPEG or PNG) from an in-memory buffer (e.g. bytes), with the given bob.io.ImageLoadOptions. The extension (e.g. '.jpg') selects the image decoder. Returns a read-only bob.io.File.");
+
+  def("load_batch", &load_batch, (arg("filenames"), arg("n_threads")=1, arg("options")=object()), "Loads the contents of a list of files with a pool of n_threads threads, releasing the GIL while the files are decoded. Each file is opened once, and at most n_threads files are open (and decoded) at once. If options (bob.io.ImageLoadOptions) are given, the files are images loaded with these options. Returns a tuple (arrays, errors). If the contents of all the readable files have the same type, arrays is a single NumPy ndarray where they are stacked along a new first dimension (the slices of the files which cannot be read are filled with zeros); otherwise, it is a list of arrays (None for the files which cannot be read). errors is a list with the error message of each file, or None if it was loaded.");
+
   def("extensions", &extensions, "Returns a dictionary containing all extensions and descriptions currently stored on the global codec registry");
 
 }
@@ -111,13 +111,54 @@ static object hdf5file_xread(bob::io::HDF5File& f, const std::string& p,
   return retval.pyobject();
 }
 
+/**
+ * Reads "count" consecutive list entries in a single HDF5 read, returning
+ * them stacked as a numpy array with an extra first dimension.
+ */
+static object hdf5file_lread_range(bob::io::HDF5File& f, const std::string& p,
+    uint64_t start, int64_t count=-1) {
+
+  const std::vector<bob::io::HDF5Descriptor>& D = f.describe(p);
+  const bob::io::HDF5Type& type = D[0].type;
+  const bob::io::HDF5Shape& shape = type.shape();
+
+  if (type.type() == bob::io::s)
+    PYTHON_ERROR(TypeError, "cannot read ranges of string datasets");
+
+  if (count < 0) count = (start < D[0].size)? (D[0].size - start) : 0;
+
+  //the stacked shape has the range length as first extent
+  bob::io::HDF5Shape stacked(shape);
+  if (shape.n() == 1 && shape[0] == 1) stacked[0] = count; //scalars
+  else {
+    stacked >>= 1;
+    stacked[0] = count;
+  }
+
+  bob::core::array::typeinfo atype;
+  bob::io::HDF5Type(type.type(), stacked).copy_to(atype);
+  bob::python::py_array retval(atype);
+  f.read_buffer(p, start, count, type, retval.ptr());
+  return retval.pyobject();
+}
+BOOST_PYTHON_FUNCTION_OVERLOADS(hdf5file_lread_range_overloads, hdf5file_lread_range, 3, 4)
+
 static object hdf5file_lread(bob::io::HDF5File& f, const std::string& p,
     int64_t pos=-1) {
   if (pos >= 0) return hdf5file_xread(f, p, 0, pos);
 
   //otherwise returns as a list
   const std::vector<bob::io::HDF5Descriptor>& D = f.describe(p);
+  const bob::io::HDF5Shape& shape = D[0].type.shape();
   list retval;
+
+  //arrays are read in one shot and then split
+  if (D[0].type.type() != bob::io::s && !(shape.n() == 1 && shape[0] == 1)) {
+    object all = hdf5file_lread_range(f, p, 0, D[0].size);
+    for (uint64_t k=0; k<D[0].size; ++k) retval.append(all[k]);
+    return retval;
+  }
+
   for (uint64_t k=0; k<D[0].size; ++k)
     retval.append(hdf5file_xread(f, p, 0, k));
   return retval;
@@ -677,6 +718,8 @@ void bind_io_hdf5() {
     .def("copy", &bob::io::HDF5File::copy, (arg("self"), arg("file")), "Copies all accessible content to another HDF5 file")
     .def("read", &hdf5file_read, (arg("self"), arg("key")), "Reads the whole dataset in a single shot. Returns a single object with all contents.")
     .def("lread", (object(*)(bob::io::HDF5File&, const std::string&, int64_t))0, hdf5file_lread_overloads((arg("self"), arg("key"), arg("pos")=-1), "Reads a given position from the dataset. Returns a single object if 'pos' >= 0, otherwise a list by reading all objects in sequence."))
+    .def("lread_range", (object(*)(bob::io::HDF5File&, const std::string&, uint64_t, int64_t))0, hdf5file_lread_range_overloads((arg("self"), arg("key"), arg("start"), arg("count")=-1), "Reads 'count' consecutive objects of a list dataset, starting at position 'start', with a single read operation. Returns a numpy.ndarray in which the first dimension indexes the objects read. If 'count' is negative, reads up to the end of the dataset."))
+    .def("set_chunk_cache", &bob::io::HDF5File::setChunkCache, (arg("self"), arg("nslots"), arg("nbytes"), arg("w0")=0.75), "Configures the chunk cache for all datasets in this file: the number of hash table slots (preferably a prime, about 100 times the number of chunks that fit in the cache), the cache size in bytes and the preemption policy 'w0', between 0 and 1 (use 1 if chunks are read only once, in sequence).")
     .def("replace", &hdf5file_replace, (arg("self"), arg("path"), arg("pos"), arg("data")), "Modifies the value of a scalar/array inside a dataset in the file.\n\n" \
   "Keyword Parameters:\n\n" \
   "path\n" \
@@ -711,5 +754,7 @@ void bind_io_hdf5() {
     .def("delete_attributes", &hdf5file_del_attributes, hdf5file_del_attributes_overloads((arg("self"), arg("path")="."), "Deletes **all** attributes associated to a (existing) path in the file. The path may point to a subdirectory or to a particular dataset. If the path does not exist, a RuntimeError is raised."))
 
     .add_property("filename", &bob::io::HDF5File::filename, "The name of the underlying file.")
+    .add_property("chunk_size", &bob::io::HDF5File::getChunkSize, &bob::io::HDF5File::setChunkSize, "Target size, in bytes, of the chunks of datasets created from now on. As many objects as fit in this size are stored in each chunk. Zero (the default) stores one object per chunk.")
+    .add_property("shuffle", &bob::io::HDF5File::getShuffle, &bob::io::HDF5File::setShuffle, "If set, compressed datasets created from now on apply the shuffle filter before gzip compression.")
     ;
 }
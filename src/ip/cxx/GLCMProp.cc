@@ -12,6 +12,8 @@
 #include "bob/core/array_copy.h"
 #include "bob/core/assert.h"
 #include <boost/make_shared.hpp>
+#include <cmath>
+#include <limits>
 
 static double sqr(const double x)
 {
@@ -639,11 +641,133 @@ void bob::ip::GLCMProp::inv_diff_mom_norm(const blitz::Array<double,3>& glcm, bl
 }
 
 
+void bob::ip::GLCMProp::properties(const blitz::Array<double,3>& glcm, const std::vector<Property>& props, blitz::Array<double,2>& values) const
+{
+  // check if the size of the output matrix is as expected
+  bob::core::array::assertSameShape(values, blitz::shape((int)props.size(), glcm.extent(2)));
 
+  const int num_levels = glcm.extent(0);
+  const double eps = std::numeric_limits<double>::min(); // small numeric value to avoid 0 as an argument to the logarithm
 
+  // marginal probabilities, and probabilities of i+j and |i-j|
+  std::vector<double> px(num_levels), py(num_levels), p_sum(2*num_levels-1), p_diff(num_levels);
 
+  for (int l=0; l < glcm.extent(2); ++l)
+  {
+    // the sum used to normalize the GLCM of this offset
+    double total = 0.;
+    for (int i=0; i < num_levels; ++i)
+      for (int j=0; j < num_levels; ++j)
+        total += glcm(i,j,l);
+
+    // single pass over the normalized matrix
+    std::fill(px.begin(), px.end(), 0.);
+    std::fill(py.begin(), py.end(), 0.);
+    std::fill(p_sum.begin(), p_sum.end(), 0.);
+    std::fill(p_diff.begin(), p_diff.end(), 0.);
+    double asm_ = 0., sum_ij = 0., entropy = 0., max_prob = glcm(0,0,l) / total;
+    for (int i=0; i < num_levels; ++i)
+    {
+      for (int j=0; j < num_levels; ++j)
+      {
+        const double p = glcm(i,j,l) / total;
+        px[i] += p;
+        py[j] += p;
+        p_sum[i+j] += p;
+        p_diff[std::abs(i-j)] += p;
+        asm_ += p * p;
+        sum_ij += i * j * p;
+        entropy -= p * log(p + eps);
+        max_prob = std::max(max_prob, p);
+      }
+    }
 
+    // statistics of the marginals
+    double sum_p = 0., mean_x = 0., mean_y = 0., hx = 0., hy = 0.;
+    for (int i=0; i < num_levels; ++i)
+    {
+      sum_p += px[i];
+      mean_x += i * px[i];
+      mean_y += i * py[i];
+      hx -= px[i] * log(px[i] + eps);
+      hy -= py[i] * log(py[i] + eps);
+    }
+    const double mean_p = sum_p / sqr(num_levels); // mean value of the normalized matrix
+    double var = 0., var_x = 0., var_y = 0.;
+    for (int i=0; i < num_levels; ++i)
+    {
+      var += sqr(i - mean_p) * px[i];
+      var_x += sqr(i - mean_x) * px[i];
+      var_y += sqr(i - mean_y) * py[i];
+    }
+    const double std_xy = sqrt(var_x) * sqrt(var_y);
 
+    // statistics of i+j
+    double sum_avg = 0., sum_entropy = 0.;
+    for (int t=0; t < 2*num_levels-1; ++t)
+    {
+      sum_avg += t * p_sum[t];
+      sum_entropy -= p_sum[t] * log(p_sum[t] + eps);
+    }
+    double sum_var = 0., cluster_shade = 0., cluster_prom = 0.;
+    for (int t=0; t < 2*num_levels-1; ++t)
+    {
+      sum_var += sqr(t - sum_entropy) * p_sum[t];
+      const double d = t - mean_x - mean_y;
+      cluster_shade += d * d * d * p_sum[t];
+      cluster_prom += d * d * d * d * p_sum[t];
+    }
 
+    // statistics of |i-j|
+    double contrast = 0., diff_entropy = 0., dissimilarity = 0., homogeneity = 0.,
+      inv_diff_mom = 0., inv_diff_norm = 0., inv_diff_mom_norm = 0.;
+    for (int t=0; t < num_levels; ++t)
+    {
+      contrast += t * t * p_diff[t];
+      diff_entropy -= p_diff[t] * log(p_diff[t] + eps);
+      dissimilarity += t * p_diff[t];
+      homogeneity += p_diff[t] / (1 + t);
+      inv_diff_mom += p_diff[t] / (1 + t * t);
+      inv_diff_norm += p_diff[t] / (1 + t / (double)num_levels);
+      inv_diff_mom_norm += p_diff[t] / (1 + t * t / sqr(num_levels));
+    }
 
+    // HXY1 and HXY2 of [1] only depend on the marginals, as p(i,j) sums to px(i) and py(j)
+    const double hxy1 = hx + hy;
+    const double hxy2 = hx * sum_p + hy * sum_p;
 
+    for (size_t k=0; k < props.size(); ++k)
+    {
+      double& value = values(k,l);
+      switch (props[k])
+      {
+        case ANGULAR_SECOND_MOMENT: value = asm_; break;
+        case ENERGY: value = sqrt(asm_); break;
+        case VARIANCE: value = var; break;
+        case CONTRAST: value = contrast; break;
+        case AUTO_CORRELATION: value = sum_ij; break;
+        case CORRELATION: value = (sum_ij - mean_x * mean_y) / std_xy; break;
+        case CORRELATION_M: value = (sum_ij - mean_x * mean_y - mean_x * mean_x + mean_x * mean_x * sum_p) / std_xy; break;
+        case INV_DIFF_MOM: value = inv_diff_mom; break;
+        case SUM_AVG: value = sum_avg; break;
+        case SUM_VAR: value = sum_var; break;
+        case SUM_ENTROPY: value = sum_entropy; break;
+        case ENTROPY: value = entropy; break;
+        case DIFF_VAR: value = contrast; break;
+        case DIFF_ENTROPY: value = diff_entropy; break;
+        case DISSIMILARITY: value = dissimilarity; break;
+        case HOMOGENEITY: value = homogeneity; break;
+        case CLUSTER_PROM: value = cluster_prom; break;
+        case CLUSTER_SHADE: value = cluster_shade; break;
+        case MAX_PROB: value = max_prob; break;
+        case INF_MEAS_CORR1: value = (entropy - hxy1) / std::max(hx, hy); break;
+        case INF_MEAS_CORR2: value = sqrt(1 - exp(-2 * (hxy2 - entropy))); break;
+        case INV_DIFF: value = homogeneity; break;
+        case INV_DIFF_NORM: value = inv_diff_norm; break;
+        case INV_DIFF_MOM_NORM: value = inv_diff_mom_norm; break;
+        default:
+          throw std::runtime_error("unknown GLCM property");
+      }
+    }
+  }
+}
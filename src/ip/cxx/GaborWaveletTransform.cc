@@ -10,13 +10,21 @@
 
 #include "bob/core/assert.h"
 #include "bob/core/array_copy.h"
+#include "bob/core/array_utils.h"
 #include "bob/ip/GaborWaveletTransform.h"
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
 #include <numeric>
 #include <sstream>
 #include <fstream>
 
 static inline double sqr(double x){return x*x;}
 
+// the maximum number of resolutions, for which the kernels are kept in the cache
+static const size_t MAX_CACHED_RESOLUTIONS = 8;
+
 /**
  * Generates a Gabor kernel.
  * @param resolution The resolution of the image to generate
@@ -167,6 +175,52 @@ void bob::ip::GaborKernel::transform(
   }
 }
 
+/**
+ * Computes the responses of this Gabor kernel at the given positions only.
+ * This corresponds to the inverse Fourier transform of the transformed frequency domain image,
+ * evaluated at these positions, without computing the whole spatial domain image.
+ * Since the kernel pixels are grouped by row, the sum over the frequencies is split into row sums.
+ * @param frequency_domain_image  The image in frequency domain
+ * @param phase_y    The phase factors exp(2i*pi*u*y_n/height) of the positions, one row per position
+ * @param phase_x    The phase factors exp(2i*pi*v*x_n/width) of the positions, one row per position
+ * @param responses  The complex responses at the given positions
+ */
+void bob::ip::GaborKernel::transform(
+  const blitz::Array<std::complex<double>,2>& frequency_domain_image,
+  const blitz::Array<std::complex<double>,2>& phase_y,
+  const blitz::Array<std::complex<double>,2>& phase_x,
+  blitz::Array<std::complex<double>,1>& responses
+) const
+{
+  const int n = responses.extent(0);
+  // assert correct sizes
+  bob::core::array::assertSameShape(frequency_domain_image, blitz::shape(m_y_resolution, m_x_resolution));
+  bob::core::array::assertSameShape(phase_y, blitz::shape(n, m_y_resolution));
+  bob::core::array::assertSameShape(phase_x, blitz::shape(n, m_x_resolution));
+
+  // compute the products of image and kernel only once
+  std::vector<std::complex<double> > product(m_kernel_pixel.size());
+  for (size_t k = 0; k < m_kernel_pixel.size(); ++k){
+    product[k] = frequency_domain_image(m_kernel_pixel[k].first) * m_kernel_pixel[k].second;
+  }
+
+  // the normalization factor of the inverse FFT
+  const double scale = 1. / ((double)m_x_resolution * m_y_resolution);
+  for (int i = 0; i < n; ++i){
+    std::complex<double> sum(0.), row_sum(0.);
+    for (size_t k = 0; k < m_kernel_pixel.size(); ++k){
+      const blitz::TinyVector<unsigned,2>& index = m_kernel_pixel[k].first;
+      row_sum += product[k] * phase_x(i, index[1]);
+      // at the end of each row, apply the phase factor of the row
+      if (k + 1 == m_kernel_pixel.size() || m_kernel_pixel[k+1].first[0] != index[0]){
+        sum += row_sum * phase_y(i, index[0]);
+        row_sum = 0.;
+      }
+    }
+    responses(i) = sum * scale;
+  }
+}
+
 /**
  * Generates and returns the image for the current kernel.
  * @return The kernel image in frequency domain.
@@ -212,7 +266,8 @@ bob::ip::GaborWaveletTransform::GaborWaveletTransform(
   m_fft(),
   m_ifft(),
   m_number_of_scales(number_of_scales),
-  m_number_of_directions(number_of_directions)
+  m_number_of_directions(number_of_directions),
+  m_n_threads(1)
 {
   computeKernelFrequencies();
 }
@@ -229,7 +284,8 @@ bob::ip::GaborWaveletTransform::GaborWaveletTransform(
   m_fft(),
   m_ifft(),
   m_number_of_scales(other.m_number_of_scales),
-  m_number_of_directions(other.m_number_of_directions)
+  m_number_of_directions(other.m_number_of_directions),
+  m_n_threads(other.m_n_threads)
 {
   computeKernelFrequencies();
 }
@@ -237,6 +293,7 @@ bob::ip::GaborWaveletTransform::GaborWaveletTransform(
 bob::ip::GaborWaveletTransform::GaborWaveletTransform(
   bob::io::HDF5File& file
 )
+: m_n_threads(1)
 {
   load(file);
 }
@@ -257,6 +314,7 @@ bob::ip::GaborWaveletTransform::operator =
   m_ifft = bob::sp::IFFT2D();
   m_number_of_scales = other.m_number_of_scales;
   m_number_of_directions = other.m_number_of_directions;
+  m_n_threads = other.m_n_threads;
 
   computeKernelFrequencies();
 
@@ -307,6 +365,9 @@ bob::ip::GaborWaveletTransform::operator !=
  * Private function that computes the frequency vectors of the Gabor kernels
  */
 void bob::ip::GaborWaveletTransform::computeKernelFrequencies(){
+  // the kernels of the old parametrization are invalid
+  m_gabor_kernels.clear();
+  m_kernel_cache.clear();
   // reserve enough space
   m_kernel_frequencies.clear();
   m_kernel_frequencies.reserve(m_number_of_scales * m_number_of_directions);
@@ -329,24 +390,53 @@ void bob::ip::GaborWaveletTransform::computeKernelFrequencies(){
   } // for s
 }
 
+/**
+ * Sets the number of threads used to compute the responses of the kernels
+ * @param n_threads  The number of threads, which should be strictly positive
+ */
+void bob::ip::GaborWaveletTransform::setNThreads(size_t n_threads)
+{
+  if (n_threads == 0)
+    throw std::runtime_error("the number of threads should be strictly positive");
+  m_n_threads = n_threads;
+}
+
 /**
  * Generates the kernels for the given image resolution.
  * This function dose not need to be called explicitly to be able to perform the GWT.
+ * The kernels of the previous resolution are kept in a cache, so that they are not regenerated
+ * when images of different resolutions are transformed alternately.
  * @param resolution  The resolution of the image to generate the kernels for
  */
 void bob::ip::GaborWaveletTransform::generateKernels(
   blitz::TinyVector<unsigned,2> resolution
 )
 {
-  if (resolution[1] != m_fft.getWidth() || resolution[0] != m_fft.getHeight()){
-    // new kernels need to be generated
-    m_gabor_kernels.clear();
-    m_gabor_kernels.reserve(m_kernel_frequencies.size());
+  if (m_gabor_kernels.empty() || resolution[1] != m_fft.getWidth() || resolution[0] != m_fft.getHeight()){
+    // put the current kernels into the cache
+    if (!m_gabor_kernels.empty()){
+      m_kernel_cache[std::make_pair((unsigned)m_fft.getHeight(), (unsigned)m_fft.getWidth())].swap(m_gabor_kernels);
+      m_gabor_kernels.clear();
+    }
 
-    for (unsigned j = 0; j < m_kernel_frequencies.size(); ++j){
-      m_gabor_kernels.push_back(bob::ip::GaborKernel(resolution, m_kernel_frequencies[j], m_sigma, m_pow_of_k, m_dc_free));
+    std::map<std::pair<unsigned,unsigned>, std::vector<bob::ip::GaborKernel> >::iterator it =
+      m_kernel_cache.find(std::make_pair(resolution[0], resolution[1]));
+    if (it != m_kernel_cache.end()){
+      // reuse the kernels generated earlier for this resolution
+      m_gabor_kernels.swap(it->second);
+      m_kernel_cache.erase(it);
+    } else {
+      // new kernels need to be generated
+      m_gabor_kernels.reserve(m_kernel_frequencies.size());
+      for (unsigned j = 0; j < m_kernel_frequencies.size(); ++j){
+        m_gabor_kernels.push_back(bob::ip::GaborKernel(resolution, m_kernel_frequencies[j], m_sigma, m_pow_of_k, m_dc_free));
+      }
     }
 
+    // limit the size of the cache
+    while (m_kernel_cache.size() > MAX_CACHED_RESOLUTIONS)
+      m_kernel_cache.erase(m_kernel_cache.begin());
+
     // reset fft sizes
     m_fft.setShape(resolution[0], resolution[1]);
     m_ifft.setShape(resolution[0], resolution[1]);
@@ -362,7 +452,7 @@ void bob::ip::GaborWaveletTransform::generateKernels(
  */
 blitz::Array<double,3> bob::ip::GaborWaveletTransform::kernelImages() const{
   // generate array of desired size
-  blitz::Array<double,3> res(m_gabor_kernels.size(), m_temp_array.shape()[0], m_temp_array.shape()[1]);
+  blitz::Array<double,3> res(m_gabor_kernels.size(), m_frequency_image.extent(0), m_frequency_image.extent(1));
   // fill in the wavelets
   for (int j = m_gabor_kernels.size(); j--;){
     res(j, blitz::Range::all(), blitz::Range::all()) = m_gabor_kernels[j].kernelImage();
@@ -370,6 +460,113 @@ blitz::Array<double,3> bob::ip::GaborWaveletTransform::kernelImages() const{
   return res;
 }
 
+/**
+ * Private function that makes sure that each thread but the first one has its own IFFT and
+ * working arrays of the current resolution.
+ */
+void bob::ip::GaborWaveletTransform::resizeThreadBuffers(){
+  const size_t n = m_n_threads - 1;
+  const int height = m_fft.getHeight(), width = m_fft.getWidth();
+  m_thread_ifft.resize(n);
+  m_thread_temp_array.resize(n);
+  m_thread_temp_array2.resize(n);
+  for (size_t t = 0; t < n; ++t){
+    if (!m_thread_ifft[t])
+      m_thread_ifft[t].reset(new bob::sp::IFFT2D(height, width));
+    else if ((int)m_thread_ifft[t]->getHeight() != height || (int)m_thread_ifft[t]->getWidth() != width)
+      m_thread_ifft[t]->setShape(height, width);
+    if (m_thread_temp_array[t].extent(0) != height || m_thread_temp_array[t].extent(1) != width){
+      m_thread_temp_array[t].resize(height, width);
+      m_thread_temp_array2[t].resize(height, width);
+    }
+  }
+}
+
+/**
+ * Private function that computes the responses of the kernels [begin, end[ in the given thread.
+ * Exactly one of the output arrays is expected to be given.
+ * @param thread         The index of the thread, which selects the IFFT and the working arrays
+ * @param begin          The first kernel to process
+ * @param end            The end of the range of kernels to process
+ * @param trafo_image    The Gabor wavelet transformed image (or NULL)
+ * @param jet_image      The Gabor jet image with absolute values and phases (or NULL)
+ * @param abs_jet_image  The Gabor jet image with absolute values only (or NULL)
+ */
+void bob::ip::GaborWaveletTransform::transformKernels(
+  unsigned thread, int begin, int end,
+  blitz::Array<std::complex<double>,3>* trafo_image,
+  blitz::Array<double,4>* jet_image,
+  blitz::Array<double,3>* abs_jet_image
+)
+{
+  const blitz::Range all = blitz::Range::all();
+  // the arrays shared with the other threads are only accessed through private views
+  bob::sp::IFFT2D& ifft = thread ? *m_thread_ifft[thread-1] : m_ifft;
+  blitz::Array<std::complex<double>,2> temp(bob::core::array::private_view(thread ? m_thread_temp_array[thread-1] : m_temp_array));
+  blitz::Array<std::complex<double>,2> temp2(bob::core::array::private_view(thread ? m_thread_temp_array2[thread-1] : m_temp_array2));
+  const blitz::Array<std::complex<double>,2> frequency_image(bob::core::array::private_view(m_frequency_image));
+  blitz::Array<std::complex<double>,3> trafo;
+  blitz::Array<double,4> jets;
+  blitz::Array<double,3> abs_jets;
+  if (trafo_image) trafo.reference(bob::core::array::private_view(*trafo_image));
+  if (jet_image) jets.reference(bob::core::array::private_view(*jet_image));
+  if (abs_jet_image) abs_jets.reference(bob::core::array::private_view(*abs_jet_image));
+
+  for (int j = begin; j < end; ++j){
+    // multiply the image with the kernel in frequency domain
+    m_gabor_kernels[j].transform(frequency_image, temp2);
+    if (trafo_image){
+      // perform ifft directly into the trafo image layer
+      blitz::Array<std::complex<double>,2> layer(trafo(j, all, all));
+      ifft(temp2, layer);
+    } else {
+      // perform ifft of transformed image
+      ifft(temp2, temp);
+      if (jet_image){
+        // convert into absolute and phase part
+        blitz::Array<double,2> abs_part(jets(all, all, 0, j));
+        abs_part = blitz::abs(temp);
+        blitz::Array<double,2> phase_part(jets(all, all, 1, j));
+        phase_part = blitz::arg(temp);
+      } else {
+        // convert into absolute part
+        blitz::Array<double,2> abs_part(abs_jets(all, all, j));
+        abs_part = blitz::abs(temp);
+      }
+    }
+  } // for j
+}
+
+/**
+ * Private function that splits the kernels into contiguous blocks, one per thread,
+ * and computes their responses in parallel.
+ */
+void bob::ip::GaborWaveletTransform::runThreads(
+  blitz::Array<std::complex<double>,3>* trafo_image,
+  blitz::Array<double,4>* jet_image,
+  blitz::Array<double,3>* abs_jet_image
+)
+{
+  const int n_kernels = m_gabor_kernels.size();
+  const int n_blocks = std::min((int)m_n_threads, n_kernels);
+  if (n_blocks <= 1){
+    transformKernels(0, 0, n_kernels, trafo_image, jet_image, abs_jet_image);
+    return;
+  }
+
+  resizeThreadBuffers();
+  boost::thread_group threads;
+  for (int t = 1; t < n_blocks; ++t){
+    const int begin = (int)(((int64_t)n_kernels * t) / n_blocks);
+    const int end = (int)(((int64_t)n_kernels * (t+1)) / n_blocks);
+    threads.create_thread(boost::bind(&bob::ip::GaborWaveletTransform::transformKernels,
+      this, (unsigned)t, begin, end, trafo_image, jet_image, abs_jet_image));
+  }
+  // the first block is processed in the current thread
+  transformKernels(0, 0, n_kernels / n_blocks, trafo_image, jet_image, abs_jet_image);
+  threads.join_all();
+}
+
 /**
  * Computes the Gabor wavelet transformation for the given image (in spatial domain)
  * @param gray_image  The source image in spatial domain
@@ -390,13 +587,7 @@ void bob::ip::GaborWaveletTransform::performGWT(
   bob::core::array::assertSameShape(trafo_image, blitz::shape(m_kernel_frequencies.size(),gray_image.extent(0),gray_image.extent(1)));
 
   // now, let each kernel compute the transformation result
-  for (unsigned j = 0; j < m_gabor_kernels.size(); ++j){
-    // get a reference to the current layer of the trafo image
-    m_gabor_kernels[j].transform(m_frequency_image, m_temp_array);
-    // perform ifft on the trafo image layer
-    blitz::Array<std::complex<double>,2> layer(trafo_image(j, blitz::Range::all(), blitz::Range::all()));
-    m_ifft(m_temp_array, layer);
-  } // for j
+  runThreads(&trafo_image, 0, 0);
 }
 
 /**
@@ -421,17 +612,7 @@ void bob::ip::GaborWaveletTransform::computeJetImage(
   bob::core::array::assertSameShape(jet_image, blitz::shape(gray_image.extent(0), gray_image.extent(1), 2, m_kernel_frequencies.size()));
 
   // now, let each kernel compute the transformation result
-  for (int j = 0; j < (int)m_gabor_kernels.size(); ++j){
-    // get a reference to the current layer of the trafo image
-    m_gabor_kernels[j].transform(m_frequency_image, m_temp_array2);
-    // perform ifft of transformed image
-    m_ifft(m_temp_array2, m_temp_array);
-    // convert into absolute and phase part
-    blitz::Array<double,2> abs_part(jet_image(blitz::Range::all(), blitz::Range::all(), 0, j));
-    abs_part = blitz::abs(m_temp_array);
-    blitz::Array<double,2> phase_part(jet_image(blitz::Range::all(), blitz::Range::all(), 1, j));
-    phase_part = blitz::arg(m_temp_array);
-  } // for j
+  runThreads(0, &jet_image, 0);
 
   if (do_normalize){
     // iterate the positions
@@ -458,7 +639,7 @@ void bob::ip::GaborWaveletTransform::computeJetImage(
 )
 {
   // first, check if we need to reset the kernels
-  generateKernels(blitz::TinyVector<int,2>(gray_image.extent(0),gray_image.extent(1)));
+  generateKernels(blitz::TinyVector<unsigned,2>(gray_image.extent(0),gray_image.extent(1)));
 
   // perform Fourier transformation to image
   m_fft(gray_image, m_frequency_image);
@@ -467,15 +648,7 @@ void bob::ip::GaborWaveletTransform::computeJetImage(
   bob::core::array::assertSameShape(jet_image, blitz::shape(gray_image.extent(0), gray_image.extent(1), m_kernel_frequencies.size()));
 
   // now, let each kernel compute the transformation result
-  for (int j = 0; j < (int)m_gabor_kernels.size(); ++j){
-    // get a reference to the current layer of the trafo image
-    m_gabor_kernels[j].transform(m_frequency_image, m_temp_array2);
-    // perform ifft of transformed image
-    m_ifft(m_temp_array2, m_temp_array);
-    // convert into absolute part
-    blitz::Array<double,2> abs_part(jet_image(blitz::Range::all(), blitz::Range::all(), j));
-    abs_part = blitz::abs(m_temp_array);
-  } // for j
+  runThreads(0, 0, &jet_image);
 
   if (do_normalize){
     // iterate the positions
@@ -489,6 +662,152 @@ void bob::ip::GaborWaveletTransform::computeJetImage(
   }
 }
 
+/**
+ * Private function that computes the responses of the kernels [begin, end[ at the given positions.
+ * Exactly one of the output arrays is expected to be given.
+ */
+void bob::ip::GaborWaveletTransform::transformKernelsAt(
+  int begin, int end,
+  const blitz::Array<std::complex<double>,2>& phase_y,
+  const blitz::Array<std::complex<double>,2>& phase_x,
+  blitz::Array<double,3>* jets,
+  blitz::Array<double,2>* abs_jets
+)
+{
+  // the arrays shared with the other threads are only accessed through private views
+  const blitz::Array<std::complex<double>,2> frequency_image(bob::core::array::private_view(m_frequency_image));
+  const blitz::Array<std::complex<double>,2> py(bob::core::array::private_view(phase_y));
+  const blitz::Array<std::complex<double>,2> px(bob::core::array::private_view(phase_x));
+  blitz::Array<double,3> jets_view;
+  blitz::Array<double,2> abs_jets_view;
+  if (jets) jets_view.reference(bob::core::array::private_view(*jets));
+  if (abs_jets) abs_jets_view.reference(bob::core::array::private_view(*abs_jets));
+
+  const int n = phase_y.extent(0);
+  blitz::Array<std::complex<double>,1> responses(n);
+  for (int j = begin; j < end; ++j){
+    m_gabor_kernels[j].transform(frequency_image, py, px, responses);
+    for (int i = 0; i < n; ++i){
+      if (jets){
+        jets_view(i, 0, j) = std::abs(responses(i));
+        jets_view(i, 1, j) = std::arg(responses(i));
+      } else {
+        abs_jets_view(i, j) = std::abs(responses(i));
+      }
+    }
+  } // for j
+}
+
+/**
+ * Private function that computes the Gabor jets at the given positions.
+ * Exactly one of the output arrays is expected to be given.
+ */
+void bob::ip::GaborWaveletTransform::computeJetsAt(
+  const blitz::Array<std::complex<double>,2>& gray_image,
+  const blitz::Array<int,2>& positions,
+  blitz::Array<double,3>* jets,
+  blitz::Array<double,2>* abs_jets
+)
+{
+  const int height = gray_image.extent(0), width = gray_image.extent(1);
+  const int n = positions.extent(0);
+  bob::core::array::assertZeroBase(positions);
+  bob::core::array::assertSameDimensionLength(positions.extent(1), 2);
+
+  // first, check if we need to reset the kernels
+  generateKernels(blitz::TinyVector<unsigned,2>(height, width));
+
+  // perform Fourier transformation to image
+  m_fft(gray_image, m_frequency_image);
+
+  // compute the phase factors of the positions; the products are taken modulo the resolution
+  // to keep the arguments small
+  blitz::Array<std::complex<double>,2> phase_y(n, height), phase_x(n, width);
+  for (int i = 0; i < n; ++i){
+    const int y = positions(i,0), x = positions(i,1);
+    if (y < 0 || y >= height || x < 0 || x >= width){
+      boost::format m("the position (%d, %d) is outside of the image of size %dx%d");
+      m % y % x % height % width;
+      throw std::runtime_error(m.str());
+    }
+    for (int u = 0; u < height; ++u)
+      phase_y(i,u) = std::polar(1., 2. * M_PI * (((int64_t)u * y) % height) / height);
+    for (int v = 0; v < width; ++v)
+      phase_x(i,v) = std::polar(1., 2. * M_PI * (((int64_t)v * x) % width) / width);
+  }
+
+  // now, let each kernel compute the responses, in parallel
+  const int n_kernels = m_gabor_kernels.size();
+  const int n_blocks = std::min((int)m_n_threads, n_kernels);
+  if (n_blocks <= 1){
+    transformKernelsAt(0, n_kernels, phase_y, phase_x, jets, abs_jets);
+  } else {
+    boost::thread_group threads;
+    for (int t = 1; t < n_blocks; ++t){
+      const int begin = (int)(((int64_t)n_kernels * t) / n_blocks);
+      const int end = (int)(((int64_t)n_kernels * (t+1)) / n_blocks);
+      threads.create_thread(boost::bind(&bob::ip::GaborWaveletTransform::transformKernelsAt,
+        this, begin, end, boost::cref(phase_y), boost::cref(phase_x), jets, abs_jets));
+    }
+    transformKernelsAt(0, n_kernels / n_blocks, phase_y, phase_x, jets, abs_jets);
+    threads.join_all();
+  }
+}
+
+/**
+ * Computes the Gabor jets including absolute values and phases at the given positions of the image.
+ * @param gray_image   The source image in spatial domain
+ * @param positions    The positions (y,x) to compute the Gabor jets at, one row per position
+ * @param jets         The resulting Gabor jets, one per position
+ * @param do_normalize Shall the Gabor jets be normalized?
+ */
+void bob::ip::GaborWaveletTransform::computeJets(
+  const blitz::Array<std::complex<double>,2>& gray_image,
+  const blitz::Array<int,2>& positions,
+  blitz::Array<double,3>& jets,
+  bool do_normalize
+)
+{
+  // check that the shape is correct
+  bob::core::array::assertSameShape(jets, blitz::shape(positions.extent(0), 2, m_kernel_frequencies.size()));
+
+  computeJetsAt(gray_image, positions, &jets, 0);
+
+  if (do_normalize){
+    for (int i = jets.extent(0); i--;){
+      blitz::Array<double,2> jet(jets(i,blitz::Range::all(),blitz::Range::all()));
+      bob::ip::normalizeGaborJet(jet);
+    }
+  }
+}
+
+/**
+ * Computes the Gabor jets including absolute values only at the given positions of the image.
+ * @param gray_image   The source image in spatial domain
+ * @param positions    The positions (y,x) to compute the Gabor jets at, one row per position
+ * @param jets         The resulting Gabor jets, one per position
+ * @param do_normalize Shall the Gabor jets be normalized?
+ */
+void bob::ip::GaborWaveletTransform::computeJets(
+  const blitz::Array<std::complex<double>,2>& gray_image,
+  const blitz::Array<int,2>& positions,
+  blitz::Array<double,2>& jets,
+  bool do_normalize
+)
+{
+  // check that the shape is correct
+  bob::core::array::assertSameShape(jets, blitz::shape(positions.extent(0), m_kernel_frequencies.size()));
+
+  computeJetsAt(gray_image, positions, 0, &jets);
+
+  if (do_normalize){
+    for (int i = jets.extent(0); i--;){
+      blitz::Array<double,1> jet(jets(i,blitz::Range::all()));
+      bob::ip::normalizeGaborJet(jet);
+    }
+  }
+}
+
 void bob::ip::GaborWaveletTransform::save(bob::io::HDF5File& file) const{
   file.set("Sigma", m_sigma);
   file.set("PowOfK", m_pow_of_k);
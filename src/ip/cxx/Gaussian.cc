@@ -76,31 +76,11 @@ void bob::ip::Gaussian::operator()<double>(const blitz::Array<double,2>& src,
    blitz::Array<double,2>& dst)
 {
   // Checks are postponed to the convolution function.
-  if(m_conv_border == bob::sp::Extrapolation::Zero)
-  {
-    m_tmp_int.resize(bob::sp::getConvSepOutputSize(src, m_kernel_y, 0, bob::sp::Conv::Same));
-    bob::sp::convSep(src, m_kernel_y, m_tmp_int, 0, bob::sp::Conv::Same);
-    bob::sp::convSep(m_tmp_int, m_kernel_x, dst, 1, bob::sp::Conv::Same);
-  }
-  else
-  {
-    m_tmp_int1.resize(bob::sp::getConvSepOutputSize(src, m_kernel_y, 0, bob::sp::Conv::Full));
-    if(m_conv_border == bob::sp::Extrapolation::NearestNeighbour)
-      bob::sp::extrapolateNearest(src, m_tmp_int1);
-    else if(m_conv_border == bob::sp::Extrapolation::Circular)
-      bob::sp::extrapolateCircular(src, m_tmp_int1);
-    else
-      bob::sp::extrapolateMirror(src, m_tmp_int1);
-    m_tmp_int.resize(bob::sp::getConvSepOutputSize(m_tmp_int1, m_kernel_y, 0, bob::sp::Conv::Valid));
-    bob::sp::convSep(m_tmp_int1, m_kernel_y, m_tmp_int, 0, bob::sp::Conv::Valid);
-
-    m_tmp_int2.resize(bob::sp::getConvSepOutputSize(m_tmp_int, m_kernel_x, 1, bob::sp::Conv::Full));
-    if(m_conv_border == bob::sp::Extrapolation::NearestNeighbour)
-      bob::sp::extrapolateNearest(m_tmp_int, m_tmp_int2);
-    else if(m_conv_border == bob::sp::Extrapolation::Circular)
-      bob::sp::extrapolateCircular(m_tmp_int, m_tmp_int2);
-    else
-      bob::sp::extrapolateMirror(m_tmp_int, m_tmp_int2);
-    bob::sp::convSep(m_tmp_int2, m_kernel_x, dst, 1, bob::sp::Conv::Valid);
-  }
+  // The Constant border type has always been handled as Mirror here.
+  const bob::sp::Extrapolation::BorderType border_type =
+    (m_conv_border == bob::sp::Extrapolation::Constant) ?
+    bob::sp::Extrapolation::Mirror : m_conv_border;
+  m_tmp_int.resize(src.extent(0), src.extent(1));
+  bob::sp::convSepBorder(src, m_kernel_y, m_tmp_int, 0, border_type);
+  bob::sp::convSepBorder(m_tmp_int, m_kernel_x, dst, 1, border_type);
 }
@@ -16,10 +16,10 @@ bob::ip::GaussianScaleSpace::GaussianScaleSpace(const size_t height,
   m_height(height), m_width(width), m_n_octaves(n_octaves),
   m_n_intervals(n_intervals), m_octave_min(octave_min),
   m_sigma_n(sigma_n), m_sigma0(sigma0),
-  m_kernel_radius_factor(kernel_radius_factor), m_conv_border(border_type)
+  m_kernel_radius_factor(kernel_radius_factor), m_conv_border(border_type),
+  m_n_threads(1)
 {
   checkOctaveMin();
-  resetCache();
   resetGaussians();
 }
 
@@ -29,9 +29,8 @@ bob::ip::GaussianScaleSpace::GaussianScaleSpace(const GaussianScaleSpace& other)
   m_octave_min(other.m_octave_min), m_sigma_n(other.m_sigma_n),
   m_sigma0(other.m_sigma0),
   m_kernel_radius_factor(other.m_kernel_radius_factor),
-  m_conv_border(other.m_conv_border)
+  m_conv_border(other.m_conv_border), m_n_threads(other.m_n_threads)
 {
-  resetCache();
   resetGaussians();
 }
 
@@ -53,16 +52,24 @@ bob::ip::GaussianScaleSpace::operator=(const bob::ip::GaussianScaleSpace& other)
     m_sigma0 = other.m_sigma0;
     m_kernel_radius_factor = other.m_kernel_radius_factor;
     m_conv_border = other.m_conv_border;
-    resetCache();
+    m_n_threads = other.m_n_threads;
     resetGaussians();
   }
   return *this;
 }
 
-void bob::ip::GaussianScaleSpace::resetCache() const
+void bob::ip::GaussianScaleSpace::setNThreads(const size_t n_threads)
 {
-  const blitz::TinyVector<int,3> shape = getOutputShape(m_octave_min);
-  m_cache_array0.resize(shape(1), shape(2));
+  if (n_threads == 0)
+    throw std::runtime_error("the number of threads should be strictly positive");
+  m_n_threads = n_threads;
+}
+
+int bob::ip::GaussianScaleSpace::nBlocks(const int n) const
+{
+  // Slabs smaller than this are not worth a thread
+  static const int min_slab = 32;
+  return std::max(1, std::min((int)m_n_threads, n / min_slab));
 }
 
 bool
@@ -154,6 +161,17 @@ void bob::ip::GaussianScaleSpace::allocateOutputPyramid(
   }
 }
 
+void bob::ip::GaussianScaleSpace::allocateOutputPyramid(
+  std::vector<blitz::Array<float,3> >& dst) const
+{
+  dst.clear();
+  for (size_t i=0; i<m_n_octaves; ++i)
+  {
+    blitz::Array<float,3> dst_o(getOutputShape(m_octave_min+(int)i));
+    dst.push_back(dst_o);
+  }
+}
+
 const blitz::TinyVector<int,3>
 bob::ip::GaussianScaleSpace::getOutputShape(const int octave) const
 {
@@ -24,7 +24,7 @@ void bob::ip::hogComputeHistogram_(const blitz::Array<double,2>& mag,
   const blitz::Array<double,2>& ori, blitz::Array<double,1>& hist,
   const bool init_hist, const bool full_orientation)
 {
-  static const double range_orientation = (full_orientation? 2*M_PI : M_PI);
+  const double range_orientation = (full_orientation? 2*M_PI : M_PI);
   const int nb_bins = hist.extent(0);
 
   // Initializes output to zero if required
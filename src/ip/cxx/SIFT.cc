@@ -103,8 +103,7 @@ bob::ip::SIFT::operator==(const bob::ip::SIFT& b) const
  if (this->m_gss_pyr.size() != b.m_gss_pyr.size() ||
      this->m_dog_pyr.size() != b.m_dog_pyr.size() ||
      this->m_gss_pyr_grad_mag.size() != b.m_gss_pyr_grad_mag.size() ||
-     this->m_gss_pyr_grad_or.size() != b.m_gss_pyr_grad_or.size() ||
-     this->m_gradient_maps.size() != b.m_gradient_maps.size())
+     this->m_gss_pyr_grad_or.size() != b.m_gss_pyr_grad_or.size())
     return false;
 
   for (size_t i=0; i<m_gss_pyr.size(); ++i)
@@ -123,10 +122,6 @@ bob::ip::SIFT::operator==(const bob::ip::SIFT& b) const
     if (!bob::core::array::isEqual(this->m_gss_pyr_grad_or[i], b.m_gss_pyr_grad_or[i]))
       return false;
 
-  for (size_t i=0; i<m_gradient_maps.size(); ++i)
-    if (*(this->m_gradient_maps[i]) != *(b.m_gradient_maps[i]))
-      return false;
-
   return true;
 }
 
@@ -157,8 +152,6 @@ void bob::ip::SIFT::resetCache()
       m_gss_pyr[i].extent(1), m_gss_pyr[i].extent(2)));
     m_gss_pyr_grad_or.push_back(blitz::Array<double,3>(m_gss_pyr[i].extent(0)-3,
       m_gss_pyr[i].extent(1), m_gss_pyr[i].extent(2)));
-    m_gradient_maps.push_back(boost::shared_ptr<bob::ip::GradientMaps>(new 
-      bob::ip::GradientMaps(m_gss_pyr[i].extent(1), m_gss_pyr[i].extent(2))));
     m_gss_pyr[i] = 0.;
     m_dog_pyr[i] = 0.;
     m_gss_pyr_grad_mag[i] = 0.;
@@ -166,43 +159,25 @@ void bob::ip::SIFT::resetCache()
   }
 }
 
-const blitz::TinyVector<int,3> 
-bob::ip::SIFT::getGaussianOutputShape(const int octave) const
+bool bob::ip::SIFT::isCacheValid() const
 {
-  return m_gss->getOutputShape(octave);
-}
-
-void bob::ip::SIFT::computeDog()
-{
-  // Computes the Difference of Gaussians pyramid
-  blitz::Range rall = blitz::Range::all();
-  for (size_t o=0; o<m_gss_pyr.size(); ++o)
-    for (size_t s=0; s<(size_t)(m_gss_pyr[o].extent(0)-1); ++s)
-    {
-      blitz::Array<double,2> dst_os = m_dog_pyr[o](s, rall, rall);
-      blitz::Array<double,2> src1 = m_gss_pyr[o](s, rall, rall);
-      blitz::Array<double,2> src2 = m_gss_pyr[o](s+1, rall, rall);
-      dst_os = src2 - src1;
-    }
-}
-
-void bob::ip::SIFT::computeGradient()
-{
-  blitz::Range rall = blitz::Range::all();
+  if (m_gss_pyr.size() != m_gss->getNOctaves()) return false;
   for (size_t i=0; i<m_gss_pyr.size(); ++i)
   {
-    blitz::Array<double,3>& gss = m_gss_pyr[i];
-    blitz::Array<double,3>& gmag = m_gss_pyr_grad_mag[i];
-    blitz::Array<double,3>& gor = m_gss_pyr_grad_or[i];
-    boost::shared_ptr<bob::ip::GradientMaps> gmap = m_gradient_maps[i];
-    for (int s=0; s<gmag.extent(0); ++s)
-    {
-      blitz::Array<double,2> gss_s = gss(s+1, rall, rall);
-      blitz::Array<double,2> gmag_s = gmag(s, rall, rall);
-      blitz::Array<double,2> gor_s = gor(s, rall, rall);
-      gmap->forward(gss_s, gmag_s, gor_s);
-    }
+    const blitz::TinyVector<int,3> shape =
+      m_gss->getOutputShape(m_gss->getOctaveMin()+(int)i);
+    if (m_gss_pyr[i].extent(0) != shape(0) ||
+        m_gss_pyr[i].extent(1) != shape(1) ||
+        m_gss_pyr[i].extent(2) != shape(2))
+      return false;
   }
+  return true;
+}
+
+const blitz::TinyVector<int,3> 
+bob::ip::SIFT::getGaussianOutputShape(const int octave) const
+{
+  return m_gss->getOutputShape(octave);
 }
 
 void bob::ip::SIFT::computeDescriptor(const std::vector<boost::shared_ptr<bob::ip::GSSKeypoint> >& keypoints,
@@ -220,4 +220,59 @@ BOOST_AUTO_TEST_CASE( test_GWT_output )
 
 }
 
+BOOST_AUTO_TEST_CASE( test_gwt_threads_and_positions )
+{
+  // create a synthetic image
+  blitz::Array<std::complex<double>,2> image(40, 50);
+  for (int y = 0; y < 40; ++y)
+    for (int x = 0; x < 50; ++x)
+      image(y,x) = std::complex<double>(128. + 100. * std::sin(0.3 * x + 0.1 * y) * std::cos(0.05 * x * y), 0.);
+
+  bob::ip::GaborWaveletTransform gwt;
+  blitz::Array<std::complex<double>,3> trafo(gwt.numberOfKernels(), 40, 50), trafo_threads(trafo.shape());
+  blitz::Array<double,4> jet_image(40, 50, 2, gwt.numberOfKernels()), jet_image_threads(jet_image.shape());
+  gwt.performGWT(image, trafo);
+  gwt.computeJetImage(image, jet_image, true);
+  blitz::Array<double,3> kernels = gwt.kernelImages();
+
+  // the results of the threaded transform do not depend on the number of threads
+  gwt.setNThreads(3);
+  gwt.performGWT(image, trafo_threads);
+  gwt.computeJetImage(image, jet_image_threads, true);
+  test_close(trafo_threads, trafo, 1e-10);
+  test_close(jet_image_threads, jet_image, 1e-10);
+  BOOST_CHECK_THROW(gwt.setNThreads(0), std::runtime_error);
+
+  // the kernels of the first resolution are taken from the cache
+  blitz::Array<std::complex<double>,2> image2(image(blitz::Range(0,29), blitz::Range(0,34)).copy());
+  blitz::Array<double,3> jet_image2(30, 35, gwt.numberOfKernels());
+  gwt.computeJetImage(image2, jet_image2, true);
+  gwt.performGWT(image, trafo_threads);
+  test_close(gwt.kernelImages(), kernels, 1e-10);
+  test_close(trafo_threads, trafo, 1e-10);
+
+  // the jets computed at some positions are identical to the ones of the jet image
+  blitz::Array<int,2> positions(4, 2);
+  positions = 0, 0,  12, 17,  39, 49,  25, 3;
+  blitz::Array<double,3> jets(4, 2, gwt.numberOfKernels());
+  blitz::Array<double,2> abs_jets(4, gwt.numberOfKernels());
+  gwt.computeJets(image, positions, jets, true);
+  gwt.computeJets(image2, blitz::Array<int,2>(positions(blitz::Range(0,1), blitz::Range::all())), abs_jets, true);
+  for (int i = 0; i < 4; ++i){
+    for (int j = 0; j < (int)gwt.numberOfKernels(); ++j){
+      const double abs_ref = jet_image(positions(i,0), positions(i,1), 0, j),
+                   phase_ref = jet_image(positions(i,0), positions(i,1), 1, j);
+      BOOST_CHECK_SMALL(jets(i,0,j) - abs_ref, 1e-8);
+      // compare the phases on the unit circle
+      BOOST_CHECK_SMALL(std::abs(std::polar(1., jets(i,1,j)) - std::polar(1., phase_ref)) * abs_ref, 1e-8);
+      if (i < 2)
+        BOOST_CHECK_SMALL(abs_jets(i,j) - jet_image2(positions(i,0), positions(i,1), j), 1e-8);
+    }
+  }
+
+  // positions outside the image are rejected
+  positions(3,1) = 50;
+  BOOST_CHECK_THROW(gwt.computeJets(image, positions, jets, true), std::runtime_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -69,6 +69,7 @@ namespace bob { namespace ip {
   {
     public:
       void run(const blitz::Array<double,2>& src, blitz::Array<double,3>& descr);
+      void fused(const blitz::Array<double,2>& src, const double eps);
   };
 }}
 
@@ -87,18 +88,76 @@ void bob::ip::SIFTtest::run(const blitz::Array<double,2>& src, blitz::Array<doub
   kpi.iy = (int)floor(kp.y/factor + 0.5);
   kpi.ix = (int)floor(kp.x/factor + 0.5);
 
-  // Set input data and compute descriptor
-  std::vector<blitz::Array<double,3> > vec;
-  blitz::Array<double,3> pyr(NINTERVALS+3,HEIGHT,WIDTH);
+  // Set the gradients of the input data (as if all the scales were equal
+  // to it) and compute descriptor
+  bob::ip::GradientMaps gmap(HEIGHT, WIDTH);
   blitz::Range rall = blitz::Range::all();
-  for (int i=0; i<NINTERVALS+3; ++i)
-    pyr(i,rall,rall) = src;
-  vec.push_back(pyr);
-  op.setGaussianPyramid(vec);
-  op.computeGradient();
+  for (int i=0; i<op.m_gss_pyr_grad_mag[0].extent(0); ++i)
+  {
+    blitz::Array<double,2> gmag_s = op.m_gss_pyr_grad_mag[0](i,rall,rall);
+    blitz::Array<double,2> gor_s = op.m_gss_pyr_grad_or[0](i,rall,rall);
+    gmap.forward(src, gmag_s, gor_s);
+  }
   op.computeDescriptor(kp, kpi, descr);
 }
 
+void bob::ip::SIFTtest::fused(const blitz::Array<double,2>& src,
+  const double eps)
+{
+  // Descriptors of a few keypoints, from the pyramids computed in a single
+  // pass (with an upsampled first octave)
+  bob::ip::SIFT op(src.extent(0), src.extent(1), 3, NINTERVALS, -1);
+  std::vector<boost::shared_ptr<bob::ip::GSSKeypoint> > kps;
+  kps.push_back(boost::shared_ptr<bob::ip::GSSKeypoint>(
+    new bob::ip::GSSKeypoint(2., 30., 40.)));
+  kps.push_back(boost::shared_ptr<bob::ip::GSSKeypoint>(
+    new bob::ip::GSSKeypoint(4.5, 20., 25.)));
+  const blitz::TinyVector<int,3> shape = op.getDescriptorShape();
+  blitz::Array<double,4> descr(kps.size(), shape(0), shape(1), shape(2));
+  op.computeDescriptor(src, kps, descr);
+
+  // Same pyramids, computed in separate passes
+  std::vector<blitz::Array<double,3> > gss;
+  op.m_gss->allocateOutputPyramid(gss);
+  (*op.m_gss)(src, gss);
+  blitz::Range rall = blitz::Range::all();
+  for (size_t o=0; o<gss.size(); ++o)
+  {
+    checkBlitzClose(op.m_gss_pyr[o], gss[o], eps);
+
+    blitz::Array<double,3> dog(gss[o].extent(0)-1, gss[o].extent(1),
+      gss[o].extent(2));
+    for (int s=0; s<dog.extent(0); ++s)
+      dog(s,rall,rall) = gss[o](s+1,rall,rall) - gss[o](s,rall,rall);
+    checkBlitzClose(op.m_dog_pyr[o], dog, eps);
+
+    bob::ip::GradientMaps gmap(gss[o].extent(1), gss[o].extent(2));
+    blitz::Array<double,3> gmag(op.m_gss_pyr_grad_mag[o].shape());
+    blitz::Array<double,3> gor(op.m_gss_pyr_grad_or[o].shape());
+    for (int s=0; s<gmag.extent(0); ++s)
+    {
+      blitz::Array<double,2> gss_s = gss[o](s+1,rall,rall);
+      blitz::Array<double,2> gmag_s = gmag(s,rall,rall);
+      blitz::Array<double,2> gor_s = gor(s,rall,rall);
+      gmap.forward(gss_s, gmag_s, gor_s);
+    }
+    checkBlitzClose(op.m_gss_pyr_grad_mag[o], gmag, eps);
+    checkBlitzClose(op.m_gss_pyr_grad_or[o], gor, eps);
+    op.m_gss_pyr_grad_mag[o] = gmag;
+    op.m_gss_pyr_grad_or[o] = gor;
+  }
+
+  // Descriptors from the gradients of the separate passes
+  blitz::Array<double,4> descr_ref(descr.shape());
+  op.computeDescriptor(kps, descr_ref);
+  for (int k=0; k<descr.extent(0); ++k)
+  {
+    blitz::Array<double,3> d = descr(k,rall,rall,rall);
+    blitz::Array<double,3> d_ref = descr_ref(k,rall,rall,rall);
+    checkBlitzClose(d, d_ref, eps);
+  }
+}
+
 // 3. Code extracted from VLFeat for testing purposes and updated for our
 // particular comparison. This extracted code was originally distributed
 // under a BSD license.
@@ -400,4 +459,18 @@ BOOST_AUTO_TEST_CASE( test_sift_vlfeat_comparison )
   checkBlitzClose( bob_descr, vl_descr, eps);
 }
 
+BOOST_AUTO_TEST_CASE( test_sift_fused_pyramids )
+{
+  // The Gaussian, DoG and gradient pyramids computed in a single pass by
+  // computeDescriptor() are the same as when computed in separate passes
+  blitz::Array<double,2> A(64,80);
+  ranlib::Uniform<double> gen;
+  for (int i=0; i<A.extent(0); ++i)
+    for (int j=0; j<A.extent(1); ++j)
+      A(i,j) = 255. * gen.random();
+
+  bob::ip::SIFTtest bob_test;
+  bob_test.fused(A, 1e-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
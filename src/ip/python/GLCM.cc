@@ -49,6 +49,7 @@ void bind_ip_glcm_uint8()
     .add_property("num_levels", &bob::ip::GLCM<uint8_t>::getNumLevels, "Specifies the number of gray-levels to use when scaling the grayscale values in the input image. This is the number of the values in the first and second dimension in the GLCM matrix. The default is the total number of gray values permitted by the type of the input image")
     .add_property("symmetric", &bob::ip::GLCM<uint8_t>::getSymmetric, &bob::ip::GLCM<uint8_t>::setSymmetric, " If True, the output matrix for each specified distance and angle will be symmetric. Both (i, j) and (j, i) are accumulated when (i, j) is encountered for a given offset. The default is False.")
     .add_property("normalized", &bob::ip::GLCM<uint8_t>::getNormalized, &bob::ip::GLCM<uint8_t>::setNormalized, " If True, each matrix for each specified distance and angle will be normalized by dividing by the total number of accumulated co-occurrences. The default is False.")
+    .add_property("n_threads", &bob::ip::GLCM<uint8_t>::getNThreads, &bob::ip::GLCM<uint8_t>::setNThreads, "The number of threads used to count the co-occurences. The stripes of rows of the image are processed in parallel, and the result does not depend on this number.")
     .def("__call__", &call_glcm<uint8_t>, (arg("self"), arg("input"), arg("output")), "Calls an object of this type to extract the GLCM matrix from the given input image.")
     .def("get_glcm_shape", &bob::ip::GLCM<uint8_t>::getGLCMShape, (arg("self")), "Get the shape of the GLCM matrix goven the input image. It has 3 dimensions: two for the number of grey levels, and one for the number of offsets.")
     ;
@@ -69,6 +70,7 @@ void bind_ip_glcm_uint16()
     .add_property("num_levels", &bob::ip::GLCM<uint16_t>::getNumLevels, "Specifies the number of gray-levels to use when scaling the grayscale values in the input image. This is the number of the values in the first and second dimension in the GLCM matrix. The default is the total number of gray values permitted by the type of the input image")
     .add_property("symmetric", &bob::ip::GLCM<uint16_t>::getSymmetric, &bob::ip::GLCM<uint16_t>::setSymmetric, " If True, the output matrix for each specified distance and angle will be symmetric. Both (i, j) and (j, i) are accumulated when (i, j) is encountered for a given offset. The default is False.")
     .add_property("normalized", &bob::ip::GLCM<uint16_t>::getNormalized, &bob::ip::GLCM<uint16_t>::setNormalized, " If True, each matrix for each specified distance and angle will be normalized by dividing by the total number of accumulated co-occurrences. The default is False.")
+    .add_property("n_threads", &bob::ip::GLCM<uint16_t>::getNThreads, &bob::ip::GLCM<uint16_t>::setNThreads, "The number of threads used to count the co-occurences. The stripes of rows of the image are processed in parallel, and the result does not depend on this number.")
     .def("__call__", &call_glcm<uint16_t>, (arg("self"), arg("input"), arg("output")), "Calls an object of this type to extract the GLCM matrix from the given input image.")
     .def("get_glcm_shape", &bob::ip::GLCM<uint16_t>::getGLCMShape, (arg("self")), "Get the shape of the GLCM matrix goven the input image. It has 3 dimensions: two for the number of grey levels, and one for the number of offsets.")
     ;
@@ -386,13 +386,66 @@ static object call_inv_diff_mom_norm_p(const bob::ip::GLCMProp& op, bob::python:
   return output.self();
 }
 
+static std::vector<bob::ip::GLCMProp::Property> convert_properties(object props)
+{
+  std::vector<bob::ip::GLCMProp::Property> res;
+  for (int k = 0; k < len(props); ++k)
+    res.push_back(extract<bob::ip::GLCMProp::Property>(props[k]));
+  return res;
+}
+
+static void call_properties_c(const bob::ip::GLCMProp& op, bob::python::const_ndarray input, object props, bob::python::ndarray output)
+{
+  blitz::Array<double,2> output_ = output.bz<double,2>();
+  op.properties(input.bz<double,3>(), convert_properties(props), output_);
+}
+
+static object call_properties_p(const bob::ip::GLCMProp& op, bob::python::const_ndarray input, object props)
+{
+  const std::vector<bob::ip::GLCMProp::Property> props_ = convert_properties(props);
+  const blitz::TinyVector<int,1> sh = op.get_prop_shape(input.bz<double,3>());
+  bob::python::ndarray output(bob::core::array::t_float64, (int)props_.size(), sh(0));
+  blitz::Array<double,2> output_ = output.bz<double,2>();
+  op.properties(input.bz<double,3>(), props_, output_);
+  return output.self();
+}
+
 
 void bind_ip_glcmprop() 
 {
+  enum_<bob::ip::GLCMProp::Property>("GLCMProperty", "The texture properties of the GLCM that can be computed together by GLCMProp.properties()")
+    .value("ANGULAR_SECOND_MOMENT", bob::ip::GLCMProp::ANGULAR_SECOND_MOMENT)
+    .value("ENERGY", bob::ip::GLCMProp::ENERGY)
+    .value("VARIANCE", bob::ip::GLCMProp::VARIANCE)
+    .value("CONTRAST", bob::ip::GLCMProp::CONTRAST)
+    .value("AUTO_CORRELATION", bob::ip::GLCMProp::AUTO_CORRELATION)
+    .value("CORRELATION", bob::ip::GLCMProp::CORRELATION)
+    .value("CORRELATION_M", bob::ip::GLCMProp::CORRELATION_M)
+    .value("INV_DIFF_MOM", bob::ip::GLCMProp::INV_DIFF_MOM)
+    .value("SUM_AVG", bob::ip::GLCMProp::SUM_AVG)
+    .value("SUM_VAR", bob::ip::GLCMProp::SUM_VAR)
+    .value("SUM_ENTROPY", bob::ip::GLCMProp::SUM_ENTROPY)
+    .value("ENTROPY", bob::ip::GLCMProp::ENTROPY)
+    .value("DIFF_VAR", bob::ip::GLCMProp::DIFF_VAR)
+    .value("DIFF_ENTROPY", bob::ip::GLCMProp::DIFF_ENTROPY)
+    .value("DISSIMILARITY", bob::ip::GLCMProp::DISSIMILARITY)
+    .value("HOMOGENEITY", bob::ip::GLCMProp::HOMOGENEITY)
+    .value("CLUSTER_PROM", bob::ip::GLCMProp::CLUSTER_PROM)
+    .value("CLUSTER_SHADE", bob::ip::GLCMProp::CLUSTER_SHADE)
+    .value("MAX_PROB", bob::ip::GLCMProp::MAX_PROB)
+    .value("INF_MEAS_CORR1", bob::ip::GLCMProp::INF_MEAS_CORR1)
+    .value("INF_MEAS_CORR2", bob::ip::GLCMProp::INF_MEAS_CORR2)
+    .value("INV_DIFF", bob::ip::GLCMProp::INV_DIFF)
+    .value("INV_DIFF_NORM", bob::ip::GLCMProp::INV_DIFF_NORM)
+    .value("INV_DIFF_MOM_NORM", bob::ip::GLCMProp::INV_DIFF_MOM_NORM)
+    ;
+
   class_<bob::ip::GLCMProp, boost::shared_ptr<bob::ip::GLCMProp>, boost::noncopyable>("GLCMProp", glcmprop_doc, no_init)
     .def(init<>((arg("self")), "Constructor"))
     .def(init<const bob::ip::GLCMProp&>((arg("self"), arg("other")), "Copy constructs a GLCMProp operator"))
 
+    .def("properties", &call_properties_c, (arg("self"), arg("input"), arg("props"), arg("output")), "Extract all the given properties (a list of GLCMProperty) of the input GLCM at once, with a single pass over the GLCM. The output has one row per property, and one column per offset.")
+    .def("properties", &call_properties_p, (arg("self"), arg("input"), arg("props")), "Extract and return all the given properties (a list of GLCMProperty) of the input GLCM at once, with a single pass over the GLCM. The output has one row per property, and one column per offset.")
     .def("get_glcmprop_shape", &bob::ip::GLCMProp::get_prop_shape, (arg("self"), arg("input")), "Get the shape of the GLCM properties vector given the input GLCM. For each offset of the GLCM, one field of the output vector is filled.")
     .def("angular_second_moment", &call_angular_second_moment_c, (arg("self"),arg("input"), arg("output")), "Extract Angular Second Moment property of the input GLCM (see ref [1])")    
     .def("angular_second_moment", &call_angular_second_moment_p, (arg("self"),arg("input")), "Extract Angular Second Moment property of the input GLCM (see ref [1])")    
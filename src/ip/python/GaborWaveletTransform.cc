@@ -135,6 +135,43 @@ static bob::python::ndarray compute_jets_2(bob::ip::GaborWaveletTransform& gwt,
   return output_jet_image;
 }
 
+static blitz::Array<int,2> convert_positions(bob::python::const_ndarray positions){
+  switch (positions.type().dtype){
+    case bob::core::array::t_int32: return positions.bz<int32_t,2>();
+    case bob::core::array::t_int64: return bob::core::array::cast<int>(positions.bz<int64_t,2>());
+    case bob::core::array::t_uint16: return bob::core::array::cast<int>(positions.bz<uint16_t,2>());
+    case bob::core::array::t_float64: return bob::core::array::cast<int>(positions.bz<double,2>());
+    default: throw std::runtime_error("unsupported data type of the positions");
+  }
+}
+
+static void compute_jets_at_1(bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image, bob::python::const_ndarray positions, bob::python::ndarray output_jets, bool normalized){
+  const blitz::Array<std::complex<double>,2>& image = convert_image(input_image);
+  const blitz::Array<int,2> pos = convert_positions(positions);
+
+  if (output_jets.type().nd == 2){
+    // compute jets with absolute values only
+    blitz::Array<double,2> jets = output_jets.bz<double,2>();
+    gwt.computeJets(image, pos, jets, normalized);
+  } else if (output_jets.type().nd == 3){
+    blitz::Array<double,3> jets = output_jets.bz<double,3>();
+    gwt.computeJets(image, pos, jets, normalized);
+  } else {
+    boost::format m("parameter `output_jets' has an unexpected shape: %s");
+    m % output_jets.type().str();
+    throw std::runtime_error(m.str());
+  }
+}
+
+static bob::python::ndarray compute_jets_at_2(bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image, bob::python::const_ndarray positions, bool include_phases, bool normalized){
+  const int n = positions.type().shape[0];
+  bob::python::ndarray output_jets = include_phases ?
+    bob::python::ndarray(bob::core::array::t_float64, n, 2, (int)gwt.numberOfKernels()) :
+    bob::python::ndarray(bob::core::array::t_float64, n, (int)gwt.numberOfKernels());
+  compute_jets_at_1(gwt, input_image, positions, output_jets, normalized);
+  return output_jets;
+}
+
 
 static void normalize_gabor_jet(bob::python::ndarray gabor_jet){
   if (gabor_jet.type().nd == 1){
@@ -252,6 +289,13 @@ void bind_ip_gabor_wavelet_transform() {
     "The number of directions that this Gabor wavelet family holds."
   )
 
+  .add_property(
+    "n_threads",
+    &bob::ip::GaborWaveletTransform::getNThreads,
+    &bob::ip::GaborWaveletTransform::setNThreads,
+    "The number of threads used to compute the responses of the Gabor wavelets. The results do not depend on this number."
+  )
+
   .def(
     "empty_trafo_image",
     &empty_trafo_image,
@@ -306,6 +350,20 @@ void bind_ip_gabor_wavelet_transform() {
     &compute_jets_2,
     (boost::python::arg("self"), boost::python::arg("input_image"), boost::python::arg("include_phases")=true, boost::python::arg("normalized")=true),
     "Performs a Gabor wavelet transform and returns the image of Gabor jets, with or without Gabor phases. If the normalized parameter is set to True (the default), the absolute parts of the Gabor jets are normalized to unit Euclidean length."
+  )
+
+  .def(
+    "compute_jets_at",
+    &compute_jets_at_1,
+    (boost::python::arg("self"), boost::python::arg("input_image"), boost::python::arg("positions"), boost::python::arg("output_jets"), boost::python::arg("normalized")=true),
+    "Computes the Gabor jets at the given positions (a N x 2 array of (y,x) coordinates, e.g., the nodes of a graph) only and fills the given array of Gabor jets (N x 2 x number_of_kernels with phases, or N x number_of_kernels without). This is faster than computing the whole jet image when only a few positions are required."
+  )
+
+  .def(
+    "compute_jets_at",
+    &compute_jets_at_2,
+    (boost::python::arg("self"), boost::python::arg("input_image"), boost::python::arg("positions"), boost::python::arg("include_phases")=true, boost::python::arg("normalized")=true),
+    "Computes the Gabor jets at the given positions (a N x 2 array of (y,x) coordinates, e.g., the nodes of a graph) only and returns them, with or without Gabor phases."
   );
 
   boost::python::def(
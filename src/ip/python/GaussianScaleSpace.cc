@@ -14,18 +14,33 @@
 
 using namespace boost::python;
 
-static object allocate_output(const bob::ip::GaussianScaleSpace& op)
+static object allocate_output(const bob::ip::GaussianScaleSpace& op,
+  bool float32=false)
 {
   boost::python::list dst;
   for (int i=op.getOctaveMin(); i<=op.getOctaveMax(); ++i)
   {
     const blitz::TinyVector<int,3> shape = op.getOutputShape(i);
-    bob::python::ndarray dst_i(bob::core::array::t_float64, shape(0), shape(1), shape(2));
+    bob::python::ndarray dst_i(float32 ? bob::core::array::t_float32 :
+      bob::core::array::t_float64, shape(0), shape(1), shape(2));
     dst.append(dst_i);
   }
   return dst;
 }
 
+BOOST_PYTHON_FUNCTION_OVERLOADS(allocate_output_overloads, allocate_output, 1, 2)
+
+
+template <typename T, typename U>
+static void inner_call_c_typed(const bob::ip::GaussianScaleSpace& op,
+  bob::python::const_ndarray src, std::vector<bob::python::const_ndarray>& ndst)
+{
+  std::vector<blitz::Array<U,3> > vdst;
+  for(std::vector<bob::python::const_ndarray>::iterator it=ndst.begin();
+    it!=ndst.end(); ++it)
+  vdst.push_back(it->bz<U,3>());
+  op(src.bz<T,2>(), vdst);
+}
 
 template <typename T>
 static void inner_call_c(const bob::ip::GaussianScaleSpace& op,
@@ -33,11 +48,11 @@ static void inner_call_c(const bob::ip::GaussianScaleSpace& op,
 {
   stl_input_iterator<bob::python::const_ndarray> begin(dst), end;
   std::vector<bob::python::const_ndarray> ndst(begin, end);
-  std::vector<blitz::Array<double,3> > vdst;
-  for(std::vector<bob::python::const_ndarray>::iterator it=ndst.begin();
-    it!=ndst.end(); ++it)
-  vdst.push_back(it->bz<double,3>());
-  op(src.bz<T,2>(), vdst);
+  // The pyramid is computed in single precision if the output is float32
+  if (ndst.size() && ndst[0].type().dtype == bob::core::array::t_float32)
+    inner_call_c_typed<T,float>(op, src, ndst);
+  else
+    inner_call_c_typed<T,double>(op, src, ndst);
 }
 
 static void call_c(bob::ip::GaussianScaleSpace& op,
@@ -121,10 +136,11 @@ void bind_ip_gaussian_scale_space()
       .add_property("sigma0", &bob::ip::GaussianScaleSpace::getSigma0, &bob::ip::GaussianScaleSpace::setSigma0, "The value sigma0 of the standard deviation for the image of the first octave and first scale")
       .add_property("kernel_radius_factor", &bob::ip::GaussianScaleSpace::getKernelRadiusFactor, &bob::ip::GaussianScaleSpace::setKernelRadiusFactor, "Factor used to determine the kernel radii (size=2*radius+1). For each Gaussian kernel, the radius is equal to ceil(kernel_radius_factor*sigma_{octave,scale}).")
       .add_property("conv_border", &bob::ip::GaussianScaleSpace::getConvBorder, &bob::ip::GaussianScaleSpace::setConvBorder, "The way to deal with convolutions at the image boundary.")
+      .add_property("n_threads", &bob::ip::GaussianScaleSpace::getNThreads, &bob::ip::GaussianScaleSpace::setNThreads, "The number of threads used to filter the images. The output does not depend on this setting.")
       .def("get_gaussian", &bob::ip::GaussianScaleSpace::getGaussian, (arg("self"), arg("index")), "Returns the Gaussian at index/interval i")
       .def("set_sigma0_no_init_smoothing", &bob::ip::GaussianScaleSpace::setSigma0NoInitSmoothing, (arg("self")), "Sets sigma0 such that there is not smoothing at the first scale of octave_min.")
-      .def("allocate_output", &allocate_output, (arg("self")), "Allocates a python list of arrays for the Gaussian pyramid.")
-      .def("__call__", &call_c, (arg("self"), arg("src"), arg("dst")), "Computes a Gaussian Pyramid for an input 2D image, and put the results in the output dst. The output should already be allocated and of the correct size (using the allocate_output() method).")
+      .def("allocate_output", &allocate_output, allocate_output_overloads((arg("self"), arg("float32")=false), "Allocates a python list of arrays for the Gaussian pyramid. If float32 is set, the arrays are single precision, and the pyramid will be computed in single precision."))
+      .def("__call__", &call_c, (arg("self"), arg("src"), arg("dst")), "Computes a Gaussian Pyramid for an input 2D image, and put the results in the output dst. The output should already be allocated and of the correct size (using the allocate_output() method). The pyramid is computed in single precision if the output arrays are float32.")
       .def("__call__", &call_p, (arg("self"), arg("src")), "Computes a Gaussian Pyramid for an input 2D image, and allocate and return the results.")
     ;
 }
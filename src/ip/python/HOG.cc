@@ -12,6 +12,7 @@
 #include <bob/python/ndarray.h>
 #include <bob/core/cast.h>
 #include <bob/ip/HOG.h>
+#include <bob/ip/IntegralHOG.h>
 
 using namespace boost::python;
 
@@ -467,6 +468,93 @@ static object hog_call2_p(bob::ip::HOG<double>& obj,
 }
 
 
+template <typename T> 
+static void inner_integral_hog_compute(bob::ip::IntegralHOG<double>& obj, 
+  bob::python::const_ndarray input)
+{
+  obj.computeIntegralHistograms(bob::core::array::cast<double>(input.bz<T,2>()));
+}
+
+static void integral_hog_compute(bob::ip::IntegralHOG<double>& obj, 
+  bob::python::const_ndarray input) 
+{
+  const bob::core::array::typeinfo& info = input.type();
+  switch (info.dtype) {
+    case bob::core::array::t_uint8: 
+      return inner_integral_hog_compute<uint8_t>(obj, input);
+    case bob::core::array::t_uint16:
+      return inner_integral_hog_compute<uint16_t>(obj, input);
+    case bob::core::array::t_float64: 
+      return obj.computeIntegralHistograms(input.bz<double,2>());
+    default: 
+      PYTHON_ERROR(TypeError, 
+        "bob.ip.IntegralHOG does not support array with type '%s'.", 
+        info.str().c_str());
+  }
+}
+
+template <typename T> 
+static void inner_integral_hog_call_cast(bob::ip::IntegralHOG<double>& obj, 
+  bob::python::const_ndarray input, blitz::Array<double,3>& output)
+{
+  blitz::Array<double,2> input_c = bob::core::array::cast<double>(input.bz<T,2>());
+  obj.forward(input_c, output);
+}
+
+static object integral_hog_call(bob::ip::IntegralHOG<double>& obj, 
+  bob::python::const_ndarray input) 
+{
+  const bob::core::array::typeinfo& info = input.type();
+  const blitz::TinyVector<int,3> shape = obj.getOutputShape();
+  bob::python::ndarray output(bob::core::array::t_float64, 
+    shape(0), shape(1), shape(2));
+  blitz::Array<double,3> output_ = output.bz<double,3>();
+
+  // forward() checks that the input has the size of a window
+  switch (info.dtype) {
+    case bob::core::array::t_uint8: 
+      inner_integral_hog_call_cast<uint8_t>(obj, input, output_);
+      break;
+    case bob::core::array::t_uint16:
+      inner_integral_hog_call_cast<uint16_t>(obj, input, output_);
+      break;
+    case bob::core::array::t_float64: 
+      obj.forward(input.bz<double,2>(), output_);
+      break;
+    default: 
+      PYTHON_ERROR(TypeError, 
+        "bob.ip.IntegralHOG __call__ does not support array with type '%s'.", 
+        info.str().c_str());
+  }
+
+  return output.self();
+}
+
+static object integral_hog_extract1(bob::ip::IntegralHOG<double>& obj, 
+  const int y, const int x) 
+{
+  const blitz::TinyVector<int,3> shape = obj.getOutputShape();
+  bob::python::ndarray output(bob::core::array::t_float64, 
+    shape(0), shape(1), shape(2));
+  blitz::Array<double,3> output_ = output.bz<double,3>();
+  obj.extract(y, x, output_);
+  return output.self();
+}
+
+static object integral_hog_extract2(bob::ip::IntegralHOG<double>& obj, 
+  bob::python::const_ndarray positions) 
+{
+  const blitz::Array<int,2> positions_ = 
+    bob::core::array::cast<int>(positions.bz<int64_t,2>());
+  const blitz::TinyVector<int,3> shape = obj.getOutputShape();
+  bob::python::ndarray output(bob::core::array::t_float64, 
+    positions_.extent(0), shape(0), shape(1), shape(2));
+  blitz::Array<double,4> output_ = output.bz<double,4>();
+  obj.extract(positions_, output_);
+  return output.self();
+}
+
+
 void bind_ip_hog() 
 {
   static const char* gradientmaps_doc = 
@@ -475,6 +563,14 @@ void bind_ip_hog()
   static const char* hog_doc = 
     "Objects of this class, after configuration, can extract \
      Histogram of Gradients (HOG) descriptors.";
+  static const char* integral_hog_doc = 
+    "Objects of this class, after configuration, can extract \
+     Histogram of Gradients (HOG) descriptors from many windows of the same \
+     image. The gradients of the image and one integral image per \
+     orientation bin are computed once by compute_integral_histograms(), \
+     after which the descriptors of any window are obtained by extract() \
+     at a cost that does not depend on the window size. The cell and block \
+     layout of a window (of size height x width) is the same as for HOG.";
 
   boost::python::enum_<bob::ip::GradientMagnitudeType>("GradientMagnitudeType")
     .value("Magnitude", bob::ip::Magnitude)
@@ -662,4 +758,95 @@ void bind_ip_hog()
     .def("forward_", &hog_call2_p, (arg("self"), arg("input")),
       "Extract the HOG descriptors. This variant does not check the inputs.")
   ;
+
+  class_<bob::ip::IntegralHOG<double>, boost::shared_ptr<bob::ip::IntegralHOG<double> > >(
+      "IntegralHOG", 
+      integral_hog_doc, 
+      init<const size_t, const size_t, 
+        optional<const size_t, const bool, const size_t, const size_t, 
+          const size_t, const size_t, const size_t, const size_t, 
+          const size_t, const size_t> >(
+        (arg("self"), arg("height"), arg("width"), arg("nb_bins")=8, 
+         arg("full_orientation")=false, arg("cell_y")=4, arg("cell_x")=4, 
+         arg("cell_ov_y")=0, arg("cell_ov_x")=0, arg("block_y")=4, 
+         arg("block_x")=4, arg("block_ov_y")=0, arg("block_ov_x")=0),
+        "Constructs a new integral HOG extractor, for windows of size height x width."))
+    .def(init<bob::ip::IntegralHOG<double>&>((arg("self"), arg("other"))))
+    .def(self == self)
+    .def(self != self)
+    .add_property("height", &bob::ip::IntegralHOG<double>::getHeight,
+      &bob::ip::IntegralHOG<double>::setHeight,
+      "Height of the windows to process.")
+    .add_property("width", &bob::ip::IntegralHOG<double>::getWidth,
+      &bob::ip::IntegralHOG<double>::setWidth,
+      "Width of the windows to process.")
+    .add_property("image_height", &bob::ip::IntegralHOG<double>::getImageHeight,
+      "Height of the image given to compute_integral_histograms().")
+    .add_property("image_width", &bob::ip::IntegralHOG<double>::getImageWidth,
+      "Width of the image given to compute_integral_histograms().")
+    .add_property("magnitude_type", 
+      &bob::ip::IntegralHOG<double>::getGradientMagnitudeType, 
+      &bob::ip::IntegralHOG<double>::setGradientMagnitudeType,
+      "Type of the magnitude to consider for the descriptors.")
+    .add_property("cell_dim", &bob::ip::IntegralHOG<double>::getCellDim,
+      &bob::ip::IntegralHOG<double>::setCellDim,
+      "Dimensionality of a cell descriptor (i.e. the number of bins).")
+    .add_property("full_orientation", 
+      &bob::ip::IntegralHOG<double>::getFullOrientation,
+      &bob::ip::IntegralHOG<double>::setFullOrientation,
+      "Whether the range [0,360] is used or not ([0,180] otherwise).")
+    .add_property("cell_y", &bob::ip::IntegralHOG<double>::getCellHeight,
+      &bob::ip::IntegralHOG<double>::setCellHeight,
+      "Height of a cell.")
+    .add_property("cell_x", &bob::ip::IntegralHOG<double>::getCellWidth,
+      &bob::ip::IntegralHOG<double>::setCellWidth,
+      "Width of a cell.")
+    .add_property("cell_ov_y", &bob::ip::IntegralHOG<double>::getCellOverlapHeight,
+      &bob::ip::IntegralHOG<double>::setCellOverlapHeight,
+      "y-overlap between cells.")
+    .add_property("cell_ov_x", &bob::ip::IntegralHOG<double>::getCellOverlapWidth,
+      &bob::ip::IntegralHOG<double>::setCellOverlapWidth,
+      "x-overlap between cells.")
+    .add_property("block_y", &bob::ip::IntegralHOG<double>::getBlockHeight,
+      &bob::ip::IntegralHOG<double>::setBlockHeight,
+      "Height of a block (in terms of cells).")
+    .add_property("block_x", &bob::ip::IntegralHOG<double>::getBlockWidth,
+      &bob::ip::IntegralHOG<double>::setBlockWidth,
+      "Width of a block (in terms of cells).")
+    .add_property("block_ov_y", &bob::ip::IntegralHOG<double>::getBlockOverlapHeight,
+      &bob::ip::IntegralHOG<double>::setBlockOverlapHeight,
+      "y-overlap between blocks (in terms of cells).")
+    .add_property("block_ov_x", &bob::ip::IntegralHOG<double>::getBlockOverlapWidth,
+      &bob::ip::IntegralHOG<double>::setBlockOverlapWidth,
+      "x-overlap between blocks (in terms of cells).")
+    .add_property("block_norm", &bob::ip::IntegralHOG<double>::getBlockNorm, 
+      &bob::ip::IntegralHOG<double>::setBlockNorm,
+      "The type of norm used for normalizing blocks.")
+    .add_property("block_norm_eps", &bob::ip::IntegralHOG<double>::getBlockNormEps, 
+      &bob::ip::IntegralHOG<double>::setBlockNormEps,
+      "Epsilon value used to avoid division by zeros when normalizing the blocks.")
+    .add_property("block_norm_threshold", 
+      &bob::ip::IntegralHOG<double>::getBlockNormThreshold, 
+      &bob::ip::IntegralHOG<double>::setBlockNormThreshold,
+      "Threshold used to perform the clipping during the block normalization.")
+    .add_property("integral_histograms", make_function(&bob::ip::IntegralHOG<double>::getIntegralHistograms, return_value_policy<copy_const_reference>()),
+      "The integral histograms of the current image (one integral image per bin, along the last dimension).")
+    .def("resize", &bob::ip::IntegralHOG<double>::resize, 
+      (arg("self"), arg("height"), arg("width")),
+      "Resizes the windows to process.")
+    .def("disable_block_normalization", 
+      &bob::ip::IntegralHOG<double>::disableBlockNormalization)
+    .def("get_output_shape", &bob::ip::IntegralHOG<double>::getOutputShape)
+    .def("compute_integral_histograms", &integral_hog_compute, 
+      (arg("self"), arg("image")),
+      "Computes the gradients and the integral histograms of an image, which may be larger than the windows.")
+    .def("extract", &integral_hog_extract1, (arg("self"), arg("y"), arg("x")),
+      "Extracts the HOG descriptors of the window with top left corner (y,x) of the current image.")
+    .def("extract", &integral_hog_extract2, (arg("self"), arg("positions")),
+      "Extracts the HOG descriptors of several windows of the current image. positions is a 2D int64 array, each row giving the (y,x) coordinates of the top left corner of a window. The first dimension of the output is the index of the window.")
+    .def("__call__", &integral_hog_call, (arg("self"), arg("input")),
+      "Extract the HOG descriptors of an image of the size of a window. An image of another size raises a RuntimeError; use compute_integral_histograms() and extract() for larger images.")
+    .def("forward", &integral_hog_call, (arg("self"), arg("input")),
+      "Extract the HOG descriptors of an image of the size of a window. An image of another size raises a RuntimeError; use compute_integral_histograms() and extract() for larger images.")
+  ;
 }
@@ -64,6 +64,7 @@ void bind_ip_sift()
       .add_property("sigma0", &bob::ip::SIFT::getSigma0, &bob::ip::SIFT::setSigma0, "The value sigma0 of the standard deviation for the input image")
       .add_property("kernel_radius_factor", &bob::ip::SIFT::getKernelRadiusFactor, &bob::ip::SIFT::setKernelRadiusFactor, "Factor used to determine the kernel radii (size=2*radius+1). For each Gaussian kernel, the radius is equal to ceil(kernel_radius_factor*sigma_{octave,scale}).")
       .add_property("conv_border", &bob::ip::SIFT::getConvBorder, &bob::ip::SIFT::setConvBorder, "The way the extractor deals with convolution at the boundary of the image when computing the Gaussian scale space.")
+      .add_property("n_threads", &bob::ip::SIFT::getNThreads, &bob::ip::SIFT::setNThreads, "The number of threads used to compute the Gaussian scale space. The output does not depend on this setting.")
       .add_property("contrast_threshold", &bob::ip::SIFT::getContrastThreshold, &bob::ip::SIFT::setContrastThreshold, "The contrast threshold used during keypoint detection")
       .add_property("edge_threshold", &bob::ip::SIFT::getEdgeThreshold, &bob::ip::SIFT::setEdgeThreshold, "The edge threshold used during keypoint detection")
       .add_property("norm_threshold", &bob::ip::SIFT::getNormThreshold, &bob::ip::SIFT::setNormThreshold, "The norm threshold used during descriptor normalization")
@@ -252,20 +252,20 @@ void py_rgb_to_hsv (bob::python::const_ndarray from, bob::python::ndarray to)
   switch (from.type().dtype) {
     case bob::core::array::t_uint8:
       {
-        blitz::Array<uint8_t,3> to_ = to.bz<uint8_t,3>();
-        bob::ip::rgb_to_hsv(from.bz<uint8_t,3>(), to_);
+        blitz::Array<uint8_t,3> to_ = to.view<uint8_t,3>();
+        bob::ip::rgb_to_hsv(from.view<uint8_t,3>(), to_);
       }
       break;
     case bob::core::array::t_uint16:
       {
-        blitz::Array<uint16_t,3> to_ = to.bz<uint16_t,3>();
-        bob::ip::rgb_to_hsv(from.bz<uint16_t,3>(), to_);
+        blitz::Array<uint16_t,3> to_ = to.view<uint16_t,3>();
+        bob::ip::rgb_to_hsv(from.view<uint16_t,3>(), to_);
       }
       break;
     case bob::core::array::t_float64:
       {
-        blitz::Array<double,3> to_ = to.bz<double,3>();
-        bob::ip::rgb_to_hsv(from.bz<double,3>(), to_);
+        blitz::Array<double,3> to_ = to.view<double,3>();
+        bob::ip::rgb_to_hsv(from.view<double,3>(), to_);
       }
       break;
     default:
@@ -288,20 +288,20 @@ void py_hsv_to_rgb (bob::python::const_ndarray from, bob::python::ndarray to)
   switch (from.type().dtype) {
     case bob::core::array::t_uint8:
       {
-        blitz::Array<uint8_t,3> to_ = to.bz<uint8_t,3>();
-        bob::ip::hsv_to_rgb(from.bz<uint8_t,3>(), to_);
+        blitz::Array<uint8_t,3> to_ = to.view<uint8_t,3>();
+        bob::ip::hsv_to_rgb(from.view<uint8_t,3>(), to_);
       }
       break;
     case bob::core::array::t_uint16:
       {
-        blitz::Array<uint16_t,3> to_ = to.bz<uint16_t,3>();
-        bob::ip::hsv_to_rgb(from.bz<uint16_t,3>(), to_);
+        blitz::Array<uint16_t,3> to_ = to.view<uint16_t,3>();
+        bob::ip::hsv_to_rgb(from.view<uint16_t,3>(), to_);
       }
       break;
     case bob::core::array::t_float64:
       {
-        blitz::Array<double,3> to_ = to.bz<double,3>();
-        bob::ip::hsv_to_rgb(from.bz<double,3>(), to_);
+        blitz::Array<double,3> to_ = to.view<double,3>();
+        bob::ip::hsv_to_rgb(from.view<double,3>(), to_);
       }
       break;
     default:
@@ -324,20 +324,20 @@ void py_rgb_to_hsl (bob::python::const_ndarray from, bob::python::ndarray to)
   switch (from.type().dtype) {
     case bob::core::array::t_uint8:
       {
-        blitz::Array<uint8_t,3> to_ = to.bz<uint8_t,3>();
-        bob::ip::rgb_to_hsl(from.bz<uint8_t,3>(), to_);
+        blitz::Array<uint8_t,3> to_ = to.view<uint8_t,3>();
+        bob::ip::rgb_to_hsl(from.view<uint8_t,3>(), to_);
       }
       break;
     case bob::core::array::t_uint16:
       {
-        blitz::Array<uint16_t,3> to_ = to.bz<uint16_t,3>();
-        bob::ip::rgb_to_hsl(from.bz<uint16_t,3>(), to_);
+        blitz::Array<uint16_t,3> to_ = to.view<uint16_t,3>();
+        bob::ip::rgb_to_hsl(from.view<uint16_t,3>(), to_);
       }
       break;
     case bob::core::array::t_float64:
       {
-        blitz::Array<double,3> to_ = to.bz<double,3>();
-        bob::ip::rgb_to_hsl(from.bz<double,3>(), to_);
+        blitz::Array<double,3> to_ = to.view<double,3>();
+        bob::ip::rgb_to_hsl(from.view<double,3>(), to_);
       }
       break;
     default:
@@ -360,20 +360,20 @@ void py_hsl_to_rgb (bob::python::const_ndarray from, bob::python::ndarray to)
   switch (from.type().dtype) {
     case bob::core::array::t_uint8:
       {
-        blitz::Array<uint8_t,3> to_ = to.bz<uint8_t,3>();
-        bob::ip::hsl_to_rgb(from.bz<uint8_t,3>(), to_);
+        blitz::Array<uint8_t,3> to_ = to.view<uint8_t,3>();
+        bob::ip::hsl_to_rgb(from.view<uint8_t,3>(), to_);
       }
       break;
     case bob::core::array::t_uint16:
       {
-        blitz::Array<uint16_t,3> to_ = to.bz<uint16_t,3>();
-        bob::ip::hsl_to_rgb(from.bz<uint16_t,3>(), to_);
+        blitz::Array<uint16_t,3> to_ = to.view<uint16_t,3>();
+        bob::ip::hsl_to_rgb(from.view<uint16_t,3>(), to_);
       }
       break;
     case bob::core::array::t_float64:
       {
-        blitz::Array<double,3> to_ = to.bz<double,3>();
-        bob::ip::hsl_to_rgb(from.bz<double,3>(), to_);
+        blitz::Array<double,3> to_ = to.view<double,3>();
+        bob::ip::hsl_to_rgb(from.view<double,3>(), to_);
       }
       break;
     default:
@@ -396,20 +396,20 @@ void py_rgb_to_yuv (bob::python::const_ndarray from, bob::python::ndarray to)
   switch (from.type().dtype) {
     case bob::core::array::t_uint8:
       {
-        blitz::Array<uint8_t,3> to_ = to.bz<uint8_t,3>();
-        bob::ip::rgb_to_yuv(from.bz<uint8_t,3>(), to_);
+        blitz::Array<uint8_t,3> to_ = to.view<uint8_t,3>();
+        bob::ip::rgb_to_yuv(from.view<uint8_t,3>(), to_);
       }
       break;
     case bob::core::array::t_uint16:
       {
-        blitz::Array<uint16_t,3> to_ = to.bz<uint16_t,3>();
-        bob::ip::rgb_to_yuv(from.bz<uint16_t,3>(), to_);
+        blitz::Array<uint16_t,3> to_ = to.view<uint16_t,3>();
+        bob::ip::rgb_to_yuv(from.view<uint16_t,3>(), to_);
       }
       break;
     case bob::core::array::t_float64:
       {
-        blitz::Array<double,3> to_ = to.bz<double,3>();
-        bob::ip::rgb_to_yuv(from.bz<double,3>(), to_);
+        blitz::Array<double,3> to_ = to.view<double,3>();
+        bob::ip::rgb_to_yuv(from.view<double,3>(), to_);
       }
       break;
     default:
@@ -432,20 +432,20 @@ void py_yuv_to_rgb (bob::python::const_ndarray from, bob::python::ndarray to)
   switch (from.type().dtype) {
     case bob::core::array::t_uint8:
       {
-        blitz::Array<uint8_t,3> to_ = to.bz<uint8_t,3>();
-        bob::ip::yuv_to_rgb(from.bz<uint8_t,3>(), to_);
+        blitz::Array<uint8_t,3> to_ = to.view<uint8_t,3>();
+        bob::ip::yuv_to_rgb(from.view<uint8_t,3>(), to_);
       }
       break;
     case bob::core::array::t_uint16:
       {
-        blitz::Array<uint16_t,3> to_ = to.bz<uint16_t,3>();
-        bob::ip::yuv_to_rgb(from.bz<uint16_t,3>(), to_);
+        blitz::Array<uint16_t,3> to_ = to.view<uint16_t,3>();
+        bob::ip::yuv_to_rgb(from.view<uint16_t,3>(), to_);
       }
       break;
     case bob::core::array::t_float64:
       {
-        blitz::Array<double,3> to_ = to.bz<double,3>();
-        bob::ip::yuv_to_rgb(from.bz<double,3>(), to_);
+        blitz::Array<double,3> to_ = to.view<double,3>();
+        bob::ip::yuv_to_rgb(from.view<double,3>(), to_);
       }
       break;
     default:
@@ -468,20 +468,20 @@ void py_rgb_to_gray (bob::python::const_ndarray from, bob::python::ndarray to)
   switch (from.type().dtype) {
     case bob::core::array::t_uint8:
       {
-        blitz::Array<uint8_t,2> to_ = to.bz<uint8_t,2>();
-        bob::ip::rgb_to_gray(from.bz<uint8_t,3>(), to_);
+        blitz::Array<uint8_t,2> to_ = to.view<uint8_t,2>();
+        bob::ip::rgb_to_gray(from.view<uint8_t,3>(), to_);
       }
       break;
     case bob::core::array::t_uint16:
       {
-        blitz::Array<uint16_t,2> to_ = to.bz<uint16_t,2>();
-        bob::ip::rgb_to_gray(from.bz<uint16_t,3>(), to_);
+        blitz::Array<uint16_t,2> to_ = to.view<uint16_t,2>();
+        bob::ip::rgb_to_gray(from.view<uint16_t,3>(), to_);
       }
       break;
     case bob::core::array::t_float64:
       {
-        blitz::Array<double,2> to_ = to.bz<double,2>();
-        bob::ip::rgb_to_gray(from.bz<double,3>(), to_);
+        blitz::Array<double,2> to_ = to.view<double,2>();
+        bob::ip::rgb_to_gray(from.view<double,3>(), to_);
       }
       break;
     default:
@@ -510,20 +510,20 @@ void py_gray_to_rgb (bob::python::const_ndarray from, bob::python::ndarray to)
   switch (from.type().dtype) {
     case bob::core::array::t_uint8:
       {
-        blitz::Array<uint8_t,3> to_ = to.bz<uint8_t,3>();
-        bob::ip::gray_to_rgb(from.bz<uint8_t,2>(), to_);
+        blitz::Array<uint8_t,3> to_ = to.view<uint8_t,3>();
+        bob::ip::gray_to_rgb(from.view<uint8_t,2>(), to_);
       }
       break;
     case bob::core::array::t_uint16:
       {
-        blitz::Array<uint16_t,3> to_ = to.bz<uint16_t,3>();
-        bob::ip::gray_to_rgb(from.bz<uint16_t,2>(), to_);
+        blitz::Array<uint16_t,3> to_ = to.view<uint16_t,3>();
+        bob::ip::gray_to_rgb(from.view<uint16_t,2>(), to_);
       }
       break;
     case bob::core::array::t_float64:
       {
-        blitz::Array<double,3> to_ = to.bz<double,3>();
-        bob::ip::gray_to_rgb(from.bz<double,2>(), to_);
+        blitz::Array<double,3> to_ = to.view<double,3>();
+        bob::ip::gray_to_rgb(from.view<double,2>(), to_);
       }
       break;
     default:
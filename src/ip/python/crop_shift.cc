@@ -19,8 +19,8 @@ static void inner_crop1(bob::python::const_ndarray src,
   bob::python::ndarray dst, const int y, const int x, const size_t h, 
   const size_t w, const bool allow_out, const bool zero_out) 
 {
-  blitz::Array<T,N> dst_ = dst.bz<T,N>();
-  bob::ip::crop<T>(src.bz<T,N>(), dst_, y, x, h, w, allow_out, zero_out);
+  blitz::Array<T,N> dst_ = dst.view<T,N>();
+  bob::ip::crop<T>(src.view<T,N>(), dst_, y, x, h, w, allow_out, zero_out);
 }
 
 template <int N>
@@ -94,9 +94,9 @@ static void inner_crop2(bob::python::const_ndarray src,
   bob::python::ndarray dmask, const int y, const int x, const size_t h, 
   const size_t w, const bool allow_out, const bool zero_out) 
 {
-  blitz::Array<T,N> dst_ = dst.bz<T,N>();
-  blitz::Array<bool,N> dmask_ = dmask.bz<bool,N>();
-  bob::ip::crop<T>(src.bz<T,N>(), smask.bz<bool,N>(), dst_, dmask_, y, x, h, 
+  blitz::Array<T,N> dst_ = dst.view<T,N>();
+  blitz::Array<bool,N> dmask_ = dmask.view<bool,N>();
+  bob::ip::crop<T>(src.view<T,N>(), smask.view<bool,N>(), dst_, dmask_, y, x, h, 
                    w, allow_out, zero_out);
 }
 
@@ -150,8 +150,8 @@ static void inner_shift1(bob::python::const_ndarray src,
   bob::python::ndarray dst, const int y, const int x, const bool allow_out, 
   const bool zero_out) 
 {
-  blitz::Array<T,N> dst_ = dst.bz<T,N>();
-  bob::ip::shift<T>(src.bz<T,N>(), dst_, y, x, allow_out, zero_out);
+  blitz::Array<T,N> dst_ = dst.view<T,N>();
+  bob::ip::shift<T>(src.view<T,N>(), dst_, y, x, allow_out, zero_out);
 }
 
 template <int N>
@@ -222,9 +222,9 @@ static void inner_shift2(bob::python::const_ndarray src,
   bob::python::ndarray dmask, const int y, const int x, const bool allow_out,
   const bool zero_out)
 {
-  blitz::Array<T,N> dst_ = dst.bz<T,N>();
-  blitz::Array<bool,N> dmask_ = dmask.bz<bool,N>();
-  bob::ip::shift<T>(src.bz<T,N>(), smask.bz<bool,N>(), dst_, dmask_, y, x, 
+  blitz::Array<T,N> dst_ = dst.view<T,N>();
+  blitz::Array<bool,N> dmask_ = dmask.view<bool,N>();
+  bob::ip::shift<T>(src.view<T,N>(), smask.view<bool,N>(), dst_, dmask_, y, x, 
     allow_out, zero_out);
 }
 
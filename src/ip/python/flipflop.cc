@@ -17,8 +17,8 @@ template <typename T, int N>
 static void inner_flip(bob::python::const_ndarray src, 
   bob::python::ndarray dst) 
 {
-  blitz::Array<T,N> dst_ = dst.bz<T,N>();
-  bob::ip::flip<T>(src.bz<T,N>(), dst_);
+  blitz::Array<T,N> dst_ = dst.view<T,N>();
+  bob::ip::flip<T>(src.view<T,N>(), dst_);
 }
 
 template <int N>
@@ -83,8 +83,8 @@ template <typename T, int N>
 static void inner_flop(bob::python::const_ndarray src, 
   bob::python::ndarray dst) 
 {
-  blitz::Array<T,N> dst_ = dst.bz<T,N>();
-  bob::ip::flop<T>(src.bz<T,N>(), dst_);
+  blitz::Array<T,N> dst_ = dst.view<T,N>();
+  bob::ip::flop<T>(src.view<T,N>(), dst_);
 }
 
 template <int N>
@@ -18,8 +18,8 @@ template <typename T, int N>
 static void inner_gammaCorrection_c(bob::python::const_ndarray src, 
   bob::python::ndarray dst, const double g) 
 {
-  blitz::Array<double,N> dst_ = dst.bz<double,N>();
-  bob::ip::gammaCorrection<T>(src.bz<T,N>(), dst_, g);
+  blitz::Array<double,N> dst_ = dst.view<double,N>();
+  bob::ip::gammaCorrection<T>(src.view<T,N>(), dst_, g);
 }
 
 static void py_gamma_correction_c(bob::python::const_ndarray src,
@@ -48,8 +48,8 @@ static object inner_gammaCorrection_p(bob::python::const_ndarray src,
   const bob::core::array::typeinfo& info = src.type();
   bob::python::ndarray dst(bob::core::array::t_float64, info.shape[0],
     info.shape[1]);
-  blitz::Array<double,N> dst_ = dst.bz<double,N>();
-  bob::ip::gammaCorrection<T>(src.bz<T,N>(), dst_, g);
+  blitz::Array<double,N> dst_ = dst.view<double,N>();
+  bob::ip::gammaCorrection<T>(src.view<T,N>(), dst_, g);
   return dst.self();
 }
 
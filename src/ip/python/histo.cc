@@ -17,8 +17,8 @@ template <typename T>
 static object inner_histo1 (bob::python::const_ndarray input) {
   int size = bob::ip::detail::getHistoSize<T>();
   bob::python::ndarray out(bob::core::array::t_uint64, size);
-  blitz::Array<uint64_t,1> out_ = out.bz<uint64_t,1>();
-  bob::ip::histogram(input.bz<T,2>(), out_, false);
+  blitz::Array<uint64_t,1> out_ = out.view<uint64_t,1>();
+  bob::ip::histogram(input.view<T,2>(), out_, false);
   return out.self();
 }
 
@@ -35,8 +35,8 @@ static object histo1 (bob::python::const_ndarray input) {
 template <typename T>
 static void inner_histo2 (bob::python::const_ndarray input, bob::python::ndarray output,
     bool accumulate) {
-  blitz::Array<uint64_t,1> out_ = output.bz<uint64_t,1>();
-  bob::ip::histogram(input.bz<T,2>(), out_, accumulate);
+  blitz::Array<uint64_t,1> out_ = output.view<uint64_t,1>();
+  bob::ip::histogram(input.view<T,2>(), out_, accumulate);
 }
 
 static void histo2 (bob::python::const_ndarray input, bob::python::ndarray output,
@@ -55,9 +55,9 @@ BOOST_PYTHON_FUNCTION_OVERLOADS(histo2_overloads, histo2, 2, 3)
 template <typename T>
 static void inner_histo3 (bob::python::const_ndarray input, bob::python::ndarray output,
     object max, bool accumulate) {
-  blitz::Array<uint64_t,1> out_ = output.bz<uint64_t,1>();
+  blitz::Array<uint64_t,1> out_ = output.view<uint64_t,1>();
   T tmax = extract<T>(max);
-  bob::ip::histogram(input.bz<T,2>(), out_, (T)0, tmax, (uint32_t)(tmax+1), accumulate);
+  bob::ip::histogram(input.view<T,2>(), out_, (T)0, tmax, (uint32_t)(tmax+1), accumulate);
 }
 
 static void histo3 (bob::python::const_ndarray input, bob::python::ndarray output, object max,
@@ -94,10 +94,10 @@ BOOST_PYTHON_FUNCTION_OVERLOADS(histo3_overloads, histo3, 3, 4)
 template <typename T>
 static void inner_histo4 (bob::python::const_ndarray input, bob::python::ndarray output,
     object min, object max, bool accumulate) {
-  blitz::Array<uint64_t,1> out_ = output.bz<uint64_t,1>();
+  blitz::Array<uint64_t,1> out_ = output.view<uint64_t,1>();
   T tmin = extract<T>(min);
   T tmax = extract<T>(max);
-  bob::ip::histogram(input.bz<T,2>(), out_, tmin, tmax, (uint32_t)(tmax-tmin+1), accumulate);
+  bob::ip::histogram(input.view<T,2>(), out_, tmin, tmax, (uint32_t)(tmax-tmin+1), accumulate);
 }
 
 static void histo4 (bob::python::const_ndarray input, bob::python::ndarray output,
@@ -134,10 +134,10 @@ BOOST_PYTHON_FUNCTION_OVERLOADS(histo4_overloads, histo4, 4, 5)
 template <typename T>
 static void inner_histo5 (bob::python::const_ndarray input, bob::python::ndarray output,
     object min, object max, uint32_t nbins, bool accumulate) {
-  blitz::Array<uint64_t,1> out_ = output.bz<uint64_t,1>();
+  blitz::Array<uint64_t,1> out_ = output.view<uint64_t,1>();
   T tmin = extract<T>(min);
   T tmax = extract<T>(max);
-  bob::ip::histogram(input.bz<T,2>(), out_, tmin, tmax, nbins, accumulate);
+  bob::ip::histogram(input.view<T,2>(), out_, tmin, tmax, nbins, accumulate);
 }
 
 static void histo5 (bob::python::const_ndarray input, bob::python::ndarray output,
@@ -176,8 +176,8 @@ static object inner_histo3a (bob::python::const_ndarray input, object max) {
   T tmax = extract<T>(max);
   uint32_t size = (uint32_t)(tmax + 1);
   bob::python::ndarray out(bob::core::array::t_uint64, size);
-  blitz::Array<uint64_t,1> out_ = out.bz<uint64_t,1>();
-  bob::ip::histogram(input.bz<T,2>(), out_, (T)0, tmax, size, false);
+  blitz::Array<uint64_t,1> out_ = out.view<uint64_t,1>();
+  bob::ip::histogram(input.view<T,2>(), out_, (T)0, tmax, size, false);
   return out.self();
 }
 
@@ -205,8 +205,8 @@ static object inner_histo4a (bob::python::const_ndarray input, object min, objec
   T tmax = extract<T>(max);
   int64_t size = (int64_t)(tmax - tmin + 1);
   bob::python::ndarray out(bob::core::array::t_uint64, size);
-  blitz::Array<uint64_t,1> out_ = out.bz<uint64_t,1>();
-  bob::ip::histogram(input.bz<T,2>(), out_, tmin, tmax, size, false);
+  blitz::Array<uint64_t,1> out_ = out.view<uint64_t,1>();
+  bob::ip::histogram(input.view<T,2>(), out_, tmin, tmax, size, false);
   return out.self();
 }
 
@@ -244,8 +244,8 @@ static object inner_histo5a (bob::python::const_ndarray input, object min, objec
   T tmin = extract<T>(min);
   T tmax = extract<T>(max);
   bob::python::ndarray out(bob::core::array::t_uint64, nbins);
-  blitz::Array<uint64_t,1> out_ = out.bz<uint64_t,1>();
-  bob::ip::histogram(input.bz<T,2>(), out_, tmin, tmax, nbins, false);
+  blitz::Array<uint64_t,1> out_ = out.view<uint64_t,1>();
+  bob::ip::histogram(input.view<T,2>(), out_, tmin, tmax, nbins, false);
   return out.self();
 }
 
@@ -280,8 +280,8 @@ static object histo5a (bob::python::const_ndarray input,
 
 template <typename T1, typename T2>
 static void inner_histogram_equalization2(bob::python::const_ndarray src, bob::python::ndarray dst){
-  const blitz::Array<T1,2> src_array = src.bz<T1,2>();
-  blitz::Array<T2,2> dst_array = dst.bz<T2,2>();
+  const blitz::Array<T1,2> src_array = src.view<T1,2>();
+  blitz::Array<T2,2> dst_array = dst.view<T2,2>();
   bob::ip::histogram_equalize<T1,T2>(src_array, dst_array);
 }
 
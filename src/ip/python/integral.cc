@@ -15,8 +15,8 @@ using namespace boost::python;
 
 template <typename T, typename U, int N>
 static void inner_integral (bob::python::const_ndarray src, bob::python::ndarray dst, bool b) {
-  blitz::Array<U,N> dst_ = dst.bz<U,N>();
-  bob::ip::integral(src.bz<T,N>(), dst_, b);
+  blitz::Array<U,N> dst_ = dst.view<U,N>();
+  bob::ip::integral(src.view<T,N>(), dst_, b);
 }
 
 template <typename T, int N>
@@ -56,8 +56,8 @@ static void integral (bob::python::const_ndarray src, bob::python::ndarray dst,
 
 template <typename T, typename U, int N>
 static void inner_integral_square (bob::python::const_ndarray src, bob::python::ndarray dst, bob::python::ndarray sqr, bool b) {
-  blitz::Array<U,N> dst_ = dst.bz<U,N>();
-  bob::ip::integral(src.bz<T,N>(), dst_, b);
+  blitz::Array<U,N> dst_ = dst.view<U,N>();
+  bob::ip::integral(src.view<T,N>(), dst_, b);
 }
 
 template <typename T, int N>
@@ -25,13 +25,13 @@ static boost::python::tuple get_rotated_output_shape(
   switch(input.type().dtype)
   {
     case bob::core::array::t_uint8:
-      size = bob::ip::getRotatedShape<uint8_t>(input.bz<uint8_t,2>(), angle);
+      size = bob::ip::getRotatedShape<uint8_t>(input.view<uint8_t,2>(), angle);
       break;
     case bob::core::array::t_uint16:
-      size = bob::ip::getRotatedShape<uint16_t>(input.bz<uint16_t,2>(), angle);
+      size = bob::ip::getRotatedShape<uint16_t>(input.view<uint16_t,2>(), angle);
       break;
     case bob::core::array::t_float64:
-      size = bob::ip::getRotatedShape<double>(input.bz<double,2>(), angle);
+      size = bob::ip::getRotatedShape<double>(input.view<double,2>(), angle);
       break;
     default:
       PYTHON_ERROR(TypeError, "bob.ip.get_rotated_output_shape() does not support array of type '%s'.", input.type().str().c_str());
@@ -49,14 +49,14 @@ static void inner_rotate(bob::python::const_ndarray input,
   {
     case 2:
       {
-        blitz::Array<double,2> output_ = output.bz<double,2>();
-        bob::ip::rotate(input.bz<T,2>(), output_, angle, rotation_algorithm);
+        blitz::Array<double,2> output_ = output.view<double,2>();
+        bob::ip::rotate(input.view<T,2>(), output_, angle, rotation_algorithm);
         break;
       }
     case 3:
       {
-        blitz::Array<double,3> output_ = output.bz<double,3>();
-        bob::ip::rotate(input.bz<T,3>(), output_, angle, rotation_algorithm);
+        blitz::Array<double,3> output_ = output.view<double,3>();
+        bob::ip::rotate(input.view<T,3>(), output_, angle, rotation_algorithm);
         break;
       }
     default:
@@ -97,18 +97,18 @@ static boost::python::object inner_rotate_p(bob::python::const_ndarray input,
   {
     case 2:
       {
-        const blitz::TinyVector<int,2> shape = bob::ip::getRotatedShape<T>(input.bz<T,2>(), angle);
+        const blitz::TinyVector<int,2> shape = bob::ip::getRotatedShape<T>(input.view<T,2>(), angle);
         bob::python::ndarray output(bob::core::array::t_float64, shape(0), shape(1));
-        blitz::Array<double,2> output_ = output.bz<double,2>();
-        bob::ip::rotate(input.bz<T,2>(), output_, angle, rotation_algorithm);
+        blitz::Array<double,2> output_ = output.view<double,2>();
+        bob::ip::rotate(input.view<T,2>(), output_, angle, rotation_algorithm);
         return output.self();
       }
     case 3:
       {
-        const blitz::TinyVector<int,3> shape = bob::ip::getRotatedShape<T>(input.bz<T,3>(), angle);
+        const blitz::TinyVector<int,3> shape = bob::ip::getRotatedShape<T>(input.view<T,3>(), angle);
         bob::python::ndarray output(bob::core::array::t_float64, shape(0), shape(1), shape(2));
-        blitz::Array<double,3> output_ = output.bz<double,3>();
-        bob::ip::rotate(input.bz<T,3>(), output_, angle, rotation_algorithm);
+        blitz::Array<double,3> output_ = output.view<double,3>();
+        bob::ip::rotate(input.view<T,3>(), output_, angle, rotation_algorithm);
         return output.self();
       }
     default:
@@ -147,14 +147,14 @@ static void inner_rotate_with_mask(bob::python::const_ndarray input,
   {
     case 2:
       {
-        blitz::Array<double,2> output_ = output.bz<double,2>();
-        bob::ip::rotate(input.bz<T,2>(), output_, angle, rotation_algorithm);
+        blitz::Array<double,2> output_ = output.view<double,2>();
+        bob::ip::rotate(input.view<T,2>(), output_, angle, rotation_algorithm);
         break;
       }
     case 3:
       {
-        blitz::Array<double,3> output_ = output.bz<double,3>();
-        bob::ip::rotate(input.bz<T,3>(), output_, angle, rotation_algorithm);
+        blitz::Array<double,3> output_ = output.view<double,3>();
+        bob::ip::rotate(input.view<T,3>(), output_, angle, rotation_algorithm);
         break;
       }
     default:
@@ -172,8 +172,8 @@ static void rotate_with_mask(bob::python::const_ndarray input,
   if (!angle_in_degrees)
     angle *= 180./M_PI;
 
-  const blitz::Array<bool,2> i_mask = input_mask.bz<bool,2>();
-  blitz::Array<bool,2> o_mask = output_mask.bz<bool,2>();
+  const blitz::Array<bool,2> i_mask = input_mask.view<bool,2>();
+  blitz::Array<bool,2> o_mask = output_mask.view<bool,2>();
 
   switch (input.type().dtype)
   {
@@ -25,11 +25,11 @@ static tuple get_scaled_output_shape(
       switch(info.dtype) 
       {
         case bob::core::array::t_uint8: 
-          return tuple(bob::ip::getScaledShape(src.bz<uint8_t,2>(), scale_factor));
+          return tuple(bob::ip::getScaledShape(src.view<uint8_t,2>(), scale_factor));
         case bob::core::array::t_uint16:
-          return tuple(bob::ip::getScaledShape(src.bz<uint16_t,2>(), scale_factor));
+          return tuple(bob::ip::getScaledShape(src.view<uint16_t,2>(), scale_factor));
         case bob::core::array::t_float64:
-          return tuple(bob::ip::getScaledShape(src.bz<double,2>(), scale_factor));
+          return tuple(bob::ip::getScaledShape(src.view<double,2>(), scale_factor));
         default:
           PYTHON_ERROR(TypeError, "bob.ip.get_scaled_output_shape() does not support array with type '%s'.", info.str().c_str());
       }
@@ -39,11 +39,11 @@ static tuple get_scaled_output_shape(
       switch(info.dtype) 
       {
         case bob::core::array::t_uint8: 
-          return tuple(bob::ip::getScaledShape(src.bz<uint8_t,3>(), scale_factor));
+          return tuple(bob::ip::getScaledShape(src.view<uint8_t,3>(), scale_factor));
         case bob::core::array::t_uint16:
-          return tuple(bob::ip::getScaledShape(src.bz<uint16_t,3>(), scale_factor));
+          return tuple(bob::ip::getScaledShape(src.view<uint16_t,3>(), scale_factor));
         case bob::core::array::t_float64:
-          return tuple(bob::ip::getScaledShape(src.bz<double,3>(), scale_factor));
+          return tuple(bob::ip::getScaledShape(src.view<double,3>(), scale_factor));
         default:
           PYTHON_ERROR(TypeError, "bob.ip.get_scaled_output_shape() does not support array with type '%s'.", info.str().c_str());
       }
@@ -57,8 +57,8 @@ template <typename T, int N>
 static void inner_scale(bob::python::const_ndarray src, 
   bob::python::ndarray dst, bob::ip::Rescale::Algorithm algo)
 {
-  blitz::Array<double,N> dst_ = dst.bz<double,N>();
-  bob::ip::scale(src.bz<T,N>(), dst_, algo);
+  blitz::Array<double,N> dst_ = dst.view<double,N>();
+  bob::ip::scale(src.view<T,N>(), dst_, algo);
 }
 
 static void scale(bob::python::const_ndarray src, bob::python::ndarray dst,
@@ -106,10 +106,10 @@ template <typename T>
 static bob::python::ndarray inner_scale_factor_2d(bob::python::const_ndarray src, 
   const double scale_factor, bob::ip::Rescale::Algorithm algo)
 {
-  const blitz::TinyVector<int,2> shape = bob::ip::getScaledShape(src.bz<T,2>(), scale_factor);
+  const blitz::TinyVector<int,2> shape = bob::ip::getScaledShape(src.view<T,2>(), scale_factor);
   bob::python::ndarray dst(bob::core::array::t_float64, shape(0), shape(1));
-  blitz::Array<double,2> dst_ = dst.bz<double,2>();
-  bob::ip::scale(src.bz<T,2>(), dst_, algo);
+  blitz::Array<double,2> dst_ = dst.view<double,2>();
+  bob::ip::scale(src.view<T,2>(), dst_, algo);
   return dst.self();
 }
 
@@ -117,10 +117,10 @@ template <typename T>
 static bob::python::ndarray inner_scale_factor_3d(bob::python::const_ndarray src, 
   const double scale_factor, bob::ip::Rescale::Algorithm algo)
 {
-  const blitz::TinyVector<int,3> shape = bob::ip::getScaledShape(src.bz<T,3>(), scale_factor);
+  const blitz::TinyVector<int,3> shape = bob::ip::getScaledShape(src.view<T,3>(), scale_factor);
   bob::python::ndarray dst(bob::core::array::t_float64, shape(0), shape(1), shape(2));
-  blitz::Array<double,3> dst_ = dst.bz<double,3>();
-  bob::ip::scale(src.bz<T,3>(), dst_, algo);
+  blitz::Array<double,3> dst_ = dst.view<double,3>();
+  bob::ip::scale(src.view<T,3>(), dst_, algo);
   return dst.self();
 }
 
@@ -171,9 +171,9 @@ static void inner_scale_mask(bob::python::const_ndarray src,
   bob::python::ndarray dst, bob::python::ndarray dmask, 
   bob::ip::Rescale::Algorithm algo) 
 {
-  blitz::Array<double,N> dst_ = dst.bz<double,N>();
-  blitz::Array<bool,N> dmask_ = dmask.bz<bool,N>();
-  bob::ip::scale(src.bz<T,N>(), smask.bz<bool,N>(), dst_, dmask_, algo);
+  blitz::Array<double,N> dst_ = dst.view<double,N>();
+  blitz::Array<bool,N> dmask_ = dmask.view<bool,N>();
+  bob::ip::scale(src.view<T,N>(), smask.view<bool,N>(), dst_, dmask_, algo);
 }
 
 static void scale_mask(bob::python::const_ndarray src, 
@@ -16,7 +16,7 @@ using namespace boost::python;
 template <typename T, int N>
 static object inner_shear_x_shape(bob::python::const_ndarray src, double s) 
 {
-  return object(bob::ip::getShearXShape<T>(src.bz<T,N>(), s));
+  return object(bob::ip::getShearXShape<T>(src.view<T,N>(), s));
 }
 
 static object shear_x_shape(bob::python::const_ndarray src, double s) 
@@ -35,7 +35,7 @@ static object shear_x_shape(bob::python::const_ndarray src, double s)
 template <typename T, int N>
 static object inner_shear_y_shape (bob::python::const_ndarray src, double s) 
 {
-  return object(bob::ip::getShearYShape<T>(src.bz<T,N>(), s));
+  return object(bob::ip::getShearYShape<T>(src.view<T,N>(), s));
 }
 
 static object shear_y_shape (bob::python::const_ndarray src, double s) 
@@ -55,8 +55,8 @@ template <typename T, int N>
 static void inner_shear_x(bob::python::const_ndarray src, 
   bob::python::ndarray dst, double a, bool aa) 
 {
-  blitz::Array<double,N> dst_ = dst.bz<double,N>();
-  bob::ip::shearX<T>(src.bz<T,N>(), dst_, a, aa);
+  blitz::Array<double,N> dst_ = dst.view<double,N>();
+  bob::ip::shearX<T>(src.view<T,N>(), dst_, a, aa);
 }
 
 static void shear_x(bob::python::const_ndarray src, 
@@ -79,10 +79,10 @@ template <typename T, int N>
 static object inner_shear_x_p(bob::python::const_ndarray src, double a, 
   bool aa)
 {
-  const blitz::TinyVector<int,2> shape = bob::ip::getShearXShape<T>(src.bz<T,2>(), a);
+  const blitz::TinyVector<int,2> shape = bob::ip::getShearXShape<T>(src.view<T,2>(), a);
   bob::python::ndarray dst(bob::core::array::t_float64, shape(0), shape(1));
-  blitz::Array<double,N> dst_ = dst.bz<double,N>();
-  bob::ip::shearX<T>(src.bz<T,N>(), dst_, a, aa);
+  blitz::Array<double,N> dst_ = dst.view<double,N>();
+  bob::ip::shearX<T>(src.view<T,N>(), dst_, a, aa);
   return dst.self();
 }
 
@@ -107,8 +107,8 @@ template <typename T, int N>
 static void inner_shear_y(bob::python::const_ndarray src, 
   bob::python::ndarray dst, double a, bool aa) 
 {
-  blitz::Array<double,N> dst_ = dst.bz<double,N>();
-  bob::ip::shearY<T>(src.bz<T,N>(), dst_, a, aa);
+  blitz::Array<double,N> dst_ = dst.view<double,N>();
+  bob::ip::shearY<T>(src.view<T,N>(), dst_, a, aa);
 }
 
 static void shear_y(bob::python::const_ndarray src, 
@@ -131,10 +131,10 @@ template <typename T, int N>
 static object inner_shear_y_p(bob::python::const_ndarray src, double a, 
   bool aa)
 {
-  const blitz::TinyVector<int,2> shape = bob::ip::getShearYShape<T>(src.bz<T,2>(), a);
+  const blitz::TinyVector<int,2> shape = bob::ip::getShearYShape<T>(src.view<T,2>(), a);
   bob::python::ndarray dst(bob::core::array::t_float64, shape(0), shape(1));
-  blitz::Array<double,N> dst_ = dst.bz<double,N>();
-  bob::ip::shearY<T>(src.bz<T,N>(), dst_, a, aa);
+  blitz::Array<double,N> dst_ = dst.view<double,N>();
+  bob::ip::shearY<T>(src.view<T,N>(), dst_, a, aa);
   return dst.self();
 }
 
@@ -159,9 +159,9 @@ static void inner_shear_x2 (bob::python::const_ndarray src,
   bob::python::const_ndarray smask, bob::python::ndarray dst,
   bob::python::ndarray dmask, double a, bool aa) 
 {
-  blitz::Array<double,N> dst_ = dst.bz<double,N>();
-  blitz::Array<bool,N> dmask_ = dmask.bz<bool,N>();
-  bob::ip::shearX<T>(src.bz<T,N>(), src.bz<bool,N>(), dst_, dmask_, a, aa);
+  blitz::Array<double,N> dst_ = dst.view<double,N>();
+  blitz::Array<bool,N> dmask_ = dmask.view<bool,N>();
+  bob::ip::shearX<T>(src.view<T,N>(), src.view<bool,N>(), dst_, dmask_, a, aa);
 }
 
 static void shear_x2(bob::python::const_ndarray src, 
@@ -189,9 +189,9 @@ static void inner_shear_y2(bob::python::const_ndarray src,
   bob::python::const_ndarray smask, bob::python::ndarray dst, 
   bob::python::ndarray dmask, double a, bool aa) 
 {
-  blitz::Array<double,N> dst_ = dst.bz<double,N>();
-  blitz::Array<bool,N> dmask_ = dmask.bz<bool,N>();
-  bob::ip::shearY<T>(src.bz<T,N>(), src.bz<bool,N>(), dst_, dmask_, a, aa);
+  blitz::Array<double,N> dst_ = dst.view<double,N>();
+  blitz::Array<bool,N> dmask_ = dmask.view<bool,N>();
+  bob::ip::shearY<T>(src.view<T,N>(), src.view<bool,N>(), dst_, dmask_, a, aa);
 }
 
 static void shear_y2(bob::python::const_ndarray src, 
@@ -17,7 +17,7 @@ template <typename T>
 static void inner_zigzag(bob::python::const_ndarray src, 
   blitz::Array<T,1>& dst, const bool rf) 
 {
-  bob::ip::zigzag(src.bz<T,2>(), dst, rf);
+  bob::ip::zigzag(src.view<T,2>(), dst, rf);
 }
 
 static object py_zigzag(bob::python::const_ndarray src, 
@@ -38,21 +38,21 @@ static object py_zigzag(bob::python::const_ndarray src,
       case bob::core::array::t_uint8:
         {
           bob::python::ndarray dst(bob::core::array::t_uint8, n_coef);
-          blitz::Array<uint8_t,1> dst_ = dst.bz<uint8_t,1>();
+          blitz::Array<uint8_t,1> dst_ = dst.view<uint8_t,1>();
           inner_zigzag<uint8_t>(src, dst_, rf);
           return dst.self();
         }
       case bob::core::array::t_uint16:
         {
           bob::python::ndarray dst(bob::core::array::t_uint16, n_coef);
-          blitz::Array<uint16_t,1> dst_ = dst.bz<uint16_t,1>();
+          blitz::Array<uint16_t,1> dst_ = dst.view<uint16_t,1>();
           inner_zigzag<uint16_t>(src, dst_, rf);
           return dst.self();
         }
       case bob::core::array::t_float64:
         {
           bob::python::ndarray dst(bob::core::array::t_float64, n_coef);
-          blitz::Array<double,1> dst_ = dst.bz<double,1>();
+          blitz::Array<double,1> dst_ = dst.view<double,1>();
           inner_zigzag<double>(src, dst_, rf);
           return dst.self();
         }
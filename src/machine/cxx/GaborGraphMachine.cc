@@ -9,7 +9,13 @@
  */
 
 #include <bob/machine/GaborGraphMachine.h>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
 #include <complex>
+#include <vector>
+#include <stdint.h>
 
 /**
  * Generates Gabor graph machine that generates grid graphs which will be placed according to the given eye positions
@@ -28,6 +34,7 @@ bob::machine::GaborGraphMachine::GaborGraphMachine(
   int above,
   int below
 )
+: m_n_threads(1)
 {
   // shortcuts for eye positions
   int lex = lefteye[1], ley = lefteye[0];
@@ -65,6 +72,7 @@ bob::machine::GaborGraphMachine::GaborGraphMachine(
   blitz::TinyVector<int,2> last,
   blitz::TinyVector<int,2> step
 )
+: m_n_threads(1)
 {
   int ycount = (last[0] - first[0]) / step[0] + 1;
   int xcount = (last[1] - first[1]) / step[1] + 1;
@@ -89,6 +97,7 @@ bob::machine::GaborGraphMachine::GaborGraphMachine(
 bob::machine::GaborGraphMachine::GaborGraphMachine(
   const GaborGraphMachine& other
 )
+: m_n_threads(other.m_n_threads)
 {
   m_node_positions.resize(other.m_node_positions.shape());
   m_node_positions = other.m_node_positions;
@@ -107,6 +116,7 @@ bob::machine::GaborGraphMachine& bob::machine::GaborGraphMachine::operator =(
 {
   m_node_positions.resize(other.m_node_positions.shape());
   m_node_positions = other.m_node_positions;
+  m_n_threads = other.m_n_threads;
   return *this;
 }
 
@@ -124,11 +134,22 @@ bool bob::machine::GaborGraphMachine::operator ==(
 }
 
 
-void bob::machine::GaborGraphMachine::checkPositions(int height, int width) const throw(){
+/**
+ * Sets the number of threads used to compute the similarities of a probe graph to a gallery
+ * @param n_threads  The number of threads, which should be strictly positive
+ */
+void bob::machine::GaborGraphMachine::setNThreads(size_t n_threads){
+  if (n_threads == 0)
+    throw std::runtime_error("the number of threads should be strictly positive");
+  m_n_threads = n_threads;
+}
+
+
+void bob::machine::GaborGraphMachine::checkPositions(int height, int width) const{
   for (int i = m_node_positions.extent(0); i--;){
     if (m_node_positions(i,0) < 0 || m_node_positions(i,0) >= height ||
         m_node_positions(i,1) < 0 || m_node_positions(i,1) >= width)
-      throw std::runtime_error((boost::format("The position (%i,%i) is out of the image boundaries %i x %i")%height%width%m_node_positions(i,0)%m_node_positions(i,1)).str());
+      throw std::runtime_error((boost::format("The position (%i,%i) is out of the image boundaries %i x %i")%m_node_positions(i,0)%m_node_positions(i,1)%height%width).str());
   }
 }
 
@@ -168,6 +189,44 @@ void bob::machine::GaborGraphMachine::extract(
   }
 }
 
+/**
+ * Extracts the Gabor jets (including phase information) at the node positions directly from the image.
+ * Only the responses at the node positions are computed, instead of the whole Gabor jet image.
+ * @param gwt        The Gabor wavelet transform to use
+ * @param image      The image to extract the Gabor jets from
+ * @param graph_jets The graph that will be filled
+ * @param do_normalize Shall the Gabor jets be normalized?
+ */
+void bob::machine::GaborGraphMachine::extract(
+  bob::ip::GaborWaveletTransform& gwt,
+  const blitz::Array<std::complex<double>,2>& image,
+  blitz::Array<double,3>& graph_jets,
+  bool do_normalize
+) const {
+  // check the positions
+  checkPositions(image.shape()[0], image.shape()[1]);
+  gwt.computeJets(image, m_node_positions, graph_jets, do_normalize);
+}
+
+/**
+ * Extracts the Gabor jets (without phase information) at the node positions directly from the image.
+ * Only the responses at the node positions are computed, instead of the whole Gabor jet image.
+ * @param gwt        The Gabor wavelet transform to use
+ * @param image      The image to extract the Gabor jets from
+ * @param graph_jets The graph that will be filled
+ * @param do_normalize Shall the Gabor jets be normalized?
+ */
+void bob::machine::GaborGraphMachine::extract(
+  bob::ip::GaborWaveletTransform& gwt,
+  const blitz::Array<std::complex<double>,2>& image,
+  blitz::Array<double,2>& graph_jets,
+  bool do_normalize
+) const {
+  // check the positions
+  checkPositions(image.shape()[0], image.shape()[1]);
+  gwt.computeJets(image, m_node_positions, graph_jets, do_normalize);
+}
+
 
 /**
  * Averages the given set of Gabor graphs into a single one by interpolating the Gabor jets
@@ -305,6 +364,120 @@ double bob::machine::GaborGraphMachine::similarity(
 }
 
 
+/**
+ * Computes the similarities of the given gallery graphs [begin, end[ to the probe graph.
+ * All Gabor jets are stored contiguously with jet_size values per node.
+ * This function only reads the given memory, and may be called by several threads concurrently.
+ */
+static void score_block(
+  const double* gallery,
+  const double* probe,
+  int number_of_nodes,
+  int number_of_kernels,
+  int jet_size,
+  const bob::machine::GaborJetSimilarity* jet_similarity_function,
+  double* scores,
+  int begin,
+  int end
+)
+{
+  // working memory of the disparity estimation of this thread
+  std::vector<double> confidences(number_of_kernels), phase_differences(number_of_kernels);
+  blitz::TinyVector<double,2> disparity;
+  const int graph_size = number_of_nodes * jet_size;
+  for (int g = begin; g < end; ++g){
+    const double* graph = gallery + (int64_t)g * graph_size;
+    // iterate over the nodes and average Gabor jet similarities
+    double similarity = 0.;
+    for (int i = 0; i < number_of_nodes; ++i){
+      similarity += jet_similarity_function->similarity(number_of_kernels, graph + i * jet_size, probe + i * jet_size, &confidences[0], &phase_differences[0], disparity);
+    }
+    scores[g] = similarity / number_of_nodes;
+  }
+}
+
+void bob::machine::GaborGraphMachine::scoreGallery(
+  const double* gallery,
+  const double* probe,
+  int number_of_graphs,
+  int number_of_nodes,
+  int number_of_kernels,
+  int jet_size,
+  const bob::machine::GaborJetSimilarity& jet_similarity_function,
+  double* scores
+) const
+{
+  const int n_blocks = std::min((int)m_n_threads, number_of_graphs);
+  if (n_blocks <= 1){
+    score_block(gallery, probe, number_of_nodes, number_of_kernels, jet_size, &jet_similarity_function, scores, 0, number_of_graphs);
+    return;
+  }
+
+  // score contiguous chunks of the gallery in parallel
+  boost::thread_group threads;
+  for (int t = 1; t < n_blocks; ++t){
+    const int begin = (int)(((int64_t)number_of_graphs * t) / n_blocks);
+    const int end = (int)(((int64_t)number_of_graphs * (t+1)) / n_blocks);
+    threads.create_thread(boost::bind(&score_block, gallery, probe, number_of_nodes, number_of_kernels, jet_size, &jet_similarity_function, scores, begin, end));
+  }
+  score_block(gallery, probe, number_of_nodes, number_of_kernels, jet_size, &jet_similarity_function, scores, 0, number_of_graphs / n_blocks);
+  threads.join_all();
+}
+
+/**
+ * Computes the similarities of the given probe graph to each of the gallery graphs
+ * @param gallery_graph_jets  The gallery graphs, stored in a C-contiguous array
+ * @param probe_graph_jets  The probe graph to compare
+ * @param jet_similarity_function  The similarity function to be used for comparison of two corresponding Gabor jets
+ * @param scores  The similarity of the probe graph to each of the gallery graphs
+ */
+void bob::machine::GaborGraphMachine::similarities(
+  const blitz::Array<double,4>& gallery_graph_jets,
+  const blitz::Array<double,3>& probe_graph_jets,
+  const bob::machine::GaborJetSimilarity& jet_similarity_function,
+  blitz::Array<double,1>& scores
+) const
+{
+  bob::core::array::assertCZeroBaseContiguous(gallery_graph_jets);
+  bob::core::array::assertCZeroBaseContiguous(probe_graph_jets);
+  bob::core::array::assertCZeroBaseContiguous(scores);
+  bob::core::array::assertSameShape(gallery_graph_jets, blitz::shape(scores.extent(0), probe_graph_jets.extent(0), 2, probe_graph_jets.extent(2)));
+
+  const int number_of_kernels = probe_graph_jets.extent(2);
+  if (jet_similarity_function.usesPhases())
+    bob::core::array::assertSameDimensionLength(number_of_kernels, jet_similarity_function.gwt().numberOfKernels());
+
+  // each jet holds the absolute values followed by the phases, which are ignored by the similarity types without phases
+  scoreGallery(gallery_graph_jets.data(), probe_graph_jets.data(), scores.extent(0), probe_graph_jets.extent(0), number_of_kernels, 2 * number_of_kernels, jet_similarity_function, scores.data());
+}
+
+/**
+ * Computes the similarities of the given probe graph (without phases) to each of the gallery graphs
+ * @param gallery_graph_jets  The gallery graphs, stored in a C-contiguous array
+ * @param probe_graph_jets  The probe graph to compare
+ * @param jet_similarity_function  The similarity function to be used for comparison of two corresponding Gabor jets
+ * @param scores  The similarity of the probe graph to each of the gallery graphs
+ */
+void bob::machine::GaborGraphMachine::similarities(
+  const blitz::Array<double,3>& gallery_graph_jets,
+  const blitz::Array<double,2>& probe_graph_jets,
+  const bob::machine::GaborJetSimilarity& jet_similarity_function,
+  blitz::Array<double,1>& scores
+) const
+{
+  if (jet_similarity_function.usesPhases())
+    throw std::runtime_error("Disparity similarity (and its derivatives) need Gabor jets including phases");
+
+  bob::core::array::assertCZeroBaseContiguous(gallery_graph_jets);
+  bob::core::array::assertCZeroBaseContiguous(probe_graph_jets);
+  bob::core::array::assertCZeroBaseContiguous(scores);
+  bob::core::array::assertSameShape(gallery_graph_jets, blitz::shape(scores.extent(0), probe_graph_jets.extent(0), probe_graph_jets.extent(1)));
+
+  const int number_of_kernels = probe_graph_jets.extent(1);
+  scoreGallery(gallery_graph_jets.data(), probe_graph_jets.data(), scores.extent(0), probe_graph_jets.extent(0), number_of_kernels, number_of_kernels, jet_similarity_function, scores.data());
+}
+
+
 void bob::machine::GaborGraphMachine::save(bob::io::HDF5File& file) const{
   file.setArray("NodePositions", m_node_positions);
 }
@@ -25,10 +25,6 @@ static double sqr(double x){return x*x;}
 
 void bob::machine::GaborJetSimilarity::init(){
   m_disparity = 0.;
-  m_confidences.resize(m_gwt.numberOfKernels());
-  std::fill(m_confidences.begin(), m_confidences.end(), 0.);
-  m_phase_differences.resize(m_gwt.numberOfKernels());
-  std::fill(m_phase_differences.begin(), m_phase_differences.end(), 0.);
 }
 
 
@@ -37,34 +33,63 @@ double bob::machine::GaborJetSimilarity::operator()(const blitz::Array<double,1>
   bob::core::array::assertCZeroBaseContiguous(jet2);
   bob::core::array::assertSameShape(jet1,jet2);
 
+  if (usesPhases())
+    throw std::runtime_error("Disparity similarity (and its derivatives) need Gabor jets including phases");
+
+  return similarity(jet1.extent(0), jet1.data(), jet2.data(), 0, 0, m_disparity);
+}
+
+
+double bob::machine::GaborJetSimilarity::operator()(const blitz::Array<double,2>& jet1, const blitz::Array<double,2>& jet2) const{
+  if (!usesPhases()){
+    // call the function without phases
+    return operator()(jet1(0,blitz::Range::all()), jet2(0,blitz::Range::all()));
+  }
+
+  // Here, only the disparity based similarity functions are executed
+  bob::core::array::assertCZeroBaseContiguous(jet1);
+  bob::core::array::assertCZeroBaseContiguous(jet2);
+  bob::core::array::assertSameShape(jet1,jet2);
+  bob::core::array::assertSameDimensionLength(jet1.extent(1), m_gwt.numberOfKernels());
+
+  std::vector<double> confidences(jet1.extent(1)), phase_differences(jet1.extent(1));
+  return similarity(jet1.extent(1), jet1.data(), jet2.data(), &confidences[0], &phase_differences[0], m_disparity);
+}
+
+
+double bob::machine::GaborJetSimilarity::similarity(
+  int number_of_kernels,
+  const double* jet1,
+  const double* jet2,
+  double* confidences,
+  double* phase_differences,
+  blitz::TinyVector<double,2>& disparity
+) const
+{
+  // The products and quotients of the SCALAR_PRODUCT and CANBERRA loops are vectorized by GCC with
+  // the release flags, but the sums are kept in order; the disparity loops call cos() and round()
   switch (m_type){
     case SCALAR_PRODUCT:
       // normalized scalar product
-      return std::inner_product(jet1.begin(), jet1.end(), jet2.begin(), 0.);
+      return std::inner_product(jet1, jet1 + number_of_kernels, jet2, 0.);
+
     case CANBERRA:{
       // Canberra similarity
       double sim = 0.;
-      unsigned size = jet1.shape()[0];
-      for (unsigned j = size; j--;){
-        sim += 1. - std::abs(jet1(j) - jet2(j)) / (jet1(j) + jet2(j));
+      for (int j = number_of_kernels; j--;){
+        sim += 1. - std::abs(jet1[j] - jet2[j]) / (jet1[j] + jet2[j]);
       }
-      return sim / size;
+      return sim / number_of_kernels;
     }
-    default:
-      throw std::runtime_error("Disparity similarity (and its derivatives) need Gabor jets including phases");
-  }
-}
-
 
-double bob::machine::GaborJetSimilarity::operator()(const blitz::Array<double,2>& jet1, const blitz::Array<double,2>& jet2) const{
-  if (m_type == SCALAR_PRODUCT || m_type == CANBERRA){
-    // call the function without phases
-    return operator()(jet1(0,blitz::Range::all()), jet2(0,blitz::Range::all()));
+    default:
+      break;
   }
 
   // Here, only the disparity based similarity functions are executed
   // compute the disparity
-  disparity(jet1, jet2);
+  compute_confidences(number_of_kernels, jet1, jet2, confidences, phase_differences);
+  compute_disparity(confidences, phase_differences, disparity);
 
   const std::vector<blitz::TinyVector<double,2> >& kernels = m_gwt.kernelFrequencies();
 
@@ -72,8 +97,8 @@ double bob::machine::GaborJetSimilarity::operator()(const blitz::Array<double,2>
     case DISPARITY:{
       // compute the similarity using the estimated disparity
       double sum = 0.;
-      for (int j = m_confidences.size(); j--;){
-        sum += m_confidences[j] * cos(m_phase_differences[j] - m_disparity[0] * kernels[j][0] - m_disparity[1] * kernels[j][1]);
+      for (int j = number_of_kernels; j--;){
+        sum += confidences[j] * cos(phase_differences[j] - disparity[0] * kernels[j][0] - disparity[1] * kernels[j][1]);
       }
       return sum;
     } // DISPARITY
@@ -81,22 +106,22 @@ double bob::machine::GaborJetSimilarity::operator()(const blitz::Array<double,2>
     case PHASE_DIFF:{
       // compute the similarity using the estimated disparity
       double sum = 0.;
-      for (int j = m_phase_differences.size(); j--;){
-        sum += cos(m_phase_differences[j] - m_disparity[0] * kernels[j][0] - m_disparity[1] * kernels[j][1]);
+      for (int j = number_of_kernels; j--;){
+        sum += cos(phase_differences[j] - disparity[0] * kernels[j][0] - disparity[1] * kernels[j][1]);
       }
-      return sum / jet1.shape()[1];
+      return sum / number_of_kernels;
     } // PHASE_DIFF
 
     case PHASE_DIFF_PLUS_CANBERRA:{
       // compute the similarity using the estimated disparity
       double sum = 0.;
-      for (int j = m_phase_differences.size(); j--;){
+      for (int j = number_of_kernels; j--;){
         // add disparity term
-        sum += cos(m_phase_differences[j] - m_disparity[0] * kernels[j][0] - m_disparity[1] * kernels[j][1]);
+        sum += cos(phase_differences[j] - disparity[0] * kernels[j][0] - disparity[1] * kernels[j][1]);
         // add Canberra term
-        sum += 1. - std::abs(jet1(0,j) - jet2(0,j)) / (jet1(0,j) + jet2(0,j));
+        sum += 1. - std::abs(jet1[j] - jet2[j]) / (jet1[j] + jet2[j]);
       }
-      return sum / (2. * jet1.shape()[1]);
+      return sum / (2. * number_of_kernels);
     }
 
     default:
@@ -110,7 +135,7 @@ double bob::machine::GaborJetSimilarity::operator()(const blitz::Array<double,2>
 ////////////////  Disparity estimation  /////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 blitz::TinyVector<double,2> bob::machine::GaborJetSimilarity::disparity(const blitz::Array<double,2>& jet1, const blitz::Array<double,2>& jet2) const{
-  if (m_type == SCALAR_PRODUCT || m_type == CANBERRA){
+  if (!usesPhases()){
     // call the function without phases
     return operator()(jet1(0,blitz::Range::all()), jet2(0,blitz::Range::all()));
   }
@@ -119,12 +144,14 @@ blitz::TinyVector<double,2> bob::machine::GaborJetSimilarity::disparity(const bl
   bob::core::array::assertCZeroBaseContiguous(jet1);
   bob::core::array::assertCZeroBaseContiguous(jet2);
   bob::core::array::assertSameShape(jet1,jet2);
+  bob::core::array::assertSameDimensionLength(jet1.extent(1), m_gwt.numberOfKernels());
 
   // compute confidence vectors
-  compute_confidences(jet1, jet2);
+  std::vector<double> confidences(jet1.extent(1)), phase_differences(jet1.extent(1));
+  compute_confidences(jet1.extent(1), jet1.data(), jet2.data(), &confidences[0], &phase_differences[0]);
 
   // now, compute the disparity
-  compute_disparity();
+  compute_disparity(&confidences[0], &phase_differences[0], m_disparity);
 
   // return the disparity
   return m_disparity;
@@ -144,34 +171,36 @@ void bob::machine::GaborJetSimilarity::shift_phase(const blitz::Array<double,2>&
   // compute phase shift for each jet entry based on disparity vector
   const std::vector<blitz::TinyVector<double,2> >& kernels = m_gwt.kernelFrequencies();
   shifted = jet;
-  for (int j = m_phase_differences.size(); j--;){
+  for (int j = jet.extent(1); j--;){
     shifted(1,j) = adjustPhase(shifted(1,j) - m_disparity[0] * kernels[j][0] - m_disparity[1] * kernels[j][1]);
   }
 }
 
-void bob::machine::GaborJetSimilarity::compute_confidences(const blitz::Array<double,2>& jet1, const blitz::Array<double,2>& jet2) const{
+void bob::machine::GaborJetSimilarity::compute_confidences(int number_of_kernels, const double* jet1, const double* jet2, double* confidences, double* phase_differences) const{
+  // the phases are stored behind the absolute values
+  const double* phases1 = jet1 + number_of_kernels, * phases2 = jet2 + number_of_kernels;
   // first, fill confidence and phase difference vectors
-  for (int j = m_confidences.size(); j--;){
-    m_confidences[j] = jet1(0,j) * jet2(0,j);
-    m_phase_differences[j] = adjustPhase(jet1(1,j) - jet2(1,j));
+  for (int j = number_of_kernels; j--;){
+    confidences[j] = jet1[j] * jet2[j];
+    phase_differences[j] = adjustPhase(phases1[j] - phases2[j]);
   }
 }
 
-void bob::machine::GaborJetSimilarity::compute_disparity() const{
+void bob::machine::GaborJetSimilarity::compute_disparity(const double* confidences, const double* phase_differences, blitz::TinyVector<double,2>& disparity) const{
   // approximate the disparity from the phase differences
   double gamma_x_x = 0., gamma_x_y = 0., gamma_y_y = 0., phi_x = 0., phi_y = 0.;
   // initialize the disparity with 0
-  m_disparity = 0.;
+  disparity = 0.;
 
   const std::vector<blitz::TinyVector<double,2> >& kernels = m_gwt.kernelFrequencies();
   // iterate backwards through the vector to start with the lowest frequency wavelets
-  for (int j = m_confidences.size()-1, level = m_gwt.numberOfScales()-1; level >= 0; --level){
+  for (int j = m_gwt.numberOfKernels()-1, level = m_gwt.numberOfScales()-1; level >= 0; --level){
     for (int direction = m_gwt.numberOfDirections()-1; direction >= 0; --direction, --j){
       double
           kjx = kernels[j][1],
           kjy = kernels[j][0],
-          conf = m_confidences[j],
-          diff = m_phase_differences[j];
+          conf = confidences[j],
+          diff = phase_differences[j];
 
       // totalize gamma matrix
       gamma_x_x += kjx * kjx * conf;
@@ -180,7 +209,7 @@ void bob::machine::GaborJetSimilarity::compute_disparity() const{
 
       // totalize phi vector
       // estimate the number of cycles that we are off
-      double nL = round((diff - m_disparity[1] * kjx - m_disparity[0] * kjy) / (2.*M_PI));
+      double nL = round((diff - disparity[1] * kjx - disparity[0] * kjy) / (2.*M_PI));
       // totalize corrected phi vector elements
       phi_x += (diff - nL * 2. * M_PI) * conf * kjx;
       phi_y += (diff - nL * 2. * M_PI) * conf * kjy;
@@ -188,8 +217,8 @@ void bob::machine::GaborJetSimilarity::compute_disparity() const{
 
     // re-calculate disparity as d=\Gamma^{-1}\Phi of the (low frequency) wavelet scales that we used up to now
     double gamma_det = gamma_x_x * gamma_y_y - sqr(gamma_x_y);
-    m_disparity[1] = (gamma_y_y * phi_x - gamma_x_y * phi_y) / gamma_det;
-    m_disparity[0] = (gamma_x_x * phi_y - gamma_x_y * phi_x) / gamma_det;
+    disparity[1] = (gamma_y_y * phi_x - gamma_x_y * phi_y) / gamma_det;
+    disparity[0] = (gamma_x_x * phi_y - gamma_x_y * phi_x) / gamma_det;
   } // for level
 }
 
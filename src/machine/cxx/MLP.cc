@@ -10,14 +10,24 @@
 
 #include <sys/time.h>
 #include <cmath>
+#include <algorithm>
 #include <boost/format.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
 
 #include <bob/core/check.h>
 #include <bob/core/array_copy.h>
+#include <bob/core/array_utils.h>
 #include <bob/core/assert.h>
 #include <bob/machine/MLP.h>
 #include <bob/math/linear.h>
+#include <bob/math/gemm.h>
+
+/**
+ * Number of rows forwarded together by the batched methods
+ */
+static const int ROWS_PER_BLOCK = 256;
 
 bob::machine::MLP::MLP (size_t input, size_t output):
   m_input_sub(input),
@@ -249,19 +259,76 @@ void bob::machine::MLP::forward (const blitz::Array<double,1>& input,
   forward_(input, output); 
 }
 
-void bob::machine::MLP::forward_ (const blitz::Array<double,2>& input,
-    blitz::Array<double,2>& output) {
+void bob::machine::MLP::forward_rows (const blitz::Array<double,2>& input,
+    blitz::Array<double,2>& output, int begin, int end) const {
 
+  blitz::firstIndex i;
+  blitz::secondIndex j;
   blitz::Range all = blitz::Range::all();
-  for (int i=0; i<input.extent(0); ++i) {
-    blitz::Array<double,1> inref(input(i,all));
-    blitz::Array<double,1> outref(output(i,all));
-    forward_(inref, outref);
+
+  //views of the arrays shared with the other threads
+  const blitz::Array<double,2> input_v(bob::core::array::private_view(input));
+  blitz::Array<double,2> output_v(bob::core::array::private_view(output));
+  const std::vector<blitz::Array<double,2> > weight(bob::core::array::private_view(m_weight));
+  const std::vector<blitz::Array<double,1> > bias(bob::core::array::private_view(m_bias));
+
+  //working arrays for the outputs of each layer, for a whole block of rows
+  const int block = std::min(ROWS_PER_BLOCK, end-begin);
+  std::vector<blitz::Array<double,2> > buffer(weight.size()+1);
+  buffer[0].resize(block, weight.front().extent(0));
+  for (size_t k=0; k<weight.size(); ++k)
+    buffer[k+1].resize(block, weight[k].extent(1));
+
+  for (int b=begin; b<end; b+=block) {
+    const int n = std::min(block, end-b);
+    blitz::Range rb(0, n-1);
+    std::vector<blitz::Array<double,2> > buf(buffer.size());
+    for (size_t k=0; k<buffer.size(); ++k) buf[k].reference(buffer[k](rb,all));
+
+    //normalizes the input
+    const blitz::Array<double,2> in(input_v(blitz::Range(b,b+n-1),all));
+    buf[0] = (in(i,j) - m_input_sub(j)) / m_input_div(j);
+
+    //input -> hidden[0]; hidden[0] -> hidden[1], ..., hidden[N-1] -> output
+    for (size_t k=0; k<weight.size(); ++k) {
+      bob::math::gemm_(buf[k], weight[k], buf[k+1]);
+      buf[k+1] += bias[k](j);
+      if (k+1 < weight.size()) m_hidden_activation->f_inplace(buf[k+1]);
+      else m_output_activation->f_inplace(buf[k+1]);
+    }
+
+    output_v(blitz::Range(b,b+n-1),all) = buf.back();
   }
 }
 
-void bob::machine::MLP::forward (const blitz::Array<double,2>& input,
+void bob::machine::MLP::forward_ (const blitz::Array<double,2>& input,
     blitz::Array<double,2>& output) {
+  forward_rows(input, output, 0, input.extent(0));
+}
+
+void bob::machine::MLP::forward_ (const blitz::Array<double,2>& input,
+    blitz::Array<double,2>& output, size_t n_threads) {
+
+  const int n_rows = input.extent(0);
+  const int n_blocks = std::min((int)n_threads, n_rows);
+  if (n_blocks <= 1) {
+    forward_rows(input, output, 0, n_rows);
+    return;
+  }
+
+  //splits the rows into contiguous blocks of (almost) equal size
+  boost::thread_group threads;
+  for (int t=0; t<n_blocks; ++t) {
+    const int begin = (int)(((int64_t)n_rows * t) / n_blocks);
+    const int end = (int)(((int64_t)n_rows * (t+1)) / n_blocks);
+    threads.create_thread(boost::bind(&bob::machine::MLP::forward_rows, this,
+          boost::cref(input), boost::ref(output), begin, end));
+  }
+  threads.join_all();
+}
+
+void bob::machine::MLP::check_forward (const blitz::Array<double,2>& input,
+    const blitz::Array<double,2>& output) const {
 
   //checks input
   if (m_weight.front().extent(0) != input.extent(1)) {//checks input
@@ -276,7 +343,18 @@ void bob::machine::MLP::forward (const blitz::Array<double,2>& input,
   }
   //checks output
   bob::core::array::assertSameDimensionLength(input.extent(0), output.extent(0));
-  forward_(input, output); 
+}
+
+void bob::machine::MLP::forward (const blitz::Array<double,2>& input,
+    blitz::Array<double,2>& output) {
+  check_forward(input, output);
+  forward_(input, output);
+}
+
+void bob::machine::MLP::forward (const blitz::Array<double,2>& input,
+    blitz::Array<double,2>& output, size_t n_threads) {
+  check_forward(input, output);
+  forward_(input, output, n_threads);
 }
 
 void bob::machine::MLP::resize (size_t input, size_t output) {
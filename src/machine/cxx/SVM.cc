@@ -22,6 +22,17 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <algorithm>
+#include <vector>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <bob/core/assert.h>
+#include <bob/core/array_utils.h>
+#include <bob/math/gemm.h>
+
+/**
+ * Number of rows predicted together by the batched methods
+ */
+static const int ROWS_PER_BLOCK = 256;
 
 static bool is_colon(char i) { return i == ':'; }
 
@@ -214,6 +225,70 @@ void bob::machine::SupportVector::reset() {
   m_input_sub = 0.0;
   m_input_div.resize(inputSize());
   m_input_div = 1.0;
+
+  densify();
+}
+
+void bob::machine::SupportVector::densify() {
+  m_collapsed = false;
+  if (kernelType() == PRECOMPUTED) return; ///< batches are predicted by libsvm
+
+  const int L = m_model->l;
+  const int D = m_input_size;
+  const int nr_class = m_model->nr_class;
+  const bool classification = (machineType() == C_SVC || machineType() == NU_SVC);
+  const int P = classification ? (nr_class*(nr_class-1))/2 : 1;
+
+  //the support vectors, one per row
+  m_sv.resize(L, D);
+  m_sv = 0.0;
+  m_sv_norm2.resize(L);
+  for (int k=0; k<L; ++k) {
+    double norm2 = 0.0;
+    for (svm_node* node = m_model->SV[k]; node->index != -1; ++node) {
+      m_sv(k, node->index-1) = node->value;
+      norm2 += node->value * node->value;
+    }
+    m_sv_norm2(k) = norm2;
+  }
+
+  //the coefficient of each support vector in each decision function: for
+  //classification, the function of classes i and j (in this order, as in
+  //svm_predict_values) only involves the support vectors of these classes
+  blitz::Array<double,2> coef(L, P);
+  coef = 0.0;
+  if (classification) {
+    std::vector<int> start(nr_class, 0);
+    for (int i=1; i<nr_class; ++i) start[i] = start[i-1] + m_model->nSV[i-1];
+    int p = 0;
+    for (int i=0; i<nr_class; ++i) {
+      for (int j=i+1; j<nr_class; ++j, ++p) {
+        for (int k=0; k<m_model->nSV[i]; ++k)
+          coef(start[i]+k, p) = m_model->sv_coef[j-1][start[i]+k];
+        for (int k=0; k<m_model->nSV[j]; ++k)
+          coef(start[j]+k, p) = m_model->sv_coef[i][start[j]+k];
+      }
+    }
+  }
+  else {
+    for (int k=0; k<L; ++k) coef(k, 0) = m_model->sv_coef[0][k];
+  }
+
+  m_rho.resize(P);
+  for (int p=0; p<P; ++p) m_rho(p) = m_model->rho[p];
+
+  if (kernelType() == LINEAR) {
+    //sum_k coef(k) * <x, sv(k)> = <x, sum_k coef(k) * sv(k)>: a single weight
+    //vector replaces the support vectors of each decision function
+    m_coef.resize(D, P);
+    bob::math::gemm_(m_sv, coef, m_coef, true, false);
+    m_sv.free();
+    m_sv_norm2.free();
+    m_collapsed = true;
+  }
+  else {
+    m_coef.reference(coef);
+  }
 }
 
 bob::machine::SupportVector::SupportVector(const std::string& model_file):
@@ -434,6 +509,227 @@ int bob::machine::SupportVector::predictClassAndProbabilities
   return predictClassAndProbabilities_(input, probabilities);
 }
 
+/**
+ * Integer power, computed as libsvm does
+ */
+static inline double powi(double base, int times) {
+  double tmp = base, ret = 1.0;
+  for (int t=times; t>0; t/=2) {
+    if (t%2 == 1) ret *= tmp;
+    tmp = tmp * tmp;
+  }
+  return ret;
+}
+
+/**
+ * Decides the class from the values of the decision functions, as
+ * svm_predict does: one-against-one votes for classification (the first
+ * class with the most votes wins), the sign for one-class machines and the
+ * (rounded) value for regression.
+ */
+static int decide(const svm_model* model, const double* dec,
+    std::vector<int>& votes) {
+
+  switch (model->param.svm_type) {
+    case ONE_CLASS:
+      return (dec[0] > 0) ? 1 : -1;
+    case EPSILON_SVR:
+    case NU_SVR:
+      return round(dec[0]);
+    default:
+      break;
+  }
+
+  const int nr_class = model->nr_class;
+  votes.assign(nr_class, 0);
+  int p = 0;
+  for (int i=0; i<nr_class; ++i)
+    for (int j=i+1; j<nr_class; ++j, ++p)
+      ++votes[(dec[p] > 0) ? i : j];
+
+  int winner = 0;
+  for (int i=1; i<nr_class; ++i)
+    if (votes[i] > votes[winner]) winner = i;
+  return model->label[winner];
+}
+
+void bob::machine::SupportVector::predictRows
+(const blitz::Array<double,2>& input_, blitz::Array<int,1>& labels,
+ blitz::Array<double,2>* scores_, int begin, int end) const {
+
+  //the arrays shared with the other threads are only accessed through
+  //private views, as slicing them would update their reference counts
+  const blitz::Array<double,2> input(bob::core::array::private_view(input_));
+  const blitz::Array<double,2> sv(bob::core::array::private_view(m_sv));
+  const blitz::Array<double,2> coef(bob::core::array::private_view(m_coef));
+  blitz::Array<double,2> scores_view;
+  if (scores_) scores_view.reference(bob::core::array::private_view(*scores_));
+  blitz::Array<double,2>* scores = scores_ ? &scores_view : 0;
+
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  blitz::Range all = blitz::Range::all();
+
+  const int D = m_input_size;
+  const int L = m_collapsed ? 0 : sv.extent(0);
+  const int P = m_rho.extent(0);
+  const svm_parameter& param = m_model->param;
+
+  //working arrays for the (normalized) inputs, their kernel values with the
+  //support vectors and the decision values, for a whole block of rows
+  const int block = std::min(ROWS_PER_BLOCK, end-begin);
+  blitz::Array<double,2> xbuf(block, D), kbuf(block, L), dbuf(block, P);
+  std::vector<int> votes;
+
+  for (int b=begin; b<end; b+=block) {
+    const int n = std::min(block, end-b);
+    blitz::Range rb(0, n-1);
+    blitz::Array<double,2> x(xbuf(rb,all));
+    blitz::Array<double,2> dec(dbuf(rb,all));
+
+    //normalizes the input (only the first inputSize() columns are used)
+    const blitz::Array<double,2> in(input(blitz::Range(b,b+n-1),
+          blitz::Range(0,D-1)));
+    x = (in(i,j) - m_input_sub(j)) / m_input_div(j);
+
+    if (m_collapsed) {
+      bob::math::gemm_(x, coef, dec);
+    }
+    else {
+      //dot products with all the support vectors, transformed in place
+      blitz::Array<double,2> k(kbuf(rb,all));
+      bob::math::gemm_(x, sv, k, false, true);
+
+      double* kd = k.data();
+      const int size = n * L;
+      switch (param.kernel_type) {
+        case POLY:
+          for (int t=0; t<size; ++t)
+            kd[t] = powi(param.gamma*kd[t] + param.coef0, param.degree);
+          break;
+        case RBF:
+          for (int r=0; r<n; ++r) {
+            const double* xr = x.data() + r*D;
+            double xnorm2 = 0.0;
+            for (int c=0; c<D; ++c) xnorm2 += xr[c] * xr[c];
+            double* kr = kd + r*L;
+            const double* svn = m_sv_norm2.data();
+            for (int l=0; l<L; ++l)
+              kr[l] = std::exp(-param.gamma *
+                  std::max(0.0, xnorm2 + svn[l] - 2.0*kr[l]));
+          }
+          break;
+        case SIGMOID:
+          for (int t=0; t<size; ++t)
+            kd[t] = std::tanh(param.gamma*kd[t] + param.coef0);
+          break;
+        default: //LINEAR
+          break;
+      }
+
+      bob::math::gemm_(k, coef, dec);
+    }
+    dec -= m_rho(j);
+
+    for (int r=0; r<n; ++r) {
+      labels(b+r) = decide(m_model.get(), dec.data() + r*P, votes);
+    }
+    if (scores) (*scores)(blitz::Range(b,b+n-1),all) = dec;
+  }
+}
+
+void bob::machine::SupportVector::predictAll
+(const blitz::Array<double,2>& input, blitz::Array<int,1>& labels,
+ blitz::Array<double,2>* scores, size_t n_threads) const {
+
+  blitz::Range all = blitz::Range::all();
+  const int n_rows = input.extent(0);
+
+  //precomputed kernels are left to libsvm (which shares the input cache)
+  if (kernelType() == PRECOMPUTED) {
+    for (int k=0; k<n_rows; ++k) {
+      const blitz::Array<double,1> row = input(k,all);
+      if (scores) {
+        blitz::Array<double,1> s = (*scores)(k,all);
+        blitz::Array<double,1> s_ = bob::core::array::ccopy(s);
+        labels(k) = predictClassAndScores_(row, s_);
+        s = s_;
+      }
+      else labels(k) = predictClass_(row);
+    }
+    return;
+  }
+
+  const int n_blocks = std::min((int)n_threads, n_rows);
+  if (n_blocks <= 1) {
+    predictRows(input, labels, scores, 0, n_rows);
+    return;
+  }
+
+  //splits the rows into contiguous blocks of (almost) equal size
+  boost::thread_group threads;
+  for (int t=0; t<n_blocks; ++t) {
+    const int begin = (int)(((int64_t)n_rows * t) / n_blocks);
+    const int end = (int)(((int64_t)n_rows * (t+1)) / n_blocks);
+    threads.create_thread(boost::bind(&bob::machine::SupportVector::predictRows,
+          this, boost::cref(input), boost::ref(labels), scores, begin, end));
+  }
+  threads.join_all();
+}
+
+void bob::machine::SupportVector::checkBatch
+(const blitz::Array<double,2>& input, const blitz::Array<int,1>& labels) const {
+
+  bob::core::array::assertZeroBase(input);
+  bob::core::array::assertZeroBase(labels);
+
+  if ((size_t)input.extent(1) < inputSize()) {
+    boost::format s("input for this SVM should have **at least** %d columns, but you provided an array with %d columns instead");
+    s % inputSize() % input.extent(1);
+    throw std::runtime_error(s.str());
+  }
+
+  bob::core::array::assertSameDimensionLength(labels.extent(0), input.extent(0));
+}
+
+void bob::machine::SupportVector::predictClassesDense_
+(const blitz::Array<double,2>& input, blitz::Array<int,1>& labels,
+ size_t n_threads) const {
+  predictAll(input, labels, 0, n_threads);
+}
+
+void bob::machine::SupportVector::predictClassesDense
+(const blitz::Array<double,2>& input, blitz::Array<int,1>& labels,
+ size_t n_threads) const {
+  checkBatch(input, labels);
+  predictClassesDense_(input, labels, n_threads);
+}
+
+void bob::machine::SupportVector::predictClassesAndScoresDense_
+(const blitz::Array<double,2>& input, blitz::Array<int,1>& labels,
+ blitz::Array<double,2>& scores, size_t n_threads) const {
+  predictAll(input, labels, &scores, n_threads);
+}
+
+void bob::machine::SupportVector::predictClassesAndScoresDense
+(const blitz::Array<double,2>& input, blitz::Array<int,1>& labels,
+ blitz::Array<double,2>& scores, size_t n_threads) const {
+
+  checkBatch(input, labels);
+  bob::core::array::assertZeroBase(scores);
+
+  size_t N = outputSize();
+  size_t size = N < 2 ? 1 : (N*(N-1))/2;
+  bob::core::array::assertSameDimensionLength(scores.extent(0), input.extent(0));
+  if ((size_t)scores.extent(1) != size) {
+    boost::format s("output scores for this SVM (%d classes) should have %d columns, but you provided an array with %d columns instead");
+    s % svm_get_nr_class(m_model.get()) % size % scores.extent(1);
+    throw std::runtime_error(s.str());
+  }
+
+  predictClassesAndScoresDense_(input, labels, scores, n_threads);
+}
+
 void bob::machine::SupportVector::save(const std::string& filename) const {
   if (svm_save_model(filename.c_str(), m_model.get())) {
     boost::format s("cannot save SVM model to file '%s'");
@@ -147,3 +147,67 @@ BOOST_AUTO_TEST_CASE( test_disparity ){
     BOOST_CHECK_SMALL(normalized_jet(1,(int)i) - test_jet(1,(int)i), epsilon);
 }
 
+
+BOOST_AUTO_TEST_CASE( test_gallery_similarities ){
+  // create a synthetic image
+  blitz::Array<std::complex<double>,2> image(60, 50);
+  for (int y = 0; y < 60; ++y)
+    for (int x = 0; x < 50; ++x)
+      image(y,x) = std::complex<double>(128. + 100. * std::sin(0.3 * x + 0.1 * y) * std::cos(0.05 * x * y), 0.);
+
+  bob::ip::GaborWaveletTransform gwt;
+  bob::machine::GaborGraphMachine machine(blitz::TinyVector<int,2>(5,5), blitz::TinyVector<int,2>(55,45), blitz::TinyVector<int,2>(10,10));
+  const int nodes = machine.numberOfNodes(), kernels = gwt.numberOfKernels();
+
+  // the graph extracted from the image is the one extracted from the jet image
+  blitz::Array<double,4> jet_image(60, 50, 2, kernels);
+  gwt.computeJetImage(image, jet_image, true);
+  blitz::Array<double,3> graph(nodes, 2, kernels), reference(nodes, 2, kernels);
+  machine.extract(jet_image, reference);
+  machine.extract(gwt, image, graph, true);
+  for (int i = 0; i < nodes; ++i)
+    for (int j = 0; j < kernels; ++j){
+      BOOST_CHECK_SMALL(graph(i,0,j) - reference(i,0,j), epsilon);
+      BOOST_CHECK_SMALL(std::abs(std::polar(1., graph(i,1,j)) - std::polar(1., reference(i,1,j))) * reference(i,0,j), 1e-6);
+    }
+
+  // create a gallery of modified graphs
+  const int count = 7;
+  blitz::Array<double,4> gallery(count, nodes, 2, kernels);
+  blitz::Array<double,3> abs_gallery(count, nodes, kernels);
+  for (int g = 0; g < count; ++g)
+    for (int i = 0; i < nodes; ++i)
+      for (int j = 0; j < kernels; ++j){
+        gallery(g,i,0,j) = graph(i,0,j) * (1. + 0.1 * std::sin(g + i + 0.3 * j));
+        gallery(g,i,1,j) = graph(i,1,j) + 0.2 * g * std::cos(0.7 * i + j);
+        abs_gallery(g,i,j) = gallery(g,i,0,j);
+      }
+  blitz::Array<double,2> abs_graph(graph(blitz::Range::all(), 0, blitz::Range::all()).copy());
+
+  std::vector<boost::shared_ptr<bob::machine::GaborJetSimilarity> > sim_fcts;
+  sim_fcts.push_back(boost::shared_ptr<bob::machine::GaborJetSimilarity>(new bob::machine::GaborJetSimilarity(bob::machine::GaborJetSimilarity::SCALAR_PRODUCT)));
+  sim_fcts.push_back(boost::shared_ptr<bob::machine::GaborJetSimilarity>(new bob::machine::GaborJetSimilarity(bob::machine::GaborJetSimilarity::CANBERRA)));
+  sim_fcts.push_back(boost::shared_ptr<bob::machine::GaborJetSimilarity>(new bob::machine::GaborJetSimilarity(bob::machine::GaborJetSimilarity::DISPARITY, gwt)));
+  sim_fcts.push_back(boost::shared_ptr<bob::machine::GaborJetSimilarity>(new bob::machine::GaborJetSimilarity(bob::machine::GaborJetSimilarity::PHASE_DIFF,gwt)));
+  sim_fcts.push_back(boost::shared_ptr<bob::machine::GaborJetSimilarity>(new bob::machine::GaborJetSimilarity(bob::machine::GaborJetSimilarity::PHASE_DIFF_PLUS_CANBERRA,gwt)));
+
+  // the scores of the gallery are those of the pairwise comparison, whatever the number of threads
+  blitz::Array<double,1> scores(count), abs_scores(count);
+  for (size_t n_threads = 1; n_threads <= 3; n_threads += 2){
+    machine.setNThreads(n_threads);
+    for (int s = sim_fcts.size(); s--;){
+      machine.similarities(gallery, graph, *sim_fcts[s], scores);
+      if (s < 2) machine.similarities(abs_gallery, abs_graph, *sim_fcts[s], abs_scores);
+      for (int g = 0; g < count; ++g){
+        blitz::Array<double,3> model(gallery(g, blitz::Range::all(), blitz::Range::all(), blitz::Range::all()).copy());
+        BOOST_CHECK_SMALL(scores(g) - machine.similarity(model, graph, *sim_fcts[s]), 1e-12);
+        if (s < 2){
+          blitz::Array<double,2> abs_model(abs_gallery(g, blitz::Range::all(), blitz::Range::all()).copy());
+          BOOST_CHECK_SMALL(abs_scores(g) - machine.similarity(abs_model, abs_graph, *sim_fcts[s]), 1e-12);
+        }
+      }
+    }
+  }
+  BOOST_CHECK_THROW(machine.similarities(abs_gallery, abs_graph, *sim_fcts[2], abs_scores), std::runtime_error);
+  BOOST_CHECK_THROW(machine.setNThreads(0), std::runtime_error);
+}
@@ -12,6 +12,7 @@
 #include <boost/python.hpp>
 #include <bob/python/ndarray.h>
 
+#include <bob/core/cast.h>
 #include <bob/ip/GaborWaveletTransform.h>
 #include <bob/machine/GaborGraphMachine.h>
 #include <bob/machine/GaborJetSimilarities.h>
@@ -46,6 +47,28 @@ static bob::python::ndarray bob_extract2(bob::machine::GaborGraphMachine& self,
   }
 }
 
+static bob::python::ndarray bob_extract3(bob::machine::GaborGraphMachine& self, bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image, bool include_phases, bool normalized){
+  blitz::Array<std::complex<double>,2> image;
+  switch (input_image.type().dtype){
+    case bob::core::array::t_uint8: image.reference(bob::core::array::cast<std::complex<double> >(input_image.bz<uint8_t,2>())); break;
+    case bob::core::array::t_uint16: image.reference(bob::core::array::cast<std::complex<double> >(input_image.bz<uint16_t,2>())); break;
+    case bob::core::array::t_float64: image.reference(bob::core::array::cast<std::complex<double> >(input_image.bz<double,2>())); break;
+    case bob::core::array::t_complex128: image.reference(input_image.bz<std::complex<double>,2>()); break;
+    default: PYTHON_ERROR(TypeError, "parameter `image' has an unsupported data type: %s", input_image.type().str().c_str());
+  }
+  if (include_phases){
+    bob::python::ndarray output_graph(bob::core::array::t_float64, self.numberOfNodes(), 2, (int)gwt.numberOfKernels());
+    blitz::Array<double,3> graph = output_graph.bz<double,3>();
+    self.extract(gwt, image, graph, normalized);
+    return output_graph;
+  } else {
+    bob::python::ndarray output_graph(bob::core::array::t_float64, self.numberOfNodes(), (int)gwt.numberOfKernels());
+    blitz::Array<double,2> graph = output_graph.bz<double,2>();
+    self.extract(gwt, image, graph, normalized);
+    return output_graph;
+  }
+}
+
 static void bob_average(bob::machine::GaborGraphMachine& self, bob::python::const_ndarray many_graph_jets, bob::python::ndarray averaged_graph_jets){
   blitz::Array<double,3> graph = averaged_graph_jets.bz<double,3>();
   self.average(many_graph_jets.bz<double,4>(), graph);
@@ -86,6 +109,21 @@ static double bob_similarity(bob::machine::GaborGraphMachine& self, bob::python:
   }
 }
 
+static blitz::Array<double,1> bob_similarities(bob::machine::GaborGraphMachine& self, bob::python::const_ndarray gallery_graphs, bob::python::const_ndarray probe_graph, const bob::machine::GaborJetSimilarity& similarity_function){
+  blitz::Array<double,1> scores(gallery_graphs.type().shape[0]);
+  switch (probe_graph.type().nd){
+    case 2: // Gabor graphs including jets without phases
+      self.similarities(gallery_graphs.bz<double,3>(), probe_graph.bz<double,2>(), similarity_function, scores);
+      break;
+    case 3: // Gabor graphs including jets with phases
+      self.similarities(gallery_graphs.bz<double,4>(), probe_graph.bz<double,3>(), similarity_function, scores);
+      break;
+    default:
+      PYTHON_ERROR(RuntimeError, "parameter `probe_graph' should be 2 or 3 dimensional, but you passed a " SIZE_T_FMT " dimensional array.", probe_graph.type().nd);
+  }
+  return scores;
+}
+
 static double bob_jet_sim(const bob::machine::GaborJetSimilarity& self, bob::python::const_ndarray jet1, bob::python::const_ndarray jet2){
   switch (jet1.type().nd){
     case 1:{
@@ -245,6 +283,20 @@ void bind_machine_gabor(){
       "The node positions of the graph."
       )
 
+    .add_property(
+      "n_threads",
+      &bob::machine::GaborGraphMachine::getNThreads,
+      &bob::machine::GaborGraphMachine::setNThreads,
+      "The number of threads used to compute the similarities of a probe graph to a gallery of graphs."
+    )
+
+    .def(
+      "extract",
+      &bob_extract3,
+      (boost::python::arg("self"), boost::python::arg("gwt"), boost::python::arg("image"), boost::python::arg("include_phases")=true, boost::python::arg("normalized")=true),
+      "Extracts and returns the Gabor jets at the desired locations directly from the given gray image, computing the Gabor wavelet transform at the node positions only"
+    )
+
     .def(
       "__call__",
       &bob_extract,
@@ -271,6 +323,13 @@ void bind_machine_gabor(){
       &bob_similarity,
       (boost::python::arg("self"), boost::python::arg("model_graph_jets"), boost::python::arg("probe_graph_jets"), boost::python::arg("jet_similarity_function")),
       "Computes the similarity between the given probe graph and the gallery, which might be a single graph or a collection of graphs"
+    )
+
+    .def(
+      "similarities",
+      &bob_similarities,
+      (boost::python::arg("self"), boost::python::arg("gallery_graph_jets"), boost::python::arg("probe_graph_jets"), boost::python::arg("jet_similarity_function")),
+      "Computes the similarity between the given probe graph and each graph of the gallery, which is a contiguous array of graphs (one more dimension than the probe graph). The gallery is split into chunks that are processed in parallel using n_threads threads."
   );
 
 }
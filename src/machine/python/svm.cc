@@ -94,6 +94,27 @@ static object predict_class_and_scores_n(const bob::machine::SupportVector& m,
   return make_tuple(tuple(classes), tuple(scores));
 }
 
+static object predict_class_dense(const bob::machine::SupportVector& m,
+    bob::python::const_ndarray input, size_t n_threads) {
+  blitz::Array<double,2> i_ = input.bz<double,2>();
+  bob::python::ndarray labels(bob::core::array::t_int32, i_.extent(0));
+  blitz::Array<int32_t,1> labels_ = labels.bz<int32_t,1>();
+  m.predictClassesDense(i_, labels_, n_threads);
+  return labels.self();
+}
+
+static tuple predict_class_and_scores_dense(const bob::machine::SupportVector& m,
+    bob::python::const_ndarray input, size_t n_threads) {
+  blitz::Array<double,2> i_ = input.bz<double,2>();
+  size_t size = m.outputSize() < 2 ? 1 : (m.outputSize()*(m.outputSize()-1))/2;
+  bob::python::ndarray labels(bob::core::array::t_int32, i_.extent(0));
+  blitz::Array<int32_t,1> labels_ = labels.bz<int32_t,1>();
+  bob::python::ndarray scores(bob::core::array::t_float64, i_.extent(0), size);
+  blitz::Array<double,2> scores_ = scores.bz<double,2>();
+  m.predictClassesAndScoresDense(i_, labels_, scores_, n_threads);
+  return make_tuple(labels.self(), scores.self());
+}
+
 static int predict_class_and_probs(const bob::machine::SupportVector& m,
     bob::python::const_ndarray input, bob::python::ndarray probs) {
   blitz::Array<double,1> probs_ = probs.bz<double,1>();
@@ -274,6 +295,8 @@ void bind_machine_svm() {
     .def("predict_class_and_scores", &predict_class_and_scores, (arg("self"), arg("input"), arg("scores")), "Returns the predicted class given a certain input. Returns the scores for each class in the second argument. Checks the input and output arrays for size conformity. In particular, the size of the output array should be, if ``o`` is the number of classes the machine can treat, :math:`o*(o-1)/2`. The order, as the ``libsvm`` README points out, is label[0] vs label[1], ..., label[0] vs. label[o-1], label[1] vs. label[2], ... label[o-2] vs label[o-1]. Note that when :math:`o = 1`, this function does not give any decision value. If the size is wrong, an exception is raised.")
     .def("predict_class_and_scores_", &predict_class_and_scores_, (arg("self"), arg("input"), arg("scores")), "Returns the predicted class given a certain input. Returns the scores for each class in the second argument. Checks the input and output arrays for size conformity. Does not check the input data and is, therefore, a little bit faster.")
     .def("predict_classes_and_scores", &predict_class_and_scores_n, (arg("self"), arg("input")), "Returns the predicted class and output scores as a tuple, in this order. Checks the input array for size conformity. In particular, the size of the output array should be, if ``o`` is the number of classes the machine can treat, :math:`o*(o-1)/2`. The order, as the ``libsvm`` README points out, is label[0] vs label[1], ..., label[0] vs. label[o-1], label[1] vs. label[2], ... label[o-2] vs label[o-1]. Note that when :math:`o = 1`, this function does not give any decision value. If the size is wrong, an exception is raised. This variant takes a single 2D double array as input. The samples should be organized row-wise.")
+    .def("predict_classes_dense", &predict_class_dense, (arg("self"), arg("input"), arg("n_threads")=1), "Returns the predicted classes of the rows of a 2D input array, as a 1D int32 array. Contrary to predict_classes(), which calls libsvm for each row, the kernel values between blocks of rows and all the support vectors are computed with a matrix product (and linear machines are collapsed into weight vectors), which is much faster for dense inputs. The decisions are the same as libsvm's, up to the rounding of the kernel values. The rows may be split among ``n_threads`` threads.")
+    .def("predict_classes_and_scores_dense", &predict_class_and_scores_dense, (arg("self"), arg("input"), arg("n_threads")=1), "Returns the predicted classes and output scores of the rows of a 2D input array, as a tuple containing a 1D int32 array and a 2D float64 array (one row of scores per input, in the order of predict_class_and_scores()). See predict_classes_dense() for details.")
     .def("predict_class_and_probabilities", &predict_class_and_probs2, (arg("self"), arg("input")), "Returns the predicted class and probabilities in a tuple (on that order) given a certain input. The current machine has to support probabilities, otherwise an exception is raised. Checks the input array for size conformity. If the size is wrong, an exception is raised.")
     .def("predict_class_and_probabilities", &predict_class_and_probs, (arg("self"), arg("input"), arg("probabilities")), "Returns the predicted class given a certain input. If the model supports it, returns the probabilities for each class in the second argument, otherwise raises an exception. Checks the input and output arrays for size conformity. If the size is wrong, an exception is raised.")
     .def("predict_class_and_probabilities_", &predict_class_and_probs_, (arg("self"), arg("input"), arg("probabilities")), "Returns the predicted class given a certain input. This version will not run any checks, so you must be sure to pass the correct input to the classifier.")
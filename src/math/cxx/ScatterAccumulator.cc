@@ -0,0 +1,224 @@
+/**
+ * @file math/cxx/ScatterAccumulator.cc
+ * @date Sat Oct 18 21:12:37 2026 +0200
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <stdexcept>
+#include <algorithm>
+#include <boost/format.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <bob/math/ScatterAccumulator.h>
+#include <bob/math/stats.h>
+#include <bob/core/assert.h>
+#include <bob/core/check.h>
+#include <bob/core/array_utils.h>
+
+bob::math::ScatterAccumulator::ScatterAccumulator(const size_t n_features):
+  m_n_threads(1)
+{
+  reset(n_features);
+}
+
+bob::math::ScatterAccumulator::ScatterAccumulator
+(const bob::math::ScatterAccumulator& other):
+  m_n_samples(other.m_n_samples),
+  m_mean(other.m_mean.copy()),
+  m_scatter(other.m_scatter.copy()),
+  m_n_threads(other.m_n_threads)
+{
+}
+
+bob::math::ScatterAccumulator& bob::math::ScatterAccumulator::operator=
+(const bob::math::ScatterAccumulator& other)
+{
+  if (this != &other) {
+    m_n_samples = other.m_n_samples;
+    m_mean.reference(other.m_mean.copy());
+    m_scatter.reference(other.m_scatter.copy());
+    m_n_threads = other.m_n_threads;
+  }
+  return *this;
+}
+
+bool bob::math::ScatterAccumulator::operator==
+(const bob::math::ScatterAccumulator& b) const
+{
+  return m_n_samples == b.m_n_samples &&
+    bob::core::array::isEqual(m_mean, b.m_mean) &&
+    bob::core::array::isEqual(m_scatter, b.m_scatter);
+}
+
+bool bob::math::ScatterAccumulator::operator!=
+(const bob::math::ScatterAccumulator& b) const
+{
+  return !(this->operator==(b));
+}
+
+void bob::math::ScatterAccumulator::reset(const size_t n_features)
+{
+  m_mean.resize(n_features);
+  m_scatter.resize(n_features, n_features);
+  reset();
+}
+
+void bob::math::ScatterAccumulator::reset()
+{
+  m_n_samples = 0;
+  m_mean = 0.;
+  m_scatter = 0.;
+}
+
+void bob::math::ScatterAccumulator::setNThreads(const size_t n_threads)
+{
+  if (n_threads == 0)
+    throw std::runtime_error("the number of threads should be strictly positive");
+  m_n_threads = n_threads;
+}
+
+void bob::math::ScatterAccumulator::getCovariance
+(blitz::Array<double,2>& covariance) const
+{
+  bob::core::array::assertSameShape(covariance, m_scatter);
+  if (m_n_samples < 2) {
+    boost::format m("the covariance matrix requires at least two samples (%d given)");
+    m % m_n_samples;
+    throw std::runtime_error(m.str());
+  }
+  covariance = m_scatter / (double)(m_n_samples-1);
+}
+
+void bob::math::ScatterAccumulator::accumulateStripe
+(const blitz::Array<double,2>& data_, const int begin, const int end,
+ blitz::Array<double,1>* mean, blitz::Array<double,2>* scatter)
+{
+  const blitz::Array<double,2> data = bob::core::array::private_view(data_);
+  const blitz::Array<double,2> stripe = data(blitz::Range(begin, end-1),
+    blitz::Range::all());
+
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  *mean = blitz::mean(stripe(j,i), j);
+  *scatter = 0.;
+  bob::math::detail::addScatter_(stripe, *mean, *scatter);
+}
+
+void bob::math::ScatterAccumulator::combine(const uint64_t n_a,
+  blitz::Array<double,1>& mean_a, blitz::Array<double,2>& scatter_a,
+  const uint64_t n_b, const blitz::Array<double,1>& mean_b,
+  const blitz::Array<double,2>& scatter_b)
+{
+  if (n_b == 0) return;
+  if (n_a == 0) {
+    mean_a = mean_b;
+    scatter_a = scatter_b;
+    return;
+  }
+
+  const double n = (double)n_a + (double)n_b;
+  blitz::Array<double,1> delta(mean_b - mean_a);
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  scatter_a += scatter_b + ((double)n_a * (double)n_b / n) * delta(i) * delta(j);
+  mean_a += delta * ((double)n_b / n);
+}
+
+void bob::math::ScatterAccumulator::accumulate
+(const blitz::Array<double,2>& data)
+{
+  bob::core::array::assertZeroBase(data);
+  bob::core::array::assertSameDimensionLength(data.extent(1), m_mean.extent(0));
+
+  const int n_samples = data.extent(0);
+  if (n_samples == 0) return;
+
+  // Each stripe of rows has its own mean and scatter
+  const int n_blocks = std::max(1, std::min((int)m_n_threads, n_samples));
+  const int n_features = m_mean.extent(0);
+  std::vector<blitz::Array<double,1> > means(n_blocks);
+  std::vector<blitz::Array<double,2> > scatters(n_blocks);
+  std::vector<int> bounds(n_blocks+1);
+  for (int t=0; t<n_blocks; ++t) {
+    means[t].resize(n_features);
+    scatters[t].resize(n_features, n_features);
+    bounds[t] = (int)(((int64_t)n_samples * t) / n_blocks);
+  }
+  bounds[n_blocks] = n_samples;
+
+  boost::thread_group threads;
+  for (int t=1; t<n_blocks; ++t)
+    threads.create_thread(boost::bind(&bob::math::ScatterAccumulator::accumulateStripe,
+      boost::cref(data), bounds[t], bounds[t+1], &means[t], &scatters[t]));
+  accumulateStripe(data, bounds[0], bounds[1], &means[0], &scatters[0]);
+  threads.join_all();
+
+  // Combines the stripes pairwise, then the block with the previous samples
+  for (int step=1; step<n_blocks; step*=2)
+    for (int t=0; t+step<n_blocks; t+=2*step)
+      combine(bounds[t+step]-bounds[t], means[t], scatters[t],
+        bounds[std::min(t+2*step,n_blocks)]-bounds[t+step], means[t+step],
+        scatters[t+step]);
+  combine(m_n_samples, m_mean, m_scatter, n_samples, means[0], scatters[0]);
+  m_n_samples += n_samples;
+}
+
+void bob::math::ScatterAccumulator::accumulate
+(const blitz::Array<double,1>& sample)
+{
+  blitz::Array<double,2> data(1, sample.extent(0));
+  data(0, blitz::Range::all()) = sample;
+  accumulate(data);
+}
+
+void bob::math::ScatterAccumulator::merge
+(const bob::math::ScatterAccumulator& other)
+{
+  bob::core::array::assertSameDimensionLength(other.getNFeatures(),
+    getNFeatures());
+  combine(m_n_samples, m_mean, m_scatter, other.m_n_samples, other.m_mean,
+    other.m_scatter);
+  m_n_samples += other.m_n_samples;
+}
+
+void bob::math::scatters(
+  const std::vector<bob::math::ScatterAccumulator>& classes,
+  blitz::Array<double,2>& Sw, blitz::Array<double,2>& Sb,
+  blitz::Array<double,1>& m)
+{
+  if (classes.empty())
+    throw std::runtime_error("the scatter matrices require at least one class");
+  const size_t n_features = classes[0].getNFeatures();
+  uint64_t n_samples = 0;
+  for (size_t k=0; k<classes.size(); ++k) {
+    bob::core::array::assertSameDimensionLength(classes[k].getNFeatures(),
+      n_features);
+    n_samples += classes[k].getNSamples();
+  }
+  if (n_samples == 0)
+    throw std::runtime_error("the scatter matrices require at least one accumulated sample");
+  bob::core::array::assertSameDimensionLength(m.extent(0), n_features);
+  bob::core::array::assertSameDimensionLength(Sw.extent(0), n_features);
+  bob::core::array::assertSameDimensionLength(Sw.extent(1), n_features);
+  bob::core::array::assertSameDimensionLength(Sb.extent(0), n_features);
+  bob::core::array::assertSameDimensionLength(Sb.extent(1), n_features);
+
+  // overall mean
+  m = 0.;
+  for (size_t k=0; k<classes.size(); ++k)
+    m += (double)classes[k].getNSamples() * classes[k].getMean();
+  m /= (double)n_samples;
+
+  // within class scatter Sw, and between class scatter Sb
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  Sw = 0.;
+  Sb = 0.;
+  blitz::Array<double,1> buffer(n_features);
+  for (size_t k=0; k<classes.size(); ++k) {
+    Sw += classes[k].getScatter();
+    buffer = m - classes[k].getMean();
+    Sb += (double)classes[k].getNSamples() * buffer(i) * buffer(j);
+  }
+}
@@ -0,0 +1,134 @@
+/**
+ * @file math/cxx/gemm.cc
+ * @date Sat Oct 18 18:02:44 2026 +0200
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <stdexcept>
+#include <algorithm>
+#include <boost/format.hpp>
+#include <bob/math/gemm.h>
+#include <bob/core/assert.h>
+#include <bob/core/array_copy.h>
+
+// Declaration of the external BLAS function
+// General matrix-matrix product (dgemm)
+extern "C" void dgemm_( const char *transa, const char *transb, const int *M,
+  const int *N, const int *K, const double *alpha, const double *A,
+  const int *lda, const double *B, const int *ldb, const double *beta,
+  double *C, const int *ldc);
+// Symmetric rank-k update (dsyrk)
+extern "C" void dsyrk_( const char *uplo, const char *trans, const int *N,
+  const int *K, const double *alpha, const double *A, const int *lda,
+  const double *beta, double *C, const int *ldc);
+
+/**
+ * Tells if the rows of a matrix are contiguous and laid out with a
+ * positive stride, as BLAS expects them (once the matrix is seen as a
+ * column-major one).
+ */
+static bool isBlasCompatible(const blitz::Array<double,2>& A)
+{
+  return A.stride(1) == 1 && A.stride(0) >= std::max(1, A.extent(1));
+}
+
+void bob::math::gemm(const blitz::Array<double,2>& A,
+  const blitz::Array<double,2>& B, blitz::Array<double,2>& C,
+  const bool transA, const bool transB, const double alpha, const double beta)
+{
+  bob::core::array::assertZeroBase(A);
+  bob::core::array::assertZeroBase(B);
+  bob::core::array::assertZeroBase(C);
+
+  const int M = transA ? A.extent(1) : A.extent(0);
+  const int K = transA ? A.extent(0) : A.extent(1);
+  const int KB = transB ? B.extent(1) : B.extent(0);
+  const int N = transB ? B.extent(0) : B.extent(1);
+  if (K != KB) {
+    boost::format m("inner dimensions of the matrix product do not match (%d != %d)");
+    m % K % KB;
+    throw std::runtime_error(m.str());
+  }
+  bob::core::array::assertSameDimensionLength(C.extent(0), M);
+  bob::core::array::assertSameDimensionLength(C.extent(1), N);
+
+  bob::math::gemm_(A, B, C, transA, transB, alpha, beta);
+}
+
+void bob::math::gemm_(const blitz::Array<double,2>& A,
+  const blitz::Array<double,2>& B, blitz::Array<double,2>& C,
+  const bool transA, const bool transB, const double alpha, const double beta)
+{
+  const int M = C.extent(0);
+  const int N = C.extent(1);
+  const int K = transA ? A.extent(0) : A.extent(1);
+  if (M == 0 || N == 0) return;
+
+  // Uses the arrays directly if possible, copies them otherwise
+  const blitz::Array<double,2> A_blas = isBlasCompatible(A) ? A :
+    bob::core::array::ccopy(A);
+  const blitz::Array<double,2> B_blas = isBlasCompatible(B) ? B :
+    bob::core::array::ccopy(B);
+  const bool C_direct_use = isBlasCompatible(C);
+  blitz::Array<double,2> C_blas;
+  if (C_direct_use) C_blas.reference(C);
+  else C_blas.reference(bob::core::array::ccopy(C));
+
+  // A row-major matrix is the transpose of a column-major one. Hence, BLAS
+  // computes C^T = op(B)^T * op(A)^T, and the operands are swapped.
+  const char ta = transA ? 'T' : 'N';
+  const char tb = transB ? 'T' : 'N';
+  const int lda = std::max(1, A_blas.stride(0));
+  const int ldb = std::max(1, B_blas.stride(0));
+  const int ldc = std::max(1, C_blas.stride(0));
+  dgemm_(&tb, &ta, &N, &M, &K, &alpha, B_blas.data(), &ldb, A_blas.data(),
+    &lda, &beta, C_blas.data(), &ldc);
+
+  if (!C_direct_use) C = C_blas;
+}
+
+void bob::math::syrk(const blitz::Array<double,2>& A,
+  blitz::Array<double,2>& C, const double alpha, const double beta)
+{
+  bob::core::array::assertZeroBase(A);
+  bob::core::array::assertZeroBase(C);
+  bob::core::array::assertSameDimensionLength(C.extent(0), A.extent(1));
+  bob::core::array::assertSameDimensionLength(C.extent(1), A.extent(1));
+
+  bob::math::syrk_(A, C, alpha, beta);
+}
+
+void bob::math::syrk_(const blitz::Array<double,2>& A,
+  blitz::Array<double,2>& C, const double alpha, const double beta)
+{
+  const int N = C.extent(0);
+  const int K = A.extent(0);
+  if (N == 0) return;
+
+  // Uses the arrays directly if possible, copies them otherwise
+  const blitz::Array<double,2> A_blas = isBlasCompatible(A) ? A :
+    bob::core::array::ccopy(A);
+  const bool C_direct_use = isBlasCompatible(C);
+  blitz::Array<double,2> C_blas;
+  if (C_direct_use) C_blas.reference(C);
+  else C_blas.reference(bob::core::array::ccopy(C));
+
+  // Seen as a column-major matrix, A is A^T, and BLAS computes A^T*A without
+  // transposition. The upper triangle of the column-major C is the lower
+  // triangle of the row-major one.
+  const char uplo = 'U';
+  const char trans = 'N';
+  const int lda = std::max(1, A_blas.stride(0));
+  const int ldc = std::max(1, C_blas.stride(0));
+  dsyrk_(&uplo, &trans, &N, &K, &alpha, A_blas.data(), &lda, &beta,
+    C_blas.data(), &ldc);
+
+  // Copies the lower triangle into the upper one
+  double* c = C_blas.data();
+  for (int i=0; i<N; ++i)
+    for (int j=i+1; j<N; ++j)
+      c[i*ldc+j] = c[j*ldc+i];
+
+  if (!C_direct_use) C = C_blas;
+}
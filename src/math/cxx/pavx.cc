@@ -16,65 +16,71 @@ void bob::math::pavx(const blitz::Array<double,1>& y, blitz::Array<double,1>& gh
   math::pavx_(y, ghat);
 }
 
-static size_t pavx_1(const blitz::Array<double,1>& y, blitz::Array<double,1>& ghat,
-  blitz::Array<size_t,1>& index, blitz::Array<size_t,1>& len)
+size_t bob::math::pavxBins_(const blitz::Array<double,1>& y,
+  blitz::Array<double,1>& height, blitz::Array<size_t,1>& width)
 {
-  // Sets output and working arrays to 0
-  index = 0;
-  len = 0;
-  ghat = 0.;
-
-  // ci is the index of the interval currently considered 
-  // ghat(ci) is the mean of y-values within this interval
+  const double* y_ = y.data();
+  double* h_ = height.data();
+  size_t* w_ = width.data();
+  const int sy = y.stride(0);
+  const int sh = height.stride(0);
+  const int sw = width.stride(0);
+
+  // ci is the index of the bin currently considered (the top of the stack)
+  // h_[ci] is the mean of the y-values within this bin, and w_[ci] its
+  // width. As ci <= j, the bins can overwrite y if height and y are the
+  // same array.
   size_t ci = 0;
-  index(ci) = 0;
-  len(ci) = 1;
-  ghat(ci) = y(ci);
-  for (int j=1; j<y.extent(0); ++j)
+  h_[0] = y_[0];
+  w_[0] = 1;
+  const int N = y.extent(0);
+  for (int j=1; j<N; ++j)
   {
-    // a new index interval "j" is created:
+    // a new bin "j" is created:
     ++ci;
-    index(ci) = j;
-    len(ci) = 1;
-    ghat(ci) = y(j);
-    while (ci >= 1 && ghat(std::max((int)ci-1,0)) >= ghat(ci))
+    double h = y_[j*sy];
+    size_t w = 1;
+    while (ci >= 1 && h_[(ci-1)*sh] >= h)
     {
       // "pool adjacent violators"
-      double nw = len(ci-1) + len(ci);
-      ghat(ci-1) += (len(ci) / nw) * (ghat(ci) - ghat(ci-1));
-      len(ci-1) = (size_t)nw;
+      const size_t wp = w_[(ci-1)*sw];
+      const double nw = wp + w;
+      h = h_[(ci-1)*sh] + (w / nw) * (h - h_[(ci-1)*sh]);
+      w = wp + w;
       --ci;
     }
+    h_[ci*sh] = h;
+    w_[ci*sw] = w;
   }
-  return ci;
+  return ci + 1;
 }
 
-static void pavx_2(blitz::Array<double,1>& ghat, blitz::Array<size_t,1>& index, size_t ci)
+/**
+ * Expands the bins (stored at the beginning of ghat) to all the indices,
+ * from right to left, such that each bin is read before being overwritten
+ */
+static void pavx_expand(blitz::Array<double,1>& ghat,
+  const blitz::Array<size_t,1>& width, size_t nbins)
 {
-  // define ghat for all indices
-  int n = index.extent(0);
-  while (n >= 1)
+  double* g_ = ghat.data();
+  const int sg = ghat.stride(0);
+  size_t end = ghat.extent(0);
+  while (nbins > 0)
   {
-    blitz::Range r((int)index(ci),n-1);
-    ghat(r) = ghat(ci);
-    n = index(ci);
-    --ci;
+    --nbins;
+    const double h = g_[nbins*sg];
+    const size_t begin = end - width(nbins);
+    for (size_t i=begin; i<end; ++i) g_[i*sg] = h;
+    end = begin;
   }
 }
 
 void bob::math::pavx_(const blitz::Array<double,1>& y, blitz::Array<double,1>& ghat)
 {
-  // Define working arrays: An interval of indices is represented by its left
-  // endpoint "index" and its length "len" 
-  int N = y.extent(0);
-  blitz::Array<size_t,1> index(N);
-  blitz::Array<size_t,1> len(N);
-
-  // First step
-  size_t ci = pavx_1(y, ghat, index, len);
-
-  // Second step
-  pavx_2(ghat, index, ci);
+  // The bins are pooled in ghat, and their widths in a working array
+  blitz::Array<size_t,1> width(y.extent(0));
+  size_t nbins = pavxBins_(y, ghat, width);
+  pavx_expand(ghat, width, nbins);
 }
 
 blitz::Array<size_t,1> bob::math::pavxWidth(const blitz::Array<double,1>& y, blitz::Array<double,1>& ghat)
@@ -83,23 +89,14 @@ blitz::Array<size_t,1> bob::math::pavxWidth(const blitz::Array<double,1>& y, bli
   bob::core::array::assertSameShape(y, ghat);
   assert(y.extent(0) > 0);
 
-  // Define working arrays: An interval of indices is represented by its left
-  // endpoint "index" and its length "len" 
-  int N = y.extent(0);
-  blitz::Array<size_t,1> index(N);
-  blitz::Array<size_t,1> len(N);
-
-  // First step
-  size_t ci = pavx_1(y, ghat, index, len);
+  // First step: pool the bins
+  blitz::Array<size_t,1> width(y.extent(0));
+  size_t nbins = pavxBins_(y, ghat, width);
 
-  // Get the width vector
-  blitz::Array<size_t,1> width(ci+1);
-  width = len(blitz::Range(0,ci));
-  
-  // Second step
-  pavx_2(ghat, index, ci);
+  // Second step: define ghat for all indices
+  pavx_expand(ghat, width, nbins);
 
-  return width;
+  return width(blitz::Range(0,nbins-1)).copy();
 }
 
 std::pair<blitz::Array<size_t,1>,blitz::Array<double,1> > bob::math::pavxWidthHeight(const blitz::Array<double,1>& y, blitz::Array<double,1>& ghat)
@@ -108,23 +105,13 @@ std::pair<blitz::Array<size_t,1>,blitz::Array<double,1> > bob::math::pavxWidthHe
   bob::core::array::assertSameShape(y, ghat);
   assert(y.extent(0) > 0);
 
-  // Define working arrays: An interval of indices is represented by its left
-  // endpoint "index" and its length "len" 
-  int N = y.extent(0);
-  blitz::Array<size_t,1> index(N);
-  blitz::Array<size_t,1> len(N);
-
-  // First step
-  size_t ci = pavx_1(y, ghat, index, len);
+  // First step: pool the bins
+  blitz::Array<size_t,1> width(y.extent(0));
+  size_t nbins = pavxBins_(y, ghat, width);
+  blitz::Array<double,1> height = ghat(blitz::Range(0,nbins-1)).copy();
 
-  // Get the width vector
-  blitz::Array<size_t,1> width(ci+1);
-  width = len(blitz::Range(0,ci));
-  blitz::Array<double,1> height(ci+1);
-  height = ghat(blitz::Range(0,ci));
-  
-  // Second step
-  pavx_2(ghat, index, ci);
+  // Second step: define ghat for all indices
+  pavx_expand(ghat, width, nbins);
 
-  return std::make_pair(width,height);
+  return std::make_pair(width(blitz::Range(0,nbins-1)).copy(), height);
 }
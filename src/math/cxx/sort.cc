@@ -0,0 +1,227 @@
+/**
+ * @file math/cxx/sort.cc
+ * @date Sun Oct 18 21:10:42 2026 +0200
+ *
+ * @brief Implements the sorting of scores with permutation, using a radix
+ * sort for large arrays
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob/math/sort.h>
+#include <bob/core/assert.h>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <boost/cstdint.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+
+/**
+ * The keys are sorted by digits of 11 bits, such that 6 passes cover the 64
+ * bits of the keys, and the counts of each pass (2048) fit in the L1 cache
+ */
+static const int RADIX_BITS = 11;
+static const size_t RADIX_SIZE = (size_t)1 << RADIX_BITS;
+static const size_t RADIX_MASK = RADIX_SIZE - 1;
+static const int RADIX_PASSES = 6;
+
+/**
+ * Arrays smaller than this are sorted with std::stable_sort, and each thread
+ * processes at least this number of values
+ */
+static const size_t RADIX_MIN = 4096;
+
+static const uint64_t SIGN_BIT = (uint64_t)1 << 63;
+
+/**
+ * Maps a double to an unsigned integer key with the same order: the sign
+ * bit of positive values is set, and all the bits of the negative values are
+ * flipped
+ */
+static inline uint64_t double2key(double v)
+{
+  if (v == 0.) v = 0.; // -0. and 0. have the same key
+  uint64_t u;
+  std::memcpy(&u, &v, sizeof(u));
+  return (u & SIGN_BIT) ? ~u : (u | SIGN_BIT);
+}
+
+static inline double key2double(uint64_t u)
+{
+  u = (u & SIGN_BIT) ? (u & ~SIGN_BIT) : ~u;
+  double v;
+  std::memcpy(&v, &u, sizeof(v));
+  return v;
+}
+
+/**
+ * Beginning of the part t (out of n) of N elements
+ */
+static inline size_t part(const size_t N, const size_t t, const size_t n)
+{
+  return (size_t)((uint64_t)N * t / n);
+}
+
+/**
+ * Runs f(t, begin, end) on n contiguous parts of N elements, the first one
+ * on the current thread
+ */
+template <typename F>
+static void parallel_for(const F& f, const size_t N, const size_t n)
+{
+  boost::thread_group threads;
+  for (size_t t=1; t<n; ++t)
+    threads.create_thread(boost::bind<void>(f, t, part(N, t, n),
+      part(N, t+1, n)));
+  f((size_t)0, (size_t)0, part(N, 1, n));
+  threads.join_all();
+}
+
+/**
+ * Computes the keys of the values, and counts their digits for all the
+ * passes
+ */
+static void make_keys(const blitz::Array<double,1>* values, uint64_t* keys,
+  size_t* index, std::vector<size_t>* counts, const size_t t,
+  const size_t begin, const size_t end)
+{
+  const double* v = values->data();
+  const int s = values->stride(0);
+  size_t* c = &(*counts)[t * RADIX_PASSES * RADIX_SIZE];
+  for (size_t i=begin; i<end; ++i) {
+    const uint64_t k = double2key(v[i*s]);
+    keys[i] = k;
+    index[i] = i;
+    for (int p=0; p<RADIX_PASSES; ++p)
+      ++c[p*RADIX_SIZE + ((k >> (p*RADIX_BITS)) & RADIX_MASK)];
+  }
+}
+
+/**
+ * Counts the digits of a single pass
+ */
+static void count_digits(const uint64_t* keys, std::vector<size_t>* counts,
+  const int p, const size_t t, const size_t begin, const size_t end)
+{
+  size_t* c = &(*counts)[(t * RADIX_PASSES + p) * RADIX_SIZE];
+  std::fill(c, c + RADIX_SIZE, 0);
+  const int shift = p * RADIX_BITS;
+  for (size_t i=begin; i<end; ++i)
+    ++c[(keys[i] >> shift) & RADIX_MASK];
+}
+
+/**
+ * Moves the keys (and their indices) to their position for the given pass,
+ * starting at the offsets of the part
+ */
+static void scatter(const uint64_t* keys, const size_t* index,
+  uint64_t* keys_out, size_t* index_out, std::vector<size_t>* offsets,
+  const int p, const size_t t, const size_t begin, const size_t end)
+{
+  size_t* o = &(*offsets)[t * RADIX_SIZE];
+  const int shift = p * RADIX_BITS;
+  for (size_t i=begin; i<end; ++i) {
+    const size_t j = o[(keys[i] >> shift) & RADIX_MASK]++;
+    keys_out[j] = keys[i];
+    index_out[j] = index[i];
+  }
+}
+
+static void write_sorted(const uint64_t* keys, const size_t* index,
+  blitz::Array<double,1>* sorted, blitz::Array<size_t,1>* permutation,
+  const size_t, const size_t begin, const size_t end)
+{
+  for (size_t i=begin; i<end; ++i) {
+    (*sorted)(i) = key2double(keys[i]);
+    (*permutation)(i) = index[i];
+  }
+}
+
+/**
+ * Compares the indices of two values
+ */
+struct CompareIndices
+{
+  CompareIndices(const blitz::Array<double,1>& values): m_values(values) {}
+  bool operator()(const size_t a, const size_t b) const
+  { return m_values(a) < m_values(b); }
+  const blitz::Array<double,1>& m_values;
+};
+
+void bob::math::sortWithPermutation(const blitz::Array<double,1>& values,
+  blitz::Array<double,1>& sorted, blitz::Array<size_t,1>& permutation,
+  const size_t n_threads)
+{
+  bob::core::array::assertSameShape(values, sorted);
+  bob::core::array::assertSameShape(values, permutation);
+  if (n_threads == 0)
+    throw std::runtime_error("the number of threads should be strictly positive");
+  bob::math::sortWithPermutation_(values, sorted, permutation, n_threads);
+}
+
+void bob::math::sortWithPermutation_(const blitz::Array<double,1>& values,
+  blitz::Array<double,1>& sorted, blitz::Array<size_t,1>& permutation,
+  const size_t n_threads)
+{
+  const size_t N = values.extent(0);
+
+  if (N < RADIX_MIN) {
+    std::vector<size_t> index(N);
+    for (size_t i=0; i<N; ++i) index[i] = i;
+    std::stable_sort(index.begin(), index.end(), CompareIndices(values));
+    for (size_t i=0; i<N; ++i) {
+      permutation(i) = index[i];
+      sorted(i) = values(index[i]);
+    }
+    return;
+  }
+
+  // The keys and their indices, with a second buffer for the scattering
+  const size_t n = std::max((size_t)1, std::min(n_threads, N / RADIX_MIN));
+  std::vector<uint64_t> keys(2*N);
+  std::vector<size_t> index(2*N);
+  std::vector<size_t> counts(n * RADIX_PASSES * RADIX_SIZE, 0);
+  parallel_for(boost::bind(&make_keys, &values, &keys[0], &index[0], &counts,
+    _1, _2, _3), N, n);
+
+  std::vector<size_t> totals(RADIX_PASSES * RADIX_SIZE, 0);
+  for (size_t t=0; t<n; ++t)
+    for (size_t k=0; k<totals.size(); ++k)
+      totals[k] += counts[t * RADIX_PASSES * RADIX_SIZE + k];
+
+  std::vector<size_t> offsets(n * RADIX_SIZE);
+  size_t src = 0;
+  bool moved = false;
+  for (int p=0; p<RADIX_PASSES; ++p) {
+    const size_t* total = &totals[p * RADIX_SIZE];
+    const uint64_t* keys_in = &keys[src*N];
+
+    // Skips the passes where all the keys have the same digit (e.g. the
+    // high bits of scores within the same range)
+    if (total[(keys_in[0] >> (p*RADIX_BITS)) & RADIX_MASK] == N) continue;
+
+    // The counts of the parts change once the keys have been moved
+    if (moved && n > 1)
+      parallel_for(boost::bind(&count_digits, keys_in, &counts, p,
+        _1, _2, _3), N, n);
+
+    // Each part starts after the smaller digits, and after the same digit
+    // in the previous parts, such that the sort is stable
+    size_t offset = 0;
+    for (size_t d=0; d<RADIX_SIZE; ++d)
+      for (size_t t=0; t<n; ++t) {
+        offsets[t * RADIX_SIZE + d] = offset;
+        offset += counts[(t * RADIX_PASSES + p) * RADIX_SIZE + d];
+      }
+
+    parallel_for(boost::bind(&scatter, keys_in, &index[src*N],
+      &keys[(1-src)*N], &index[(1-src)*N], &offsets, p, _1, _2, _3), N, n);
+    src = 1 - src;
+    moved = true;
+  }
+
+  parallel_for(boost::bind(&write_sorted, &keys[src*N], &index[src*N],
+    &sorted, &permutation, _1, _2, _3), N, n);
+}
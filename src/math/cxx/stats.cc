@@ -0,0 +1,33 @@
+/**
+ * @file math/cxx/stats.cc
+ * @date Sat Oct 18 21:12:37 2026 +0200
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <algorithm>
+#include <bob/math/stats.h>
+#include <bob/math/gemm.h>
+
+/**
+ * Number of centered rows gathered before each symmetric rank-k update
+ */
+static const int SCATTER_BLOCK_SIZE = 256;
+
+void bob::math::detail::addScatter_(const blitz::Array<double,2>& A,
+  const blitz::Array<double,1>& M, blitz::Array<double,2>& S)
+{
+  const int n_samples = A.extent(0);
+  const int n_features = A.extent(1);
+  if (n_samples == 0 || n_features == 0) return;
+
+  blitz::Range a = blitz::Range::all();
+  const int block_size = std::min(n_samples, SCATTER_BLOCK_SIZE);
+  blitz::Array<double,2> buffer(block_size, n_features);
+  for (int start=0; start<n_samples; start+=block_size) {
+    const int n_rows = std::min(block_size, n_samples-start);
+    blitz::Array<double,2> block = buffer(blitz::Range(0,n_rows-1), a);
+    for (int z=0; z<n_rows; ++z) block(z,a) = A(start+z,a) - M;
+    bob::math::syrk_(block, S, 1., 1.);
+  }
+}
@@ -0,0 +1,133 @@
+/**
+ * @file math/cxx/test/ScatterAccumulator.cc
+ * @date Sat Oct 18 21:12:37 2026 +0200
+ *
+ * @brief Test the accumulation of the scatter matrices by blocks
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE math-ScatterAccumulator Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <blitz/array.h>
+#include <bob/math/stats.h>
+#include <bob/math/ScatterAccumulator.h>
+#include <vector>
+#include <algorithm>
+
+struct T {
+  double eps;
+
+  T(): eps(1e-8)
+  {
+  }
+
+  ~T() {}
+};
+
+template<typename T>
+void checkBlitzClose( const blitz::Array<T,1>& t1, const blitz::Array<T,1>& t2,
+  const double eps )
+{
+  BOOST_REQUIRE_EQUAL(t1.extent(0), t2.extent(0));
+  for( int i=0; i<t1.extent(0); ++i)
+    BOOST_CHECK_SMALL( fabs( t2(i)-t1(i) ), eps);
+}
+
+template<typename T>
+void checkBlitzClose( const blitz::Array<T,2>& t1, const blitz::Array<T,2>& t2,
+  const double eps )
+{
+  BOOST_REQUIRE_EQUAL(t1.extent(0), t2.extent(0));
+  BOOST_REQUIRE_EQUAL(t1.extent(1), t2.extent(1));
+  for( int i=0; i<t1.extent(0); ++i)
+    for( int j=0; j<t1.extent(1); ++j)
+      BOOST_CHECK_SMALL( fabs( t2(i,j)-t1(i,j) ), eps);
+}
+
+static blitz::Array<double,2> randomData(const int M, const int N)
+{
+  blitz::Array<double,2> t(M,N);
+  for (int i=0; i < M; ++i)
+    for (int j=0; j < N; ++j)
+      t(i,j) = (rand()/(double)RAND_MAX)*10. + 1000.;
+  return t;
+}
+
+BOOST_FIXTURE_TEST_SUITE( test_setup, T )
+
+BOOST_AUTO_TEST_CASE( test_scatter_accumulator )
+{
+  for (int loop=0; loop < 10; ++loop) {
+    const int M = (rand() % 600 + 2);
+    const int N = (rand() % 32 + 1);
+    blitz::Array<double,2> data = randomData(M,N);
+
+    // Reference: the scatter matrix of the whole data set
+    blitz::Array<double,1> mean(N);
+    blitz::Array<double,2> S(N,N);
+    bob::math::scatter(data, S, mean);
+
+    // The same in blocks of random sizes, with several threads
+    bob::math::ScatterAccumulator acc(N);
+    acc.setNThreads(loop % 4 + 1);
+    for (int start=0; start<M; ) {
+      const int end = std::min(M, start + rand() % 100 + 1);
+      acc.accumulate(data(blitz::Range(start,end-1), blitz::Range::all()).copy());
+      start = end;
+    }
+    BOOST_CHECK_EQUAL(acc.getNSamples(), (uint64_t)M);
+    checkBlitzClose(mean, acc.getMean(), eps);
+    checkBlitzClose(S, acc.getScatter(), 1e-6 * M);
+
+    blitz::Array<double,2> cov(N,N);
+    acc.getCovariance(cov);
+    checkBlitzClose(blitz::Array<double,2>(S / (M-1.)), cov, 1e-6);
+
+    // Merged accumulators, and sample by sample accumulation
+    bob::math::ScatterAccumulator acc1(N), acc2(N);
+    const int half = M / 2;
+    for (int i=0; i<half; ++i)
+      acc1.accumulate(data(i, blitz::Range::all()));
+    acc2.accumulate(data(blitz::Range(half,M-1), blitz::Range::all()).copy());
+    acc1.merge(acc2);
+    BOOST_CHECK_EQUAL(acc1.getNSamples(), (uint64_t)M);
+    checkBlitzClose(mean, acc1.getMean(), eps);
+    checkBlitzClose(S, acc1.getScatter(), 1e-6 * M);
+  }
+
+  bob::math::ScatterAccumulator acc(3);
+  BOOST_CHECK_THROW(acc.setNThreads(0), std::runtime_error);
+  blitz::Array<double,2> cov(3,3);
+  BOOST_CHECK_THROW(acc.getCovariance(cov), std::runtime_error);
+  blitz::Array<double,2> wrong(2,4);
+  BOOST_CHECK_THROW(acc.accumulate(wrong), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE( test_scatters_accumulator )
+{
+  const int N = 7;
+  std::vector<blitz::Array<double,2> > data;
+  std::vector<bob::math::ScatterAccumulator> classes;
+  for (int k=0; k<3; ++k) {
+    data.push_back(randomData(rand() % 50 + 2, N));
+    classes.push_back(bob::math::ScatterAccumulator(N));
+    classes[k].accumulate(data[k]);
+  }
+
+  blitz::Array<double,1> m(N), m_acc(N);
+  blitz::Array<double,2> Sw(N,N), Sb(N,N), Sw_acc(N,N), Sb_acc(N,N);
+  bob::math::scatters(data, Sw, Sb, m);
+  bob::math::scatters(classes, Sw_acc, Sb_acc, m_acc);
+  checkBlitzClose(m, m_acc, eps);
+  checkBlitzClose(Sw, Sw_acc, 1e-6);
+  checkBlitzClose(Sb, Sb_acc, 1e-6);
+
+  // Nothing accumulated
+  std::vector<bob::math::ScatterAccumulator> empty(2, bob::math::ScatterAccumulator(N));
+  BOOST_CHECK_THROW(bob::math::scatters(empty, Sw_acc, Sb_acc, m_acc), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
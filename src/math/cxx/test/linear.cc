@@ -13,6 +13,7 @@
 #define BOOST_TEST_MAIN
 #include <boost/test/unit_test.hpp>
 #include <bob/math/linear.h>
+#include <bob/math/gemm.h>
 
 
 struct T {
@@ -99,6 +100,52 @@ BOOST_AUTO_TEST_CASE( test_matrix_matrix_prod )
   checkBlitzClose( A_23, sol, eps);
 }
 
+BOOST_AUTO_TEST_CASE( test_matrix_matrix_gemm )
+{
+  blitz::Array<double,2> sol(2,3);
+  bob::math::gemm( A_24, A_43, sol);
+  checkBlitzClose( A_23, sol, eps);
+
+  // Transposed operands, and non contiguous ones
+  blitz::Array<double,2> A_42 = A_24.copy().transpose(1,0);
+  blitz::Array<double,2> A_34 = A_43.copy().transpose(1,0);
+  bob::math::gemm( A_42, A_34, sol, true, true);
+  checkBlitzClose( A_23, sol, eps);
+
+  // Transposed (non contiguous) output and accumulation
+  blitz::Array<double,2> solt(3,2);
+  solt = 1.;
+  blitz::Array<double,2> solt_t = solt.transpose(1,0);
+  bob::math::gemm( A_24, A_43, solt_t, false, false, 2., 1.);
+  blitz::Array<double,2> ref(2,3);
+  ref = 2.*A_23 + 1.;
+  checkBlitzClose( ref, solt_t, eps);
+
+  // Inconsistent sizes
+  blitz::Array<double,2> sol_w(3,3);
+  BOOST_CHECK_THROW( bob::math::gemm( A_24, A_43, sol_w), std::runtime_error);
+  BOOST_CHECK_THROW( bob::math::gemm( A_24, A_43, sol, true), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE( test_matrix_syrk )
+{
+  // Same as gemm with the transposed matrix as first operand
+  blitz::Array<double,2> ref(3,3), sol(3,3);
+  bob::math::gemm( A_43, A_43, ref, true, false);
+  bob::math::syrk( A_43, sol);
+  checkBlitzClose( ref, sol, eps);
+
+  // Non contiguous input and accumulation
+  blitz::Array<double,2> A_43t = A_43.copy().transpose(1,0).copy().transpose(1,0);
+  bob::math::syrk( A_43t, sol, 2., 1.);
+  ref *= 3.;
+  checkBlitzClose( ref, sol, eps);
+
+  // Inconsistent sizes
+  blitz::Array<double,2> sol_w(4,4);
+  BOOST_CHECK_THROW( bob::math::syrk( A_43, sol_w), std::runtime_error);
+}
+
 BOOST_AUTO_TEST_CASE( test_matrix_vector_prod )
 {
   blitz::Array<double,1> sol(2);
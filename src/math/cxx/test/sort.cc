@@ -0,0 +1,84 @@
+/**
+ * @file math/cxx/test/sort.cc
+ * @date Sun Oct 18 21:10:42 2026 +0200
+ *
+ * @brief Test the sorting of scores with permutation
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE math-sort Tests
+#define BOOST_TEST_MAIN
+
+#include <boost/test/unit_test.hpp>
+#include <boost/random.hpp>
+#include <algorithm>
+#include <vector>
+#include "bob/math/sort.h"
+
+struct CompareIndices {
+  CompareIndices(const blitz::Array<double,1>& v): m_v(v) {}
+  bool operator()(size_t a, size_t b) const { return m_v(a) < m_v(b); }
+  const blitz::Array<double,1>& m_v;
+};
+
+/**
+ * Compares the sort to std::stable_sort, with the given number of threads
+ */
+void check_sort(const blitz::Array<double,1>& values, const size_t n_threads)
+{
+  const int N = values.extent(0);
+  std::vector<size_t> ref(N);
+  for (int i=0; i<N; ++i) ref[i] = i;
+  std::stable_sort(ref.begin(), ref.end(), CompareIndices(values));
+
+  blitz::Array<double,1> sorted(N);
+  blitz::Array<size_t,1> permutation(N);
+  bob::math::sortWithPermutation(values, sorted, permutation, n_threads);
+  for (int i=0; i<N; ++i) {
+    BOOST_CHECK_EQUAL(permutation(i), ref[i]);
+    BOOST_CHECK_EQUAL(sorted(i), values(ref[i]));
+  }
+}
+
+struct T {
+  boost::mt19937 rng;
+  blitz::Array<double,1> small, large, ties;
+
+  T(): small(7), large(20000), ties(20000)
+  {
+    small = 3., -1., 0., 2.5, -1., -7.25, 3.;
+    boost::normal_distribution<> normal(0., 100.);
+    boost::variate_generator<boost::mt19937&, boost::normal_distribution<> > gen(rng, normal);
+    for (int i=0; i<large.extent(0); ++i) large(i) = gen();
+    // few distinct values, both signs and zeros of both signs
+    for (int i=0; i<ties.extent(0); ++i) {
+      const double v[] = {-1e300, -2.5, -0., 0., 1e-300, 4., 1e300};
+      ties(i) = v[i*7919 % 7];
+    }
+  }
+
+  ~T() {}
+};
+
+BOOST_FIXTURE_TEST_SUITE( test_setup, T )
+
+BOOST_AUTO_TEST_CASE( test_sort_small )
+{
+  check_sort(small, 1);
+}
+
+BOOST_AUTO_TEST_CASE( test_sort_radix )
+{
+  check_sort(large, 1);
+  check_sort(ties, 1);
+}
+
+BOOST_AUTO_TEST_CASE( test_sort_radix_threads )
+{
+  check_sort(large, 3);
+  check_sort(ties, 4);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -16,6 +16,7 @@ void bind_math_norminv();
 void bind_math_stats();
 void bind_math_histogram();
 void bind_math_pavx();
+void bind_math_sort();
 
 BOOST_PYTHON_MODULE(_math) {
   boost::python::docstring_options docopt(true, true, false);
@@ -27,4 +28,5 @@ BOOST_PYTHON_MODULE(_math) {
   bind_math_stats();
   bind_math_histogram();
   bind_math_pavx();
+  bind_math_sort();
 }
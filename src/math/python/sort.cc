@@ -0,0 +1,36 @@
+/**
+ * @file math/python/sort.cc
+ * @date Sun Oct 18 21:10:42 2026 +0200
+ *
+ * @brief Binds the sorting of scores with permutation
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "bob/math/sort.h"
+
+#include "bob/python/ndarray.h"
+#include "bob/core/cast.h"
+
+using namespace boost::python;
+
+static const char* SORT_DOC = "Sorts the values in increasing order, keeping equal values in their original order (as a stable sort). Returns a tuple with the sorted values and the permutation (the index of each sorted value in the input). Large arrays are sorted with a radix sort, using the given number of threads. -0. and 0. are considered equal, and the values should not be NaN.";
+
+static object p_sortWithPermutation(bob::python::const_ndarray values,
+  const size_t n_threads)
+{
+  const bob::core::array::typeinfo& info = values.type();
+  bob::python::ndarray sorted(bob::core::array::t_float64, info.shape[0]);
+  blitz::Array<double,1> sorted_ = sorted.bz<double,1>();
+  blitz::Array<size_t,1> p_(info.shape[0]);
+  bob::math::sortWithPermutation(values.bz<double,1>(), sorted_, p_, n_threads);
+  bob::python::ndarray permutation(bob::core::array::t_uint64, info.shape[0]);
+  blitz::Array<uint64_t,1> permutation_ = permutation.bz<uint64_t,1>();
+  permutation_ = bob::core::array::cast<uint64_t>(p_);
+  return make_tuple(sorted, permutation);
+}
+
+void bind_math_sort()
+{
+  def("sortWithPermutation", &p_sortWithPermutation, (arg("values"), arg("n_threads")=1), SORT_DOC);
+}
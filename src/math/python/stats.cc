@@ -12,6 +12,7 @@
 #include <bob/python/ndarray.h>
 #include <boost/python/stl_iterator.hpp>
 #include <bob/math/stats.h>
+#include <bob/math/ScatterAccumulator.h>
 
 using namespace boost::python;
 
@@ -26,7 +27,7 @@ static const char* SCATTERS_DOC1 = "Computes the within-class and between-class
 
 static const char* SCATTERS_DOC2 = "Computes the within-class and between-class scatter matrices of a set of 2D arrays considering data is organized row-wise (each sample is a row, each feature is a column). This implies that all the 2D arrays in 'data' should have the same number of columns. This variant also returns the total sample means in 'm'. The resulting arrays 'm', 'sb' and 'sw' have to have the correct sizes ('sb' and 'sw' should be square with extents equal to the number of columns in the arrays of 'data' and 'm' should be a 1D vector with extents equal to the number of columns in the arrays of 'data').";
 
-static const char* SCATTERS_DOC3 = "Computes the within-class and between-class scatter matrices of a set of 2D arrays considering data is organized row-wise (each sample is a row, each feature is a column). This implies that all the 2D arrays in 'data' should have the same number of columns. This variant returns the sample means and the scatter matrices 'sb' and 'sw' in a tuple. If you are looking for efficiency, prefer the variants that receive the output variable as one of the input parameters. This variant will allocate the resulting arrays 'm' and 'sb' and 'sw' internally every time it is called.";
+static const char* SCATTERS_DOC3 = "Computes the within-class and between-class scatter matrices of a set of 2D arrays considering data is organized row-wise (each sample is a row, each feature is a column). This implies that all the 2D arrays in 'data' should have the same number of columns. 'data' may also be a list of ScatterAccumulator objects, one per class. This variant returns the sample means and the scatter matrices 'sb' and 'sw' in a tuple. If you are looking for efficiency, prefer the variants that receive the output variable as one of the input parameters. This variant will allocate the resulting arrays 'm' and 'sb' and 'sw' internally every time it is called.";
 
 
 template <typename T> static tuple scatter_inner(bob::python::const_ndarray A) {
@@ -148,7 +149,20 @@ static tuple scatters_inner(std::vector<bob::python::const_ndarray>& data)
   return make_tuple(Sw, Sb, M);
 }
 
+static tuple scatters_accumulators(object data) {
+  stl_input_iterator<bob::math::ScatterAccumulator> dbegin(data), dend;
+  std::vector<bob::math::ScatterAccumulator> vdata(dbegin, dend);
+  const int n_features = vdata[0].getNFeatures();
+  blitz::Array<double,2> Sw(n_features, n_features);
+  blitz::Array<double,2> Sb(n_features, n_features);
+  blitz::Array<double,1> M(n_features);
+  bob::math::scatters(vdata, Sw, Sb, M);
+  return make_tuple(Sw, Sb, M);
+}
+
 static tuple scatters(object data) {
+  if (len(data) > 0 && extract<const bob::math::ScatterAccumulator&>(data[0]).check())
+    return scatters_accumulators(data);
   stl_input_iterator<bob::python::const_ndarray> dbegin(data), dend;
   std::vector<bob::python::const_ndarray> vdata(dbegin, dend);
   const bob::core::array::typeinfo& info = vdata[0].type();
@@ -281,7 +295,57 @@ static void scatters_M_check(object data, bob::python::ndarray Sw,
 }
 
 
+static void accumulator_accumulate(bob::math::ScatterAccumulator& acc,
+    bob::python::const_ndarray data) {
+  const bob::core::array::typeinfo& info = data.type();
+  switch (info.nd) {
+    case 1:
+      acc.accumulate(data.bz<double,1>());
+      break;
+    case 2:
+      acc.accumulate(data.bz<double,2>());
+      break;
+    default:
+      PYTHON_ERROR(TypeError, "scatter accumulation does not support input of type '%s'", info.str().c_str());
+  }
+}
+
+static object accumulator_covariance(const bob::math::ScatterAccumulator& acc) {
+  bob::python::ndarray cov(bob::core::array::t_float64, acc.getNFeatures(), acc.getNFeatures());
+  blitz::Array<double,2> cov_ = cov.bz<double,2>();
+  acc.getCovariance(cov_);
+  return cov.self();
+}
+
+static void accumulator_reset(bob::math::ScatterAccumulator& acc, const size_t n_features) {
+  acc.reset(n_features);
+}
+
+static void accumulator_reset_all(bob::math::ScatterAccumulator& acc) {
+  acc.reset();
+}
+
+static const char* ACCUMULATOR_DOC = "Accumulates the mean and the scatter matrix of samples given as blocks of rows (each sample is a row, each feature is a column), so that a data set does not need to be loaded in memory at once. Each block is split into stripes of rows processed by n_threads threads, and the partial results are combined with the pairwise update of Chan et al., which avoids the loss of precision of the sum of squares. Accumulators filled independently can be combined with merge(), and a list of accumulators (one per class) can be given to scatters().";
+
+
 void bind_math_stats() {
+  class_<bob::math::ScatterAccumulator, boost::shared_ptr<bob::math::ScatterAccumulator> >("ScatterAccumulator", ACCUMULATOR_DOC, init<optional<const size_t> >((arg("self"), arg("n_features")=0), "Creates an accumulator for samples of the given dimensionality."))
+    .def(init<const bob::math::ScatterAccumulator&>((arg("self"), arg("other")), "Copy constructs a ScatterAccumulator"))
+    .def(self == self)
+    .def(self != self)
+    .add_property("n_features", &bob::math::ScatterAccumulator::getNFeatures, "The dimensionality of the samples")
+    .add_property("n_samples", &bob::math::ScatterAccumulator::getNSamples, "The number of accumulated samples")
+    .add_property("mean", make_function(&bob::math::ScatterAccumulator::getMean, return_value_policy<copy_const_reference>()), "The mean of the accumulated samples")
+    .add_property("scatter", make_function(&bob::math::ScatterAccumulator::getScatter, return_value_policy<copy_const_reference>()), "The scatter matrix of the accumulated samples")
+    .add_property("n_threads", &bob::math::ScatterAccumulator::getNThreads, &bob::math::ScatterAccumulator::setNThreads, "The number of threads used to accumulate a block of samples")
+    .def("covariance", &accumulator_covariance, (arg("self")), "Returns the covariance matrix of the accumulated samples (the scatter matrix divided by the number of samples minus one)")
+    .def("accumulate", &accumulator_accumulate, (arg("self"), arg("data")), "Adds the samples of the given 2D array (one sample per row), or the given 1D sample")
+    .def("merge", &bob::math::ScatterAccumulator::merge, (arg("self"), arg("other")), "Adds the samples accumulated by another accumulator")
+    .def("reset", &accumulator_reset, (arg("self"), arg("n_features")), "Discards the accumulated samples, and sets the dimensionality of the samples")
+    .def("reset", &accumulator_reset_all, (arg("self")), "Discards the accumulated samples")
+    ;
+
+
   // Scatter of a matrix
   def("scatter_", &scatter_nocheck, (arg("a"), arg("s")), SCATTER_DOC1);
   def("scatter", &scatter_check, (arg("a"), arg("s")), SCATTER_DOC1);
@@ -9,13 +9,14 @@
  */
 
 #include <stdexcept>
+#include <cmath>
 #include <algorithm>
 #include <limits>
 #include <boost/format.hpp>
 #include <bob/measure/error.h>
 #include <bob/core/assert.h>
-#include <bob/core/cast.h>
 #include <bob/math/pavx.h>
+#include <bob/math/sort.h>
 #include <bob/math/linsolve.h>
 
 std::pair<double, double> bob::measure::farfrr(const blitz::Array<double,1>& negatives,
@@ -65,8 +66,8 @@ double bob::measure::eerThreshold(const blitz::Array<double,1>& negatives,
 }
 
 double bob::measure::eerRocch(const blitz::Array<double,1>& negatives,
-    const blitz::Array<double,1>& positives) {
-  return bob::measure::rocch2eer(bob::measure::rocch(negatives, positives));
+    const blitz::Array<double,1>& positives, const size_t n_threads) {
+  return bob::measure::rocch2eer(bob::measure::rocch(negatives, positives, n_threads));
 }
 
 double bob::measure::farThreshold(const blitz::Array<double,1>& negatives,
@@ -208,43 +209,16 @@ blitz::Array<double,2> bob::measure::precision_recall_curve(const blitz::Array<d
 }
 
 /**
-  * Structure for getting permutations when sorting an array
-  */
-struct ComparePairs
-{
-  ComparePairs(const blitz::Array<double,1> &v):
-    m_v(v)
-  {
-  }
-
-  bool operator()(size_t a, size_t b)
-  {
-    return m_v(a) < m_v(b);
-  }
-
-  blitz::Array<double,1> m_v;
-};
-
-ComparePairs CreateComparePairs(const blitz::Array<double,1>& v)
-{
-  return ComparePairs(v);
-}
-
-/**
-  * Sort an array and get the permutations (using stable_sort)
-  */
-void sortWithPermutation(const blitz::Array<double,1>& values, std::vector<size_t>& v)
-{
-  int N = values.extent(0);
-  bob::core::array::assertSameDimensionLength(N, v.size());
-  for(int i=0; i<N; ++i)
-    v[i] = i;
-
-  std::stable_sort(v.begin(), v.end(), CreateComparePairs(values));
-}
-
-blitz::Array<double,2> bob::measure::rocch(const blitz::Array<double,1>& negatives,
- const blitz::Array<double,1>& positives)
+ * Sorts the positive and negative scores together and applies the PAV
+ * algorithm to the ideal posteriors (1 for the positives and 0 for the
+ * negatives, in the order of the sorted scores). Returns the number of bins,
+ * and sets the permutation of the sorted scores (the positives first, then
+ * the negatives) as well as the heights and widths of the bins.
+ */
+static size_t rocch_bins(const blitz::Array<double,1>& negatives,
+  const blitz::Array<double,1>& positives, const size_t n_threads,
+  blitz::Array<size_t,1>& perturb, blitz::Array<double,1>& height,
+  blitz::Array<size_t,1>& width)
 {
   // Number of positive and negative scores
   size_t Nt = positives.extent(0);
@@ -258,41 +232,58 @@ blitz::Array<double,2> bob::measure::rocch(const blitz::Array<double,1>& negativ
   scores(blitz::Range(Nt,N-1)) = negatives(rall);
 
   // It is important here that scores that are the same (i.e. already in order) should NOT be swapped.
-  // std::stable_sort has this property.
-  std::vector<size_t> perturb(N);
-  sortWithPermutation(scores, perturb);
+  // The sort is stable, such that the positives come first.
+  perturb.resize(N);
+  height.resize(N);
+  width.resize(N);
+  bob::math::sortWithPermutation(scores, height, perturb, n_threads);
 
-  // Apply permutation
-  blitz::Array<size_t,1> Pideal(N);
+  // Apply permutation (the sorted scores are not needed)
   for(size_t i=0; i<N; ++i)
-    Pideal(i) = (perturb[i] < Nt ? 1 : 0);
-  blitz::Array<double,1> Pideal_d = bob::core::array::cast<double>(Pideal);
+    height(i) = (perturb(i) < Nt ? 1. : 0.);
 
-  // Apply the PAVA algorithm
-  blitz::Array<double,1> Popt(N);
-  blitz::Array<size_t,1> width = bob::math::pavxWidth(Pideal_d, Popt);
+  // Apply the PAVA algorithm, in place
+  return bob::math::pavxBins_(height, height, width);
+}
+
+/**
+ * Computes the vertices of the ROC Convex Hull from the PAV bins, counting
+ * the positives and negatives on each side of each bin. If llr_negatives
+ * and llr_positives are set, the log-likelihood-ratio of each bin is also
+ * assigned to its scores.
+ */
+static blitz::Array<double,2> rocch_vertices(size_t Nn, size_t Nt,
+  const blitz::Array<size_t,1>& perturb, const blitz::Array<double,1>& height,
+  const blitz::Array<size_t,1>& width, size_t nbins,
+  blitz::Array<double,1>* llr_negatives=0,
+  blitz::Array<double,1>* llr_positives=0)
+{
+  const size_t N = Nt + Nn;
+  const double log_prior_odds = std::log((double)Nt / (double)Nn);
 
   // Allocate output
-  int nbins = width.extent(0);
   blitz::Array<double,2> retval(2,nbins+1); // FAR, FRR
 
   // Fill in output
   size_t left = 0;
   size_t fa = Nn;
   size_t miss = 0;
-  for(int i=0; i<nbins; ++i)
+  for(size_t i=0; i<nbins; ++i)
   {
     retval(0,i) = fa / (double)Nn; // pfa
     retval(1,i) = miss / (double)Nt; // pmiss
-    left += width(i);
-    if(left >= 1)
-      miss = blitz::sum(Pideal(blitz::Range(0,left-1)));
-    else
-      miss = 0;
-    if(Pideal.extent(0)-1 >= (int)left)
-      fa = N - left - blitz::sum(Pideal(blitz::Range(left,Pideal.extent(0)-1)));
-    else
-      fa = 0;
+    const double llr = std::log(height(i)) - std::log(1. - height(i)) - log_prior_odds;
+    for(const size_t right = left + width(i); left < right; ++left)
+    {
+      const size_t k = perturb(left);
+      if(k < Nt)
+      {
+        ++miss;
+        if(llr_positives) (*llr_positives)(k) = llr;
+      }
+      else if(llr_negatives) (*llr_negatives)(k - Nt) = llr;
+    }
+    fa = N - left - (Nt - miss);
   }
   retval(0,nbins) = fa / (double)Nn; // pfa
   retval(1,nbins) = miss / (double)Nt; // pmiss
@@ -300,6 +291,34 @@ blitz::Array<double,2> bob::measure::rocch(const blitz::Array<double,1>& negativ
   return retval;
 }
 
+blitz::Array<double,2> bob::measure::rocch(const blitz::Array<double,1>& negatives,
+ const blitz::Array<double,1>& positives, const size_t n_threads)
+{
+  blitz::Array<size_t,1> perturb;
+  blitz::Array<double,1> height;
+  blitz::Array<size_t,1> width;
+  size_t nbins = rocch_bins(negatives, positives, n_threads, perturb, height, width);
+  return rocch_vertices(negatives.extent(0), positives.extent(0), perturb,
+    height, width, nbins);
+}
+
+double bob::measure::calibrateRocch(const blitz::Array<double,1>& negatives,
+  const blitz::Array<double,1>& positives,
+  blitz::Array<double,1>& llr_negatives,
+  blitz::Array<double,1>& llr_positives, const size_t n_threads)
+{
+  bob::core::array::assertSameShape(negatives, llr_negatives);
+  bob::core::array::assertSameShape(positives, llr_positives);
+
+  blitz::Array<size_t,1> perturb;
+  blitz::Array<double,1> height;
+  blitz::Array<size_t,1> width;
+  size_t nbins = rocch_bins(negatives, positives, n_threads, perturb, height, width);
+  return bob::measure::rocch2eer(rocch_vertices(negatives.extent(0),
+    positives.extent(0), perturb, height, width, nbins, &llr_negatives,
+    &llr_positives));
+}
+
 double bob::measure::rocch2eer(const blitz::Array<double,2>& pfa_pmiss)
 {
   bob::core::array::assertSameDimensionLength(2, pfa_pmiss.extent(0));
@@ -52,8 +52,8 @@ static double bob_eer_threshold(bob::python::const_ndarray negatives, bob::pytho
   return bob::measure::eerThreshold(negatives.cast<double,1>(), positives.cast<double,1>());
 }
 
-static double bob_eer_rocch(bob::python::const_ndarray negatives, bob::python::const_ndarray positives){
-  return bob::measure::eerRocch(negatives.cast<double,1>(), positives.cast<double,1>());
+static double bob_eer_rocch(bob::python::const_ndarray negatives, bob::python::const_ndarray positives, size_t n_threads){
+  return bob::measure::eerRocch(negatives.cast<double,1>(), positives.cast<double,1>(), n_threads);
 }
 
 static double bob_min_weighted_error_rate_threshold(bob::python::const_ndarray negatives, bob::python::const_ndarray positives, const double costs){
@@ -85,14 +85,23 @@ static blitz::Array<double,2> bob_precision_recall_curve(bob::python::const_ndar
   return bob::measure::precision_recall_curve(negatives.cast<double,1>(), positives.cast<double,1>(), n_points);
 }
 
-static blitz::Array<double,2> bob_rocch(bob::python::const_ndarray negatives, bob::python::const_ndarray positives){
-  return bob::measure::rocch(negatives.cast<double,1>(), positives.cast<double,1>());
+static blitz::Array<double,2> bob_rocch(bob::python::const_ndarray negatives, bob::python::const_ndarray positives, size_t n_threads){
+  return bob::measure::rocch(negatives.cast<double,1>(), positives.cast<double,1>(), n_threads);
 }
 
 static double bob_rocch2eer(bob::python::const_ndarray pfa_pmiss){
   return bob::measure::rocch2eer(pfa_pmiss.cast<double,2>());
 }
 
+static tuple bob_calibrate_rocch(bob::python::const_ndarray negatives, bob::python::const_ndarray positives, size_t n_threads){
+  blitz::Array<double,1> negatives_ = negatives.cast<double,1>();
+  blitz::Array<double,1> positives_ = positives.cast<double,1>();
+  blitz::Array<double,1> llr_negatives(negatives_.extent(0));
+  blitz::Array<double,1> llr_positives(positives_.extent(0));
+  double eer = bob::measure::calibrateRocch(negatives_, positives_, llr_negatives, llr_positives, n_threads);
+  return make_tuple(llr_negatives, llr_positives, eer);
+}
+
 
 static blitz::Array<double,2> bob_roc_for_far(bob::python::const_ndarray negatives, bob::python::const_ndarray positives, bob::python::const_ndarray far_list){
   return bob::measure::roc_for_far(negatives.cast<double,1>(), positives.cast<double,1>(), far_list.cast<double,1>());
@@ -153,8 +162,8 @@ void bind_measure_error() {
  def(
     "eer_rocch",
     &bob_eer_rocch,
-    (arg("negatives"), arg("positives")),
-    "Calculates the equal-error-rate (EER) given the input data, on the ROC Convex Hull as done in the Bosaris toolkit (https://sites.google.com/site/bosaristoolkit/)."
+    (arg("negatives"), arg("positives"), arg("n_threads")=1),
+    "Calculates the equal-error-rate (EER) given the input data, on the ROC Convex Hull as done in the Bosaris toolkit (https://sites.google.com/site/bosaristoolkit/). The scores are sorted with 'n_threads' threads."
   );
 
   def(
@@ -206,8 +215,8 @@ void bind_measure_error() {
   def(
     "rocch",
     &bob_rocch,
-    (arg("negatives"), arg("positives")),
-    "Calculates the ROC Convex Hull curve given a set of positive and negative scores. Returns a two-dimensional blitz::Array of doubles that express the X (FAR) and Y (FRR) coordinates in this order."
+    (arg("negatives"), arg("positives"), arg("n_threads")=1),
+    "Calculates the ROC Convex Hull curve given a set of positive and negative scores. Returns a two-dimensional blitz::Array of doubles that express the X (FAR) and Y (FRR) coordinates in this order. The scores are sorted with a radix sort using 'n_threads' threads."
   );
 
   def(
@@ -217,6 +226,13 @@ void bind_measure_error() {
     "Calculates the threshold that is as close as possible to the equal-error-rate (EER) given the input data."
   );
 
+  def(
+    "calibrate_rocch",
+    &bob_calibrate_rocch,
+    (arg("negatives"), arg("positives"), arg("n_threads")=1),
+    "Calibrates the scores optimally on the ROC Convex Hull, as opt_loglr() of the Bosaris toolkit (https://sites.google.com/site/bosaristoolkit/): each score is replaced by the log-likelihood-ratio of the bin of the Pool Adjacent Violators algorithm it falls into (-/+infinity for the bins of only negatives or positives). Returns a tuple with the calibrated negatives, the calibrated positives and the equal-error-rate on the ROC Convex Hull (as eer_rocch()), computed from a single sort of the scores with 'n_threads' threads."
+  );
+
   def(
     "roc_for_far",
     &bob_roc_for_far,
@@ -334,6 +334,22 @@ PyArray_Descr* bob::python::dtype::descr() {
  * Free methods                                                             *
  ****************************************************************************/
 
+static bob::python::copy_statistics_t s_copy_statistics = {0, 0};
+
+const bob::python::copy_statistics_t& bob::python::copy_statistics() {
+  return s_copy_statistics;
+}
+
+void bob::python::reset_copy_statistics() {
+  s_copy_statistics.count = 0;
+  s_copy_statistics.bytes = 0;
+}
+
+void bob::python::account_copy(size_t bytes) {
+  ++s_copy_statistics.count;
+  s_copy_statistics.bytes += bytes;
+}
+
 void bob::python::typeinfo_ndarray_ (const boost::python::object& o, bob::core::array::typeinfo& i) {
   PyArrayObject* npy = TP_ARRAY(o);
   npy_intp strides[NPY_MAXDIMS];
@@ -710,13 +726,29 @@ bob::python::convert_t bob::python::convertible_to(boost::python::object array_l
  * Ndarray (PyArrayObject) manipulations                                   *
  ***************************************************************************/
 
+/**
+ * Tells if we can skin the given ndarray with a blitz::Array<> without
+ * copying: the data must be aligned, in native byte order and all strides
+ * must be multiples of the element size. The array does not need to be
+ * contiguous.
+ */
+static bool is_referable (PyArrayObject* a) {
+  if (!PyArray_ISALIGNED(a) || !PyArray_ISNOTSWAPPED(a)) return false;
+  const npy_intp elsize = PyArray_DESCR(a)->elsize;
+  if (elsize <= 0) return false;
+  for (int k=0; k<PyArray_NDIM(a); ++k)
+    if (PyArray_STRIDES(a)[k] % elsize) return false;
+  return true;
+}
+
 /**
  * Returns either a reference or a copy of the given array_like object,
  * depending on the following requirements for referral:
  *
  * 0. The pointed object is a numpy.ndarray
- * 1. The array type description type_num matches
- * 2. The array is C-style, contiguous and aligned
+ * 1. The array is aligned, in native byte order and its strides are a
+ *    multiple of the element size (slices, transposes and reversed arrays are
+ *    therefore referred to).
  */
 static boost::python::object try_refer_ndarray (boost::python::object array_like,
     boost::python::object dtype_like) {
@@ -729,9 +761,10 @@ static boost::python::object try_refer_ndarray (boost::python::object array_like
 
   if (!PyArray_Check((PyObject*)candidate)) can_refer = false;
 
-  if (can_refer && !PyArray_ISCARRAY_RO(candidate)) can_refer = false;
+  if (can_refer && !is_referable(candidate)) can_refer = false;
 
   if (can_refer) {
+    Py_XDECREF(req_dtype);
     PyObject* tmp = PyArray_FromArray(candidate, 0, 0);
     boost::python::handle<> hdl(tmp); //< raises if NULL
     boost::python::object retval(hdl);
@@ -749,6 +782,7 @@ static boost::python::object try_refer_ndarray (boost::python::object array_like
   PyObject* tmp = PyArray_FromAny(_ptr, req_dtype, 0, 0, flags, 0);
   boost::python::handle<> hdl(tmp); //< raises if NULL
   boost::python::object retval(hdl);
+  bob::python::account_copy(PyArray_NBYTES(TP_ARRAY(retval)));
   return retval;
 
 }
@@ -769,26 +803,40 @@ bob::python::py_array::py_array(boost::python::object o, boost::python::object _
 {
   if (TPY_ISNONE(o)) PYTHON_ERROR(TypeError, "You cannot pass 'None' as input parameter to C++-bound bob methods that expect NumPy ndarrays (or blitz::Array<T,N>'s). Double-check your input!");
   boost::python::object mine = try_refer_ndarray(o, _dtype);
+  PyArrayObject* npy = TP_ARRAY(mine);
 
-  //captures data from a numeric::array
-  typeinfo_ndarray_(mine, m_type);
+  //captures the shape from a numeric::array, with C-style strides
+  m_type.set<npy_intp>(bob::python::num_to_type(PyArray_DESCR(npy)->type_num),
+      PyArray_NDIM(npy), PyArray_DIMS(npy));
 
   //transforms the from boost::python ref counting to boost::shared_ptr<void>
   m_data = shared_from_ndarray(mine);
 
-  //set-up the C-style pointer to this data
-  m_ptr = static_cast<void*>(PyArray_DATA(TP_ARRAY(mine)));
+  //set-up the view on the (possibly strided) data
+  m_view_ptr = static_cast<void*>(PyArray_DATA(npy));
+  for (int k=0; k<PyArray_NDIM(npy); ++k)
+    m_view_stride[k] = PyArray_STRIDES(npy)[k]/PyArray_DESCR(npy)->elsize;
+  m_contiguous = PyArray_ISCARRAY_RO(npy);
+
+  //the C-style pointer is only set-up now if no copy is required
+  m_ptr = m_contiguous? m_view_ptr : 0;
 }
 
-bob::python::py_array::py_array(const bob::core::array::interface& other) {
+bob::python::py_array::py_array(const bob::core::array::interface& other):
+  m_ptr(0), m_is_numpy(false), m_view_ptr(0), m_contiguous(true)
+{
   set(other);
 }
 
-bob::python::py_array::py_array(boost::shared_ptr<bob::core::array::interface> other) {
+bob::python::py_array::py_array(boost::shared_ptr<bob::core::array::interface> other):
+  m_ptr(0), m_is_numpy(false), m_view_ptr(0), m_contiguous(true)
+{
   set(other);
 }
 
-bob::python::py_array::py_array(const bob::core::array::typeinfo& info) {
+bob::python::py_array::py_array(const bob::core::array::typeinfo& info):
+  m_ptr(0), m_is_numpy(false), m_view_ptr(0), m_contiguous(true)
+{
   set(info);
 }
 
@@ -860,12 +908,33 @@ static boost::python::object copy_data (const void* data, const bob::core::array
   return retval;
 }
 
+void bob::python::py_array::set_contiguous_view() {
+  m_view_ptr = m_ptr;
+  for (size_t k=0; k<m_type.nd; ++k) m_view_stride[k] = m_type.stride[k];
+  m_contiguous = true;
+  m_copy.reset();
+}
+
+void bob::python::py_array::materialize() const {
+  TDEBUG1("[non-optimal] copying strided array to contiguous memory for "
+      << m_type.str());
+
+  boost::python::handle<> hdl(boost::python::borrowed(boost::static_pointer_cast<PyObject>(m_data).get()));
+  boost::python::object mine(hdl);
+  boost::python::object copied = copy_array(mine);
+  bob::python::account_copy(m_type.buffer_size());
+
+  m_copy = shared_from_ndarray(copied);
+  m_ptr = static_cast<void*>(PyArray_DATA(TP_ARRAY(copied)));
+}
+
 void bob::python::py_array::set(const bob::core::array::interface& other) {
   TDEBUG1("[non-optimal] buffer copying operation being performed for "
       << other.type().str());
 
   //performs a copy of the data into a numpy array
-  boost::python::object mine = copy_data(other.ptr(), m_type);
+  boost::python::object mine = copy_data(other.ptr(), other.type());
+  bob::python::account_copy(other.type().buffer_size());
 
   //captures data from a numeric::array
   typeinfo_ndarray_(mine, m_type);
@@ -877,6 +946,7 @@ void bob::python::py_array::set(const bob::core::array::interface& other) {
   m_ptr = static_cast<void*>(PyArray_DATA(TP_ARRAY(mine)));
 
   m_is_numpy = true;
+  set_contiguous_view();
 }
 
 void bob::python::py_array::set(boost::shared_ptr<bob::core::array::interface> other) {
@@ -884,6 +954,7 @@ void bob::python::py_array::set(boost::shared_ptr<bob::core::array::interface> o
   m_is_numpy = false;
   m_ptr = other->ptr();
   m_data = other->owner();
+  set_contiguous_view();
 }
 
 /**
@@ -921,9 +992,16 @@ void bob::python::py_array::set (const bob::core::array::typeinfo& req) {
   m_ptr = static_cast<void*>(PyArray_DATA(TP_ARRAY(mine)));
 
   m_is_numpy = true;
+  set_contiguous_view();
 }
 
 boost::python::object bob::python::py_array::copy(const boost::python::object& dtype) {
+  bob::python::account_copy(m_type.buffer_size());
+  if (m_is_numpy) {
+    boost::python::handle<> hdl(boost::python::borrowed(boost::static_pointer_cast<PyObject>(m_data).get()));
+    boost::python::object mine(hdl);
+    return copy_array(mine);
+  }
   return copy_data(m_ptr, m_type);
 }
 
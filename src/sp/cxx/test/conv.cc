@@ -15,6 +15,7 @@
 #include <boost/test/floating_point_comparison.hpp>
 
 #include <bob/sp/conv.h>
+#include <bob/sp/convsep.h>
 
 struct T {
   blitz::Array<double,1> A1_10;
@@ -253,6 +254,41 @@ void test_conv_2D( T eps, const blitz::Array<T,2>& a1,
       BOOST_CHECK_SMALL(res(i,j) - mat(i,j), eps);
 }
 
+template <typename T>
+void test_convsep_border( T eps, const blitz::Array<T,2>& a1,
+  const blitz::Array<T,1>& b, const size_t dim,
+  const bob::sp::Extrapolation::BorderType border_type)
+{
+  // Reference: extrapolation followed by a 'valid' separable convolution
+  blitz::TinyVector<int,2> shape = a1.shape();
+  shape(dim) += b.extent(0) - 1;
+  blitz::Array<T,2> ext(shape);
+  bob::sp::extrapolate(a1, ext, border_type, (T)0.5);
+  blitz::Array<T,2> ref(a1.shape());
+  bob::sp::convSep( ext, b, ref, dim, bob::sp::Conv::Valid);
+
+  blitz::Array<T,2> res(a1.shape());
+  bob::sp::convSepBorder( a1, b, res, dim, border_type, (T)0.5);
+  for (int i=0; i<res.extent(0); ++i)
+    for (int j=0; j<res.extent(1); ++j)
+      BOOST_CHECK_SMALL(res(i,j) - ref(i,j), eps);
+}
+
+template <typename T>
+void test_convsep_border_same( T eps, const blitz::Array<T,2>& a1,
+  const blitz::Array<T,1>& b, const size_t dim)
+{
+  // With zeros beyond the borders, the kernel is centred as for Conv::Same
+  blitz::Array<T,2> ref(a1.shape());
+  bob::sp::convSep( a1, b, ref, dim, bob::sp::Conv::Same);
+
+  blitz::Array<T,2> res(a1.shape());
+  bob::sp::convSepBorder( a1, b, res, dim, bob::sp::Extrapolation::Zero);
+  for (int i=0; i<res.extent(0); ++i)
+    for (int j=0; j<res.extent(1); ++j)
+      BOOST_CHECK_SMALL(res(i,j) - ref(i,j), eps);
+}
+
 
 
 
@@ -411,4 +447,42 @@ BOOST_AUTO_TEST_CASE( test_convolve_2D_3x4_2x2 )
     bob::sp::Conv::Valid);
 }
 
+// Separable convolution with border extrapolation, compared to the explicit
+// extrapolation followed by a 'valid' convolution
+BOOST_AUTO_TEST_CASE( test_convsep_border )
+{
+  const bob::sp::Extrapolation::BorderType borders[] = {
+    bob::sp::Extrapolation::Zero, bob::sp::Extrapolation::Constant,
+    bob::sp::Extrapolation::NearestNeighbour,
+    bob::sp::Extrapolation::Circular, bob::sp::Extrapolation::Mirror };
+  // Symmetric kernel
+  blitz::Array<double,1> g(5);
+  g = 0.1, 0.2, 0.4, 0.2, 0.1;
+  blitz::Array<double,1> g4(4);
+  g4 = 0.1, 0.4, 0.4, 0.1;
+  // Transposed (non contiguous rows) input
+  blitz::Array<double,2> A2_5t = A2_5.transpose(1,0);
+
+  for (int k=0; k<5; ++k)
+    for (size_t dim=0; dim<2; ++dim)
+    {
+      test_convsep_border( eps_d, A2_5, b1_3, dim, borders[k]);
+      test_convsep_border( eps_d, A2_5, b1_5, dim, borders[k]);
+      test_convsep_border( eps_d, A2_5, g, dim, borders[k]);
+      test_convsep_border( eps_d, A2_5t, g, dim, borders[k]);
+      test_convsep_border( eps_d, A2b_3x4, b1_3, dim, borders[k]);
+      // Even kernels, not symmetric and symmetric
+      test_convsep_border( eps_d, A2_5, b1_4, dim, borders[k]);
+      test_convsep_border( eps_d, A2_5, g4, dim, borders[k]);
+      test_convsep_border( eps_d, A2b_3x4, g4, dim, borders[k]);
+    }
+
+  for (size_t dim=0; dim<2; ++dim)
+  {
+    test_convsep_border_same( eps_d, A2_5, b1_3, dim);
+    test_convsep_border_same( eps_d, A2_5, b1_4, dim);
+    test_convsep_border_same( eps_d, A2_5, g4, dim);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
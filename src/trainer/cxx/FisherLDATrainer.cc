@@ -111,12 +111,55 @@ void bob::trainer::FisherLDATrainer::train
     }
   }
 
-  int osize = output_size(data);
+  blitz::Array<double,1> preMean(n_features);
+  blitz::Array<double,2> Sw(n_features, n_features);
+  blitz::Array<double,2> Sb(n_features, n_features);
+  bob::math::scatters_(data, Sw, Sb, preMean);
+
+  setupMachine(machine, eigen_values, Sw, Sb, preMean, output_size(data));
+}
+
+void bob::trainer::FisherLDATrainer::train
+(bob::machine::LinearMachine& machine, blitz::Array<double,1>& eigen_values,
+  const std::vector<bob::math::ScatterAccumulator>& classes) const
+{
+  // if #classes < 2, then throw
+  if (classes.size() < 2) {
+    boost::format m("The number of accumulators in the input data == %d whereas for LDA you should provide at least 2");
+    m % classes.size();
+    throw std::runtime_error(m.str());
+  }
+
+  // checks for the shape once
+  const size_t n_features = classes[0].getNFeatures();
+
+  for (size_t cl=0; cl<classes.size(); ++cl) {
+    if (classes[cl].getNFeatures() != n_features) {
+      boost::format m("The number of features (%u) of the accumulator at position %u of your input differs from that of the accumulator at position 0 (%u)");
+      m % classes[cl].getNFeatures() % cl % n_features;
+      throw std::runtime_error(m.str());
+    }
+  }
+
+  blitz::Array<double,1> preMean(n_features);
+  blitz::Array<double,2> Sw(n_features, n_features);
+  blitz::Array<double,2> Sb(n_features, n_features);
+  bob::math::scatters(classes, Sw, Sb, preMean);
+
+  setupMachine(machine, eigen_values, Sw, Sb, preMean, output_size(classes));
+}
+
+void bob::trainer::FisherLDATrainer::setupMachine
+(bob::machine::LinearMachine& machine, blitz::Array<double,1>& eigen_values,
+  blitz::Array<double,2>& Sw, blitz::Array<double,2>& Sb,
+  const blitz::Array<double,1>& preMean, const int osize) const
+{
+  const int n_features = preMean.extent(0);
 
   // Checks that the dimensions are matching
-  if (machine.inputSize() != (size_t)data[0].extent(1)) {
+  if (machine.inputSize() != (size_t)n_features) {
     boost::format m("Number of features at input data set (%d columns) does not match machine input size (%d)");
-    m % data[0].extent(1) % machine.inputSize();
+    m % n_features % machine.inputSize();
     throw std::runtime_error(m.str());
   }
   if (machine.outputSize() != (size_t)osize) {
@@ -130,11 +173,6 @@ void bob::trainer::FisherLDATrainer::train
     throw std::runtime_error(m.str());
   }
 
-  blitz::Array<double,1> preMean(n_features);
-  blitz::Array<double,2> Sw(n_features, n_features);
-  blitz::Array<double,2> Sb(n_features, n_features);
-  bob::math::scatters_(data, Sw, Sb, preMean);
-
   // computes the generalized eigenvalue decomposition
   // so to find the eigen vectors/values of Sw^(-1) * Sb
   blitz::Array<double,2> V(Sw.shape());
@@ -194,3 +232,13 @@ void bob::trainer::FisherLDATrainer::train(bob::machine::LinearMachine& machine,
 size_t bob::trainer::FisherLDATrainer::output_size(const std::vector<blitz::Array<double,2> >& data) const {
   return m_strip_to_rank ? std::min(data.size()-1, (size_t)data[0].extent(1)) : data[0].extent(1);
 }
+
+void bob::trainer::FisherLDATrainer::train(bob::machine::LinearMachine& machine,
+    const std::vector<bob::math::ScatterAccumulator>& classes) const {
+  blitz::Array<double,1> throw_away(output_size(classes));
+  train(machine, throw_away, classes);
+}
+
+size_t bob::trainer::FisherLDATrainer::output_size(const std::vector<bob::math::ScatterAccumulator>& classes) const {
+  return m_strip_to_rank ? std::min(classes.size()-1, classes[0].getNFeatures()) : classes[0].getNFeatures();
+}
@@ -8,9 +8,13 @@
  */
 
 #include <algorithm>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
 #include <bob/core/assert.h>
+#include <bob/core/array_utils.h>
 #include <bob/core/check.h>
 #include <bob/math/linear.h>
+#include <bob/math/gemm.h>
 #include <bob/trainer/MLPBaseTrainer.h>
 
 bob::trainer::MLPBaseTrainer::MLPBaseTrainer(size_t batch_size,
@@ -19,6 +23,7 @@ bob::trainer::MLPBaseTrainer::MLPBaseTrainer(size_t batch_size,
   m_cost(cost),
   m_train_bias(true),
   m_H(0), ///< handy!
+  m_n_threads(1),
   m_deriv(1),
   m_deriv_bias(1),
   m_error(1),
@@ -38,6 +43,7 @@ bob::trainer::MLPBaseTrainer::MLPBaseTrainer(size_t batch_size,
   m_cost(cost),
   m_train_bias(true),
   m_H(machine.numOfHiddenLayers()), ///< handy!
+  m_n_threads(1),
   m_deriv(m_H + 1),
   m_deriv_bias(m_H + 1),
   m_error(m_H + 1),
@@ -54,6 +60,7 @@ bob::trainer::MLPBaseTrainer::MLPBaseTrainer(size_t batch_size,
   m_cost(cost),
   m_train_bias(train_biases),
   m_H(machine.numOfHiddenLayers()), ///< handy!
+  m_n_threads(1),
   m_deriv(m_H + 1),
   m_deriv_bias(m_H + 1),
   m_error(m_H + 1),
@@ -68,12 +75,14 @@ bob::trainer::MLPBaseTrainer::MLPBaseTrainer(const MLPBaseTrainer& other):
   m_batch_size(other.m_batch_size),
   m_cost(other.m_cost),
   m_train_bias(other.m_train_bias),
-  m_H(other.m_H)
+  m_H(other.m_H),
+  m_n_threads(other.m_n_threads)
 {
   bob::core::array::ccopy(other.m_deriv, m_deriv);
   bob::core::array::ccopy(other.m_deriv_bias, m_deriv_bias);
   bob::core::array::ccopy(other.m_error, m_error);
   bob::core::array::ccopy(other.m_output, m_output);
+  resize_thread_buffers();
 }
 
 bob::trainer::MLPBaseTrainer& bob::trainer::MLPBaseTrainer::operator=
@@ -84,11 +93,13 @@ bob::trainer::MLPBaseTrainer& bob::trainer::MLPBaseTrainer::operator=
     m_cost = other.m_cost;
     m_train_bias = other.m_train_bias;
     m_H = other.m_H;
+    m_n_threads = other.m_n_threads;
 
     bob::core::array::ccopy(other.m_deriv, m_deriv);
     bob::core::array::ccopy(other.m_deriv_bias, m_deriv_bias);
     bob::core::array::ccopy(other.m_error, m_error);
     bob::core::array::ccopy(other.m_output, m_output);
+    resize_thread_buffers();
   }
   return *this;
 }
@@ -108,6 +119,27 @@ void bob::trainer::MLPBaseTrainer::setBatchSize (size_t batch_size) {
   }
 }
 
+void bob::trainer::MLPBaseTrainer::setNThreads(size_t n_threads) {
+  if (n_threads == 0)
+    throw std::runtime_error("the number of threads should be strictly positive");
+  m_n_threads = n_threads;
+  resize_thread_buffers();
+}
+
+void bob::trainer::MLPBaseTrainer::resize_thread_buffers() {
+  const size_t n_extra = (m_n_threads > 1 ? m_n_threads-1 : 0);
+  m_thread_deriv.resize(n_extra);
+  m_thread_deriv_bias.resize(n_extra);
+  for (size_t t=0; t<n_extra; ++t) {
+    m_thread_deriv[t].resize(m_deriv.size());
+    m_thread_deriv_bias[t].resize(m_deriv_bias.size());
+    for (size_t k=0; k<m_deriv.size(); ++k) {
+      m_thread_deriv[t][k].resize(m_deriv[k].shape());
+      m_thread_deriv_bias[t][k].resize(m_deriv_bias[k].shape());
+    }
+  }
+}
+
 bool bob::trainer::MLPBaseTrainer::isCompatible(const bob::machine::MLP& machine) const
 {
   if (m_H != machine.numOfHiddenLayers()) return false;
@@ -125,62 +157,150 @@ bool bob::trainer::MLPBaseTrainer::isCompatible(const bob::machine::MLP& machine
   return true;
 }
 
-void bob::trainer::MLPBaseTrainer::forward_step(const bob::machine::MLP& machine,
-  const blitz::Array<double,2>& input)
+/**
+ * Number of blocks a batch of n_rows examples is split into
+ */
+static int number_of_blocks(size_t n_threads, int n_rows) {
+  return std::max(1, std::min((int)n_threads, n_rows));
+}
+
+void bob::trainer::MLPBaseTrainer::forward_rows(const bob::machine::MLP& machine,
+  const blitz::Array<double,2>& input, int begin, int end)
 {
-  const std::vector<blitz::Array<double,2> >& machine_weight = machine.getWeights();
-  const std::vector<blitz::Array<double,1> >& machine_bias = machine.getBiases();
+  if (begin >= end) return;
+
+  //views of the arrays shared with the other threads
+  const std::vector<blitz::Array<double,2> > machine_weight(bob::core::array::private_view(machine.getWeights()));
+  const std::vector<blitz::Array<double,1> > machine_bias(bob::core::array::private_view(machine.getBiases()));
+  std::vector<blitz::Array<double,2> > output(bob::core::array::private_view(m_output));
 
   boost::shared_ptr<bob::machine::Activation> hidden_actfun = machine.getHiddenActivation();
   boost::shared_ptr<bob::machine::Activation> output_actfun = machine.getOutputActivation();
 
+  blitz::secondIndex j;
+  blitz::Range all = blitz::Range::all();
+  blitz::Range rows(begin, end-1);
+
+  const blitz::Array<double,2> in(bob::core::array::private_view(input)(rows,all));
   for (size_t k=0; k<machine_weight.size(); ++k) { //for all layers
-    if (k == 0) bob::math::prod_(input, machine_weight[k], m_output[k]);
-    else bob::math::prod_(m_output[k-1], machine_weight[k], m_output[k]);
-    boost::shared_ptr<bob::machine::Activation> cur_actfun =
-      (k == (machine_weight.size()-1) ? output_actfun : hidden_actfun );
-    for (int i=0; i<(int)m_batch_size; ++i) { //for every example
-      for (int j=0; j<m_output[k].extent(1); ++j) { //for all variables
-        m_output[k](i,j) = cur_actfun->f(m_output[k](i,j) + machine_bias[k](j));
-      }
-    }
+    blitz::Array<double,2> out(output[k](rows,all));
+    if (k == 0) bob::math::gemm_(in, machine_weight[k], out);
+    else bob::math::gemm_(output[k-1](rows,all), machine_weight[k], out);
+    out += machine_bias[k](j);
+    if (k == (machine_weight.size()-1)) output_actfun->f_inplace(out);
+    else hidden_actfun->f_inplace(out);
   }
 }
 
-void bob::trainer::MLPBaseTrainer::backward_step
+void bob::trainer::MLPBaseTrainer::forward_step(const bob::machine::MLP& machine,
+  const blitz::Array<double,2>& input)
+{
+  const int n_rows = m_output[0].extent(0);
+  const int n_blocks = number_of_blocks(m_n_threads, n_rows);
+  if (n_blocks == 1) {
+    forward_rows(machine, input, 0, n_rows);
+    return;
+  }
+
+  //the rows of the output buffers written by each thread do not overlap
+  boost::thread_group threads;
+  for (int t=0; t<n_blocks; ++t) {
+    const int begin = (int)(((int64_t)n_rows * t) / n_blocks);
+    const int end = (int)(((int64_t)n_rows * (t+1)) / n_blocks);
+    threads.create_thread(boost::bind(&bob::trainer::MLPBaseTrainer::forward_rows,
+          this, boost::cref(machine), boost::cref(input), begin, end));
+  }
+  threads.join_all();
+}
+
+void bob::trainer::MLPBaseTrainer::backward_rows
 (const bob::machine::MLP& machine,
- const blitz::Array<double,2>& input, const blitz::Array<double,2>& target)
+ const blitz::Array<double,2>& input, const blitz::Array<double,2>& target,
+ int begin, int end,
+ std::vector<blitz::Array<double,2> >& deriv,
+ std::vector<blitz::Array<double,1> >& deriv_bias)
 {
-  const std::vector<blitz::Array<double,2> >& machine_weight = machine.getWeights();
+  //views of the arrays shared with the other threads
+  const std::vector<blitz::Array<double,2> > machine_weight(bob::core::array::private_view(machine.getWeights()));
+  std::vector<blitz::Array<double,2> > output(bob::core::array::private_view(m_output));
+  std::vector<blitz::Array<double,2> > error(bob::core::array::private_view(m_error));
+
+  if (begin >= end) {
+    for (size_t k=0; k<machine_weight.size(); ++k) {
+      deriv[k] = 0.;
+      deriv_bias[k] = 0.;
+    }
+    return;
+  }
+
+  blitz::Range all = blitz::Range::all();
+  blitz::Range rows(begin, end-1);
 
   //last layer
-  boost::shared_ptr<bob::machine::Activation> output_actfun = machine.getOutputActivation();
-  for (int i=0; i<(int)m_batch_size; ++i) { //for every example
-    for (int j=0; j<m_error[m_H].extent(1); ++j) { //for all variables
-      m_error[m_H](i,j) = m_cost->error(m_output[m_H](i,j), target(i,j));
+  for (int i=begin; i<end; ++i) { //for every example
+    for (int j=0; j<error[m_H].extent(1); ++j) { //for all variables
+      error[m_H](i,j) = m_cost->error(output[m_H](i,j), target(i,j));
     }
   }
 
   //all other layers
   boost::shared_ptr<bob::machine::Activation> hidden_actfun = machine.getHiddenActivation();
   for (size_t k=m_H; k>0; --k) {
-    bob::math::prod_(m_error[k], machine_weight[k].transpose(1,0), m_error[k-1]);
-    for (int i=0; i<(int)m_batch_size; ++i) { //for every example
-      for (int j=0; j<m_error[k-1].extent(1); ++j) { //for all variables
-        m_error[k-1](i,j) *= hidden_actfun->f_prime_from_f(m_output[k-1](i,j));
-      }
-    }
+    blitz::Array<double,2> err(error[k-1](rows,all));
+    bob::math::gemm_(error[k](rows,all), machine_weight[k], err, false, true);
+    blitz::Array<double,2> fprime(output[k-1](rows,all).copy());
+    hidden_actfun->f_prime_from_f_inplace(fprime);
+    err *= fprime;
   }
 
-  //calculate the derivatives of the cost w.r.t. the weights and biases
+  //calculate the contributions of these examples to the derivatives of the
+  //cost w.r.t. the weights and biases
+  const double scale = 1. / m_batch_size;
+  const blitz::Array<double,2> in(bob::core::array::private_view(input)(rows,all));
+  blitz::secondIndex bj;
   for (size_t k=0; k<machine_weight.size(); ++k) { //for all layers
     // For the weights
-    if (k == 0) bob::math::prod_(input.transpose(1,0), m_error[k], m_deriv[k]);
-    else bob::math::prod_(m_output[k-1].transpose(1,0), m_error[k], m_deriv[k]);
-    m_deriv[k] /= m_batch_size;
+    if (k == 0) bob::math::gemm_(in, error[k](rows,all), deriv[k], true, false, scale);
+    else bob::math::gemm_(output[k-1](rows,all), error[k](rows,all), deriv[k], true, false, scale);
     // For the biases
-    blitz::secondIndex bj;
-    m_deriv_bias[k] = blitz::mean(m_error[k].transpose(1,0), bj);
+    deriv_bias[k] = blitz::sum(error[k](rows,all).transpose(1,0), bj) * scale;
+  }
+}
+
+void bob::trainer::MLPBaseTrainer::backward_step
+(const bob::machine::MLP& machine,
+ const blitz::Array<double,2>& input, const blitz::Array<double,2>& target)
+{
+  const int n_rows = m_output[0].extent(0);
+  const int n_blocks = number_of_blocks(m_n_threads, n_rows);
+  if (n_blocks == 1) {
+    backward_rows(machine, input, target, 0, n_rows, m_deriv, m_deriv_bias);
+    return;
+  }
+
+  //each thread back-propagates its own rows of the error buffers, and
+  //computes partial derivatives: the first thread in m_deriv, the other
+  //ones in their own buffers
+  boost::thread_group threads;
+  for (int t=0; t<n_blocks; ++t) {
+    const int begin = (int)(((int64_t)n_rows * t) / n_blocks);
+    const int end = (int)(((int64_t)n_rows * (t+1)) / n_blocks);
+    std::vector<blitz::Array<double,2> >& deriv =
+      (t == 0 ? m_deriv : m_thread_deriv[t-1]);
+    std::vector<blitz::Array<double,1> >& deriv_bias =
+      (t == 0 ? m_deriv_bias : m_thread_deriv_bias[t-1]);
+    threads.create_thread(boost::bind(&bob::trainer::MLPBaseTrainer::backward_rows,
+          this, boost::cref(machine), boost::cref(input), boost::cref(target),
+          begin, end, boost::ref(deriv), boost::ref(deriv_bias)));
+  }
+  threads.join_all();
+
+  //reduction
+  for (int t=1; t<n_blocks; ++t) {
+    for (size_t k=0; k<m_deriv.size(); ++k) {
+      m_deriv[k] += m_thread_deriv[t-1][k];
+      m_deriv_bias[k] += m_thread_deriv_bias[t-1][k];
+    }
   }
 }
 
@@ -221,6 +341,7 @@ void bob::trainer::MLPBaseTrainer::initialize(const bob::machine::MLP& machine)
     m_output[k].resize(m_batch_size, m_deriv[k].extent(1));
     m_error[k].resize(m_batch_size, m_deriv[k].extent(1));
   }
+  resize_thread_buffers();
 
   reset();
 }
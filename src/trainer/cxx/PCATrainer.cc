@@ -62,26 +62,22 @@ bool bob::trainer::PCATrainer::is_similar_to
 }
 
 /**
- * Sets up the machine calculating the PC's via the Covariance Matrix
+ * Sets up the machine from the mean and the covariance matrix of the data
  */
-static void pca_via_covmat(
+static void pca_from_covmat(
     bob::machine::LinearMachine& machine,
     blitz::Array<double,1>& eigen_values, 
-    const blitz::Array<double,2>& X,
+    const blitz::Array<double,1>& mean,
+    blitz::Array<double,2>& Sigma,
     int rank
     ) {
   /**
-   * computes the covariance matrix (X-mu)(X-mu)^T / (len(X)-1) and then solves
-   * the generalized eigen-value problem taking into consideration the
+   * solves the generalized eigen-value problem taking into consideration the
    * covariance matrix is symmetric (and, by extension, hermitian).
    */
-  blitz::Array<double,1> mean(X.extent(1));
-  blitz::Array<double,2> Sigma(X.extent(1), X.extent(1));
-  bob::math::scatter_(X, Sigma, mean);
-  Sigma /= (X.extent(0)-1); //unbiased variance estimator
-
-  blitz::Array<double,2> U(X.extent(1), X.extent(1));
-  blitz::Array<double,1> e(X.extent(1));
+  const int n_features = mean.extent(0);
+  blitz::Array<double,2> U(n_features, n_features);
+  blitz::Array<double,1> e(n_features);
   bob::math::eigSym_(Sigma, U, e);
   e.reverseSelf(0);
   U.reverseSelf(1);
@@ -102,6 +98,26 @@ static void pca_via_covmat(
   }
 }
 
+/**
+ * Sets up the machine calculating the PC's via the Covariance Matrix
+ */
+static void pca_via_covmat(
+    bob::machine::LinearMachine& machine,
+    blitz::Array<double,1>& eigen_values, 
+    const blitz::Array<double,2>& X,
+    int rank
+    ) {
+  /**
+   * computes the covariance matrix (X-mu)(X-mu)^T / (len(X)-1)
+   */
+  blitz::Array<double,1> mean(X.extent(1));
+  blitz::Array<double,2> Sigma(X.extent(1), X.extent(1));
+  bob::math::scatter_(X, Sigma, mean);
+  Sigma /= (X.extent(0)-1); //unbiased variance estimator
+
+  pca_from_covmat(machine, eigen_values, mean, Sigma, rank);
+}
+
 /**
  * Sets up the machine calculating the PC's via SVD
  */
@@ -190,7 +206,49 @@ void bob::trainer::PCATrainer::train(bob::machine::LinearMachine& machine,
   train(machine, throw_away_eigen_values, X);
 }
 
+void bob::trainer::PCATrainer::train(bob::machine::LinearMachine& machine,
+  blitz::Array<double,1>& eigen_values,
+  const bob::math::ScatterAccumulator& stats) const
+{
+  const int rank = output_size(stats);
+  const int n_features = stats.getNFeatures();
+
+  // Checks that the dimensions are matching
+  if (machine.inputSize() != (size_t)n_features) {
+    boost::format m("Number of features of the accumulated data (%d) does not match machine input size (%d)");
+    m % n_features % machine.inputSize();
+    throw std::runtime_error(m.str());
+  }
+  if (machine.outputSize() != (size_t)rank) {
+    boost::format m("Number of outputs of the given machine (%d) does not match the maximum covariance rank, i.e., min(#samples-1,#features) = min(%d, %d) = %d");
+    m % machine.outputSize() % (stats.getNSamples()-1) % n_features % rank;
+    throw std::runtime_error(m.str());
+  }
+  if (eigen_values.extent(0) != rank) {
+    boost::format m("Number of eigenvalues on the given 1D array (%d) does not match the maximum covariance rank, i.e., min(#samples-1,#features) = min(%d,%d) = %d");
+    m % eigen_values.extent(0) % (stats.getNSamples()-1) % n_features % rank;
+    throw std::runtime_error(m.str());
+  }
+
+  blitz::Array<double,2> Sigma(n_features, n_features);
+  stats.getCovariance(Sigma);
+  pca_from_covmat(machine, eigen_values, stats.getMean(), Sigma, rank);
+}
+
+void bob::trainer::PCATrainer::train(bob::machine::LinearMachine& machine,
+  const bob::math::ScatterAccumulator& stats) const
+{
+  blitz::Array<double,1> throw_away_eigen_values(output_size(stats));
+  train(machine, throw_away_eigen_values, stats);
+}
+
 size_t bob::trainer::PCATrainer::output_size
 (const blitz::Array<double,2>& X) const{
   return (size_t)std::min(X.extent(0)-1,X.extent(1));
 }
+
+size_t bob::trainer::PCATrainer::output_size
+(const bob::math::ScatterAccumulator& stats) const{
+  if (stats.getNSamples() == 0) return 0;
+  return (size_t)std::min(stats.getNSamples()-1, (uint64_t)stats.getNFeatures());
+}
@@ -0,0 +1,253 @@
+/**
+ * @file trainer/cxx/RandomizedPCATrainer.cc
+ * @date Sun Oct 19 10:24:51 2026 +0200
+ *
+ * @brief Truncated Principal Component Analysis based on randomized range
+ * finding. Implementation.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <boost/format.hpp>
+#include <bob/math/gemm.h>
+#include <bob/math/svd.h>
+#include <bob/math/eig.h>
+#include <bob/trainer/RandomizedPCATrainer.h>
+
+/**
+ * Number of rows of the blocks of an in-memory data set
+ */
+static const int BLOCK_SIZE = 256;
+
+namespace bob { namespace trainer { namespace detail {
+/**
+ * Reads an in-memory data set by blocks of rows, without copying it
+ */
+class ArraySource: public bob::trainer::BlockSource
+{
+  public:
+    ArraySource(const blitz::Array<double,2>& X):
+      m_X(X), m_next(0) {}
+
+    virtual size_t getNFeatures() const { return m_X.extent(1); }
+
+    virtual void rewind() { m_next = 0; }
+
+    virtual bool next(blitz::Array<double,2>& block)
+    {
+      if (m_next >= m_X.extent(0)) return false;
+      const int end = std::min(m_X.extent(0), m_next + BLOCK_SIZE);
+      block.reference(m_X(blitz::Range(m_X.lbound(0) + m_next,
+        m_X.lbound(0) + end - 1), blitz::Range::all()));
+      m_next = end;
+      return true;
+    }
+
+  private:
+    blitz::Array<double,2> m_X;
+    int m_next;
+};
+}}}
+
+bob::trainer::RandomizedPCATrainer::RandomizedPCATrainer(const size_t rank,
+    const size_t oversampling, const size_t n_iterations):
+  m_rank(rank), m_oversampling(oversampling), m_n_iterations(n_iterations),
+  m_rng(new boost::mt19937())
+{
+  setRank(rank);
+}
+
+bob::trainer::RandomizedPCATrainer::RandomizedPCATrainer
+(const bob::trainer::RandomizedPCATrainer& other):
+  m_rank(other.m_rank), m_oversampling(other.m_oversampling),
+  m_n_iterations(other.m_n_iterations), m_rng(other.m_rng)
+{
+}
+
+bob::trainer::RandomizedPCATrainer::~RandomizedPCATrainer() {}
+
+bob::trainer::RandomizedPCATrainer& bob::trainer::RandomizedPCATrainer::operator=
+(const bob::trainer::RandomizedPCATrainer& other)
+{
+  if (this != &other) {
+    m_rank = other.m_rank;
+    m_oversampling = other.m_oversampling;
+    m_n_iterations = other.m_n_iterations;
+    m_rng = other.m_rng;
+  }
+  return *this;
+}
+
+bool bob::trainer::RandomizedPCATrainer::operator==
+  (const bob::trainer::RandomizedPCATrainer& other) const
+{
+  return m_rank == other.m_rank &&
+    m_oversampling == other.m_oversampling &&
+    m_n_iterations == other.m_n_iterations &&
+    *m_rng == *(other.m_rng);
+}
+
+bool bob::trainer::RandomizedPCATrainer::operator!=
+  (const bob::trainer::RandomizedPCATrainer& other) const
+{
+  return !(this->operator==(other));
+}
+
+void bob::trainer::RandomizedPCATrainer::setRank(const size_t rank)
+{
+  if (rank == 0)
+    throw std::runtime_error("the number of components to extract should be strictly positive");
+  m_rank = rank;
+}
+
+/**
+ * Replaces Y by an orthonormal basis of its range (the left singular
+ * vectors)
+ */
+static void orthonormalize(blitz::Array<double,2>& Y)
+{
+  blitz::Array<double,2> U(Y.extent(0), Y.extent(1));
+  blitz::Array<double,1> sigma(Y.extent(1));
+  bob::math::svd_(Y, U, sigma);
+  Y = U;
+}
+
+/**
+ * Copies the given block of samples minus the mean into a contiguous array
+ */
+static void center(const blitz::Array<double,2>& block,
+  const blitz::Array<double,1>& mean, blitz::Array<double,2>& centered)
+{
+  blitz::Range a = blitz::Range::all();
+  centered.resize(block.extent(0), block.extent(1));
+  for (int i=0; i<block.extent(0); ++i)
+    centered(i,a) = block(block.lbound(0)+i, a) - mean;
+}
+
+void bob::trainer::RandomizedPCATrainer::multiply(BlockSource& data,
+  const blitz::Array<double,1>& mean, const blitz::Array<double,2>& Q,
+  blitz::Array<double,2>& Y) const
+{
+  Y = 0.;
+  blitz::Array<double,2> block, centered, T;
+  data.rewind();
+  while (data.next(block)) {
+    center(block, mean, centered);
+    T.resize(centered.extent(0), Q.extent(1));
+    bob::math::gemm_(centered, Q, T);
+    bob::math::gemm_(centered, T, Y, true, false, 1., 1.);
+  }
+}
+
+void bob::trainer::RandomizedPCATrainer::train(
+  bob::machine::LinearMachine& machine, blitz::Array<double,1>& eigen_values,
+  BlockSource& data) const
+{
+  const int n_features = data.getNFeatures();
+  const int rank = m_rank;
+
+  // Checks that the dimensions are matching
+  if (machine.inputSize() != (size_t)n_features) {
+    boost::format m("Number of features of the input data (%d) does not match machine input size (%d)");
+    m % n_features % machine.inputSize();
+    throw std::runtime_error(m.str());
+  }
+  if (machine.outputSize() != (size_t)rank) {
+    boost::format m("Number of outputs of the given machine (%d) does not match the number of components to extract (%d)");
+    m % machine.outputSize() % rank;
+    throw std::runtime_error(m.str());
+  }
+  if (eigen_values.extent(0) != rank) {
+    boost::format m("Number of eigenvalues on the given 1D array (%d) does not match the number of components to extract (%d)");
+    m % eigen_values.extent(0) % rank;
+    throw std::runtime_error(m.str());
+  }
+
+  // 1. Computes the mean of the data
+  blitz::Range a = blitz::Range::all();
+  blitz::Array<double,1> mean(n_features);
+  mean = 0.;
+  uint64_t n_samples = 0;
+  blitz::Array<double,2> block;
+  data.rewind();
+  while (data.next(block)) {
+    if (block.extent(1) != n_features) {
+      boost::format m("Number of features of a block of data (%d) does not match the one of the data source (%d)");
+      m % block.extent(1) % n_features;
+      throw std::runtime_error(m.str());
+    }
+    for (int i=block.lbound(0); i<=block.ubound(0); ++i) mean += block(i,a);
+    n_samples += block.extent(0);
+  }
+  if (n_samples < 2 || (uint64_t)rank > std::min(n_samples-1, (uint64_t)n_features)) {
+    boost::format m("Number of components to extract (%d) is larger than the maximum covariance rank, i.e., min(#samples-1,#features) = min(%d,%d)");
+    m % rank % ((int64_t)n_samples-1) % n_features;
+    throw std::runtime_error(m.str());
+  }
+  mean /= (double)n_samples;
+
+  // 2. Finds the range of the covariance matrix, starting from random
+  // directions, with power iterations
+  const int n_directions = std::min(n_features, rank + (int)m_oversampling);
+  blitz::Array<double,2> Q(n_features, n_directions);
+  boost::normal_distribution<double> normal;
+  boost::variate_generator<boost::mt19937&, boost::normal_distribution<double> >
+    die(*m_rng, normal);
+  for (int i=0; i<n_features; ++i)
+    for (int j=0; j<n_directions; ++j)
+      Q(i,j) = die();
+
+  blitz::Array<double,2> Y(n_features, n_directions);
+  multiply(data, mean, Q, Y);
+  for (size_t it=0; it<m_n_iterations; ++it) {
+    orthonormalize(Y);
+    multiply(data, mean, Y, Q);
+    Y = Q;
+  }
+  orthonormalize(Y);
+
+  // 3. Projects the covariance matrix on this range (Rayleigh-Ritz), and
+  // solves the small eigen value problem
+  blitz::Array<double,2> B(n_directions, n_directions);
+  B = 0.;
+  blitz::Array<double,2> centered, T;
+  data.rewind();
+  while (data.next(block)) {
+    center(block, mean, centered);
+    T.resize(centered.extent(0), n_directions);
+    bob::math::gemm_(centered, Y, T);
+    bob::math::syrk_(T, B, 1., 1.);
+  }
+  blitz::Array<double,2> V(n_directions, n_directions);
+  blitz::Array<double,1> e(n_directions);
+  bob::math::eigSym_(B, V, e);
+  e.reverseSelf(0);
+  V.reverseSelf(1);
+
+  // 4. Sets the linear machine with the leading components
+  blitz::Range up_to_rank(0, rank-1);
+  blitz::Array<double,2> U(n_features, rank);
+  bob::math::gemm_(Y, V(a,up_to_rank), U);
+  machine.setInputSubtraction(mean);
+  machine.setInputDivision(1.0);
+  machine.setBiases(0.0);
+  machine.setWeights(U);
+  eigen_values = e(up_to_rank) / (double)(n_samples-1); //unbiased variance estimator
+}
+
+void bob::trainer::RandomizedPCATrainer::train(
+  bob::machine::LinearMachine& machine, blitz::Array<double,1>& eigen_values,
+  const blitz::Array<double,2>& X) const
+{
+  bob::trainer::detail::ArraySource data(X);
+  train(machine, eigen_values, data);
+}
+
+void bob::trainer::RandomizedPCATrainer::train(
+  bob::machine::LinearMachine& machine, const blitz::Array<double,2>& X) const
+{
+  blitz::Array<double,1> throw_away_eigen_values(m_rank);
+  train(machine, throw_away_eigen_values, X);
+}
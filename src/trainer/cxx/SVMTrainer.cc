@@ -227,20 +227,17 @@ boost::shared_ptr<bob::machine::SupportVector> bob::trainer::SVMTrainer::train
   }
 
   //converts the input arraysets into something libsvm can digest
-  double save_gamma = m_param.gamma; ///< the next method may update it!
+  svm_parameter param = m_param; ///< the next method may update it!
   boost::shared_ptr<svm_problem> problem =
-    data2problem(data, input_subtraction, input_division,
-        const_cast<svm_parameter&>(m_param) ///< temporary cast
-        );
+    data2problem(data, input_subtraction, input_division, param);
 
   //checks parametrization to make sure all is alright.
-  const char* error_msg = svm_check_parameter(problem.get(), &m_param);
+  const char* error_msg = svm_check_parameter(problem.get(), &param);
 
   if (error_msg) {
-    const_cast<double&>(m_param.gamma) = save_gamma;
     boost::format m("libsvm-%d reports: %s");
     m % libsvm_version % error_msg;
-    std::runtime_error(m.str());
+    throw std::runtime_error(m.str());
   }
 
   //do the training, returns the new machine
@@ -251,11 +248,9 @@ boost::shared_ptr<bob::machine::SupportVector> bob::trainer::SVMTrainer::train
   m % libsvm_version;
   debug_libsvm(m.str().c_str());
 #endif
-  boost::shared_ptr<svm_model> model(svm_train(problem.get(), &m_param),
+  boost::shared_ptr<svm_model> model(svm_train(problem.get(), &param),
       std::ptr_fun(svm_model_free));
 
-  const_cast<double&>(m_param.gamma) = save_gamma;
-
   //save newly created machine to file, reload from there to get rid of memory
   //dependencies due to the poorly implemented memory model in libsvm
   boost::shared_ptr<svm_model> new_model =
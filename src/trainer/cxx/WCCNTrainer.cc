@@ -72,6 +72,51 @@ void bob::trainer::WCCNTrainer::train(bob::machine::LinearMachine& machine,
     }
   }
 
+  // 1. Computes the mean vector and the Scatter matrix Sw and Sb
+  blitz::Array<double,1> mean(n_features);
+  blitz::Array<double,2> buf1(n_features, n_features); // Sw
+  blitz::Array<double,2> buf2(n_features, n_features); // Sb
+  bob::math::scatters(data, buf1, buf2, mean); // buf1 = Sw; buf2 = Sb
+
+  setupMachine(machine, buf1, n_classes);
+}
+
+void bob::trainer::WCCNTrainer::train(bob::machine::LinearMachine& machine,
+    const std::vector<bob::math::ScatterAccumulator>& classes)
+{
+  const size_t n_classes = classes.size();
+  // if #classes < 2, then throw
+  if (n_classes < 2) {
+    boost::format m("number of classes should be >= 2, but you passed %u");
+    m % n_classes;
+    throw std::runtime_error(m.str());
+  }
+
+  // checks for the shape once
+  const size_t n_features = classes[0].getNFeatures();
+
+  for (size_t cl=0; cl<n_classes; ++cl) {
+    if (classes[cl].getNFeatures() != n_features) {
+      boost::format m("number of features of the accumulator for class %u (%u) does not match that of the accumulator for class 0 (%u)");
+      m % cl % classes[cl].getNFeatures() % n_features;
+      throw std::runtime_error(m.str());
+    }
+  }
+
+  // 1. Computes the mean vector and the Scatter matrix Sw and Sb
+  blitz::Array<double,1> mean(n_features);
+  blitz::Array<double,2> Sw(n_features, n_features);
+  blitz::Array<double,2> Sb(n_features, n_features);
+  bob::math::scatters(classes, Sw, Sb, mean);
+
+  setupMachine(machine, Sw, n_classes);
+}
+
+void bob::trainer::WCCNTrainer::setupMachine(bob::machine::LinearMachine& machine,
+    blitz::Array<double,2>& Sw, const size_t n_classes)
+{
+  const int n_features = Sw.extent(0);
+
   // machine dimensions
   const size_t n_inputs = machine.inputSize();
   const size_t n_outputs = machine.outputSize();
@@ -88,11 +133,8 @@ void bob::trainer::WCCNTrainer::train(bob::machine::LinearMachine& machine,
     throw std::runtime_error(m.str());
   }
 
-  // 1. Computes the mean vector and the Scatter matrix Sw and Sb
-  blitz::Array<double,1> mean(n_features);
-  blitz::Array<double,2> buf1(n_features, n_features); // Sw
-  blitz::Array<double,2> buf2(n_features, n_features); // Sb
-  bob::math::scatters(data, buf1, buf2, mean); // buf1 = Sw; buf2 = Sb
+  blitz::Array<double,2> buf1(Sw);
+  blitz::Array<double,2> buf2(n_features, n_features);
 
   // 2. Computes the inverse of (1/N * Sw), Sw is the within-class covariance matrix
   buf1 /= n_classes;
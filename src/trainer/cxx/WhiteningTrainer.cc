@@ -76,6 +76,41 @@ void bob::trainer::WhiteningTrainer::train(bob::machine::LinearMachine& machine,
   bob::math::scatter(ar, cov, mean);
   cov /= (double)(n_samples-1);
 
+  setupMachine(machine, mean, cov);
+}
+
+void bob::trainer::WhiteningTrainer::train(bob::machine::LinearMachine& machine, 
+  const bob::math::ScatterAccumulator& stats)
+{
+  const size_t n_features = stats.getNFeatures();
+  // machine dimensions
+  const size_t n_inputs = machine.inputSize();
+  const size_t n_outputs = machine.outputSize();
+
+  // Checks that the dimensions are matching
+  if (n_inputs != n_features) {
+    boost::format m("machine input size (%u) does not match the number of features of the accumulated data (%u)");
+    m % n_inputs % n_features;
+    throw std::runtime_error(m.str());
+  }
+  if (n_outputs != n_features) {
+    boost::format m("machine output size (%u) does not match the number of features of the accumulated data (%u)");
+    m % n_outputs % n_features;
+    throw std::runtime_error(m.str());
+  }
+
+  // 1. Gets the covariance matrix of the training set
+  blitz::Array<double,2> cov(n_features,n_features);
+  stats.getCovariance(cov);
+
+  setupMachine(machine, stats.getMean(), cov);
+}
+
+void bob::trainer::WhiteningTrainer::setupMachine(bob::machine::LinearMachine& machine,
+  const blitz::Array<double,1>& mean, const blitz::Array<double,2>& cov)
+{
+  const size_t n_features = mean.extent(0);
+
   // 2. Computes the inverse of the covariance matrix
   blitz::Array<double,2> icov(n_features,n_features);
   bob::math::inv(cov, icov);
@@ -17,8 +17,31 @@
 
 using namespace boost::python;
 
+/**
+ * Tells if the data of the classes is given as a sequence of
+ * bob.math.ScatterAccumulator instead of a sequence of arrays
+ */
+static bool is_accumulators(object data)
+{
+  return len(data) > 0 && extract<const bob::math::ScatterAccumulator&>(data[0]).check();
+}
+
+static std::vector<bob::math::ScatterAccumulator> accumulators(object data)
+{
+  stl_input_iterator<bob::math::ScatterAccumulator> dbegin(data), dend;
+  return std::vector<bob::math::ScatterAccumulator>(dbegin, dend);
+}
+
 static tuple lda_train1(bob::trainer::FisherLDATrainer& t, object data)
 {
+  if (is_accumulators(data)) {
+    std::vector<bob::math::ScatterAccumulator> classes = accumulators(data);
+    int osize = t.output_size(classes);
+    blitz::Array<double,1> eig_val(osize);
+    bob::machine::LinearMachine m(classes[0].getNFeatures(), osize);
+    t.train(m, eig_val, classes);
+    return make_tuple(m, eig_val);
+  }
   stl_input_iterator<bob::python::const_ndarray> dbegin(data), dend;
   std::vector<bob::python::const_ndarray> vdata_ref(dbegin, dend);
   std::vector<blitz::Array<double,2> > vdata;
@@ -35,6 +58,12 @@ static tuple lda_train1(bob::trainer::FisherLDATrainer& t, object data)
 static object lda_train2(bob::trainer::FisherLDATrainer& t,
   bob::machine::LinearMachine& m, object data)
 {
+  if (is_accumulators(data)) {
+    std::vector<bob::math::ScatterAccumulator> classes = accumulators(data);
+    blitz::Array<double,1> eig_val(t.output_size(classes));
+    t.train(m, eig_val, classes);
+    return object(eig_val);
+  }
   stl_input_iterator<bob::python::const_ndarray> dbegin(data), dend;
   std::vector<bob::python::const_ndarray> vdata_ref(dbegin, dend);
   std::vector<blitz::Array<double,2> > vdata;
@@ -47,6 +76,7 @@ static object lda_train2(bob::trainer::FisherLDATrainer& t,
 }
 
 static size_t output_size(bob::trainer::FisherLDATrainer& t, object data) {
+  if (is_accumulators(data)) return t.output_size(accumulators(data));
   stl_input_iterator<bob::python::const_ndarray> dbegin(data), dend;
   std::vector<bob::python::const_ndarray> vdata_ref(dbegin, dend);
   std::vector<blitz::Array<double,2> > vdata;
@@ -135,7 +165,7 @@ void bind_trainer_lda()
     .def("train", &lda_train1, (arg("self"), arg("X")), 
         "Creates a LinearMachine that performs Fisher/LDA discrimination.\n" \
         "\n" \
-        "The resulting machine will contain the eigen-vectors of the :math:`S_w^{-1} S_b` product, arranged by decreasing energy. Each input arrayset represents data from a given input class. This method returns a tuple containing the resulting linear machine and the eigen values in a 1D array. This way, you can reset the machine as you see fit.\n" \
+        "The resulting machine will contain the eigen-vectors of the :math:`S_w^{-1} S_b` product, arranged by decreasing energy. Each input arrayset represents data from a given input class. The classes may also be given as :py:class:`bob.math.ScatterAccumulator`'s filled with the data of each class, which then does not need to be loaded in memory. This method returns a tuple containing the resulting linear machine and the eigen values in a 1D array. This way, you can reset the machine as you see fit.\n" \
         "\n" \
         ".. note::\n" \
         "   \n" \
@@ -145,7 +175,7 @@ void bind_trainer_lda()
     .def("train", &lda_train2, (arg("self"), arg("machine"), arg("X")),
         "Trains a given LinearMachine to perform Fisher/LDA discrimination.\n" \
         "\n" \
-        "After this method has been called, the input machine will have the eigen-vectors of the :math:`S_w^{-1} S_b` product, arranged by decreasing energy. Each input data set represents data from a given input class. This method also returns the eigen values allowing you to implement your own compression scheme.\n" \
+        "After this method has been called, the input machine will have the eigen-vectors of the :math:`S_w^{-1} S_b` product, arranged by decreasing energy. Each input data set represents data from a given input class. The classes may also be given as :py:class:`bob.math.ScatterAccumulator`'s filled with the data of each class. This method also returns the eigen values allowing you to implement your own compression scheme.\n" \
         "\n" \
         ".. note::\n" \
         "   \n" \
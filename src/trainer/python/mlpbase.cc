@@ -220,6 +220,8 @@ void bind_trainer_mlpbase() {
 
     .add_property("train_biases", &bob::trainer::MLPBaseTrainer::getTrainBiases, &bob::trainer::MLPBaseTrainer::setTrainBiases, "A flag, indicating if this trainer will adjust the biases of the network (``True``) or not (``False``).")
 
+    .add_property("n_threads", &bob::trainer::MLPBaseTrainer::getNThreads, &bob::trainer::MLPBaseTrainer::setNThreads, "The number of threads used to forward and back-propagate a batch (defaults to 1). The examples of the batch are split into contiguous blocks, one per thread, and the derivatives obtained on each block are summed up.")
+
     .def("is_compatible", &bob::trainer::MLPBaseTrainer::isCompatible, (arg("self"), arg("machine")), "Checks if a given machine is compatible with my inner settings")
 
     .def("initialize", &bob::trainer::MLPBaseTrainer::initialize, (arg("self"), arg("mlp")), "Initialize the training process.")
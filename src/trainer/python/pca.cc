@@ -14,6 +14,7 @@
 
 #include <bob/python/ndarray.h>
 #include <bob/trainer/PCATrainer.h>
+#include <bob/trainer/RandomizedPCATrainer.h>
 
 using namespace boost::python;
 
@@ -38,6 +39,101 @@ static object pca_train2(bob::trainer::PCATrainer& t,
   return object(eig_val);
 }
 
+static tuple pca_train_stats1(bob::trainer::PCATrainer& t,
+    const bob::math::ScatterAccumulator& stats) {
+
+  const int rank = t.output_size(stats);
+  bob::machine::LinearMachine m(stats.getNFeatures(), rank);
+  blitz::Array<double,1> eig_val(rank);
+  t.train(m, eig_val, stats);
+  return make_tuple(m, object(eig_val));
+}
+
+static object pca_train_stats2(bob::trainer::PCATrainer& t,
+    bob::machine::LinearMachine& m, const bob::math::ScatterAccumulator& stats) {
+
+  const int rank = t.output_size(stats);
+  blitz::Array<double,1> eig_val(rank);
+  t.train(m, eig_val, stats);
+  return object(eig_val);
+}
+
+static size_t pca_output_size(const bob::trainer::PCATrainer& t,
+    bob::python::const_ndarray data) {
+  return t.output_size(data.bz<double,2>());
+}
+
+/**
+ * Reads the blocks of a data set from a python iterable, which is iterated
+ * again at each pass
+ */
+class PythonBlockSource: public bob::trainer::BlockSource
+{
+  public:
+    PythonBlockSource(object blocks): m_blocks(blocks), m_n_features(0)
+    {
+      rewind();
+      blitz::Array<double,2> first;
+      if (!next(first))
+        PYTHON_ERROR(RuntimeError, "the data set should contain at least one block");
+      m_n_features = first.extent(1);
+    }
+
+    virtual size_t getNFeatures() const { return m_n_features; }
+
+    virtual void rewind()
+    {
+      m_iterator = object(handle<>(PyObject_GetIter(m_blocks.ptr())));
+    }
+
+    virtual bool next(blitz::Array<double,2>& block)
+    {
+      PyObject* item = PyIter_Next(m_iterator.ptr());
+      if (!item) {
+        if (PyErr_Occurred()) throw_error_already_set();
+        return false;
+      }
+      object block_(handle<>(item));
+      // the block is copied, as the python array is released afterwards
+      bob::python::const_ndarray array(block_);
+      block.reference(array.cast<double,2>().copy());
+      return true;
+    }
+
+  private:
+    object m_blocks;
+    object m_iterator;
+    size_t m_n_features;
+};
+
+static tuple rpca_train1(const bob::trainer::RandomizedPCATrainer& t,
+    bob::python::const_ndarray data) {
+
+  const blitz::Array<double,2> data_ = data.bz<double,2>();
+  bob::machine::LinearMachine m(data_.extent(1), t.getRank());
+  blitz::Array<double,1> eig_val(t.getRank());
+  t.train(m, eig_val, data_);
+  return make_tuple(m, object(eig_val));
+}
+
+static object rpca_train2(const bob::trainer::RandomizedPCATrainer& t,
+    bob::machine::LinearMachine& m, bob::python::const_ndarray data) {
+
+  blitz::Array<double,1> eig_val(t.getRank());
+  t.train(m, eig_val, data.bz<double,2>());
+  return object(eig_val);
+}
+
+static tuple rpca_train_blocks(const bob::trainer::RandomizedPCATrainer& t,
+    object blocks) {
+
+  PythonBlockSource source(blocks);
+  bob::machine::LinearMachine m(source.getNFeatures(), t.getRank());
+  blitz::Array<double,1> eig_val(t.getRank());
+  t.train(m, eig_val, source);
+  return make_tuple(m, object(eig_val));
+}
+
 static const char CLASS_DOC[] = \
   "Sets a linear machine to perform the Principal Component Analysis (a.k.a. Karhunen-Loève Transform) on a given dataset using either Singular Value Decomposition (SVD, *the default*) or the Covariance Matrix Method.\n" \
   "\n" \
@@ -158,7 +254,19 @@ void bind_trainer_pca() {
         "  The input data matrix :math:`X`, of 64-bit floating point numbers organized in such a way that every row corresponds to a new observation of the phenomena (i.e., a new sample) and every column corresponds to a different feature.\n"
         )
 
-    .def("output_size", &bob::trainer::PCATrainer::output_size, (arg("self"), arg("X")), 
+    .def("train", &pca_train_stats1, (arg("self"), arg("stats")),
+        "Trains a LinearMachine to perform the KLT, from the mean and the scatter matrix of the data accumulated by a :py:class:`bob.math.ScatterAccumulator`, so that the data set does not need to be loaded in memory at once. The Covariance Method is always used.\n" \
+        "\n" \
+        "This method returns a tuple containing the resulting linear machine and the eigen values in a 1D array.\n"
+        )
+
+    .def("train", &pca_train_stats2, (arg("self"), arg("machine"), arg("stats")),
+        "Trains a LinearMachine to perform the KLT, from the mean and the scatter matrix of the data accumulated by a :py:class:`bob.math.ScatterAccumulator`, so that the data set does not need to be loaded in memory at once. The Covariance Method is always used.\n" \
+        "\n" \
+        "This method returns the eigen values in a 1D array and sets-up the input machine to perform PCA.\n"
+        )
+
+    .def("output_size", &pca_output_size, (arg("self"), arg("X")), 
         "Calculates the maximum possible rank for the covariance matrix of X, given X\n"\
         "\n" \
         "Returns the maximum number of non-zero eigen values that can be generated by this trainer, given some data. This number (K) depends on the size of X and is calculated as follows :math:`K=\\min{(S-1,F)}`, with :math:`S` being the number of rows in ``data`` (samples) and :math:`F` the number of columns (or features).\n" \
@@ -175,4 +283,25 @@ void bind_trainer_pca() {
         "If the use_svd flag is enabled, this flag will indicates which LAPACK svd function to use (dgesvd if set to true, dgesdd otherwise).")
     ;
 
+  class_<bob::trainer::RandomizedPCATrainer, boost::shared_ptr<bob::trainer::RandomizedPCATrainer> >("RandomizedPCATrainer",
+      "Sets a linear machine to perform a truncated Principal Component Analysis, which only extracts the given number of leading components.\n" \
+      "\n" \
+      "The range of the covariance matrix is found by randomized power iterations, and the components are extracted from a small eigen value problem on this range (Rayleigh-Ritz). Neither the covariance matrix nor its full eigen decomposition is computed: each pass over the data only requires products of blocks of samples with matrices of size (n_features, rank+oversampling). The data is read 3+n_iterations times, and may be given as blocks of rows with :py:meth:`train_blocks`, so that it does not need to be loaded in memory at once.\n" \
+      "\n" \
+      "The resulting :py:class:`bob.machine.LinearMachine` has the same format as the one of :py:class:`bob.trainer.PCATrainer`, with the components sorted by decreasing eigen value.\n" \
+      "\n" \
+      "Reference: \"Finding structure with randomness: Probabilistic algorithms for constructing approximate matrix decompositions\", N. Halko, P. G. Martinsson and J. A. Tropp, SIAM Review 53(2), 2011.\n",
+      init<const size_t, optional<const size_t, const size_t> >((arg("self"), arg("rank"), arg("oversampling")=10, arg("n_iterations")=2), "Initializes a new trainer, which extracts 'rank' components. 'oversampling' additional random directions are used to find the range of the covariance matrix, and 'n_iterations' power iterations improve the accuracy when the eigen values decrease slowly."))
+    .def(init<const bob::trainer::RandomizedPCATrainer&>((arg("self"), arg("other")), "Copy constructor"))
+    .def(self == self)
+    .def(self != self)
+    .def("train", &rpca_train1, (arg("self"), arg("X")), "Trains and returns a LinearMachine extracting the leading components of the data matrix X (one sample per row), with the corresponding eigen values of the covariance matrix, in a tuple.")
+    .def("train", &rpca_train2, (arg("self"), arg("machine"), arg("X")), "Trains the given LinearMachine to extract the leading components of the data matrix X (one sample per row), and returns the corresponding eigen values of the covariance matrix.")
+    .def("train_blocks", &rpca_train_blocks, (arg("self"), arg("blocks")), "Trains and returns a LinearMachine extracting the leading components of a data set given as blocks of rows, with the corresponding eigen values of the covariance matrix, in a tuple. 'blocks' is iterated several times, and should give the same 2D arrays at each pass (e.g. a list, or an object whose __iter__ method reads the blocks from a file).")
+    .add_property("rank", &bob::trainer::RandomizedPCATrainer::getRank, &bob::trainer::RandomizedPCATrainer::setRank, "The number of components to extract")
+    .add_property("oversampling", &bob::trainer::RandomizedPCATrainer::getOversampling, &bob::trainer::RandomizedPCATrainer::setOversampling, "The number of additional random directions used to find the range of the covariance matrix")
+    .add_property("n_iterations", &bob::trainer::RandomizedPCATrainer::getNIterations, &bob::trainer::RandomizedPCATrainer::setNIterations, "The number of power iterations")
+    .add_property("rng", &bob::trainer::RandomizedPCATrainer::getRng, &bob::trainer::RandomizedPCATrainer::setRng, "The Mersenne Twister mt19937 random generator used for the random directions.")
+    ;
+
 }
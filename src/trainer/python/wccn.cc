@@ -54,8 +54,28 @@ static char CLASS_DOC[] = \
   "\n"\
 ;
 
+/**
+ * Tells if the data of the classes is given as a sequence of
+ * bob.math.ScatterAccumulator instead of a sequence of arrays
+ */
+static bool is_accumulators(object data)
+{
+  return len(data) > 0 && extract<const bob::math::ScatterAccumulator&>(data[0]).check();
+}
+
+static std::vector<bob::math::ScatterAccumulator> accumulators(object data)
+{
+  stl_input_iterator<bob::math::ScatterAccumulator> dbegin(data), dend;
+  return std::vector<bob::math::ScatterAccumulator>(dbegin, dend);
+}
+
 void py_train1(bob::trainer::WCCNTrainer& t, bob::machine::LinearMachine& m, object data)
 {
+  if (is_accumulators(data)) {
+    std::vector<bob::math::ScatterAccumulator> classes = accumulators(data);
+    t.train(m, classes);
+    return;
+  }
   stl_input_iterator<bob::python::const_ndarray> dbegin(data), dend;
   std::vector<bob::python::const_ndarray> vdata_ref(dbegin, dend);
   std::vector<blitz::Array<double,2> > vdata;
@@ -68,6 +88,12 @@ void py_train1(bob::trainer::WCCNTrainer& t, bob::machine::LinearMachine& m, obj
 
 object py_train2(bob::trainer::WCCNTrainer& t, object data)
 {
+  if (is_accumulators(data)) {
+    std::vector<bob::math::ScatterAccumulator> classes = accumulators(data);
+    bob::machine::LinearMachine m(classes[0].getNFeatures(), classes[0].getNFeatures());
+    t.train(m, classes);
+    return object(m);
+  }
   stl_input_iterator<bob::python::const_ndarray> dbegin(data), dend;
   std::vector<bob::python::const_ndarray> vdata_ref(dbegin, dend);
   std::vector<blitz::Array<double,2> > vdata;
@@ -86,7 +112,7 @@ void bind_trainer_wccn()
     .def(self == self)
     .def(self != self)
     .def("is_similar_to", &bob::trainer::WCCNTrainer::is_similar_to, (arg("self"), arg("other"), arg("r_epsilon")=1e-5, arg("a_epsilon")=1e-8), "Compares this WCCNTrainer with the 'other' one to be approximately the same.")
-    .def("train", &py_train1, (arg("self"), arg("machine"), arg("data")), "Trains the LinearMachine to perform the WCCN, given a training set.")
-    .def("train", &py_train2, (arg("self"), arg("data")), "Allocates, trains and returns a LinearMachine to perform the WCCN, given a training set.")
+    .def("train", &py_train1, (arg("self"), arg("machine"), arg("data")), "Trains the LinearMachine to perform the WCCN, given a training set (a list of arrays, or of :py:class:`bob.math.ScatterAccumulator` filled with the data of each class).")
+    .def("train", &py_train2, (arg("self"), arg("data")), "Allocates, trains and returns a LinearMachine to perform the WCCN, given a training set (a list of arrays, or of :py:class:`bob.math.ScatterAccumulator` filled with the data of each class).")
   ;
 }
@@ -10,6 +10,8 @@
  * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
  */
 
+#include <cmath>
+#include <algorithm>
 #include <boost/lambda/lambda.hpp>
 #include <boost/lambda/bind.hpp>
 #include <boost/format.hpp>
@@ -18,6 +20,7 @@
 
 #include "bob/visioner/cv/cv_detector.h"
 #include "bob/visioner/model/mdecoder.h"
+#include "bob/visioner/util/threads.h"
 #include "bob/visioner/util/timer.h"
 
 namespace bob { namespace visioner {
@@ -26,9 +29,17 @@ namespace bob { namespace visioner {
   CVDetector::CVDetector():	
     m_ds(2),
     m_cluster(0.05),
+    m_nms(NMSGreedy),
     m_threshold(0.0),
     m_type(GroundTruth),
-    m_levels(0)
+    m_rescan(10),
+    m_track_range(4),
+    m_levels(0),
+    m_calibrated(false),
+    m_tracking(false),
+    m_track_frames(0),
+    m_track_rows(0),
+    m_track_cols(0)
   {
   }
 
@@ -69,10 +80,34 @@ namespace bob { namespace visioner {
       ("detect_cluster",
        boost::program_options::value<double>()->default_value(m_cluster),
        "detection: overlapping threshold for clustering detections")
+
+      ("detect_nms",
+       boost::program_options::value<std::string>()->default_value("greedy"),
+       "detection: method for clustering detections (greedy, average, soft)")
       
       ("detect_method",
        boost::program_options::value<std::string>()->default_value("groundtruth"),
-       "detection: method (scanning, groundtruth)");
+       "detection: method (scanning, groundtruth)")
+
+      ("detect_incremental",
+       boost::program_options::value<bool>()->default_value(false),
+       "detection: build the image pyramid incrementally (video processing)")
+
+      ("detect_calibrated",
+       boost::program_options::value<bool>()->default_value(false),
+       "detection: use the calibrated rejection thresholds for each level")
+
+      ("detect_tracking",
+       boost::program_options::value<bool>()->default_value(false),
+       "detection: scan only around the previous detections (video processing)")
+
+      ("detect_rescan",
+       boost::program_options::value<uint64_t>()->default_value(m_rescan),
+       "detection: tracking - scan the whole image every given number of frames")
+
+      ("detect_track_range",
+       boost::program_options::value<uint64_t>()->default_value(m_track_range),
+       "detection: tracking - neighbourhood size (in scanning steps) of the previous detections");
 
   }
 
@@ -102,6 +137,26 @@ namespace bob { namespace visioner {
     decode_var(po_desc, po_vm, "detect_ds", m_ds);
     decode_var(po_desc, po_vm, "detect_cluster", m_cluster);     
 
+    std::string cmd_nms;
+    decode_var(po_desc, po_vm, "detect_nms", cmd_nms);
+    if (decode_nms(cmd_nms, m_nms) == false)
+    {
+      bob::core::error << "Invalid clustering method!" << std::endl;
+      return false;
+    }
+
+    bool cmd_incremental = false;
+    decode_var(po_desc, po_vm, "detect_incremental", cmd_incremental);
+    set_incremental(cmd_incremental);
+
+    decode_var(po_desc, po_vm, "detect_calibrated", m_calibrated);
+
+    bool cmd_tracking = false;
+    decode_var(po_desc, po_vm, "detect_tracking", cmd_tracking);
+    set_tracking(cmd_tracking);
+    decode_var(po_desc, po_vm, "detect_rescan", m_rescan);
+    decode_var(po_desc, po_vm, "detect_track_range", m_track_range);
+
     std::string cmd_method;
     decode_var(po_desc, po_vm, "detect_method", cmd_method);
 
@@ -130,8 +185,16 @@ namespace bob { namespace visioner {
       CVDetector::Type detection_method):
     m_ds(scale_variation),
     m_cluster(clustering),
+    m_nms(NMSGreedy),
     m_threshold(threshold),
-    m_type(detection_method) {
+    m_type(detection_method),
+    m_rescan(10),
+    m_track_range(4),
+    m_calibrated(false),
+    m_tracking(false),
+    m_track_frames(0),
+    m_track_rows(0),
+    m_track_cols(0) {
 
       // Load the model
       if (Model::load(model, m_model) == false) {
@@ -162,6 +225,7 @@ namespace bob { namespace visioner {
     // Build the level classifiers
     m_lmodel_begins.resize(n_outputs(), m_levels + 1);
     m_lmodel_ends.resize(n_outputs(), m_levels + 1);
+    m_lrejections.resize(n_outputs(), m_levels + 1);
     for (uint64_t o = 0; o < n_outputs(); o ++)
     {
       const uint64_t size = m_model->n_luts(o);
@@ -175,23 +239,70 @@ namespace bob { namespace visioner {
         m_lmodel_ends(o, l) = size >> (m_levels - l);
       }
     }
+
+    // ... and the minimum score required to evaluate each level:
+    //	either zero or the calibrated thresholds (if available)
+    const std::vector<std::vector<double> >& rejections = m_model->rejections();
+    m_ocalibrated.resize(n_outputs());
+    for (uint64_t o = 0; o < n_outputs(); o ++)
+    {
+      const bool calibrated = m_calibrated == true &&
+        o < rejections.size() && rejections[o].size() == m_levels;
+      m_ocalibrated[o] = calibrated;
+
+      m_lrejections(o, 0) = 0.0;
+      for (uint64_t l = 1; l <= m_levels; l ++)
+      {
+        m_lrejections(o, l) = calibrated ? rejections[o][l - 1] : 0.0;
+      }
+    }
+  }
+
+  void CVDetector::set_calibrated(bool calibrated) {
+    m_calibrated = calibrated;
+    set_scan_levels(m_levels);
+  }
+
+  void CVDetector::set_tracking(bool tracking) {
+    m_tracking = tracking;
+    reset_tracking();
+  }
+
+  void CVDetector::reset_tracking() {
+    m_tracks.clear();
+    m_track_frames = 0;
+    m_track_rows = 0;
+    m_track_cols = 0;
   }
 
   // Load an image (build the image pyramid)
   bool CVDetector::load(const std::string& ifile, const std::string& gfile)
   {
-    return	m_ipyramid.load(ifile, gfile) &&
-      m_ipyramid.empty() == false;
+    return	loaded(m_ipyramid.load(ifile, gfile));
   }
   bool CVDetector::load(const ipscale_t& ipscale)
   {
-    return	m_ipyramid.load(ipscale) &&
-      m_ipyramid.empty() == false;
+    return	loaded(m_ipyramid.load(ipscale));
   }
   bool CVDetector::load(const uint8_t* image, uint64_t rows, uint64_t cols)
   {
-    return	m_ipyramid.load(image, rows, cols) &&
-      m_ipyramid.empty() == false;
+    return	loaded(m_ipyramid.load(image, rows, cols));
+  }
+
+  // Finalize the image pyramid after loading a new image
+  bool CVDetector::loaded(bool ok)
+  {
+    if (ok == false || m_ipyramid.empty() == true)
+    {
+      return false;
+    }
+
+    if (m_ipyramid.incremental() == true)
+    {
+      m_ipyramid.integrate(boost::thread::hardware_concurrency());
+    }
+
+    return true;
   }
 
   // Check the validity of different components
@@ -244,8 +355,78 @@ namespace bob { namespace visioner {
       return false;
     }
 
-    // Scan the image ... 
+    m_stats.m_level_sws.resize(std::max(m_stats.m_level_sws.size(), (size_t)m_levels + 1), 0);
+    m_stats.m_level_evals.resize(std::max(m_stats.m_level_evals.size(), (size_t)m_levels + 1), 0);
+
+    // Scan the whole image or only around the previous detections (tracking)
+    const bool tracked = m_tracking == true &&
+      m_tracks.empty() == false &&
+      m_track_frames < m_rescan &&
+      m_track_rows == ipscale().rows() &&
+      m_track_cols == ipscale().cols();
+
     Timer timer;
+    if (tracked == true)
+    {
+      std::vector<subwindow_t> sws;
+      track(sws);
+      scan_subwindows(sws, detections);
+    }
+    else
+    {
+      scan_pyramid(detections);
+    }
+
+    // Update statistics
+    m_stats.m_gts += n_objects();
+    m_stats.m_timing += timer.elapsed();
+    m_stats.m_frames ++;
+    m_stats.m_tracked += tracked == true ? 1 : 0;
+
+    // OK, cluster detections
+    nms(detections, m_cluster, n_outputs(), m_nms, m_threshold);
+
+    // ... and keep them to be tracked in the next frame
+    if (m_tracking == true)
+    {
+      m_tracks = detections;
+      m_track_frames = tracked == true ? m_track_frames + 1 : 1;
+      m_track_rows = ipscale().rows();
+      m_track_cols = ipscale().cols();
+    }
+    return true;
+  }
+
+  // Score the <x, y> sub-window (at the current scale) with the level
+  //	classifiers of the given output
+  bool CVDetector::classify(uint64_t o, int x, int y, double& score) const
+  {
+    // Concentrate computation on the most promising detections
+    score = 0.0;
+    uint64_t l = 0;
+    for ( ; l <= m_levels && score >= m_lrejections[o][l]; l ++)
+    {
+      const uint64_t lbegin = m_lmodel_begins[o][l];
+      const uint64_t lend = m_lmodel_ends[o][l];
+      score += m_model->score(o, lbegin, lend, x, y);
+
+      // Update statistics
+      m_stats.m_evals += lend - lbegin;
+      m_stats.m_level_sws[l] ++;
+      m_stats.m_level_evals[l] += lend - lbegin;
+    }
+
+    // Update statistics
+    m_stats.m_sws ++;
+
+    // The sub-windows rejected at zero keep their partial (negative) score,
+    //	but the calibrated thresholds may reject positive scores
+    return l > m_levels || m_ocalibrated[o] == false;
+  }
+
+  // Scan the whole pyramid
+  void CVDetector::scan_pyramid(std::vector<detection_t>& detections) const
+  {
     for (uint64_t is = 0; is < m_ipyramid.size(); is ++)
     {
       const ipscale_t& ip = m_ipyramid[is];
@@ -257,40 +438,94 @@ namespace bob { namespace visioner {
         for (int x = ip.m_scan_min_x; x < ip.m_scan_max_x; x += ip.m_scan_dx)
           for (int y = ip.m_scan_min_y; y < ip.m_scan_max_y; y += ip.m_scan_dy)
           {
-            // Concentrate computation on the most promising detections
-            double score = 0.0;
-            for (uint64_t l = 0; l <= m_levels && score >= 0.0; l ++)
-            {
-              const uint64_t lbegin = m_lmodel_begins[o][l];
-              const uint64_t lend = m_lmodel_ends[o][l];
-              score += m_model->score(o, lbegin, lend, x, y);
-
-              // Update statistics
-              m_stats.m_evals += lend - lbegin;
-            }
-
             // Threshold detection and map it to the original image size
-            if (score >= m_threshold)
+            double score;
+            if (classify(o, x, y, score) == true && score >= m_threshold)
             {
               detections.push_back(make_detection(
                     score, 
                     m_ipyramid.map(subwindow_t(x, y, is)), 
                     o));
             }
-
-            // Update statistics
-            m_stats.m_sws ++;
           }
       }
     }
+  }
 
-    // Update statistics
-    m_stats.m_gts += n_objects();
-    m_stats.m_timing += timer.elapsed();
+  // Scan only the given sub-windows (sorted by scale)
+  void CVDetector::scan_subwindows(const std::vector<subwindow_t>& sws,
+      std::vector<detection_t>& detections) const
+  {
+    for (uint64_t i = 0; i < sws.size(); i ++)
+    {
+      const subwindow_t& sw = sws[i];
+      if (i == 0 || sw.m_s != sws[i - 1].m_s)
+      {
+        m_model->preprocess(m_ipyramid[sw.m_s]);
+      }
 
-    // OK, cluster detections
-    cluster(detections, m_cluster, n_outputs());
-    return true;
+      // ... with every model type
+      for (uint64_t o = 0; o < n_outputs(); o ++)
+      {
+        // Threshold detection and map it to the original image size
+        double score;
+        if (classify(o, sw.m_x, sw.m_y, score) == true && score >= m_threshold)
+        {
+          detections.push_back(make_detection(score, m_ipyramid.map(sw), o));
+        }
+      }
+    }
+  }
+
+  // Order sub-windows by scale and then by location
+  static bool sw_less(const subwindow_t& one, const subwindow_t& two)
+  {
+    return  one.m_s < two.m_s || (one.m_s == two.m_s && 
+        (one.m_y < two.m_y || (one.m_y == two.m_y && one.m_x < two.m_x)));
+  }
+  static bool sw_equal(const subwindow_t& one, const subwindow_t& two)
+  {
+    return  one.m_s == two.m_s && one.m_y == two.m_y && one.m_x == two.m_x;
+  }
+
+  // Sub-windows in the neighbourhood of the detections of the previous frame
+  void CVDetector::track(std::vector<subwindow_t>& sws) const
+  {
+    sws.clear();
+
+    const int range = (int)m_track_range;
+    for (std::vector<detection_t>::const_iterator it = m_tracks.begin(); it != m_tracks.end(); ++ it)
+    {
+      // The nearby scales and locations of the detection (with the
+      //	scanning step of its scale), as evaluated by the full scan
+      const subwindow_t seed = m_ipyramid.map(it->second.first, param());
+      const ipscale_t& ip = m_ipyramid[seed.m_s];
+
+      const std::vector<std::vector<subwindow_t> > ssws = m_ipyramid.neighbours(
+          seed, 1, range, ip.m_scan_dx, range, ip.m_scan_dy, param());
+      for (uint64_t ss = 0; ss < ssws.size(); ss ++)
+      {
+        for (uint64_t i = 0; i < ssws[ss].size(); i ++)
+        {
+          // Align the sub-window to the scanning grid of its scale
+          const subwindow_t& sw = ssws[ss][i];
+          const ipscale_t& sip = m_ipyramid[sw.m_s];
+          const int x = sip.m_scan_min_x + sip.m_scan_dx * (int)(0.5 + 
+              (double)((int)sw.m_x - sip.m_scan_min_x) / sip.m_scan_dx);
+          const int y = sip.m_scan_min_y + sip.m_scan_dy * (int)(0.5 + 
+              (double)((int)sw.m_y - sip.m_scan_min_y) / sip.m_scan_dy);
+          if (    x >= sip.m_scan_min_x && x < sip.m_scan_max_x &&
+              y >= sip.m_scan_min_y && y < sip.m_scan_max_y)
+          {
+            sws.push_back(subwindow_t(x, y, sw.m_s));
+          }
+        }
+      }
+    }
+
+    // The neighbourhoods of close detections overlap: evaluate each sub-window once
+    std::sort(sws.begin(), sws.end(), sw_less);
+    sws.erase(std::unique(sws.begin(), sws.end(), sw_equal), sws.end());
   }
 
   // Match detections with ground truth locations
@@ -373,46 +608,6 @@ namespace bob { namespace visioner {
         detections.end());
   }
 
-  void CVDetector::cluster(std::vector<detection_t>& detections, double thres, uint64_t n_outputs)
-  {
-    if (thres >= 1.0)
-    {
-      // Clustering deactivated!
-      return;
-    }
-
-    sort_desc(detections);
-
-    // Check if the detection ...
-    std::vector<detection_t> result;
-    for (uint64_t o = 0; o < n_outputs; o ++)
-    {
-      for (uint64_t iref = 0; iref < detections.size(); iref ++)
-      {
-        const detection_t& ref = detections[iref];
-        if (    ref.second.first.left() > -0.5 && // ... is still valid!
-            ref.second.second == (int)o)
-        {
-          result.push_back(ref);
-
-          // Then, remove the overlapping detections
-          for (uint64_t icrt = iref + 1; icrt < detections.size(); icrt ++)
-          {
-            detection_t& crt = detections[icrt];
-            if (	crt.second.first.left() > -0.5 &&
-                crt.second.second == (int)o &&
-                overlap(ref.second.first, crt.second.first) >= thres)
-            {
-              crt.second.first.setLeft(-1.0);
-            }
-          }
-        }
-      }
-    }
-
-    detections.swap(result);
-  }
-
   // Compute the ROC - the number of true positives and false alarms
   //	for the <min_score + t * delta_score, t < n_thress> threshold values.
   void CVDetector::roc(
@@ -550,12 +745,126 @@ namespace bob { namespace visioner {
     stats().show();
   }
 
+  // Calibrate the rejection thresholds after each level
+  bool CVDetector::calibrate(const std::vector<std::string>& ifiles, 
+      const std::vector<std::string>& gfiles, double recall) {
+
+    if (valid_model() == false || m_levels == 0)
+    {
+      return false;
+    }
+
+    // 1st pass: collect the cumulated scores at each level for the
+    //	sub-windows that would be detected without early rejection ...
+    std::vector<std::vector<std::vector<double> > > oscores(n_outputs());
+    std::vector<double> lscores(m_levels + 1);
+
+    for (uint64_t i = 0; i < ifiles.size(); i ++) {
+
+      const std::string& ifile = ifiles[i];
+      const std::string& gfile = gfiles[i];
+
+      if (load(ifile, gfile) == false) {
+        bob::core::warn << "Failed to load image <" << ifile << "> or ground truth <" << gfile << ">!" << std::endl;
+        continue;
+      }
+
+      for (uint64_t is = 0; is < m_ipyramid.size(); is ++)
+      {
+        const ipscale_t& ip = m_ipyramid[is];
+        m_model->preprocess(ip);
+
+        for (uint64_t o = 0; o < n_outputs(); o ++)
+        {
+          for (int x = ip.m_scan_min_x; x < ip.m_scan_max_x; x += ip.m_scan_dx)
+            for (int y = ip.m_scan_min_y; y < ip.m_scan_max_y; y += ip.m_scan_dy)
+            {
+              double score = 0.0;
+              for (uint64_t l = 0; l <= m_levels; l ++)
+              {
+                score += m_model->score(o, m_lmodel_begins[o][l], m_lmodel_ends[o][l], x, y);
+                lscores[l] = score;
+              }
+
+              // ... keep only the true positive detections
+              if (score >= m_threshold &&
+                  label(make_detection(score, m_ipyramid.map(subwindow_t(x, y, is)), o)) == true)
+              {
+                oscores[o].push_back(lscores);
+              }
+            }
+        }
+      }
+
+      bob::core::info << "Image [" << (i + 1) << "/" << ifiles.size() 
+        << "]: processed." << std::endl;
+    }
+
+    // 2nd pass: choose the thresholds level by level such that the
+    //	overall fraction of kept detections is <recall>
+    const double lrecall = std::pow(range(recall, 0.0, 1.0), inverse(m_levels));
+
+    std::vector<std::vector<double> > rejections(n_outputs(), std::vector<double>(m_levels, 0.0));
+    for (uint64_t o = 0; o < n_outputs(); o ++)
+    {
+      std::vector<std::vector<double> >& scores = oscores[o];
+      for (uint64_t l = 0; l < m_levels && scores.empty() == false; l ++)
+      {
+        std::vector<double> values(scores.size());
+        for (uint64_t s = 0; s < scores.size(); s ++)
+        {
+          values[s] = scores[s][l];
+        }
+        std::sort(values.begin(), values.end());
+
+        const uint64_t k = std::min((uint64_t)((1.0 - lrecall) * values.size()), 
+            (uint64_t)values.size() - 1);
+        rejections[o][l] = values[k];
+
+        // Keep only the detections passing this level
+        uint64_t n_kept = 0;
+        for (uint64_t s = 0; s < scores.size(); s ++)
+        {
+          if (scores[s][l] >= rejections[o][l])
+          {
+            scores[n_kept ++].swap(scores[s]);
+          }
+        }
+        scores.resize(n_kept);
+
+        bob::core::info << "Output [" << (o + 1) << "/" << n_outputs() 
+          << "], level [" << (l + 1) << "/" << m_levels << "]: threshold = " 
+          << rejections[o][l] << " keeps " << n_kept << "/" << values.size() 
+          << " detections." << std::endl;
+      }
+    }
+
+    m_model->set_rejections(rejections);
+    set_scan_levels(m_levels);
+
+    // OK
+    return true;
+  }
+
   // Display statistics
   void CVDetector::stats_t::show() const {
     bob::core::info << "Processed " << m_gts << " GTs by scanning " 
       << m_sws << " SWs with " << (inverse(m_sws) * m_evals) 
       << " LUT evaluations done in " << (inverse(m_sws) * m_timing) 
       << " seconds on average." << std::endl;
+    for (uint64_t l = 0; l < m_level_sws.size(); l ++) {
+      bob::core::info << "Level [" << (l + 1) << "/" << m_level_sws.size() 
+        << "]: evaluated " << (100.0 * inverse(m_sws) * m_level_sws[l])
+        << "% of the SWs with " << m_level_evals[l] << " LUT evaluations." 
+        << std::endl;
+    }
+    if (m_tracked > 0) {
+      bob::core::info << "Tracking: scanned " << m_tracked << "/" << m_frames
+        << " frames only around the previous detections, with "
+        << (inverse(m_frames) * m_sws) << " SWs and "
+        << (inverse(m_frames) * m_evals) << " LUT evaluations per frame on average."
+        << std::endl;
+    }
   }
 
   // Save the model back to file
@@ -175,6 +175,56 @@ namespace bob { namespace visioner {
     return true;
   }
 
+  // Predict the location of the keypoints in the <reg> region, initialized
+  //	with the keypoints predicted at the previous frame
+  bool CVLocalizer::locate(const CVDetector& detector, const QRectF& reg,
+      const std::vector<QPointF>& init, std::vector<QPointF>& dt_points) const
+  {
+    // No initialization (or a single shot): process as a still image
+    if (init.size() != n_points() || m_type == SingleShot)
+    {
+      return locate(detector, reg, dt_points);
+    }
+
+    // Check the sub-window
+    const subwindow_t sw = detector.ipyramid().map(reg, param());
+    if (detector.ipyramid().check(sw, param()) == false)
+    {
+      return false;
+    }
+
+    // Collect predictions (not projected): the keypoints move little between
+    //	frames, so only the closest locations at the same scale are used ...
+    std::vector<std::vector<QPointF> > preds(n_points());
+    locate(detector, sw, 
+        0, 1, std::max((int)1, (int)(0.5 + 0.02 * param().m_cols)), 
+        1, std::max((int)1, (int)(0.5 + 0.02 * param().m_rows)), preds);
+
+    // ... together with the previous keypoints
+    for (uint64_t i = 0; i < n_points(); i ++)
+    {
+      preds[i].push_back(init[i]);
+    }
+
+    // Process the predictions: average or median
+    std::vector<QPointF> pred;                
+    switch (m_type)
+    {
+      case MultipleShots_Average:
+        avg(preds, pred);
+        break;
+
+      case MultipleShots_Median:
+      default:
+        med(preds, pred);
+        break;
+    }
+
+    // OK
+    dt_points.insert(dt_points.end(), pred.begin(), pred.end());
+    return true;
+  }
+
   // Collect predictions from the neighbourhood of <seed_sw>
   void CVLocalizer::locate(
       const CVDetector& detector, const subwindow_t& seed_sw, 
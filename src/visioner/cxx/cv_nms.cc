@@ -0,0 +1,498 @@
+/**
+ * @file visioner/cxx/cv_nms.cc
+ * @date Sun 19 Oct 2026 14:05:31 CEST
+ *
+ * @brief Non-maximum suppression of object detections, comparing only the
+ * detections that are close in location and scale.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <cmath>
+#include <map>
+#include <queue>
+#include <limits>
+#include <fstream>
+#include <algorithm>
+
+#include "bob/visioner/cv/cv_nms.h"
+#include "bob/visioner/vision/vision.h"
+
+namespace bob { namespace visioner {
+
+  namespace {
+
+    // Regions of similar areas, indexed by a uniform grid whose cells are
+    //	as large as the largest region (each region is in at most 4 cells)
+    struct band_t
+    {
+      band_t()
+        :       m_min_area(std::numeric_limits<double>::max()), m_max_area(0.0),
+        m_cell(0.0), m_x0(0.0), m_y0(0.0), m_cols(0), m_rows(0)
+      {
+      }
+
+      // Range of cells covered by the given coordinates (false if none)
+      bool cells(double min, double max, double origin, uint64_t n_cells,
+          uint64_t& begin, uint64_t& end) const
+      {
+        const double cbegin = std::floor((min - origin) / m_cell);
+        const double cend = std::floor((max - origin) / m_cell) + 1.0;
+        if (cend <= 0.0 || cbegin >= (double)n_cells)
+        {
+          return false;
+        }
+        begin = (uint64_t)std::max(cbegin, 0.0);
+        end = (uint64_t)std::min(cend, (double)n_cells);
+        return true;
+      }
+
+      double                  m_min_area, m_max_area; // Range of areas
+      double                  m_cell;         // Cell size
+      double                  m_x0, m_y0;     // Origin of the grid
+      uint64_t                m_cols, m_rows; // Grid size
+      std::vector<uint64_t>   m_offsets;      // [begin, end) items for each cell
+      std::vector<uint64_t>   m_items;        // Region indices
+    };
+
+    // Spatial index of regions, to find the ones which may overlap a given
+    //	region by at least some threshold (NB: the overlap is at most the
+    //	ratio of the smallest to the largest area)
+    class grid_t
+    {
+      public:
+
+        // Constructor (NB: the regions with a null area are not indexed)
+        grid_t(const std::vector<QRectF>& regs)
+          :       m_stamps(regs.size(), 0), m_stamp(0)
+        {
+          // Group the regions by bands of half an octave in area
+          std::map<int, std::vector<uint64_t> > groups;
+          for (uint64_t i = 0; i < regs.size(); i ++)
+          {
+            const double a = area(regs[i]);
+            if (a > 0.0)
+            {
+              groups[(int)std::floor(2.0 * std::log(a) / std::log(2.0))].push_back(i);
+            }
+          }
+
+          m_bands.resize(groups.size());
+          std::vector<band_t>::iterator band = m_bands.begin();
+          for (std::map<int, std::vector<uint64_t> >::const_iterator it = groups.begin();
+              it != groups.end(); ++ it, ++ band)
+          {
+            build(regs, it->second, *band);
+          }
+        }
+
+        // Return the indices of the regions which may overlap the given
+        //	one by at least <thres> (unique)
+        const std::vector<uint64_t>& query(const QRectF& reg, double thres)
+        {
+          m_result.clear();
+          m_stamp ++;
+
+          const double a = area(reg);
+          if (!(a > 0.0))
+          {
+            return m_result;
+          }
+          const double min_area = thres > 0.0 ? thres * a : 0.0;
+          const double max_area = thres > 0.0 ? a / thres : std::numeric_limits<double>::max();
+
+          for (std::vector<band_t>::const_iterator band = m_bands.begin(); band != m_bands.end(); ++ band)
+          {
+            uint64_t xbegin, xend, ybegin, yend;
+            if (    band->m_max_area < min_area || band->m_min_area > max_area ||
+                band->cells(reg.left(), reg.right(), band->m_x0, band->m_cols, xbegin, xend) == false ||
+                band->cells(reg.top(), reg.bottom(), band->m_y0, band->m_rows, ybegin, yend) == false)
+            {
+              continue;
+            }
+
+            for (uint64_t y = ybegin; y < yend; y ++)
+              for (uint64_t x = xbegin; x < xend; x ++)
+              {
+                const uint64_t c = y * band->m_cols + x;
+                for (uint64_t k = band->m_offsets[c]; k < band->m_offsets[c + 1]; k ++)
+                {
+                  const uint64_t i = band->m_items[k];
+                  if (m_stamps[i] != m_stamp)
+                  {
+                    m_stamps[i] = m_stamp;
+                    m_result.push_back(i);
+                  }
+                }
+              }
+          }
+
+          return m_result;
+        }
+
+      private:
+
+        // Index the given regions in a band
+        static void build(const std::vector<QRectF>& regs,
+            const std::vector<uint64_t>& indices, band_t& band)
+        {
+          double x1 = -std::numeric_limits<double>::max(), y1 = x1;
+          band.m_x0 = band.m_y0 = std::numeric_limits<double>::max();
+          for (std::vector<uint64_t>::const_iterator it = indices.begin(); it != indices.end(); ++ it)
+          {
+            const QRectF& reg = regs[*it];
+            band.m_min_area = std::min(band.m_min_area, area(reg));
+            band.m_max_area = std::max(band.m_max_area, area(reg));
+            band.m_cell = std::max(band.m_cell, std::max(reg.width(), reg.height()));
+            band.m_x0 = std::min(band.m_x0, reg.left());
+            band.m_y0 = std::min(band.m_y0, reg.top());
+            x1 = std::max(x1, reg.right());
+            y1 = std::max(y1, reg.bottom());
+          }
+
+          // NB: larger cells if the regions are sparse, to bound the memory
+          const double max_cells = 4.0 * indices.size() + 1024.0;
+          while ( (std::floor((x1 - band.m_x0) / band.m_cell) + 1.0) *
+              (std::floor((y1 - band.m_y0) / band.m_cell) + 1.0) > max_cells)
+          {
+            band.m_cell *= 2.0;
+          }
+          band.m_cols = (uint64_t)std::floor((x1 - band.m_x0) / band.m_cell) + 1;
+          band.m_rows = (uint64_t)std::floor((y1 - band.m_y0) / band.m_cell) + 1;
+
+          // Count the regions in each cell, then fill the cells
+          band.m_offsets.assign(band.m_cols * band.m_rows + 1, 0);
+          for (int pass = 0; pass < 2; pass ++)
+          {
+            std::vector<uint64_t> fill;
+            if (pass == 1)
+            {
+              for (uint64_t c = 1; c < band.m_offsets.size(); c ++)
+              {
+                band.m_offsets[c] += band.m_offsets[c - 1];
+              }
+              band.m_items.resize(band.m_offsets.back());
+              fill.assign(band.m_offsets.begin(), band.m_offsets.end() - 1);
+            }
+
+            for (std::vector<uint64_t>::const_iterator it = indices.begin(); it != indices.end(); ++ it)
+            {
+              const QRectF& reg = regs[*it];
+              uint64_t xbegin, xend, ybegin, yend;
+              band.cells(reg.left(), reg.right(), band.m_x0, band.m_cols, xbegin, xend);
+              band.cells(reg.top(), reg.bottom(), band.m_y0, band.m_rows, ybegin, yend);
+              for (uint64_t y = ybegin; y < yend; y ++)
+                for (uint64_t x = xbegin; x < xend; x ++)
+                {
+                  const uint64_t c = y * band.m_cols + x;
+                  if (pass == 0)
+                  {
+                    band.m_offsets[c + 1] ++;
+                  }
+                  else
+                  {
+                    band.m_items[fill[c] ++] = *it;
+                  }
+                }
+            }
+          }
+        }
+
+      private: // representation
+
+        std::vector<band_t>     m_bands;        // Bands of areas
+        std::vector<uint64_t>   m_stamps;       // Last query of each region
+        uint64_t                m_stamp;        // Current query
+        std::vector<uint64_t>   m_result;       // Regions of the current query
+    };
+
+    // Greedy (and averaging) NMS of the detections of a single output,
+    //	sorted by decreasing score
+    void nms_greedy(const std::vector<detection_t>& dets, double thres, bool average,
+        std::vector<detection_t>& result)
+    {
+      if (dets.empty())
+      {
+        return;
+      }
+
+      // Everything overlaps the best detection!
+      if (thres <= 0.0)
+      {
+        QRectF reg = dets[0].second.first;
+        if (average == true)
+        {
+          double x = 0.0, y = 0.0, w = 0.0, h = 0.0;
+          for (uint64_t i = 0; i < dets.size(); i ++)
+          {
+            const QRectF& crt = dets[i].second.first;
+            x += crt.left(), y += crt.top(), w += crt.width(), h += crt.height();
+          }
+          const double norm = 1.0 / dets.size();
+          reg = QRectF(x * norm, y * norm, w * norm, h * norm);
+        }
+        result.push_back(make_detection(dets[0].first, reg, dets[0].second.second));
+        return;
+      }
+
+      std::vector<QRectF> regs(dets.size());
+      for (uint64_t i = 0; i < dets.size(); i ++)
+      {
+        regs[i] = dets[i].second.first;
+      }
+
+      grid_t grid(regs);
+      std::vector<bool> removed(dets.size(), false);
+      for (uint64_t iref = 0; iref < dets.size(); iref ++)
+      {
+        if (removed[iref] == true)
+        {
+          continue;
+        }
+
+        const QRectF& ref = regs[iref];
+        double x = ref.left(), y = ref.top(), w = ref.width(), h = ref.height();
+        uint64_t n = 1;
+
+        // Remove the overlapping detections with lower scores
+        const std::vector<uint64_t>& candidates = grid.query(ref, thres);
+        for (std::vector<uint64_t>::const_iterator it = candidates.begin(); it != candidates.end(); ++ it)
+        {
+          const uint64_t icrt = *it;
+          if (    icrt > iref && removed[icrt] == false &&
+              overlap(ref, regs[icrt]) >= thres)
+          {
+            removed[icrt] = true;
+
+            const QRectF& crt = regs[icrt];
+            x += crt.left(), y += crt.top(), w += crt.width(), h += crt.height();
+            n ++;
+          }
+        }
+
+        const double norm = 1.0 / n;
+        result.push_back(make_detection(dets[iref].first,
+              average == true ? QRectF(x * norm, y * norm, w * norm, h * norm) : ref,
+              dets[iref].second.second));
+      }
+    }
+
+    // Soft NMS of the detections of a single output, sorted by decreasing
+    //	score
+    void nms_soft(const std::vector<detection_t>& dets, double thres, double min_score,
+        std::vector<detection_t>& result)
+    {
+      std::vector<QRectF> regs(dets.size());
+      std::vector<double> scores(dets.size());
+      std::priority_queue<std::pair<double, int64_t> > queue;
+      for (uint64_t i = 0; i < dets.size(); i ++)
+      {
+        regs[i] = dets[i].second.first;
+        scores[i] = dets[i].first;
+        queue.push(std::make_pair(scores[i], -(int64_t)i)); // NB: ties by rank
+      }
+
+      grid_t grid(regs);
+      std::vector<bool> done(dets.size(), false);
+      while (queue.empty() == false)
+      {
+        const double score = queue.top().first;
+        const uint64_t iref = -queue.top().second;
+        queue.pop();
+
+        // The highest (decayed) score ...
+        if (done[iref] == true || score != scores[iref])
+        {
+          continue;
+        }
+        done[iref] = true;
+        result.push_back(make_detection(score, regs[iref], dets[iref].second.second));
+
+        // ... decays the scores of the overlapping detections
+        const std::vector<uint64_t>& candidates = grid.query(regs[iref], thres);
+        for (std::vector<uint64_t>::const_iterator it = candidates.begin(); it != candidates.end(); ++ it)
+        {
+          const uint64_t icrt = *it;
+          if (done[icrt] == true)
+          {
+            continue;
+          }
+
+          const double ov = overlap(regs[iref], regs[icrt]);
+          if (ov >= thres && ov > 0.0)
+          {
+            scores[icrt] -= ov * std::abs(scores[icrt]);
+            if (scores[icrt] < min_score)
+            {
+              done[icrt] = true;
+            }
+            else
+            {
+              queue.push(std::make_pair(scores[icrt], -(int64_t)icrt));
+            }
+          }
+        }
+      }
+    }
+
+    // Split the detections by output, sorted by decreasing score
+    void split(const std::vector<detection_t>& detections, uint64_t n_outputs,
+        std::vector<std::vector<detection_t> >& odetections)
+    {
+      odetections.resize(n_outputs);
+      for (std::vector<detection_t>::const_iterator it = detections.begin(); it != detections.end(); ++ it)
+      {
+        const int o = it->second.second;
+        if (o >= 0 && (uint64_t)o < n_outputs)
+        {
+          odetections[o].push_back(*it);
+        }
+      }
+
+      for (uint64_t o = 0; o < n_outputs; o ++)
+      {
+        std::sort(odetections[o].begin(), odetections[o].end(), std::greater<detection_t>());
+      }
+    }
+
+  }
+
+  // Decode a NMS method from its name
+  bool decode_nms(const std::string& name, NMSMethod& method)
+  {
+    if (name == "greedy")
+    {
+      method = NMSGreedy;
+    }
+    else if (name == "average")
+    {
+      method = NMSAverage;
+    }
+    else if (name == "soft")
+    {
+      method = NMSSoft;
+    }
+    else
+    {
+      return false;
+    }
+    return true;
+  }
+
+  // Suppress the overlapping detections
+  void nms(std::vector<detection_t>& detections, double thres, uint64_t n_outputs,
+      NMSMethod method, double min_score)
+  {
+    if (thres >= 1.0)
+    {
+      // Clustering deactivated!
+      return;
+    }
+
+    std::vector<std::vector<detection_t> > odetections;
+    split(detections, n_outputs, odetections);
+
+    std::vector<detection_t> result;
+    for (uint64_t o = 0; o < n_outputs; o ++)
+    {
+      switch (method)
+      {
+        case NMSSoft:
+          nms_soft(odetections[o], thres, min_score, result);
+          break;
+
+        case NMSAverage:
+          nms_greedy(odetections[o], thres, true, result);
+          break;
+
+        case NMSGreedy:
+        default:
+          nms_greedy(odetections[o], thres, false, result);
+          break;
+      }
+    }
+
+    detections.swap(result);
+  }
+
+  // Reference greedy NMS, comparing all the pairs of detections
+  void nms_pairwise(std::vector<detection_t>& detections, double thres, uint64_t n_outputs)
+  {
+    if (thres >= 1.0)
+    {
+      // Clustering deactivated!
+      return;
+    }
+
+    std::vector<std::vector<detection_t> > odetections;
+    split(detections, n_outputs, odetections);
+
+    std::vector<detection_t> result;
+    for (uint64_t o = 0; o < n_outputs; o ++)
+    {
+      const std::vector<detection_t>& dets = odetections[o];
+      std::vector<bool> removed(dets.size(), false);
+      for (uint64_t iref = 0; iref < dets.size(); iref ++)
+      {
+        if (removed[iref] == true)
+        {
+          continue;
+        }
+        result.push_back(dets[iref]);
+
+        for (uint64_t icrt = iref + 1; icrt < dets.size(); icrt ++)
+        {
+          if (    removed[icrt] == false &&
+              overlap(dets[iref].second.first, dets[icrt].second.first) >= thres)
+          {
+            removed[icrt] = true;
+          }
+        }
+      }
+    }
+
+    detections.swap(result);
+  }
+
+  // Save detections to a text file
+  bool save_detections(const std::string& path, const std::vector<detection_t>& detections)
+  {
+    std::ofstream out(path.c_str());
+    if (out.is_open() == false)
+    {
+      return false;
+    }
+
+    out.precision(std::numeric_limits<double>::digits10 + 2);
+    for (std::vector<detection_t>::const_iterator it = detections.begin(); it != detections.end(); ++ it)
+    {
+      const QRectF& reg = it->second.first;
+      out << it->first << " " << reg.left() << " " << reg.top() << " "
+        << reg.width() << " " << reg.height() << " " << it->second.second << std::endl;
+    }
+
+    return out.good();
+  }
+
+  // Load detections from a text file
+  bool load_detections(const std::string& path, std::vector<detection_t>& detections)
+  {
+    detections.clear();
+
+    std::ifstream in(path.c_str());
+    if (in.is_open() == false)
+    {
+      return false;
+    }
+
+    double score, x, y, w, h;
+    int ilabel;
+    while (in >> score >> x >> y >> w >> h >> ilabel)
+    {
+      detections.push_back(make_detection(score, QRectF(x, y, w, h), ilabel));
+    }
+
+    return in.eof();
+  }
+
+}}
@@ -10,6 +10,8 @@
  * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
  */
 
+#include <cmath>
+
 #include "bob/visioner/vision/image.h"
 #include "bob/visioner/util/util.h"
 
@@ -39,6 +41,56 @@ namespace bob { namespace visioner {
     return load(qimage.scaled(new_w, new_h, Qt::KeepAspectRatio, Qt::SmoothTransformation), dst);
   }
 
+  // Downscale the <src> source image to exactly <rows> x <cols> pixels using
+  //	area averaging (NB: <dst> is not reallocated if it has the right size)
+  bool scale(const Matrix<uint8_t>& src, uint64_t rows, uint64_t cols, Matrix<uint8_t>& dst)
+  {
+    if (	rows == 0 || cols == 0 ||
+        rows > src.rows() || cols > src.cols())
+    {
+      return false;
+    }
+    dst.resize(rows, cols);
+
+    // Each destination pixel covers a <fy> x <fx> area in the source image
+    const double fy = (double)src.rows() / rows;
+    const double fx = (double)src.cols() / cols;
+    const double norm = inverse(fx * fy);
+
+    for (uint64_t y = 0; y < rows; y ++)
+    {
+      const double y0 = y * fy, y1 = std::min(y0 + fy, (double)src.rows());
+      const uint64_t sy0 = (uint64_t)y0, sy1 = std::min((uint64_t)std::ceil(y1), (uint64_t)src.rows());
+
+      uint8_t* dst_row = dst[y];
+      for (uint64_t x = 0; x < cols; x ++)
+      {
+        const double x0 = x * fx, x1 = std::min(x0 + fx, (double)src.cols());
+        const uint64_t sx0 = (uint64_t)x0, sx1 = std::min((uint64_t)std::ceil(x1), (uint64_t)src.cols());
+
+        // Accumulate the (partially) covered source pixels
+        double sum = 0.0;
+        for (uint64_t sy = sy0; sy < sy1; sy ++)
+        {
+          const double wy = std::min(y1, sy + 1.0) - std::max(y0, (double)sy);
+          const uint8_t* src_row = src[sy];
+
+          double row_sum = 0.0;
+          for (uint64_t sx = sx0; sx < sx1; sx ++)
+          {
+            const double wx = std::min(x1, sx + 1.0) - std::max(x0, (double)sx);
+            row_sum += wx * src_row[sx];
+          }
+          sum += wy * row_sum;
+        }
+
+        dst_row[x] = (uint8_t)range((int)(0.5 + norm * sum), 0, 255);
+      }
+    }
+
+    return true;
+  }
+
   // Convert from <Matrix<uint8_t>> to <QImage>
   QImage convert(const Matrix<uint8_t>& grays)
   {
@@ -15,6 +15,8 @@
 #include "bob/visioner/model/ipyramid.h"
 #include "bob/visioner/vision/image.h"
 #include "bob/visioner/vision/integral.h"
+#include "bob/visioner/util/threads.h"
+#include "bob/visioner/util/timer.h"
 
 namespace bob { namespace visioner {
 
@@ -97,9 +99,17 @@ namespace bob { namespace visioner {
     visioner::scale(m_image, dst.m_scale, dst.m_image);
   }
 
+  // Scale an image and its ground truth, and set the scanning parameters
+  void ipscale_t::scale(double sfactor, const param_t& param, ipscale_t& dst) const
+  {
+    scale(sfactor, dst);
+    update_ipscale(dst, param);
+  }
+
   // Constructor
   ipyramid_t::ipyramid_t(const param_t& param)
-    :       Parametrizable(param)
+    :       Parametrizable(param),
+    m_incremental(false)
   {                
   }
 
@@ -135,23 +145,9 @@ namespace bob { namespace visioner {
       throw std::runtime_error(m.str());
     }
     m_ipscales[0].m_image = tmp_image;
-    update_ipscale(m_ipscales[0], m_param);
 
     // Build the scaled versions of the original image
-    const ipscale_t& src = m_ipscales[0];
-    for (uint64_t i = 1; i < scales.size(); i ++)
-    {
-      ipscale_t& dst = m_ipscales[i];
-      src.scale(scales[i], dst);
-      update_ipscale(dst, m_param);
-
-      if (	dst.m_scan_min_x >= dst.m_scan_max_x ||
-          dst.m_scan_min_y >= dst.m_scan_max_y)
-      {
-        m_ipscales.erase(m_ipscales.begin() + i, m_ipscales.end());
-        break;
-      }
-    }
+    build(scales);
 
     // OK
     return true;
@@ -160,12 +156,13 @@ namespace bob { namespace visioner {
   // Loads scaled versions of an image and its ground truth
   bool ipyramid_t::load(const ipscale_t& ipscale)
   {
-    m_ipscales.clear();
-
     // Compute the scalling factors
     const std::vector<double> scales = scan_scales(m_param.m_rows, m_param.m_cols, ipscale.rows(), ipscale.cols(), m_param.m_ds);
 
-    if (scales.empty()) return false;
+    if (scales.empty()) {
+      m_ipscales.clear();
+      return false;
+    }
 
     m_ipscales.resize(scales.size());
 
@@ -173,21 +170,9 @@ namespace bob { namespace visioner {
     m_ipscales[0] = ipscale;
     m_ipscales[0].m_scale = 1.0;
     m_ipscales[0].m_inv_scale = 1.0;
-    update_ipscale(m_ipscales[0], m_param);
 
     // Build the scaled versions of the original image
-    const ipscale_t& src = m_ipscales[0];
-    for (uint64_t i = 1; i < scales.size(); i ++) {
-      ipscale_t& dst = m_ipscales[i];
-      src.scale(scales[i], dst);
-      update_ipscale(dst, m_param);
-
-      if (dst.m_scan_min_x >= dst.m_scan_max_x ||
-          dst.m_scan_min_y >= dst.m_scan_max_y) {
-        m_ipscales.erase(m_ipscales.begin() + i, m_ipscales.end());
-        break;
-      }
-    }
+    build(scales);
 
     // OK
     return true;
@@ -196,29 +181,90 @@ namespace bob { namespace visioner {
   // Loads scaled versions of an image without its ground-thruth
   bool ipyramid_t::load(const uint8_t* image, uint64_t rows, uint64_t cols)
   {
-    //AA: no simple way not to have a copy here...
-    Matrix<uint8_t> tmp_image(rows, cols, image);
-
     // Compute the scalling factors
-    const std::vector<double> scales = scan_scales(m_param.m_rows, m_param.m_cols, tmp_image.rows(), tmp_image.cols(), m_param.m_ds);
+    const std::vector<double> scales = scan_scales(m_param.m_rows, m_param.m_cols, rows, cols, m_param.m_ds);
     if (scales.empty()) return false;
 
     m_ipscales.resize(scales.size());
 
-    // Load the ground truth and the image
-    m_ipscales[0].m_scale = 1.0;
-    m_ipscales[0].m_inv_scale = 1.0;
-    m_ipscales[0].m_image = tmp_image;
-    update_ipscale(m_ipscales[0], m_param);
+    // Load the image (NB: the buffer of the previous image is reused)
+    ipscale_t& ip = m_ipscales[0];
+    ip.m_scale = 1.0;
+    ip.m_inv_scale = 1.0;
+    ip.m_objects.clear();
+    ip.m_image.resize(rows, cols);
+    std::copy(image, image + rows * cols, ip.m_image.begin());
 
     // Build the scaled versions of the original image
+    build(scales);
+
+    // OK
+    return true;
+  }
+
+  // Build the scaled versions of the first (original) image
+  void ipyramid_t::build(const std::vector<double>& scales)
+  {
+    m_timings.resize(m_ipscales.size());
+    std::fill(m_timings.begin(), m_timings.end(), 0.0);
+
+    // Invalidate the integral images of the previous image
+    //	(NB: the ones still used by some models are released, not cleared)
+    for (std::vector<ipscale_t>::iterator it = m_ipscales.begin(); it != m_ipscales.end(); ++ it)
+    {
+      if (it->m_iimage.unique() == true)
+      {
+        it->m_iimage->clear();
+      }
+      else
+      {
+        it->m_iimage.reset();
+      }
+    }
+
+    update_ipscale(m_ipscales[0], m_param);
+
     const ipscale_t& src = m_ipscales[0];
     for (uint64_t i = 1; i < scales.size(); i ++)
     {
+      Timer timer;
+
       ipscale_t& dst = m_ipscales[i];
-      src.scale(scales[i], dst);
+      if (m_incremental == false)
+      {
+        src.scale(scales[i], dst);
+      }
+      else
+      {
+        // Derive this scale from the smallest one that is at least an
+        //	octave larger (or from the original image for the first octave)
+        uint64_t iref = 0;
+        for (uint64_t j = 1; j < i && m_ipscales[j].m_scale >= 2.0 * scales[i]; j ++)
+        {
+          iref = j;
+        }
+
+        dst.m_scale = range(scales[i], 0.0, 1.0);
+        dst.m_inv_scale = inverse(dst.m_scale);
+
+        dst.m_objects = src.m_objects;
+        for (std::vector<Object>::iterator it = dst.m_objects.begin(); it != dst.m_objects.end(); ++ it)
+        {
+          it->scale(dst.m_scale);
+        }
+
+        const uint64_t rows = (uint64_t)(0.5 + dst.m_scale * src.rows());
+        const uint64_t cols = (uint64_t)(0.5 + dst.m_scale * src.cols());
+        if (visioner::scale(m_ipscales[iref].m_image, rows, cols, dst.m_image) == false)
+        {
+          m_ipscales.erase(m_ipscales.begin() + i, m_ipscales.end());
+          break;
+        }
+      }
       update_ipscale(dst, m_param);
 
+      m_timings[i] = timer.elapsed();
+
       if (	dst.m_scan_min_x >= dst.m_scan_max_x ||
           dst.m_scan_min_y >= dst.m_scan_max_y)
       {
@@ -227,8 +273,39 @@ namespace bob { namespace visioner {
       }
     }
 
-    // OK
-    return true;
+    m_timings.resize(m_ipscales.size());
+  }
+
+  // Compute the integral images of all scales (using multiple threads)
+  void ipyramid_t::integrate(size_t threads)
+  {
+    if (!threads) {
+      integrate_mt(0, 1);
+    }
+    else {
+      // NB: the scales are distributed in a round-robin fashion, as their
+      //	size decreases monotonically
+      thread_iloop(boost::bind(&ipyramid_t::integrate_mt,
+            this, boost::lambda::_1, (uint64_t)threads), 
+          size(), threads);
+    }
+  }
+
+  void ipyramid_t::integrate_mt(uint64_t ith, uint64_t n_threads)
+  {
+    for (uint64_t s = ith; s < m_ipscales.size(); s += n_threads)
+    {
+      Timer timer;
+
+      ipscale_t& ip = m_ipscales[s];
+      if (ip.m_iimage.unique() == false)
+      {
+        ip.m_iimage.reset(new Matrix<uint32_t>);
+      }
+      integral(ip.m_image, *ip.m_iimage);
+
+      m_timings[s] += timer.elapsed();
+    }
   }
 
   // Map regions (at the original scale) to sub-windows
@@ -279,7 +356,7 @@ namespace bob { namespace visioner {
     for (int ds = -n_ds; ds <= n_ds; ds ++)
     {                
       const int s = sw.m_s + ds;
-      if (s < 0 && s >= (int)size())
+      if (s < 0 || s >= (int)size())
       {
         continue;
       }
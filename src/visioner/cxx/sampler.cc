@@ -11,10 +11,17 @@
  */
 
 #include <algorithm>
+#include <fstream>
 
 #include <boost/bind.hpp>
 #include <boost/lambda/lambda.hpp>
 #include <boost/format.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/serialization/split_free.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
 
 #include "bob/core/logging.h"
 
@@ -37,12 +44,203 @@ std::vector<T> stat_cumulate(const std::vector<std::vector<T> >& stats,
   return result;
 }
 
+// Serialization of the scaled images (and their ground truth) to cache files
+BOOST_SERIALIZATION_SPLIT_FREE(QPointF)
+BOOST_SERIALIZATION_SPLIT_FREE(QRectF)
+BOOST_SERIALIZATION_SPLIT_FREE(bob::visioner::Object)
+
+namespace boost { namespace serialization {
+
+  template <typename Archive>
+    void save(Archive& ar, const QPointF& point, const unsigned int) {
+      const double x = point.x(), y = point.y();
+      ar & x;
+      ar & y;
+    }
+
+  template <typename Archive>
+    void load(Archive& ar, QPointF& point, const unsigned int) {
+      double x, y;
+      ar & x;
+      ar & y;
+      point = QPointF(x, y);
+    }
+
+  template <typename Archive>
+    void save(Archive& ar, const QRectF& rect, const unsigned int) {
+      const double x = rect.x(), y = rect.y(), w = rect.width(), h = rect.height();
+      ar & x;
+      ar & y;
+      ar & w;
+      ar & h;
+    }
+
+  template <typename Archive>
+    void load(Archive& ar, QRectF& rect, const unsigned int) {
+      double x, y, w, h;
+      ar & x;
+      ar & y;
+      ar & w;
+      ar & h;
+      rect = QRectF(x, y, w, h);
+    }
+
+  template <typename Archive>
+    void serialize(Archive& ar, bob::visioner::Keypoint& keypoint, const unsigned int) {
+      ar & keypoint.m_id;
+      ar & keypoint.m_point;
+    }
+
+  template <typename Archive>
+    void save(Archive& ar, const bob::visioner::Object& object, const unsigned int) {
+      const std::string type = object.type(), pose = object.pose(), id = object.id();
+      const QRectF bbx = object.bbx();
+      const std::vector<bob::visioner::Keypoint> keypoints = object.keypoints();
+      ar & type;
+      ar & pose;
+      ar & id;
+      ar & bbx;
+      ar & keypoints;
+    }
+
+  template <typename Archive>
+    void load(Archive& ar, bob::visioner::Object& object, const unsigned int) {
+      std::string type, pose, id;
+      QRectF bbx;
+      std::vector<bob::visioner::Keypoint> keypoints;
+      ar & type;
+      ar & pose;
+      ar & id;
+      ar & bbx;
+      ar & keypoints;
+      object = bob::visioner::Object(type, pose, id, bbx);
+      for (uint64_t k = 0; k < keypoints.size(); k ++) {
+        object.add(keypoints[k]);
+      }
+    }
+
+  // NB: the integral image is not saved
+  template <typename Archive>
+    void serialize(Archive& ar, bob::visioner::ipscale_t& ip, const unsigned int) {
+      ar & ip.m_image;
+      ar & ip.m_objects;
+      ar & ip.m_scale;
+      ar & ip.m_inv_scale;
+      ar & ip.m_scan_dx;
+      ar & ip.m_scan_dy;
+      ar & ip.m_scan_min_x;
+      ar & ip.m_scan_max_x;
+      ar & ip.m_scan_min_y;
+      ar & ip.m_scan_max_y;
+      ar & ip.m_scan_w;
+      ar & ip.m_scan_h;
+      ar & ip.m_scan_o_w;
+      ar & ip.m_scan_o_h;
+    }
+
+}}
+
+namespace {
+
+// The size and modification time of each file (zero if it does not exist)
+void stamp_files(const std::vector<std::string>& files,
+    std::vector<uint64_t>& sizes, std::vector<int64_t>& mtimes) {
+  sizes.resize(files.size());
+  mtimes.resize(files.size());
+  for (uint64_t i = 0; i < files.size(); ++i) {
+    boost::system::error_code ec;
+    sizes[i] = boost::filesystem::file_size(files[i], ec);
+    if (ec) sizes[i] = 0;
+    mtimes[i] = boost::filesystem::last_write_time(files[i], ec);
+    if (ec) mtimes[i] = 0;
+  }
+}
+
+// Identifies the files (with their size and modification time) and the
+// parameters a cache file was saved with
+struct cache_key_t {
+
+  cache_key_t() : version(0), type(0), lazy(false), rows(0), cols(0), ds(0),
+    min_gt_overlap(0.0) { }
+
+  cache_key_t(const bob::visioner::param_t& param, int type, bool lazy,
+      const std::vector<std::string>& ifiles,
+      const std::vector<std::string>& gfiles) :
+    magic("visioner sampler cache"), version(2), type(type), lazy(lazy),
+    ifiles(ifiles), gfiles(gfiles), rows(param.m_rows), cols(param.m_cols),
+    ds(param.m_ds), tagger(param.m_tagger), labels(param.m_labels),
+    min_gt_overlap(param.m_min_gt_overlap) {
+      stamp_files(ifiles, isizes, imtimes);
+      stamp_files(gfiles, gsizes, gmtimes);
+    }
+
+  bool operator==(const cache_key_t& other) const {
+    return magic == other.magic && version == other.version &&
+      type == other.type && lazy == other.lazy &&
+      ifiles == other.ifiles && gfiles == other.gfiles &&
+      isizes == other.isizes && imtimes == other.imtimes &&
+      gsizes == other.gsizes && gmtimes == other.gmtimes &&
+      rows == other.rows && cols == other.cols && ds == other.ds &&
+      tagger == other.tagger && labels == other.labels &&
+      min_gt_overlap == other.min_gt_overlap;
+  }
+
+  template <typename Archive>
+    void serialize(Archive& ar, const unsigned int) {
+      ar & magic;
+      ar & version;
+      ar & type;
+      ar & lazy;
+      ar & ifiles;
+      ar & gfiles;
+      ar & isizes;
+      ar & imtimes;
+      ar & gsizes;
+      ar & gmtimes;
+      ar & rows;
+      ar & cols;
+      ar & ds;
+      ar & tagger;
+      ar & labels;
+      ar & min_gt_overlap;
+    }
+
+  std::string magic;
+  uint64_t version;
+  int type;
+  bool lazy;
+  std::vector<std::string> ifiles, gfiles;
+  std::vector<uint64_t> isizes, gsizes;
+  std::vector<int64_t> imtimes, gmtimes;
+  uint64_t rows, cols, ds;
+  std::string tagger;
+  std::vector<std::string> labels;
+  double min_gt_overlap;
+};
+
+}
+
 namespace bob { namespace visioner {
 
+  // Images and samples found in a single file
+  struct Sampler::loaded_t {
+
+    loaded_t() : ok(false) { }
+
+    bool ok;                          // Loaded?
+    std::string error;                // Error message (if an exception was thrown)
+    std::vector<ipscale_t> ipscales;  // Scaled images with samples (the original image in lazy mode)
+    std::vector<double> factors;      // Scale factor of each scaled image with samples
+    std::vector<uint64_t> n_samples;  // # of samples of each scaled image with samples
+    std::vector<uint64_t> tcounts;    // # of times / distinct target type
+  };
+
   // Constructor
-  Sampler::Sampler(const param_t& param, SamplerType type, size_t max_threads) :
+  Sampler::Sampler(const param_t& param, SamplerType type, size_t max_threads,
+      bool lazy, const std::string& cache) :
     m_param(param),
     m_type(type),
+    m_lazy(lazy),
     m_tagger(make_tagger(m_param)),
     m_loss(make_loss(m_param)),
     m_n_outputs(m_tagger->n_outputs()),
@@ -66,7 +264,8 @@ namespace bob { namespace visioner {
           throw std::runtime_error(m.str());
         }
 
-        this->load(ifiles, gfiles);
+        if (cache.empty()) this->load(ifiles, gfiles);
+        else this->load(ifiles, gfiles, cache);
       }
 
     }
@@ -75,21 +274,116 @@ namespace bob { namespace visioner {
   void Sampler::load(const std::vector<std::string>& ifiles,
       const std::vector<std::string>& gfiles) {
 
+    m_ipscales.clear();
+    m_ipsbegins.clear();
+    m_ipsends.clear();
+    m_ipsources.clear();
+    m_ipsfactors.clear();
+    std::fill(m_tcounts.begin(), m_tcounts.end(), 0);
+    m_n_samples = 0;
+
+    // Load and tag the images (NB: the files are distributed in a
+    //	round-robin fashion, as consecutive files often have similar sizes)
+    std::vector<loaded_t> loaded(ifiles.size());
+    const uint64_t n_threads = m_rgens.size();
+    if (n_threads == 1) {
+      th_load(0, 1, ifiles, gfiles, loaded);
+    }
+    else {
+      thread_iloop(boost::bind(&Sampler::th_load,
+            this, boost::lambda::_1, n_threads, boost::cref(ifiles),
+            boost::cref(gfiles), boost::ref(loaded)),
+          ifiles.size(), n_threads);
+    }
+
+    // Merge the results in the order of the files
+    for (uint64_t i = 0; i < ifiles.size(); ++i) {
+
+      loaded_t& result = loaded[i];
+      if (result.error.empty() == false) {
+        throw std::runtime_error(result.error);
+      }
+      if (result.ok == false) {
+        bob::core::warn << "failed to load the image in file '"
+          << ifiles[i] << "'" << std::endl;
+        continue;
+      }
+
+      for (uint64_t is = 0; is < result.factors.size(); ++is) {
+        m_ipsbegins.push_back(m_n_samples);
+        m_ipsends.push_back(m_n_samples + result.n_samples[is]);
+        if (m_lazy == true) {
+          m_ipsources.push_back(m_ipscales.size());
+          m_ipsfactors.push_back(result.factors[is]);
+        }
+        m_n_samples += result.n_samples[is];
+      }
+      for (uint64_t iti = 0; iti < n_types(); iti ++) {
+        m_tcounts[iti] += result.tcounts[iti];
+      }
+
+      m_ipscales.insert(m_ipscales.end(), result.ipscales.begin(), result.ipscales.end());
+      std::vector<ipscale_t>().swap(result.ipscales);
+    }
+
+#   ifdef BOB_DEBUG
+    for (uint64_t iti = 0; iti < n_types(); iti ++) {
+      TDEBUG1("" << type2str() << " sampler] target type '" << iti << "'"
+        << " found in " << m_tcounts[iti] << " of " << n_samples()
+        << " samples.");
+    }
+#   endif
+
+  }
+
+  // Reset to a set of listfiles, using a cache file
+  void Sampler::load(const std::vector<std::string>& ifiles,
+      const std::vector<std::string>& gfiles, const std::string& cache) {
+
+    if (restore(cache, ifiles, gfiles) == true) {
+      return;
+    }
+
+    load(ifiles, gfiles);
+
+    if (save(cache, ifiles, gfiles) == false) {
+      bob::core::warn << "failed to save the " << type2str()
+        << " samples to the cache file '" << cache << "'" << std::endl;
+    }
+  }
+
+  // Loading thread
+  void Sampler::th_load(uint64_t ith, uint64_t n_threads,
+      const std::vector<std::string>& ifiles,
+      const std::vector<std::string>& gfiles,
+      std::vector<loaded_t>& loaded) const {
+
     ipyramid_t ipyramid(m_param);
 
     std::vector<double> targets(n_outputs());
     uint64_t type;
 
-    // Process each image in the list
-    for (uint64_t i = 0; i < ifiles.size(); ++i) {
+    for (uint64_t i = ith; i < ifiles.size(); i += n_threads) {
 
       TDEBUG1("[" << type2str() << " sampler] loading image "
         << (i + 1) << " of " << ifiles.size() << "...");
 
+      loaded_t& result = loaded[i];
+      result.tcounts.resize(n_types(), 0);
+
       // Load the scaled images ...
-      if (ipyramid.load(ifiles[i], gfiles[i]) == false) {
-        bob::core::warn << "failed to load the image in file '"
-          << ifiles[i] << "'" << std::endl;
+      try {
+        result.ok = ipyramid.load(ifiles[i], gfiles[i]);
+      }
+      catch (std::exception& e) {
+        result.error = e.what();
+      }
+      catch (...) {
+        boost::format m("unknown error while loading the image in file '%s'");
+        m % ifiles[i];
+        result.error = m.str();
+      }
+      if (result.ok == false) {
         continue;
       }
 
@@ -98,41 +392,109 @@ namespace bob { namespace visioner {
 
         const ipscale_t& ip = ipyramid[is];
 
-        uint64_t new_n_samples = 0, old_n_samples = n_samples();
+        uint64_t new_n_samples = 0;
         for (int y = ip.m_scan_min_y; y < ip.m_scan_max_y; y += ip.m_scan_dy)
           for (int x = ip.m_scan_min_x; x < ip.m_scan_max_x; x += ip.m_scan_dx)
           {
             if (m_tagger->check(ip, x, y, targets, type) == true)
             {
-              m_tcounts[type] ++;
+              result.tcounts[type] ++;
               new_n_samples ++;
             }
           }
 
         // Make sure to store only images with at least one sample
         if (new_n_samples > 0) {
-          m_ipscales.push_back(ip);
-          m_ipsbegins.push_back(old_n_samples);
-          m_ipsends.push_back(old_n_samples + new_n_samples);
-          m_n_samples += new_n_samples;
+          if (m_lazy == false) {
+            result.ipscales.push_back(ip);
+          }
+          result.factors.push_back(ip.m_scale);
+          result.n_samples.push_back(new_n_samples);
         }
+      }
 
-        // Backgroung image - there is no point in keeping in memory too many scales!
-        // if (ip.m_objects.empty() == true)
-        // {
-        //         is += 2;//ipyramid.size() / 8;
-        // }
+      // ... or only the original image in lazy mode
+      if (m_lazy == true && result.factors.empty() == false) {
+        result.ipscales.push_back(ipyramid[0]);
       }
     }
+  }
 
-#   ifdef BOB_DEBUG
-    for (uint64_t iti = 0; iti < n_types(); iti ++) {
-      TDEBUG1("" << type2str() << " sampler] target type '" << iti << "'"
-        << " found in " << m_tcounts[iti] << " of " << n_samples()
-        << " samples.");
+  // Save the loaded images and samples to a cache file
+  bool Sampler::save(const std::string& path,
+      const std::vector<std::string>& ifiles,
+      const std::vector<std::string>& gfiles) const {
+
+    std::ofstream ofs(path.c_str(), std::ios::out | std::ios::binary);
+    if (ofs.is_open() == false) {
+      return false;
+    }
+
+    try {
+      const cache_key_t key(m_param, m_type, m_lazy, ifiles, gfiles);
+      boost::archive::binary_oarchive oa(ofs);
+      oa << key;
+      oa << m_n_samples;
+      oa << m_tcounts;
+      oa << m_ipscales;
+      oa << m_ipsbegins;
+      oa << m_ipsends;
+      oa << m_ipsources;
+      oa << m_ipsfactors;
+    }
+    catch (std::exception&) {
+      return false;
     }
-#   endif
 
+    return ofs.good();
+  }
+
+  // Restore the loaded images and samples from a cache file
+  bool Sampler::restore(const std::string& path,
+      const std::vector<std::string>& ifiles,
+      const std::vector<std::string>& gfiles) {
+
+    std::ifstream ifs(path.c_str(), std::ios::in | std::ios::binary);
+    if (ifs.is_open() == false) {
+      return false;
+    }
+
+    try {
+      boost::archive::binary_iarchive ia(ifs);
+      cache_key_t key;
+      ia >> key;
+      if (!(key == cache_key_t(m_param, m_type, m_lazy, ifiles, gfiles))) {
+        return false;
+      }
+
+      uint64_t n_samples;
+      std::vector<uint64_t> tcounts, ipsbegins, ipsends, ipsources;
+      std::vector<ipscale_t> ipscales;
+      std::vector<double> ipsfactors;
+      ia >> n_samples;
+      ia >> tcounts;
+      ia >> ipscales;
+      ia >> ipsbegins;
+      ia >> ipsends;
+      ia >> ipsources;
+      ia >> ipsfactors;
+      if (tcounts.size() != n_types()) {
+        return false;
+      }
+
+      m_n_samples = n_samples;
+      m_tcounts.swap(tcounts);
+      m_ipscales.swap(ipscales);
+      m_ipsbegins.swap(ipsbegins);
+      m_ipsends.swap(ipsends);
+      m_ipsources.swap(ipsources);
+      m_ipsfactors.swap(ipsfactors);
+    }
+    catch (std::exception&) {
+      return false;
+    }
+
+    return true;
   }
 
   void Sampler::sample(uint64_t n_sel_samples,
@@ -357,16 +719,28 @@ namespace bob { namespace visioner {
   // Map the given sample to image
   uint64_t Sampler::sample2image(uint64_t s) const
   {
-    for (uint64_t i = 0; i < n_images(); i ++)
+    // NB: the sample intervals are consecutive and sorted
+    return std::upper_bound(m_ipsends.begin(), m_ipsends.end(), s) -
+      m_ipsends.begin();
+  }
+
+  // Return the given scaled image (generated in <buffer> in lazy mode)
+  const ipscale_t& Sampler::ipscale(uint64_t i, ipscale_t& buffer) const
+  {
+    if (m_lazy == false)
     {
-      if (    m_ipsbegins[i] <= s &&
-          s < m_ipsends[i])
-      {
-        return i;
-      }
+      return m_ipscales[i];
+    }
+
+    const ipscale_t& src = m_ipscales[m_ipsources[i]];
+    if (m_ipsfactors[i] >= 1.0)
+    {
+      return src;
     }
 
-    return n_images();
+    src.scale(m_ipsfactors[i], m_param, buffer);
+    buffer.m_iimage.reset();
+    return buffer;
   }
 
   // Compute the error of the given sample
@@ -409,11 +783,13 @@ namespace bob { namespace visioner {
     boost::mt19937& gen = m_rgens[ith];
     boost::uniform_01<> die;
 
+    ipscale_t buffer;
+
     // Process the valid samples in the range ...
     for (uint64_t i = sample2image(srange.first), s = m_ipsbegins[i];
         s < srange.second && i < n_images(); i ++)
     {
-      const ipscale_t& ip = m_ipscales[i];
+      const ipscale_t& ip = ipscale(i, buffer);
 
       for (int y = ip.m_scan_min_y; y < ip.m_scan_max_y; y += ip.m_scan_dy)
         for (int x = ip.m_scan_min_x; x < ip.m_scan_max_x; x += ip.m_scan_dx)
@@ -449,11 +825,13 @@ namespace bob { namespace visioner {
     boost::mt19937& gen = m_rgens[ith];
     boost::uniform_01<> die;
 
+    ipscale_t buffer;
+
     // Process the valid samples in the range ...
     for (uint64_t i = sample2image(srange.first), s = m_ipsbegins[i];
         s < srange.second && i < n_images(); i ++) {
 
-      const ipscale_t& ip = m_ipscales[i];
+      const ipscale_t& ip = ipscale(i, buffer);
 
       model->preprocess(ip);
 
@@ -493,11 +871,13 @@ namespace bob { namespace visioner {
     std::vector<double> targets(n_outputs()), scores(n_outputs());
     uint64_t type;
 
+    ipscale_t buffer;
+
     // Process the valid samples in the range ...
     for (uint64_t i = sample2image(srange.first), s = m_ipsbegins[i];
         s < srange.second && i < n_images(); i ++)
     {
-      const ipscale_t& ip = m_ipscales[i];
+      const ipscale_t& ip = ipscale(i, buffer);
 
       model->preprocess(ip);
 
@@ -531,11 +911,13 @@ namespace bob { namespace visioner {
     std::vector<double> targets(n_outputs());
     uint64_t type;
 
+    ipscale_t buffer;
+
     // Process the valid samples in the range ...
     for (uint64_t ss = srange.first, i = sample2image(samples[ss]), s = m_ipsbegins[i];
         ss < srange.second && i < n_images(); i ++)
     {
-      const ipscale_t& ip = m_ipscales[i];
+      const ipscale_t& ip = ipscale(i, buffer);
 
       model->preprocess(ip);
 
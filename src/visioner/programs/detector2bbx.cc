@@ -30,7 +30,9 @@ int main(int argc, char *argv[]) {
     ("data", boost::program_options::value<std::string>(), 
      "test datasets")
     ("results", boost::program_options::value<std::string>()->default_value("./"),
-     "directory to save bounding boxes to");
+     "directory to save bounding boxes to")
+    ("raw", boost::program_options::value<bool>()->default_value(false),
+     "also save all the detections before clustering (to replay them with detector_nms)");
   detector.add_options(po_desc);
 
   boost::program_options::variables_map po_vm;
@@ -51,6 +53,7 @@ int main(int argc, char *argv[]) {
 
   const std::string cmd_data = po_vm["data"].as<std::string>();
   const std::string cmd_results = po_vm["results"].as<std::string>();
+  const bool cmd_raw = po_vm["raw"].as<bool>();
 
   // Load the test datasets
   std::vector<std::string> ifiles, gfiles;
@@ -82,7 +85,23 @@ int main(int argc, char *argv[]) {
     std::vector<bob::visioner::detection_t> detections;                
     std::vector<int> labels;
 
-    detector.scan(detections);
+    if (cmd_raw == true)
+    {
+      // Scan without clustering, save and then cluster the detections
+      const double cluster = detector.m_cluster;
+      detector.m_cluster = 1.0;
+      detector.scan(detections);
+      detector.m_cluster = cluster;
+
+      bob::visioner::save_detections(
+          cmd_results + "/" + bob::visioner::basename(ifiles[i]) + ".det.raw", detections);
+      bob::visioner::nms(detections, detector.m_cluster, detector.n_outputs(),
+          detector.m_nms, detector.m_threshold);
+    }
+    else
+    {
+      detector.scan(detections);
+    }
     detector.label(detections, labels);
 
     // Save the bounding boxes of the correct detections
@@ -0,0 +1,75 @@
+/**
+ * @file visioner/programs/detector_calibrate.cc
+ * @date Sun 18 Oct 2026 10:12:41 CEST
+ *
+ * @brief Calibrates the rejection thresholds used when scanning a detection
+ * model in levels and saves them with the model.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include "bob/core/logging.h"
+
+#include "bob/visioner/cv/cv_detector.h"
+
+int main(int argc, char *argv[]) {
+
+  bob::visioner::CVDetector detector;
+
+  // Parse the command line
+  boost::program_options::options_description po_desc("", 160);
+  po_desc.add_options()
+    ("help,h", "help message");
+  po_desc.add_options()
+    ("data", boost::program_options::value<std::string>(),
+     "validation datasets")
+    ("recall", boost::program_options::value<double>()->default_value(0.99),
+     "fraction of the detections to keep")
+    ("model", boost::program_options::value<std::string>(),
+     "file to save the calibrated model");
+  detector.add_options(po_desc);
+
+  boost::program_options::variables_map po_vm;
+  boost::program_options::store(
+      boost::program_options::command_line_parser(argc, argv)
+      .options(po_desc).run(),
+      po_vm);
+  boost::program_options::notify(po_vm);
+
+  // Check arguments and options
+  if (	po_vm.empty() || po_vm.count("help") ||
+      !po_vm.count("data") ||
+      !po_vm.count("model") ||
+      !detector.decode(po_desc, po_vm))
+  {
+    bob::core::error << po_desc << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string cmd_data = po_vm["data"].as<std::string>();
+  const double cmd_recall = po_vm["recall"].as<double>();
+  const std::string cmd_model = po_vm["model"].as<std::string>();
+
+  // Load the validation datasets
+  std::vector<std::string> ifiles, gfiles;
+  if (bob::visioner::load_listfiles(cmd_data, ifiles, gfiles) == false)
+  {
+    bob::core::error << "Failed to load the validation datasets <" << cmd_data << ">!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Calibrate the rejection thresholds ...
+  if (detector.calibrate(ifiles, gfiles, cmd_recall) == false)
+  {
+    bob::core::error << "Failed to calibrate the model (are there scanning levels?)!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // ... and save them with the model
+  detector.save(cmd_model);
+
+  // OK
+  bob::core::info << "Program finished successfully" << std::endl;
+  return EXIT_SUCCESS;
+
+}
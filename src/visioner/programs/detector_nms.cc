@@ -0,0 +1,156 @@
+/**
+ * @file visioner/programs/detector_nms.cc
+ * @date Sun 19 Oct 2026 14:05:31 CEST
+ *
+ * @brief Replays stored lists of detections (e.g. saved with detector2bbx
+ * --raw) through the non-maximum suppression, to benchmark it against the
+ * reference pairwise implementation.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <fstream>
+#include <algorithm>
+#include <boost/program_options.hpp>
+#include <boost/algorithm/string.hpp>
+
+#include "bob/core/logging.h"
+
+#include "bob/visioner/cv/cv_nms.h"
+#include "bob/visioner/util/timer.h"
+
+int main(int argc, char *argv[]) {
+
+  // Parse the command line
+  boost::program_options::options_description po_desc("", 160);
+  po_desc.add_options()
+    ("help,h", "help message");
+  po_desc.add_options()
+    ("data", boost::program_options::value<std::string>(),
+     "file listing the files of detections to replay (one per line)")
+    ("cluster", boost::program_options::value<double>()->default_value(0.05),
+     "overlapping threshold for clustering detections")
+    ("method", boost::program_options::value<std::string>()->default_value("greedy"),
+     "method for clustering detections (greedy, average, soft)")
+    ("min_score", boost::program_options::value<double>()->default_value(0.0),
+     "minimum score of the detections (soft method)")
+    ("repeats", boost::program_options::value<uint64_t>()->default_value(1),
+     "number of times each list of detections is processed")
+    ("pairwise", boost::program_options::value<bool>()->default_value(true),
+     "also run (and time) the reference pairwise implementation");
+
+  boost::program_options::variables_map po_vm;
+  boost::program_options::store(
+      boost::program_options::command_line_parser(argc, argv)
+      .options(po_desc).run(),
+      po_vm);
+  boost::program_options::notify(po_vm);
+
+  bob::visioner::NMSMethod method = bob::visioner::NMSGreedy;
+
+  // Check arguments and options
+  if (	po_vm.empty() || po_vm.count("help") ||
+      !po_vm.count("data") ||
+      !bob::visioner::decode_nms(po_vm["method"].as<std::string>(), method))
+  {
+    bob::core::error << po_desc << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  const std::string cmd_data = po_vm["data"].as<std::string>();
+  const double cmd_cluster = po_vm["cluster"].as<double>();
+  const double cmd_min_score = po_vm["min_score"].as<double>();
+  const uint64_t cmd_repeats = std::max((uint64_t)1, po_vm["repeats"].as<uint64_t>());
+  const bool cmd_pairwise = po_vm["pairwise"].as<bool>();
+
+  // Load the list of files of detections
+  std::vector<std::string> dfiles;
+  std::ifstream in(cmd_data.c_str());
+  std::string line;
+  while (std::getline(in, line))
+  {
+    boost::trim(line);
+    if (line.empty() == false)
+    {
+      dfiles.push_back(line);
+    }
+  }
+  if (dfiles.empty() == true)
+  {
+    bob::core::error << "Failed to load the list of detections <" << cmd_data << ">!" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  bob::visioner::Timer timer;
+  double total_nms = 0.0, total_pairwise = 0.0;
+  uint64_t total_dets = 0, n_mismatches = 0;
+
+  // Process each list of detections ...
+  for (std::size_t i = 0; i < dfiles.size(); i ++)
+  {
+    std::vector<bob::visioner::detection_t> detections;
+    if (bob::visioner::load_detections(dfiles[i], detections) == false)
+    {
+      bob::core::error << "Failed to load the detections <" << dfiles[i] << ">!" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+    uint64_t n_outputs = 0;
+    for (std::size_t d = 0; d < detections.size(); d ++)
+    {
+      n_outputs = std::max(n_outputs, (uint64_t)(detections[d].second.second + 1));
+    }
+
+    // NMS using the spatial index ...
+    std::vector<bob::visioner::detection_t> result;
+    timer.restart();
+    for (uint64_t r = 0; r < cmd_repeats; r ++)
+    {
+      result = detections;
+      bob::visioner::nms(result, cmd_cluster, n_outputs, method, cmd_min_score);
+    }
+    const double time_nms = timer.elapsed() / cmd_repeats;
+
+    // ... and comparing all pairs of detections
+    double time_pairwise = 0.0;
+    bool match = true;
+    if (cmd_pairwise == true)
+    {
+      std::vector<bob::visioner::detection_t> reference;
+      timer.restart();
+      for (uint64_t r = 0; r < cmd_repeats; r ++)
+      {
+        reference = detections;
+        bob::visioner::nms_pairwise(reference, cmd_cluster, n_outputs);
+      }
+      time_pairwise = timer.elapsed() / cmd_repeats;
+
+      if (method == bob::visioner::NMSGreedy && result != reference)
+      {
+        match = false;
+        n_mismatches ++;
+      }
+    }
+
+    total_nms += time_nms;
+    total_pairwise += time_pairwise;
+    total_dets += detections.size();
+
+    bob::core::info
+      << "Detections [" << (i + 1) << "/" << dfiles.size() << "]: kept "
+      << result.size() << "/" << detections.size() << " in "
+      << time_nms << "s (pairwise: " << time_pairwise << "s)"
+      << (match == true ? "." : " - MISMATCH!") << std::endl;
+  }
+
+  // Display statistics
+  bob::core::info
+    << "Processed " << total_dets << " detections in " << total_nms
+    << "s (pairwise: " << total_pairwise << "s), with " << n_mismatches
+    << " mismatches." << std::endl;
+
+  // OK
+  bob::core::info << "Program finished successfuly" << std::endl;
+  return n_mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+
+}
@@ -68,6 +68,9 @@ int main(int argc, char *argv[]) {
 
   bob::visioner::Timer timer;
 
+  // Keypoints localized in the previous frame (tracking)
+  std::vector<std::pair<QRectF, std::vector<QPointF> > > prev_points;
+
   // Process each image ...
   for (std::size_t i = 0; i < ifiles.size(); i ++)
   {
@@ -93,21 +96,46 @@ int main(int argc, char *argv[]) {
     QImage qimage = bob::visioner::draw_gt(detector.ipscale());
     bob::visioner::draw_detections(qimage, detections, detector.param(), labels);
 
-    // Localize keypoints
+    // Localize keypoints (in tracking mode, initialized with the keypoints
+    //	of the matching detection of the previous frame)
     bob::visioner::Object object;
-    std::vector<QPointF> dt_points;
+    std::vector<std::pair<QRectF, std::vector<QPointF> > > frame_points;
     for (std::vector<bob::visioner::detection_t>::const_iterator it = detections.begin(); it != detections.end(); ++ it)
       if (detector.match(*it, object) == true)
       {
-        if (localizer.locate(detector, it->second.first, dt_points) == false)
+        const QRectF& reg = it->second.first;
+
+        const std::vector<QPointF>* init = 0;
+        double max_overlap = detector.MinOverlap();
+        for (std::size_t p = 0; p < prev_points.size(); p ++)
+        {
+          const double ov = bob::visioner::overlap(reg, prev_points[p].first);
+          if (ov >= max_overlap)
+          {
+            max_overlap = ov;
+            init = &prev_points[p].second;
+          }
+        }
+
+        std::vector<QPointF> dt_points;
+        const bool ok = init == 0 ?
+          localizer.locate(detector, reg, dt_points) :
+          localizer.locate(detector, reg, *init, dt_points);
+        if (ok == false)
         {
           bob::core::warn << "Failed to localize the keypoints for the <" << ifile << "> image!" << std::endl;
           continue;
         }          
 
         bob::visioner::draw_points(qimage, dt_points);
+        frame_points.push_back(std::make_pair(reg, dt_points));
       }
 
+    if (detector.get_tracking() == true)
+    {
+      prev_points.swap(frame_points);
+    }
+
     qimage.save((cmd_results + "/" + bob::visioner::basename(ifiles[i]) + ".loc.png").c_str());
 
     bob::core::info 
@@ -116,6 +144,9 @@ int main(int argc, char *argv[]) {
       << timer.elapsed() << "s." << std::endl;                
   }
 
+  // Display statistics
+  detector.stats().show();
+
   // OK
   bob::core::info << "Program finished successfully" << std::endl;
   return EXIT_SUCCESS;
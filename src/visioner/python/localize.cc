@@ -62,8 +62,62 @@ static boost::python::object detect(bob::visioner::CVDetector& det,
   return boost::python::tuple(tmp);
 }
 
+static boost::python::object pyramid_timings(const bob::visioner::CVDetector& det) {
+  boost::python::list tmp;
+  const std::vector<double>& timings = det.ipyramid().timings();
+  for (size_t i=0; i<timings.size(); ++i) tmp.append(timings[i]);
+  return boost::python::tuple(tmp);
+}
+
+static boost::python::object stats(const bob::visioner::CVDetector& det) {
+  const bob::visioner::CVDetector::stats_t& st = det.stats();
+  boost::python::dict tmp;
+  tmp["ground_truths"] = st.m_gts;
+  tmp["subwindows"] = st.m_sws;
+  tmp["evaluations"] = st.m_evals;
+  tmp["timing"] = st.m_timing;
+  boost::python::list level_sws, level_evals;
+  for (size_t i=0; i<st.m_level_sws.size(); ++i) {
+    level_sws.append(st.m_level_sws[i]);
+    level_evals.append(st.m_level_evals[i]);
+  }
+  tmp["level_subwindows"] = boost::python::tuple(level_sws);
+  tmp["level_evaluations"] = boost::python::tuple(level_evals);
+  tmp["frames"] = st.m_frames;
+  tmp["tracked_frames"] = st.m_tracked;
+  return tmp;
+}
+
+static bool calibrate(bob::visioner::CVDetector& det, 
+    boost::python::object ifiles, boost::python::object gfiles, double recall) {
+  std::vector<std::string> vifiles, vgfiles;
+  for (int i=0; i<boost::python::len(ifiles); ++i) {
+    vifiles.push_back(boost::python::extract<std::string>(ifiles[i]));
+    vgfiles.push_back(boost::python::extract<std::string>(gfiles[i]));
+  }
+  return det.calibrate(vifiles, vgfiles, recall);
+}
+
 static boost::python::object locate(bob::visioner::CVLocalizer& loc,
-    bob::visioner::CVDetector& det, bob::python::const_ndarray image) {
+    bob::visioner::CVDetector& det, bob::python::const_ndarray image,
+    boost::python::object previous) {
+
+  // The result of the previous frame (if any), to initialize the localization
+  QRectF prev_bbox;
+  std::vector<QPointF> prev_points;
+  if (!previous.is_none()) {
+    boost::python::object bbox = previous[0], points = previous[1];
+    prev_bbox = QRectF(
+        boost::python::extract<double>(bbox[0]),
+        boost::python::extract<double>(bbox[1]),
+        boost::python::extract<double>(bbox[2]),
+        boost::python::extract<double>(bbox[3]));
+    for (int i=0; i<boost::python::len(points); ++i) {
+      prev_points.push_back(QPointF(
+            boost::python::extract<double>(points[i][0]),
+            boost::python::extract<double>(points[i][1])));
+    }
+  }
 
   blitz::Array<uint8_t,2> bzimage = image.bz<uint8_t,2>();
   det.load(bzimage.data(), bzimage.rows(), bzimage.cols());
@@ -81,8 +135,12 @@ static boost::python::object locate(bob::visioner::CVLocalizer& loc,
   std::vector<QPointF> dt_points;
 
   for (std::vector<bob::visioner::detection_t>::const_iterator it = detections.begin(); it != detections.end(); ++ it) {
-    if (det.match(*it, object) && loc.locate(det, it->second.first, dt_points))
-      break;
+    if (!det.match(*it, object)) continue;
+    const QRectF& reg = it->second.first;
+    if (bob::visioner::overlap(reg, prev_bbox) >= det.MinOverlap()) {
+      if (loc.locate(det, reg, prev_points, dt_points)) break;
+    }
+    else if (loc.locate(det, reg, dt_points)) break;
   }
 
   // Returns a 2-tuple: 
@@ -106,12 +164,29 @@ void bind_visioner_localize() {
     .value("GroundTruth", bob::visioner::CVDetector::GroundTruth)
     ;
 
+  boost::python::enum_<bob::visioner::NMSMethod>("NMSMethod")
+    .value("Greedy", bob::visioner::NMSGreedy)
+    .value("Average", bob::visioner::NMSAverage)
+    .value("Soft", bob::visioner::NMSSoft)
+    ;
+
   boost::python::class_<bob::visioner::CVDetector>("CVDetector", "Object detector that processes a pyramid of images", boost::python::init<const std::string&, double, uint64_t, uint64_t, double, bob::visioner::CVDetector::Type>((boost::python::arg("model"), boost::python::arg("threshold")=0.0, boost::python::arg("scanning_levels")=0, boost::python::arg("scale_variation")=2, boost::python::arg("clustering")=0.05, boost::python::arg("method")=bob::visioner::CVDetector::GroundTruth), "Basic constructor with the following parameters:\n\nmodel\n  file containing the model to be loaded; **note**: Serialization will use a native text format by default. Files that have their names suffixed with '.gz' will be automatically decompressed. If the filename ends in '.vbin' or '.vbgz' the format used will be the native binary format.\n\nthreshold\n  object classification threshold\n\nscanning_levels\n  scanning levels (the more, the faster)\n\nscale_variation\n  scale variation in pixels\n\nclustering\n  overlapping threshold for clustering detections\n\nmethod\n  Scanning or GroundTruth"))
     .def_readwrite("threshold", &bob::visioner::CVDetector::m_threshold, "Object classification threshold")
     .add_property("scanning_levels", &bob::visioner::CVDetector::get_scan_levels, &bob::visioner::CVDetector::set_scan_levels, "Levels (the more, the faster)")
     .def_readwrite("scale_variation", &bob::visioner::CVDetector::m_ds, "Scale variation in pixels")
     .def_readwrite("clustering", &bob::visioner::CVDetector::m_cluster, "Overlapping threshold for clustering detections")
+    .def_readwrite("nms", &bob::visioner::CVDetector::m_nms, "Method for clustering detections: Greedy (default) keeps the best of the overlapping detections, Average also replaces its bounding box by the average of the ones it removes, and Soft decays the scores of the overlapping detections instead of removing them (they are removed if their score falls below the threshold)")
     .def_readwrite("method", &bob::visioner::CVDetector::m_type, "Scanning or GroundTruth (default)")
+    .add_property("incremental", &bob::visioner::CVDetector::get_incremental, &bob::visioner::CVDetector::set_incremental, "If set, the image pyramid is built incrementally (each scale from the nearest one an octave larger) re-using the buffers of the previous image, and the integral images of all scales are computed in parallel. This is meant for processing video frames of the same size.")
+    .add_property("pyramid_timings", &pyramid_timings, "Time (in seconds) spent building each scale of the image pyramid for the last image")
+    .add_property("calibrated", &bob::visioner::CVDetector::get_calibrated, &bob::visioner::CVDetector::set_calibrated, "If set, the scanning stops evaluating a sub-window after each level if its score is below the calibrated rejection threshold of that level (see calibrate()), instead of zero")
+    .add_property("stats", &stats, "Scanning statistics accumulated since the detector was created (or since reset_stats() was called), including the number of sub-windows and LUT evaluations at each scanning level")
+    .add_property("tracking", &bob::visioner::CVDetector::get_tracking, &bob::visioner::CVDetector::set_tracking, "If set (video processing), the whole image is scanned only every rescan frames (or when there is nothing to track): the other frames are only scanned in the neighbourhood (location and nearby scales) of the detections of the previous frame. The frames scanned this way are counted in the stats (tracked_frames).")
+    .def_readwrite("rescan", &bob::visioner::CVDetector::m_rescan, "Tracking: the whole image is scanned every given number of frames")
+    .def_readwrite("track_range", &bob::visioner::CVDetector::m_track_range, "Tracking: the size of the neighbourhood of the previous detections, in scanning steps (in each direction)")
+    .def("reset_tracking", &bob::visioner::CVDetector::reset_tracking, (boost::python::arg("self")), "Forgets the detections of the previous frame, such that the next image is fully scanned (e.g. at a shot change)")
+    .def("reset_stats", &bob::visioner::CVDetector::reset_stats, (boost::python::arg("self")), "Resets the scanning statistics")
+    .def("calibrate", &calibrate, (boost::python::arg("self"), boost::python::arg("images"), boost::python::arg("ground_truths"), boost::python::arg("recall")=0.99), "Calibrates the rejection thresholds of each scanning level on the given validation images (and their ground-truth files), such that the given fraction of the true detections is kept. The thresholds are stored with the model (see save()). Returns False if the model cannot be scanned in levels.")
     .def("detect", &detect, (boost::python::arg("self"), boost::python::arg("image")), "Detects faces in the input (gray-scaled) image according to the current settings. The input image format should be a 2D array of dtype=uint8.")
     .def("detect_max", &detect_max, (boost::python::arg("self"), boost::python::arg("image")), "Detects the most probable face in the input (gray-scaled) image according to the current settings")
     .def("save", &bob::visioner::CVDetector::save, (boost::python::arg("self"), boost::python::arg("filename")), "Saves the model and parameters to a given file.\n\n**Note**: Serialization will use a native text format by default. Files that have their name suffixed with '.gz' will be automatically decompressed. If the filename ends in '.vbin' or '.vbgz' the format used will be the native binary format.")
@@ -125,7 +200,7 @@ void bind_visioner_localize() {
 
   boost::python::class_<bob::visioner::CVLocalizer>("CVLocalizer", "Keypoint localizer to be applied in tandem with ground-truth or detections from CVDetector", boost::python::init<const std::string&, bob::visioner::CVLocalizer::Type>((boost::python::arg("model"), boost::python::arg("method")=bob::visioner::CVLocalizer::MultipleShots_Median), "Basic constructor taking a model file and the localization method to use"))
       .def_readwrite("method", &bob::visioner::CVLocalizer::m_type, "SingleShot, MultipleShots_Average or MultipleShots_Median (default)")
-      .def("locate", &locate, (boost::python::arg("self"), boost::python::arg("detector"), boost::python::arg("image")), "Runs the keypoint localization on the first (highest scored) face location determined by the detector. The input image format should be a 2D array of dtype=uint8.")
+      .def("locate", &locate, (boost::python::arg("self"), boost::python::arg("detector"), boost::python::arg("image"), boost::python::arg("previous")=boost::python::object()), "Runs the keypoint localization on the first (highest scored) face location determined by the detector. The input image format should be a 2D array of dtype=uint8. For video frames, the result of the previous frame may be given as previous: if its bounding box overlaps the face location, its keypoints initialize the localization (fewer predictions are collected nearby, and combined with the previous keypoints).")
     .def("save", &bob::visioner::CVLocalizer::save, (boost::python::arg("self"), boost::python::arg("filename")), "Saves the model and parameters to a given file.\n\n**Note**: Serialization will use a native text format by default. Files that have their name suffixed with '.gz' will be automatically decompressed. If the filename ends in '.vbin' or '.vbgz' the format used will be the native binary format.")
     ;
 }
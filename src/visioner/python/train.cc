@@ -135,6 +135,41 @@ static void sampler_load(bob::visioner::Sampler& s, boost::python::object images
   s.load(i, g);
 }
 
+static void sampler_load_cached(bob::visioner::Sampler& s,
+    boost::python::object images, boost::python::object gts,
+    const std::string& cache) {
+  boost::python::stl_input_iterator<const char*> ibegin(images), iend;
+  std::vector<std::string> i(ibegin, iend);
+    boost::python::stl_input_iterator<const char*> gbegin(gts), gend;
+  std::vector<std::string> g(gbegin, gend);
+  s.load(i, g, cache);
+}
+
+static boost::python::tuple sampler_map(const bob::visioner::Sampler& s,
+    boost::python::object samples, const bob::visioner::Model& model,
+    size_t threads) {
+  boost::python::stl_input_iterator<uint64_t> sbegin(samples), send;
+  std::vector<uint64_t> v(sbegin, send);
+  bob::visioner::DataSet data;
+  s.map(v, model, data, threads);
+
+  bob::python::ndarray targets(bob::core::array::t_float64,
+      data.n_samples(), data.n_outputs());
+  blitz::Array<double,2> targets_ = targets.bz<double,2>();
+  for (uint64_t i = 0; i < data.n_samples(); ++i)
+    for (uint64_t o = 0; o < data.n_outputs(); ++o)
+      targets_((int)i, (int)o) = data.target(i, o);
+
+  bob::python::ndarray values(bob::core::array::t_uint16,
+      data.n_samples(), data.n_features());
+  blitz::Array<uint16_t,2> values_ = values.bz<uint16_t,2>();
+  for (uint64_t i = 0; i < data.n_samples(); ++i)
+    for (uint64_t f = 0; f < data.n_features(); ++f)
+      values_((int)i, (int)f) = data.value(f, i);
+
+  return boost::python::make_tuple(targets.self(), values.self());
+}
+
 static boost::shared_ptr<bob::visioner::Sampler> 
 sampler_from_files(const bob::visioner::param_t& param,
     bob::visioner::Sampler::SamplerType type, boost::python::object images,
@@ -195,7 +230,7 @@ void bind_visioner_train() {
     .value("Validation", bob::visioner::Sampler::ValidSampler)
     ;
 
-  boost::python::class_<bob::visioner::Sampler>("Sampler", "Object used for sampling uniformly, such that the same number of samples are obtained for distinct target values.", boost::python::init<bob::visioner::param_t, bob::visioner::Sampler::SamplerType, boost::python::optional<size_t> >((boost::python::arg("param"), boost::python::arg("type"), boost::python::arg("max_threads")=0), "Default constructor with parameters and the type of sampler this sampler will be. Set the maximum number of threads to zero if you want the job to be executed in the current thread, or to 1 or more if you would like to have more threads spawn. At this point, this parameter will only create as many random number generators as you specify (with a minimum of 1, if you set 0 there)."))
+  boost::python::class_<bob::visioner::Sampler>("Sampler", "Object used for sampling uniformly, such that the same number of samples are obtained for distinct target values.", boost::python::init<bob::visioner::param_t, bob::visioner::Sampler::SamplerType, boost::python::optional<size_t, bool, std::string> >((boost::python::arg("param"), boost::python::arg("type"), boost::python::arg("max_threads")=0, boost::python::arg("lazy")=false, boost::python::arg("cache")=""), "Default constructor with parameters and the type of sampler this sampler will be. Set the maximum number of threads to zero if you want the job to be executed in the current thread, or to 1 or more if you would like to have more threads spawn. At this point, this parameter will create as many random number generators as you specify (with a minimum of 1, if you set 0 there), and the images will be loaded with the same number of threads. In lazy mode, only the original images are kept in memory and the scaled images are generated again each time they are used. If a cache file is given, the samples are restored from it if it was saved with the same files and parameters, otherwise they are loaded and saved to it."))
     .def("__init__", make_constructor(&sampler_from_files, boost::python::default_call_policies(), (boost::python::arg("param"), boost::python::arg("type"), boost::python::arg("images"), boost::python::arg("ground_thruth"))), "Constructs a new (single-threaded) sampler with parameters, a type and a list of images and (associated) ground-thruth information. Note that if you specify the list of images and ground-thruth inside the parameters object, that list will be read, but discarded in favor of the discrete list provided with the two input parameters.")
     .def("__init__", make_constructor(&sampler_from_files_2, boost::python::default_call_policies(), (boost::python::arg("param"), boost::python::arg("type"), boost::python::arg("images"), boost::python::arg("ground_thruth"), boost::python::arg("max_threads"))), "Constructs a new (multi-threaded) sampler with parameters, a type and a list of images and (associated) ground-thruth information. Note that if you specify the list of images and ground-thruth inside the parameters object, that list will be read, but discarded in favor of the discrete list provided with the two input parameters.")
     .add_property("num_of_images", &bob::visioner::Sampler::n_images)
@@ -203,7 +238,10 @@ void bind_visioner_train() {
     .add_property("num_of_outputs", &bob::visioner::Sampler::n_outputs)
     .add_property("num_of_types", &bob::visioner::Sampler::n_types)
     .add_property("type", &bob::visioner::Sampler::getType, "This sampler's type")
+    .add_property("lazy", &bob::visioner::Sampler::lazy, "Are the scaled images generated again each time they are used?")
     .def("load", &sampler_load, (boost::python::arg("self"), boost::python::arg("images"), boost::python::arg("ground_thruth")), "Resets the current contents of this sampler to use the image and (matching) ground-thruth files given. This method input lists or python iterables with the absolute or relative path of images and ground-thruth files you need to load.")
+    .def("map", &sampler_map, (boost::python::arg("self"), boost::python::arg("samples"), boost::python::arg("model"), boost::python::arg("threads")=0), "Maps the given samples (indexes between 0 and num_of_samples, sorted and without duplicates) to their targets and feature values with the given model. Returns a tuple (targets, values), with one row per sample in both arrays.")
+    .def("load", &sampler_load_cached, (boost::python::arg("self"), boost::python::arg("images"), boost::python::arg("ground_thruth"), boost::python::arg("cache")), "Resets the current contents of this sampler to use the image and (matching) ground-thruth files given, restoring them from the cache file if it was saved with the same files and parameters, or loading the files and saving them to the cache file otherwise.")
     ;
 
   boost::python::class_<bob::visioner::Model, boost::shared_ptr<bob::visioner::Model>, boost::noncopyable>("Model", "Multivariate model as a linear combination of LUTs. NB: The ::preprocess() must be called before ::get() and ::score() functions.", boost::python::no_init)